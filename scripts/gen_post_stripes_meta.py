@@ -107,6 +107,10 @@ def main():
     # Perform transition
     print("generate transition solution, post-transition placement file: {}".format(str(post_placement_path)))
     cmd = "cd {}; ./BTSGenerator {} {} {} {} {} {} {} {} {} {}".format(str(bin_dir), k_i, m_i, k_f, m_f, num_nodes, num_stripes, approach,  str(pre_placement_path), str(post_placement_path), str(sg_meta_path))
+    # (optional) store the binary plan file
+    plan_filename = config["Controller"].get("plan_filename", "")
+    if plan_filename != "":
+        cmd += " --plan={} --pre_block_mapping={}".format(str(metadata_dir / plan_filename), str(pre_block_mapping_path))
     exec_cmd(cmd, exec=True)
 
     # Read post placement
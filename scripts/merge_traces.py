@@ -0,0 +1,61 @@
+import os
+import sys
+import json
+import argparse
+from pathlib import Path
+
+def parse_args(cmd_args):
+    arg_parser = argparse.ArgumentParser(description="merge the trace files of Controller and Agents into one timeline")
+    arg_parser.add_argument("-trace_files", type=str, nargs="+", required=True, help="trace files, or directories of trace files (trace_*.json)")
+    arg_parser.add_argument("-output_filename", type=str, required=True, help="output trace file name")
+    arg_parser.add_argument("-keep_timestamps", action="store_true", help="keep the wall-clock timestamps (default: start the timeline at 0)")
+
+    args = arg_parser.parse_args(cmd_args)
+    return args
+
+def main():
+    args = parse_args(sys.argv[1:])
+    if not args:
+        exit()
+
+    # collect trace files
+    trace_filenames = []
+    for item in args.trace_files:
+        path = Path(item)
+        if path.is_dir():
+            trace_filenames += sorted(str(filename) for filename in path.glob("trace_*.json"))
+        else:
+            trace_filenames.append(str(path))
+
+    output_path = os.path.abspath(args.output_filename)
+    trace_filenames = [filename for filename in trace_filenames if os.path.abspath(filename) != output_path]
+    if len(trace_filenames) == 0:
+        print("error: no trace files found")
+        exit(1)
+
+    # merge events (each node is a process in the timeline)
+    events = []
+    for trace_filename in trace_filenames:
+        with open(trace_filename, "r") as f:
+            trace = json.load(f)
+        node_events = trace["traceEvents"] if isinstance(trace, dict) else trace
+        num_stages = sum(1 for event in node_events if event["ph"] == "X")
+        print("read {} stages from {}".format(num_stages, trace_filename))
+        events += node_events
+
+    # start the timeline at the earliest stage
+    if args.keep_timestamps == False:
+        timestamps = [event["ts"] for event in events if "ts" in event and event["ph"] != "M"]
+        if len(timestamps) > 0:
+            min_ts = min(timestamps)
+            for event in events:
+                if "ts" in event and event["ph"] != "M":
+                    event["ts"] -= min_ts
+
+    with open(args.output_filename, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, f)
+
+    print("written {} events of {} trace files to {}".format(len(events), len(trace_filenames), args.output_filename))
+
+if __name__ == '__main__':
+    main()
@@ -1,5 +1,7 @@
 #include "include/include.hh"
 #include "util/Config.hh"
+#include "util/Tracer.hh"
+#include "util/Logger.hh"
 #include "comm/AgentNode.hh"
 
 int main(int argc, char **argv)
@@ -16,6 +18,16 @@ int main(int argc, char **argv)
     Config config(config_filename);
     config.print();
 
+    // asynchronous logging
+    Logger::init(config.log_level, config.log_buffer_size, config.log_rate_limit);
+
+    // (optional) timeline tracing of the node
+    if (config.trace_dir.empty() == false)
+    {
+        Tracer::init(config.trace_dir + "/trace_agent_" + to_string(agent_id) + ".json", agent_id, "Agent " + to_string(agent_id), config.trace_buffer_size);
+        Tracer::setThreadName("Agent " + to_string(agent_id));
+    }
+
     AgentNode agent_node(agent_id, config);
 
     // benchmarking
@@ -30,5 +42,12 @@ int main(int argc, char **argv)
     gettimeofday(&end_time, nullptr);
     finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                   (end_time.tv_usec - start_time.tv_usec) / 1000;
+
+    // flush the buffered logs
+    Logger::shutdown();
+
     printf("Agent::main finished transitioning, time: %f ms\n", finish_time);
+
+    // write the timeline trace (all threads are finished)
+    Tracer::dump();
 }
\ No newline at end of file
@@ -2,17 +2,19 @@
 #include "model/ConvertibleCode.hh"
 #include "model/ClusterSettings.hh"
 #include "util/StripeGenerator.hh"
+#include "model/TransApproach.hh"
 #include "model/StripeBatch.hh"
 #include "model/RandomSolution.hh"
 #include "model/BWOptSolution.hh"
 #include "model/BART.hh"
+#include "model/PlanFile.hh"
 #include "util/Stats.hh"
 
 int main(int argc, char *argv[])
 {
-    if (argc != 11 && argc != 12)
+    if (argc < 11)
     {
-        printf("usage: ./BTSGenerator k_i m_i k_f m_f num_nodes num_stripes approach[RDRE/RDPM/BWRE/BWPM/BTRE/BTPM/BT/BTWeighted] pre_placement_filename post_placement_filename sg_meta_filename [bw_filename]\n");
+        printf("usage: ./BTSGenerator k_i m_i k_f m_f num_nodes num_stripes approach[RDRE/RDPM/BWRE/BWPM/BTRE/BTPM/BT/BTWeighted] pre_placement_filename post_placement_filename sg_meta_filename [bw_filename] [--plan=plan_filename] [--pre_block_mapping=pre_block_mapping_filename]\n");
         return -1;
     }
 
@@ -22,18 +24,37 @@ int main(int argc, char *argv[])
     uint8_t m_f = atoi(argv[4]);
     uint16_t num_nodes = atoi(argv[5]);
     uint32_t num_stripes = atoi(argv[6]);
-    string approach = argv[7];
+    TransApproach approach = TransApproachUtils::parse(argv[7]); // resolve the approach once
     string pre_placement_filename = argv[8];
     string post_placement_filename = argv[9];
     string sg_meta_filename = argv[10];
     string bw_filename;
+    string plan_filename;              // (optional) binary plan file
+    string pre_block_mapping_filename; // (optional) pre-transition block mapping stored in the plan file
 
     // heterogeneous network
     bool is_heterogeneous = false;
-    if (argc == 12)
+    for (int arg_id = 11; arg_id < argc; arg_id++)
     {
-        bw_filename = argv[11];
-        is_heterogeneous = true;
+        string arg = argv[arg_id];
+        if (arg.find("--plan=") == 0)
+        {
+            plan_filename = arg.substr(strlen("--plan="));
+        }
+        else if (arg.find("--pre_block_mapping=") == 0)
+        {
+            pre_block_mapping_filename = arg.substr(strlen("--pre_block_mapping="));
+        }
+        else if (is_heterogeneous == false)
+        {
+            bw_filename = arg;
+            is_heterogeneous = true;
+        }
+        else
+        {
+            printf("invalid argument: %s\n", argv[arg_id]);
+            return -1;
+        }
     }
 
     // random generator
@@ -62,9 +83,9 @@ int main(int argc, char *argv[])
         return -1;
     }
 
-    if (approach == "BTWeighted")
+    if (approach == TransApproach::BT_WEIGHTED)
     {
-        if (argc != 12)
+        if (is_heterogeneous == false)
         {
             printf("For BTWeighted, please explicitly specify the network settings <bw_filename>\n");
             return -1;
@@ -94,18 +115,18 @@ int main(int argc, char *argv[])
     struct timeval start_time, end_time;
     gettimeofday(&start_time, nullptr);
 
-    if (approach == "RDRE" || approach == "RDPM")
+    if (approach == TransApproach::RDRE || approach == TransApproach::RDPM)
     {
         RandomSolution random_solution(random_generator);
         random_solution.genSolution(stripe_batch, approach);
     }
-    else if (approach == "BWRE" || approach == "BWPM")
+    else if (approach == TransApproach::BWRE || approach == TransApproach::BWPM)
     {
         // BWOptSolution
         BWOptSolution stripe_merge(random_generator);
         stripe_merge.genSolution(stripe_batch, approach);
     }
-    else if (approach == "BTRE" || approach == "BTPM" || approach == "BT" || approach == "BTWeighted")
+    else if (approach == TransApproach::BTRE || approach == TransApproach::BTPM || approach == TransApproach::BT || approach == TransApproach::BT_WEIGHTED)
     {
         // BART solution
         BART bart(random_generator);
@@ -113,7 +134,7 @@ int main(int argc, char *argv[])
     }
     else
     {
-        printf("invalid approach: %s\n", approach.c_str());
+        printf("invalid approach: %s\n", argv[7]);
         return -1;
     }
 
@@ -139,10 +160,41 @@ int main(int argc, char *argv[])
     // store stripe group metadata to sg_meta_filename metadata file
     stripe_batch.storeSGMetadata(sg_meta_filename);
 
+    // store the binary plan (placements, stripe group metadata and
+    // optionally the pre-transition block mapping)
+    if (plan_filename.empty() == false)
+    {
+        vector<vector<pair<uint16_t, string>>> pre_block_mapping;
+        bool is_pre_block_mapping_loaded = false;
+        if (pre_block_mapping_filename.empty() == false)
+        {
+            is_pre_block_mapping_loaded = stripe_generator.loadBlockMapping(code.n_i, settings.num_stripes, pre_block_mapping_filename, pre_block_mapping);
+        }
+
+        // tie the plan to the text metadata generated together (and the
+        // stored block mapping), so a stale plan is detected on loading
+        vector<string> meta_filenames = {pre_placement_filename, post_placement_filename, sg_meta_filename};
+        if (is_pre_block_mapping_loaded == true)
+        {
+            meta_filenames.push_back(pre_block_mapping_filename);
+        }
+        uint64_t meta_stamp = 0;
+        if (PlanFile::stampFiles(meta_filenames, meta_stamp) == false)
+        {
+            printf("error: failed to access metadata files for the plan stamp\n");
+            return -1;
+        }
+
+        if (PlanFile::store(plan_filename, stripe_batch, is_pre_block_mapping_loaded == true ? &pre_block_mapping : NULL, NULL, meta_stamp) == false)
+        {
+            return -1;
+        }
+    }
+
     // get load distribution
     vector<u32string> transfer_load_dist = trans_solution.getTransferLoadDist();
 
-    printf("================ Approach : %s =========================\n", approach.c_str());
+    printf("================ Approach : %s =========================\n", TransApproachUtils::getName(approach));
 
     if (is_heterogeneous == true)
     {
@@ -6,7 +6,7 @@ AgentNode::AgentNode(uint16_t _self_conn_id, Config &_config) : Node(_self_conn_
     for (auto &item : connectors_map)
     {
         uint16_t conn_id = item.first;
-        cmd_dist_queues[conn_id] = new MessageQueue<Command>(MAX_MSG_QUEUE_LEN);
+        cmd_dist_queues[conn_id] = new MultiWriterQueue<Command>(MAX_MSG_QUEUE_LEN);
     }
 
     // create compute task queues
@@ -21,25 +21,64 @@ AgentNode::AgentNode(uint16_t _self_conn_id, Config &_config) : Node(_self_conn_
         reloc_task_queues[reloc_worker_id] = new MultiWriterQueue<Command>(MAX_MSG_QUEUE_LEN);
     }
 
-    // create block request handler
-    block_req_handler = new BlockReqHandler(config, self_conn_id, config.settings.num_nodes); // DEBUG
+    // number of chunk buffers reserved by the block request handler, and
+    // required by the largest task of a compute or relocation worker
+    ConvertibleCode &code = config.code;
+    unsigned int num_reserved_buffers = (config.settings.num_nodes - 1) * config.max_conns_per_peer * config.num_chunk_slots;
+    unsigned int num_compute_task_buffers = max(ComputeWorker::getTaskNumBuffers(config, code.k_f, code.m_f), ComputeWorker::getTaskNumBuffers(config, code.lambda_i, 1));
+    unsigned int num_task_buffers = max(num_compute_task_buffers, (unsigned int)config.num_chunk_slots);
+
+    // create memory pool (sized by the memory budget, or for all workers to
+    // run at once)
+    unsigned int num_pool_buffers = config.memory_budget / config.chunk_size;
+    if (config.memory_budget == 0)
+    {
+        num_pool_buffers = num_reserved_buffers + config.num_compute_workers * num_compute_task_buffers + config.num_reloc_workers * config.num_chunk_slots;
+    }
+    if (num_pool_buffers < num_reserved_buffers + num_task_buffers)
+    {
+        LOG_ERROR("AgentNode::AgentNode error: memory_budget (%lu Bytes) is too small: %u chunks reserved by BlockReqHandler, %u chunks required by a task", config.memory_budget, num_reserved_buffers, num_task_buffers);
+        exit(EXIT_FAILURE);
+    }
+    memory_pool = new MemoryPool(num_pool_buffers, config.chunk_size, config.use_hugepage);
+
+    LOG_INFO("[Node %u] AgentNode::AgentNode created memory pool: %u chunks of %lu Bytes (hugepage: %u)", self_conn_id, memory_pool->num_blocks, memory_pool->block_size, memory_pool->is_hugepage);
+
+    // bandwidth limits of block transfers (may be updated by Controller)
+    BlockIO::setBandwidthLimits(config.send_bw_limit, config.recv_bw_limit);
+    if (config.send_bw_limit > 0 || config.recv_bw_limit > 0)
+    {
+        LOG_INFO("[Node %u] AgentNode::AgentNode bandwidth limits (send, recv): (%lu, %lu) Bytes/s", self_conn_id, config.send_bw_limit, config.recv_bw_limit);
+    }
+
+    // create block store
+    block_store = new BlockStore(config.sync_policy, config.sync_batch_size, config.preallocate);
+
+    // create block request handler (reserves the chunk rings of connections)
+    block_req_handler = new BlockReqHandler(config, self_conn_id, *memory_pool, *block_store);
+
+    // create connection pool to block request handlers
+    conn_pool = new ConnPool(config, self_conn_id, config.max_conns_per_peer);
 
     // create command distributor
     cmd_distributor = new CmdDist(config, self_conn_id, connectors_map, cmd_dist_queues);
 
     // create command handler
-    cmd_handler = new CmdHandler(config, self_conn_id, sockets_map, &cmd_dist_queues, &compute_task_queues, &reloc_task_queues);
+    cmd_handler = new CmdHandler(config, self_conn_id, sockets_map, &cmd_dist_queues, &compute_task_queues, &reloc_task_queues, NULL);
+
+    // task completion reports to Controller (dispatch and progress tracking)
+    MultiWriterQueue<Command> *report_queue = cmd_dist_queues[CTRL_NODE_ID];
 
     // create compute workers
     for (unsigned int cmp_worker_id = 0; cmp_worker_id < config.num_compute_workers; cmp_worker_id++)
     {
-        compute_workers[cmp_worker_id] = new ComputeWorker(config, cmp_worker_id, self_conn_id, *compute_task_queues[cmp_worker_id], reloc_task_queues);
+        compute_workers[cmp_worker_id] = new ComputeWorker(config, cmp_worker_id, self_conn_id, *compute_task_queues[cmp_worker_id], reloc_task_queues, report_queue, *conn_pool, *memory_pool, *block_store);
     }
 
     // create relocation workers
     for (unsigned int reloc_worker_id = 0; reloc_worker_id < config.num_reloc_workers; reloc_worker_id++)
     {
-        reloc_workers[reloc_worker_id] = new RelocWorker(config, reloc_worker_id, self_conn_id, *reloc_task_queues[reloc_worker_id]);
+        reloc_workers[reloc_worker_id] = new RelocWorker(config, reloc_worker_id, self_conn_id, *reloc_task_queues[reloc_worker_id], report_queue, *conn_pool, *memory_pool);
     }
 }
 
@@ -63,9 +102,18 @@ AgentNode::~AgentNode()
     // delete command distributor
     delete cmd_distributor;
 
+    // delete connection pool
+    delete conn_pool;
+
     // delete block request handler
     delete block_req_handler;
 
+    // delete block store
+    delete block_store;
+
+    // delete memory pool
+    delete memory_pool;
+
     // delete relocation task queues
     for (unsigned int reloc_worker_id = 0; reloc_worker_id < config.num_reloc_workers; reloc_worker_id++)
     {
@@ -124,13 +172,24 @@ void AgentNode::stop()
         compute_workers[cmp_worker_id]->wait();
     }
 
+    // all tasks are finished (and reported): stop the connection to Controller
+    Command cmd_disconnect;
+    cmd_disconnect.buildCommand(CommandType::CMD_STOP, self_conn_id, CTRL_NODE_ID);
+    cmd_dist_queues[CTRL_NODE_ID]->Push(cmd_disconnect);
+
     // wait cmd_distributor finish
     cmd_distributor->wait();
 
     // wait cmd_handler finish
     cmd_handler->wait();
 
+    // close pooled connections (all block transfers are finished)
+    conn_pool->closeAll();
+
     // wait block request handler
     block_req_handler->stopHandling();
     block_req_handler->wait();
+
+    // sync the written blocks not yet synced (batched sync)
+    block_store->flush();
 }
\ No newline at end of file
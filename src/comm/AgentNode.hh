@@ -5,20 +5,24 @@
 #include "../util/Config.hh"
 #include "../util/MessageQueue.hh"
 #include "../util/MultiWriterQueue.h"
+#include "../util/MemoryPool.hh"
+#include "../util/Logger.hh"
 #include "Node.hh"
 #include "CmdHandler.hh"
 #include "CmdDist.hh"
 #include "BlockReqHandler.hh"
 #include "ComputeWorker.hh"
 #include "RelocWorker.hh"
+#include "ConnPool.hh"
+#include "BlockStore.hh"
 
 class AgentNode : public Node
 {
 private:
     /* data */
 public:
-    // command distribution queues: each retrieves command from CmdHandler and distributes commands to the corresponding CmdDist (CmdHandler<conn_id> -> CmdDist<conn_id>)
-    unordered_map<uint16_t, MessageQueue<Command> *> cmd_dist_queues;
+    // command distribution queues: each retrieves command from CmdHandler (and task completion reports from workers) and distributes commands to the corresponding CmdDist (CmdHandler<conn_id> / workers -> CmdDist<conn_id>)
+    unordered_map<uint16_t, MultiWriterQueue<Command> *> cmd_dist_queues;
 
     // compute task queues: each retrieves computation task from Controller, and pass to a ComputeWorker (CmdHandler -> ComputeWorker<worker_id>)
     unordered_map<unsigned int, MessageQueue<Command> *> compute_task_queues;
@@ -26,9 +30,18 @@ public:
     // block relocation task queue: each retrieves block relocation task (from both CmdHandler and ComputeWorker), and pass to a RelocWorker (ComputerWorker / CmdHandler -> RelocWorker<worker_id>)
     unordered_map<unsigned int, MultiWriterQueue<Command> *> reloc_task_queues;
 
+    // memory pool of chunk buffers (shared by all workers)
+    MemoryPool *memory_pool;
+
+    // destination of block writes (shared by ComputeWorker and BlockReqHandler)
+    BlockStore *block_store;
+
     // block request handlers
     BlockReqHandler *block_req_handler;
 
+    // persistent connections to block request handlers of other nodes (shared by ComputeWorker and RelocWorker)
+    ConnPool *conn_pool;
+
     // distribute commands
     CmdDist *cmd_distributor;
 
@@ -0,0 +1,632 @@
+#include "AsyncBlockIO.hh"
+
+#ifdef HAS_IO_URING
+mutex AsyncBlockIO::pool_reg_mtx;
+MemoryPool *AsyncBlockIO::reg_pool = NULL;
+int AsyncBlockIO::pool_ring_fd = -1;
+vector<struct iovec> AsyncBlockIO::pool_iovs;
+bool AsyncBlockIO::is_clone_supported = true;
+#endif
+
+AsyncBlockIO::AsyncBlockIO(unsigned int _queue_depth, bool use_io_uring, bool _use_direct_io, BlockStore *_block_store) : use_direct_io(_use_direct_io), queue_depth(max(_queue_depth, 1U)), num_inflight(0), block_store(_block_store), transfers(NULL)
+{
+    is_uring = false;
+#ifdef HAS_IO_URING
+    ring_fd = -1;
+    sq_ptr = MAP_FAILED;
+    cq_ptr = MAP_FAILED;
+    sqes = (struct io_uring_sqe *)MAP_FAILED;
+    if (use_io_uring == true)
+    {
+        is_uring = setupRing();
+        if (is_uring == false)
+        {
+            LOG_WARN("AsyncBlockIO::AsyncBlockIO io_uring is not supported (error: %d), fall back to synchronous I/O", errno);
+        }
+    }
+#endif
+}
+
+AsyncBlockIO::~AsyncBlockIO()
+{
+#ifdef HAS_IO_URING
+    if (sqes != MAP_FAILED)
+    {
+        munmap(sqes, sqes_size);
+    }
+    if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)
+    {
+        munmap(cq_ptr, cq_ring_size);
+    }
+    if (sq_ptr != MAP_FAILED)
+    {
+        munmap(sq_ptr, sq_ring_size);
+    }
+    if (ring_fd >= 0)
+    {
+        close(ring_fd);
+    }
+#endif
+}
+
+#ifdef HAS_IO_URING
+bool AsyncBlockIO::setupRing()
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    ring_fd = syscall(__NR_io_uring_setup, queue_depth, &params);
+    if (ring_fd < 0)
+    {
+        return false;
+    }
+
+    // IORING_OP_READ / IORING_OP_WRITE are available since IORING_FEAT_RW_CUR_POS
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0)
+    {
+        errno = ENOSYS;
+        return false;
+    }
+
+    // map the submission and completion rings, and the submission entries
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool is_single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (is_single_mmap == true)
+    {
+        sq_ring_size = max(sq_ring_size, cq_ring_size);
+        cq_ring_size = sq_ring_size;
+    }
+
+    sq_ptr = mmap(NULL, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED)
+    {
+        return false;
+    }
+    cq_ptr = is_single_mmap ? sq_ptr : mmap(NULL, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+    if (cq_ptr == MAP_FAILED)
+    {
+        return false;
+    }
+    sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes = (struct io_uring_sqe *)mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        return false;
+    }
+
+    unsigned char *sq_base = (unsigned char *)sq_ptr;
+    sq_head = (unsigned int *)(sq_base + params.sq_off.head);
+    sq_tail = (unsigned int *)(sq_base + params.sq_off.tail);
+    sq_mask = (unsigned int *)(sq_base + params.sq_off.ring_mask);
+    sq_array = (unsigned int *)(sq_base + params.sq_off.array);
+
+    unsigned char *cq_base = (unsigned char *)cq_ptr;
+    cq_head = (unsigned int *)(cq_base + params.cq_off.head);
+    cq_tail = (unsigned int *)(cq_base + params.cq_off.tail);
+    cq_mask = (unsigned int *)(cq_base + params.cq_off.ring_mask);
+    cqes = (struct io_uring_cqe *)(cq_base + params.cq_off.cqes);
+
+    sq_local_tail = *sq_tail;
+    num_to_submit = 0;
+
+    // completions never overflow: at most sq_entries (< cq_entries) chunk I/Os are in flight
+    queue_depth = min(queue_depth, params.sq_entries);
+
+    return true;
+}
+#endif
+
+bool AsyncBlockIO::isUring()
+{
+    return is_uring;
+}
+
+#ifdef HAS_IO_URING
+int AsyncBlockIO::registerPool(MemoryPool &memory_pool)
+{
+    unique_lock<mutex> lck(pool_reg_mtx);
+    if (reg_pool != NULL)
+    { // registered (or failed) by an earlier engine
+        return (reg_pool == &memory_pool) ? pool_ring_fd : -1;
+    }
+    reg_pool = &memory_pool;
+
+    uint64_t stride = 0;
+    unsigned char *base = memory_pool.getRegion(stride);
+    uint64_t num_blocks = memory_pool.num_blocks;
+
+    // each registered buffer is at most 1 GiB: split the region into whole blocks
+    uint64_t blocks_per_iov = max((uint64_t)MAX_REGISTERED_BUFFER_SIZE / stride, (uint64_t)1);
+    for (uint64_t block_id = 0; block_id < num_blocks; block_id += blocks_per_iov)
+    {
+        struct iovec iov;
+        iov.iov_base = base + block_id * stride;
+        iov.iov_len = min(blocks_per_iov, num_blocks - block_id) * stride;
+        pool_iovs.push_back(iov);
+    }
+
+    // the anchor ring only holds the registration (no I/O is submitted)
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    pool_ring_fd = syscall(__NR_io_uring_setup, 1, &params);
+    if (pool_ring_fd >= 0 && (pool_iovs.empty() == true || syscall(__NR_io_uring_register, pool_ring_fd, IORING_REGISTER_BUFFERS, &pool_iovs[0], pool_iovs.size()) < 0))
+    {
+        close(pool_ring_fd);
+        pool_ring_fd = -1;
+    }
+    if (pool_ring_fd < 0)
+    {
+        LOG_WARN("AsyncBlockIO::registerPool failed to register %lu Bytes (error: %d), use regular buffers", num_blocks * stride, errno);
+        pool_iovs.clear();
+    }
+
+    return pool_ring_fd;
+}
+#endif
+
+bool AsyncBlockIO::registerBuffers(MemoryPool &memory_pool)
+{
+#ifdef HAS_IO_URING
+    if (is_uring == false || reg_iovs.empty() == false)
+    {
+        return false;
+    }
+
+    int src_ring_fd = registerPool(memory_pool);
+    if (src_ring_fd < 0 || is_clone_supported == false)
+    {
+        return false;
+    }
+
+    // reference the registration of the anchor ring (not pinned again)
+    CloneBuffersArg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.src_fd = src_ring_fd;
+    if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_CLONE_BUFFERS, &arg, 1) < 0)
+    {
+        unique_lock<mutex> lck(pool_reg_mtx);
+        if (is_clone_supported == true)
+        {
+            LOG_WARN("AsyncBlockIO::registerBuffers failed to clone the registered memory pool (error: %d), register the buffers of engines only", errno);
+            is_clone_supported = false;
+        }
+        return false;
+    }
+
+    reg_iovs = pool_iovs;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool AsyncBlockIO::registerBuffers(unsigned char **buffers, uint64_t num_buffers, uint64_t buffer_size)
+{
+#ifdef HAS_IO_URING
+    if (is_uring == false || reg_iovs.empty() == false || num_buffers == 0)
+    {
+        return false;
+    }
+
+    vector<struct iovec> iovs(num_buffers);
+    for (uint64_t buffer_id = 0; buffer_id < num_buffers; buffer_id++)
+    {
+        iovs[buffer_id].iov_base = buffers[buffer_id];
+        iovs[buffer_id].iov_len = buffer_size;
+    }
+
+    if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS, &iovs[0], iovs.size()) < 0)
+    {
+        LOG_WARN("AsyncBlockIO::registerBuffers failed to register %lu Bytes (error: %d), use regular buffers", num_buffers * buffer_size, errno);
+        return false;
+    }
+
+    reg_iovs = iovs;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AsyncBlockIO::openTransfer(BlockFileTransfer &transfer, uint64_t block_size)
+{
+    ChunkRing &ring = *transfer.ring;
+
+    // O_DIRECT requires aligned chunk offsets, lengths and buffers
+    bool is_aligned = (ring.chunk_size % DIRECT_IO_ALIGNMENT == 0);
+    for (uint64_t slot_id = 0; is_aligned == true && slot_id < ring.num_slots; slot_id++)
+    {
+        is_aligned = ((uintptr_t)ring.slots[slot_id] % DIRECT_IO_ALIGNMENT == 0);
+    }
+
+    transfer.fd = -1;
+    transfer.is_direct = false;
+    if (use_direct_io == true && is_aligned == true)
+    {
+        transfer.fd = transfer.is_write ? BlockIO::openBlockFile(transfer.block_path, block_size, block_store, true) : open(transfer.block_path.c_str(), O_RDONLY | O_DIRECT);
+        transfer.is_direct = (transfer.fd >= 0);
+    }
+    if (transfer.fd < 0)
+    { // the file system may not support O_DIRECT
+        transfer.fd = transfer.is_write ? BlockIO::openBlockFile(transfer.block_path, block_size, block_store) : open(transfer.block_path.c_str(), O_RDONLY);
+    }
+    if (transfer.fd < 0)
+    {
+        LOG_ERROR("AsyncBlockIO::openTransfer failed to open file %s, error: %d", transfer.block_path.c_str(), errno);
+        exit(EXIT_FAILURE);
+    }
+
+    transfer.num_chunks = (block_size + ring.chunk_size - 1) / ring.chunk_size;
+    transfer.num_submitted = 0;
+    transfer.num_completed = 0;
+    transfer.is_chunk_done.assign(ring.num_slots, false);
+}
+
+void AsyncBlockIO::closeTransfer(BlockFileTransfer &transfer, uint64_t block_size)
+{
+    // the last chunk is written with an aligned length under O_DIRECT
+    if (transfer.is_write == true && transfer.is_direct == true && block_size % DIRECT_IO_ALIGNMENT != 0)
+    {
+        if (ftruncate(transfer.fd, block_size) != 0)
+        {
+            LOG_ERROR("AsyncBlockIO::closeTransfer error truncating file %s, error: %d", transfer.block_path.c_str(), errno);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (transfer.is_write == true)
+    {
+        BlockIO::closeBlockFile(transfer.fd, block_store);
+    }
+    else
+    {
+        close(transfer.fd);
+    }
+    transfer.fd = -1;
+}
+
+void AsyncBlockIO::submitChunk(uint32_t transfer_id, uint64_t chunk_id, uint64_t block_size)
+{
+    BlockFileTransfer &transfer = (*transfers)[transfer_id];
+    ChunkRing &ring = *transfer.ring;
+
+    uint64_t offset = chunk_id * ring.chunk_size;
+    uint64_t len = min(ring.chunk_size, block_size - offset);
+    if (transfer.is_direct == true)
+    {
+        len = (len + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+    }
+    unsigned char *buffer = ring.getSlot(chunk_id);
+    uint64_t user_data = ((uint64_t)transfer_id << 32) | chunk_id;
+
+    num_inflight++;
+
+#ifdef HAS_IO_URING
+    if (is_uring == true)
+    {
+        unsigned int sqe_idx = sq_local_tail & *sq_mask;
+        struct io_uring_sqe *sqe = &sqes[sqe_idx];
+        memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+        // fixed buffer (the registered iovecs are few: the memory pool in
+        // 1 GiB iovecs, or the buffers of the engine)
+        sqe->opcode = transfer.is_write ? IORING_OP_WRITE : IORING_OP_READ;
+        for (uint32_t buf_index = 0; buf_index < reg_iovs.size(); buf_index++)
+        {
+            unsigned char *iov_base = (unsigned char *)reg_iovs[buf_index].iov_base;
+            if (buffer >= iov_base && buffer + len <= iov_base + reg_iovs[buf_index].iov_len)
+            {
+                sqe->opcode = transfer.is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+                sqe->buf_index = buf_index;
+                break;
+            }
+        }
+        sqe->fd = transfer.fd;
+        sqe->off = offset;
+        sqe->addr = (uint64_t)(uintptr_t)buffer;
+        sqe->len = len;
+        sqe->user_data = user_data;
+
+        sq_array[sqe_idx] = sqe_idx;
+        sq_local_tail++;
+        num_to_submit++;
+
+        return;
+    }
+#endif
+
+    ssize_t res = transfer.is_write ? pwrite(transfer.fd, buffer, len, offset) : pread(transfer.fd, buffer, len, offset);
+    sync_completions.push_back(pair<uint64_t, int64_t>(user_data, res < 0 ? -(int64_t)errno : (int64_t)res));
+}
+
+void AsyncBlockIO::completeChunk(uint64_t user_data, int64_t res, uint64_t block_size)
+{
+    uint32_t transfer_id = user_data >> 32;
+    uint64_t chunk_id = user_data & UINT32_MAX;
+
+    BlockFileTransfer &transfer = (*transfers)[transfer_id];
+    ChunkRing &ring = *transfer.ring;
+
+    num_inflight--;
+
+    uint64_t offset = chunk_id * ring.chunk_size;
+    uint64_t cur_chunk_size = min(ring.chunk_size, block_size - offset);
+    if (res < 0 || (uint64_t)res < cur_chunk_size)
+    { // the other side of the ring waits for the whole block
+        LOG_ERROR("AsyncBlockIO::completeChunk error %s file %s at offset %lu: %s", transfer.is_write ? "writing" : "reading", transfer.block_path.c_str(), offset, res < 0 ? strerror(-res) : "short I/O");
+        exit(EXIT_FAILURE);
+    }
+
+    // chunks may complete out of order: advance the completed prefix
+    transfer.is_chunk_done[chunk_id % ring.num_slots] = true;
+    uint64_t prev_completed = transfer.num_completed;
+    while (transfer.num_completed < transfer.num_submitted && transfer.is_chunk_done[transfer.num_completed % ring.num_slots] == true)
+    {
+        transfer.is_chunk_done[transfer.num_completed % ring.num_slots] = false;
+        transfer.num_completed++;
+    }
+
+    if (transfer.num_completed > prev_completed)
+    {
+        if (transfer.is_write == true)
+        {
+            ring.setConsumed(transfer.num_completed);
+        }
+        else
+        {
+            ring.setProduced(transfer.num_completed);
+        }
+    }
+}
+
+void AsyncBlockIO::progressTransfers(uint64_t block_size, bool is_wait)
+{
+    uint64_t observed_seq = progress.get();
+
+    // submit the ready chunks, one chunk per transfer in each round
+    bool is_submitted = false;
+    bool is_round_submitted = true;
+    while (is_round_submitted == true && num_inflight < queue_depth)
+    {
+        is_round_submitted = false;
+        for (uint32_t transfer_id = 0; transfer_id < transfers->size() && num_inflight < queue_depth; transfer_id++)
+        {
+            BlockFileTransfer &transfer = (*transfers)[transfer_id];
+            uint64_t chunk_id = transfer.num_submitted;
+            if (chunk_id >= transfer.num_chunks)
+            {
+                continue;
+            }
+            bool is_ready = transfer.is_write ? transfer.ring->isSlotFilled(chunk_id) : transfer.ring->isSlotFree(chunk_id);
+            if (is_ready == true)
+            {
+                submitChunk(transfer_id, chunk_id, block_size);
+                transfer.num_submitted++;
+                is_round_submitted = true;
+                is_submitted = true;
+            }
+        }
+    }
+
+    // submit in a batch (and wait for a completion), and reap completions
+    bool is_completed = false;
+#ifdef HAS_IO_URING
+    if (is_uring == true && (num_to_submit > 0 || (is_wait == true && num_inflight > 0)))
+    {
+        __atomic_store_n(sq_tail, sq_local_tail, __ATOMIC_RELEASE);
+
+        // the kernel may submit fewer entries than asked (and then does not
+        // wait): submit until the submission ring is drained
+        unsigned int min_complete = (is_wait == true && num_inflight > 0) ? 1 : 0;
+        unsigned int flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        while (true)
+        {
+            int ret_val = syscall(__NR_io_uring_enter, ring_fd, num_to_submit, min_complete, flags, NULL, 0);
+            if (ret_val < 0)
+            {
+                if (errno != EINTR)
+                {
+                    LOG_ERROR("AsyncBlockIO::progressTransfers error io_uring_enter: %d", errno);
+                    exit(EXIT_FAILURE);
+                }
+                num_to_submit = sq_local_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+                continue;
+            }
+
+            if (ret_val == 0 && num_to_submit > 0)
+            {
+                LOG_ERROR("AsyncBlockIO::progressTransfers error io_uring_enter: no entry submitted (%u left)", num_to_submit);
+                exit(EXIT_FAILURE);
+            }
+            num_to_submit -= min((unsigned int)ret_val, num_to_submit);
+            if (num_to_submit == 0)
+            {
+                break;
+            }
+        }
+    }
+
+    if (is_uring == true)
+    {
+        unsigned int head = *cq_head;
+        unsigned int tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail)
+        {
+            struct io_uring_cqe *cqe = &cqes[head & *cq_mask];
+            completeChunk(cqe->user_data, cqe->res, block_size);
+            head++;
+            is_completed = true;
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    }
+#endif
+
+    if (sync_completions.empty() == false)
+    {
+        vector<pair<uint64_t, int64_t>> completions;
+        completions.swap(sync_completions);
+        for (auto &completion : completions)
+        {
+            completeChunk(completion.first, completion.second, block_size);
+        }
+        is_completed = true;
+    }
+
+    // nothing to do: wait for the other sides of the rings
+    if (is_wait == true && is_submitted == false && is_completed == false && num_inflight == 0)
+    {
+        progress.waitChange(observed_seq);
+    }
+}
+
+void AsyncBlockIO::startTransfers(vector<BlockFileTransfer> &_transfers, uint64_t block_size)
+{
+    transfers = &_transfers;
+    for (auto &transfer : *transfers)
+    {
+        openTransfer(transfer, block_size);
+        transfer.ring->setProgress(&progress);
+    }
+}
+
+void AsyncBlockIO::finishTransfers(uint64_t block_size)
+{
+    while (true)
+    {
+        bool is_done = true;
+        for (auto &transfer : *transfers)
+        {
+            is_done = is_done && (transfer.num_completed == transfer.num_chunks);
+        }
+        if (is_done == true)
+        {
+            break;
+        }
+        progressTransfers(block_size, true);
+    }
+
+    for (auto &transfer : *transfers)
+    {
+        transfer.ring->setProgress(NULL);
+        closeTransfer(transfer, block_size);
+    }
+    transfers = NULL;
+}
+
+void AsyncBlockIO::transferBlocks(vector<BlockFileTransfer> &_transfers, uint64_t block_size)
+{
+    startTransfers(_transfers, block_size);
+    finishTransfers(block_size);
+}
+
+uint64_t AsyncBlockIO::readBlock(string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    vector<BlockFileTransfer> read_transfers(1, BlockFileTransfer(block_path, &ring, false));
+    transferBlocks(read_transfers, block_size);
+
+    return block_size;
+}
+
+uint64_t AsyncBlockIO::writeBlock(string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    vector<BlockFileTransfer> write_transfers(1, BlockFileTransfer(block_path, &ring, true));
+    transferBlocks(write_transfers, block_size);
+
+    return block_size;
+}
+
+template <typename SocketType>
+uint64_t AsyncBlockIO::readAndSendBlockAsync(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    ring.reset();
+
+    vector<BlockFileTransfer> read_transfers(1, BlockFileTransfer(block_path, &ring, false));
+    startTransfers(read_transfers, block_size);
+
+    uint64_t offset = 0;
+    for (uint64_t chunk_id = 0; offset < block_size; chunk_id++)
+    {
+        uint64_t cur_chunk_size = min(ring.chunk_size, block_size - offset);
+        while (ring.isSlotFilled(chunk_id) == false)
+        {
+            progressTransfers(block_size, true);
+        }
+
+        BlockIO::sendBlock(skt, ring.getSlot(chunk_id), cur_chunk_size);
+        offset += cur_chunk_size;
+        ring.setConsumed(chunk_id + 1);
+
+        // read into the drained slot
+        progressTransfers(block_size, false);
+    }
+    finishTransfers(block_size);
+
+    return offset;
+}
+
+template <typename SocketType>
+uint64_t AsyncBlockIO::recvAndWriteBlockAsync(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    ring.reset();
+
+    vector<BlockFileTransfer> write_transfers(1, BlockFileTransfer(block_path, &ring, true));
+    startTransfers(write_transfers, block_size);
+
+    uint64_t offset = 0;
+    for (uint64_t chunk_id = 0; offset < block_size; chunk_id++)
+    {
+        uint64_t cur_chunk_size = min(ring.chunk_size, block_size - offset);
+        while (ring.isSlotFree(chunk_id) == false)
+        {
+            progressTransfers(block_size, true);
+        }
+
+        unsigned char *chunk = ring.getSlot(chunk_id);
+        uint64_t chunk_offset = 0;
+        while (chunk_offset < cur_chunk_size)
+        {
+            uint64_t recv_size = min((uint64_t)TCP_BUFFER_SIZE, cur_chunk_size - chunk_offset);
+            ssize_t recv_bytes = skt.read_n(chunk + chunk_offset, recv_size * sizeof(unsigned char));
+
+            if (recv_bytes == -1 || recv_bytes == 0)
+            {
+                LOG_ERROR("AsyncBlockIO::recvAndWriteBlock error recv data: %d, %s", skt.last_error(), skt.last_error_str().c_str());
+                exit(EXIT_FAILURE);
+            }
+            BlockIO::throttleRecv(recv_bytes);
+
+            chunk_offset += recv_bytes;
+        }
+        offset += cur_chunk_size;
+        ring.setProduced(chunk_id + 1);
+
+        // write the received chunk
+        progressTransfers(block_size, false);
+    }
+    finishTransfers(block_size);
+
+    return offset;
+}
+
+uint64_t AsyncBlockIO::readAndSendBlock(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    return readAndSendBlockAsync(connector, block_path, block_size, ring);
+}
+
+uint64_t AsyncBlockIO::readAndSendBlock(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    return readAndSendBlockAsync(skt, block_path, block_size, ring);
+}
+
+uint64_t AsyncBlockIO::recvAndWriteBlock(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    return recvAndWriteBlockAsync(connector, block_path, block_size, ring);
+}
+
+uint64_t AsyncBlockIO::recvAndWriteBlock(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    return recvAndWriteBlockAsync(skt, block_path, block_size, ring);
+}
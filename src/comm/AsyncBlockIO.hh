@@ -0,0 +1,274 @@
+#ifndef __ASYNC_BLOCK_IO_HH__
+#define __ASYNC_BLOCK_IO_HH__
+
+#include "../include/include.hh"
+#include "../util/MemoryPool.hh"
+#include "../util/Logger.hh"
+#include "BlockIO.hh"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+#define DIRECT_IO_ALIGNMENT 4096
+#define MAX_REGISTERED_BUFFER_SIZE 1073741824 // 1 GiB (kernel limit per registered buffer)
+
+#ifdef HAS_IO_URING
+#ifndef IORING_REGISTER_CLONE_BUFFERS
+#define IORING_REGISTER_CLONE_BUFFERS 30 // Linux 6.12
+#endif
+
+/**
+ * @brief argument of IORING_REGISTER_CLONE_BUFFERS (struct
+ * io_uring_clone_buffers): zeroed fields clone all buffers of src_fd
+ */
+typedef struct CloneBuffersArg
+{
+    uint32_t src_fd;
+    uint32_t flags;
+    uint32_t pad[6];
+} CloneBuffersArg;
+#endif
+
+/**
+ * @brief a block transfer between a file and a chunk ring, driven by
+ * AsyncBlockIO: a read fills the ring from the file, and a write drains
+ * the ring into the file
+ */
+typedef struct BlockFileTransfer
+{
+    string block_path;
+    ChunkRing *ring;
+    bool is_write;
+
+    // states (maintained by AsyncBlockIO)
+    int fd;
+    bool is_direct;               // opened with O_DIRECT
+    uint64_t num_chunks;          // number of chunks of the block
+    uint64_t num_submitted;       // chunks [0, num_submitted) are submitted
+    uint64_t num_completed;       // chunks [0, num_completed) are completed
+    vector<bool> is_chunk_done;   // completion of in-flight chunks (by slot)
+
+    BlockFileTransfer(string _block_path, ChunkRing *_ring, bool _is_write) : block_path(_block_path), ring(_ring), is_write(_is_write), fd(-1), is_direct(false), num_chunks(0), num_submitted(0), num_completed(0) {}
+} BlockFileTransfer;
+
+/**
+ * @brief asynchronous block I/O engine over io_uring (raw syscalls, no
+ * liburing): chunk reads / writes of all transfers driven by a thread are
+ * prepared in a batch and submitted with one io_uring_enter, so a thread
+ * keeps up to queue_depth chunk I/Os in flight; the chunk buffers can be
+ * registered (fixed buffers), and files can be opened with O_DIRECT. The
+ * memory pool is registered (pinned) once per process, in an anchor ring
+ * whose registration the rings of engines clone. Without io_uring (not compiled in, or not supported by the
+ * kernel), each chunk I/O is done synchronously with pread / pwrite.
+ *
+ * An engine is driven by a single thread.
+ */
+class AsyncBlockIO
+{
+private:
+    bool is_uring;      // io_uring is set up
+    bool use_direct_io; // open files with O_DIRECT (if the rings are aligned)
+    unsigned int queue_depth;
+    unsigned int num_inflight; // submitted but not reaped chunk I/Os
+    BlockStore *block_store;   // (optional) destination of written blocks
+
+    vector<BlockFileTransfer> *transfers; // transfers being driven
+    RingProgress progress;                // progress of the rings of transfers
+
+    // registered buffers (the index of an iovec is its buf_index)
+    vector<struct iovec> reg_iovs;
+
+    // completions of synchronous I/Os (without io_uring): <user_data, res>
+    vector<pair<uint64_t, int64_t>> sync_completions;
+
+#ifdef HAS_IO_URING
+    int ring_fd;
+    void *sq_ptr;
+    void *cq_ptr;
+    uint64_t sq_ring_size;
+    uint64_t cq_ring_size;
+    struct io_uring_sqe *sqes;
+    uint64_t sqes_size;
+
+    unsigned int *sq_head;
+    unsigned int *sq_tail;
+    unsigned int *sq_mask;
+    unsigned int *sq_array;
+    unsigned int *cq_head;
+    unsigned int *cq_tail;
+    unsigned int *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    unsigned int sq_local_tail; // prepared (not yet submitted) entries end here
+    unsigned int num_to_submit;
+
+    // memory pool registered once per process (in the anchor ring)
+    static mutex pool_reg_mtx;
+    static MemoryPool *reg_pool;           // memory pool of the registration (NULL: not yet registered)
+    static int pool_ring_fd;               // anchor ring holding the registration (-1: failed)
+    static vector<struct iovec> pool_iovs; // registered iovecs of the memory pool
+    static bool is_clone_supported;        // IORING_REGISTER_CLONE_BUFFERS is supported
+
+    /**
+     * @brief register the memory pool in the anchor ring (once per process)
+     *
+     * @param memory_pool
+     * @return int fd of the anchor ring; -1: failed
+     */
+    static int registerPool(MemoryPool &memory_pool);
+
+    /**
+     * @brief set up the io_uring (and map the rings)
+     *
+     * @return true
+     * @return false not supported
+     */
+    bool setupRing();
+#endif
+
+    /**
+     * @brief open the file of the transfer
+     *
+     * @param transfer
+     * @param block_size
+     */
+    void openTransfer(BlockFileTransfer &transfer, uint64_t block_size);
+
+    /**
+     * @brief close the file of the transfer
+     *
+     * @param transfer
+     * @param block_size
+     */
+    void closeTransfer(BlockFileTransfer &transfer, uint64_t block_size);
+
+    /**
+     * @brief prepare (io_uring) or perform (synchronous) the I/O of a chunk
+     *
+     * @param transfer_id
+     * @param chunk_id
+     * @param block_size
+     */
+    void submitChunk(uint32_t transfer_id, uint64_t chunk_id, uint64_t block_size);
+
+    /**
+     * @brief handle the completion of a chunk I/O
+     *
+     * @param user_data transfer_id (upper 32 bits), chunk_id (lower 32 bits)
+     * @param res bytes transferred, or -errno
+     * @param block_size
+     */
+    void completeChunk(uint64_t user_data, int64_t res, uint64_t block_size);
+
+    /**
+     * @brief submit the ready chunks of all transfers, and reap completions;
+     * with is_wait, block until a chunk I/O completes (if any is in flight)
+     * or a ring makes progress (otherwise)
+     *
+     * @param block_size
+     * @param is_wait
+     */
+    void progressTransfers(uint64_t block_size, bool is_wait);
+
+    /**
+     * @brief start driving the transfers
+     *
+     * @param _transfers
+     * @param block_size
+     */
+    void startTransfers(vector<BlockFileTransfer> &_transfers, uint64_t block_size);
+
+    /**
+     * @brief drive the transfers to completion, and close the files
+     *
+     * @param block_size
+     */
+    void finishTransfers(uint64_t block_size);
+
+    template <typename SocketType>
+    uint64_t readAndSendBlockAsync(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring);
+
+    template <typename SocketType>
+    uint64_t recvAndWriteBlockAsync(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring);
+
+public:
+    /**
+     * @brief Construct a new AsyncBlockIO
+     *
+     * @param _queue_depth maximum number of in-flight chunk I/Os
+     * @param use_io_uring false: synchronous I/O
+     * @param _use_direct_io
+     * @param _block_store (optional) destination of written blocks
+     */
+    AsyncBlockIO(unsigned int _queue_depth, bool use_io_uring, bool _use_direct_io, BlockStore *_block_store = NULL);
+    ~AsyncBlockIO();
+
+    /**
+     * @brief check if the engine runs on io_uring
+     *
+     * @return true
+     * @return false
+     */
+    bool isUring();
+
+    /**
+     * @brief use the blocks of the memory pool as fixed buffers, by cloning
+     * the registration of the process (best effort: other buffers, or a
+     * failed registration, use regular I/Os)
+     *
+     * @param memory_pool
+     * @return true
+     * @return false not supported (e.g., no buffer cloning before Linux 6.12)
+     */
+    bool registerBuffers(MemoryPool &memory_pool);
+
+    /**
+     * @brief register the buffers owned by the engine as fixed buffers
+     * (e.g., if the memory pool cannot be shared); best effort
+     *
+     * @param buffers
+     * @param num_buffers
+     * @param buffer_size
+     * @return true
+     * @return false
+     */
+    bool registerBuffers(unsigned char **buffers, uint64_t num_buffers, uint64_t buffer_size);
+
+    /**
+     * @brief run the transfers (reads and writes of blocks) to completion
+     *
+     * @param _transfers
+     * @param block_size
+     */
+    void transferBlocks(vector<BlockFileTransfer> &_transfers, uint64_t block_size);
+
+    uint64_t readBlock(string block_path, uint64_t block_size, ChunkRing &ring);
+    uint64_t writeBlock(string block_path, uint64_t block_size, ChunkRing &ring);
+
+    /**
+     * @brief read the block from disk and send it through the ring in the
+     * calling thread: the next chunks are read asynchronously while the
+     * current chunk is being sent
+     */
+    uint64_t readAndSendBlock(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring);
+    uint64_t readAndSendBlock(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring);
+
+    /**
+     * @brief receive the block and write it to disk through the ring in the
+     * calling thread: the received chunks are written asynchronously while
+     * the next chunks are being received
+     */
+    uint64_t recvAndWriteBlock(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring);
+    uint64_t recvAndWriteBlock(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring);
+};
+
+#endif // __ASYNC_BLOCK_IO_HH__
@@ -1,5 +1,125 @@
 #include "BlockIO.hh"
 
+RingProgress::RingProgress() : seq(0)
+{
+}
+
+RingProgress::~RingProgress()
+{
+}
+
+uint64_t RingProgress::get()
+{
+    unique_lock<mutex> lck(progress_mtx);
+    return seq;
+}
+
+void RingProgress::notify()
+{
+    unique_lock<mutex> lck(progress_mtx);
+    seq++;
+    lck.unlock();
+
+    progress_cv.notify_all();
+}
+
+void RingProgress::waitChange(uint64_t observed_seq)
+{
+    unique_lock<mutex> lck(progress_mtx);
+    progress_cv.wait(lck, [&]
+                     { return seq != observed_seq; });
+}
+
+ChunkRing::ChunkRing() : num_produced_chunks(0), num_consumed_chunks(0), progress(NULL), chunk_size(0), num_slots(0)
+{
+}
+
+ChunkRing::~ChunkRing()
+{
+}
+
+void ChunkRing::bind(unsigned char **_slots, uint64_t _num_slots, uint64_t _chunk_size)
+{
+    unique_lock<mutex> lck(ring_mtx);
+    slots.assign(_slots, _slots + _num_slots);
+    num_slots = _num_slots;
+    chunk_size = _chunk_size;
+    num_produced_chunks = 0;
+    num_consumed_chunks = 0;
+}
+
+void ChunkRing::reset()
+{
+    unique_lock<mutex> lck(ring_mtx);
+    num_produced_chunks = 0;
+    num_consumed_chunks = 0;
+}
+
+void ChunkRing::setProgress(RingProgress *_progress)
+{
+    unique_lock<mutex> lck(ring_mtx);
+    progress = _progress;
+}
+
+bool ChunkRing::isSlotFree(uint64_t chunk_id)
+{
+    unique_lock<mutex> lck(ring_mtx);
+    return chunk_id < num_consumed_chunks + num_slots;
+}
+
+bool ChunkRing::isSlotFilled(uint64_t chunk_id)
+{
+    unique_lock<mutex> lck(ring_mtx);
+    return chunk_id < num_produced_chunks;
+}
+
+unsigned char *ChunkRing::getSlot(uint64_t chunk_id)
+{
+    return slots[chunk_id % num_slots];
+}
+
+void ChunkRing::waitFreeSlot(uint64_t chunk_id)
+{
+    unique_lock<mutex> lck(ring_mtx);
+    ring_cv.wait(lck, [&]
+                 { return chunk_id < num_consumed_chunks + num_slots; });
+}
+
+void ChunkRing::setProduced(uint64_t num_chunks)
+{
+    unique_lock<mutex> lck(ring_mtx);
+    num_produced_chunks = max(num_produced_chunks, num_chunks);
+    RingProgress *cur_progress = progress;
+    lck.unlock();
+
+    ring_cv.notify_all();
+    if (cur_progress != NULL)
+    {
+        cur_progress->notify();
+    }
+}
+
+void ChunkRing::waitFilledSlot(uint64_t chunk_id)
+{
+    unique_lock<mutex> lck(ring_mtx);
+    ring_cv.wait(lck, [&]
+                 { return chunk_id < num_produced_chunks; });
+}
+
+void ChunkRing::setConsumed(uint64_t num_chunks)
+{
+    unique_lock<mutex> lck(ring_mtx);
+    num_consumed_chunks = max(num_consumed_chunks, num_chunks);
+    RingProgress *cur_progress = progress;
+    lck.unlock();
+
+    ring_cv.notify_all();
+    if (cur_progress != NULL)
+    {
+        cur_progress->notify();
+    }
+}
+
 BlockIO::BlockIO(/* args */)
 {
 }
@@ -8,12 +128,31 @@ BlockIO::~BlockIO()
 {
 }
 
+TokenBucket BlockIO::send_bucket;
+TokenBucket BlockIO::recv_bucket;
+
+void BlockIO::setBandwidthLimits(uint64_t send_bw_limit, uint64_t recv_bw_limit)
+{
+    send_bucket.setRate(send_bw_limit);
+    recv_bucket.setRate(recv_bw_limit);
+}
+
+void BlockIO::throttleSend(uint64_t num_bytes)
+{
+    send_bucket.acquire(num_bytes);
+}
+
+void BlockIO::throttleRecv(uint64_t num_bytes)
+{
+    recv_bucket.acquire(num_bytes);
+}
+
 uint64_t BlockIO::readBlock(string block_path, unsigned char *buffer, uint64_t block_size)
 {
     FILE *file = fopen(block_path.c_str(), "r");
     if (!file)
     {
-        fprintf(stderr, "BlockIO::readBlock failed to open file %s\n", block_path.c_str());
+        LOG_ERROR("BlockIO::readBlock failed to open file %s", block_path.c_str());
         exit(EXIT_FAILURE);
     }
 
@@ -30,49 +169,57 @@ uint64_t BlockIO::readBlock(string block_path, unsigned char *buffer, uint64_t b
     return offset;
 }
 
-uint64_t BlockIO::writeBlock(string block_path, unsigned char *buffer, uint64_t block_size)
+int BlockIO::openBlockFile(string block_path, uint64_t block_size, BlockStore *block_store, bool is_direct)
 {
-    // mkdir
-    string block_dir;
-    auto it = block_path.find_last_of("/");
-    if (it == string::npos)
-    { // relative path; get current working directory
-        char cwd[256];
-        if (getcwd(cwd, 256))
-        {
-            block_dir = cwd;
-        }
+    if (block_store != NULL)
+    {
+        return block_store->openBlock(block_path, block_size, is_direct);
     }
-    else
-    { // absolute path
-        block_dir = block_path.substr(0, it);
+
+    auto it = block_path.find_last_of("/");
+    if (it != string::npos)
+    {
+        BlockStore::makeDirs(block_path.substr(0, it));
     }
-    char mkdir_command[256];
-    sprintf(mkdir_command, "mkdir -p %s", block_dir.c_str());
-    if (system(mkdir_command) < 0)
+
+    return open(block_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | (is_direct ? O_DIRECT : 0), 0666);
+}
+
+void BlockIO::closeBlockFile(int fd, BlockStore *block_store)
+{
+    if (block_store != NULL)
     {
-        fprintf(stderr, "BlockIO::writeBlock error create block directory: %s\n", block_dir.c_str());
-        exit(EXIT_FAILURE);
+        block_store->closeBlock(fd);
+        return;
     }
 
-    // printf("BlockIO::writeBlock create block directory: %s for block path: %s\n", block_dir.c_str(), block_path.c_str());
+    close(fd);
+}
 
-    // write file
-    FILE *file = fopen(block_path.c_str(), "w");
-    if (!file)
+uint64_t BlockIO::writeBlock(string block_path, unsigned char *buffer, uint64_t block_size, BlockStore *block_store)
+{
+    int fd = openBlockFile(block_path, block_size, block_store);
+    if (fd < 0)
     {
-        fprintf(stderr, "BlockIO::writeBlock failed to open file %s, error: %d\n", block_path.c_str(), errno);
+        LOG_ERROR("BlockIO::writeBlock failed to open file %s, error: %d", block_path.c_str(), errno);
         exit(EXIT_FAILURE);
     }
-    uint64_t write_bytes = 0;
+
     uint64_t offset = 0;
-    uint64_t bytes_left = block_size;
-    while (offset < block_size && (write_bytes = fwrite(buffer + offset, 1, bytes_left, file)))
+    while (offset < block_size)
     {
-        bytes_left -= write_bytes;
+        ssize_t write_bytes = write(fd, buffer + offset, block_size - offset);
+        if (write_bytes == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (write_bytes <= 0)
+        {
+            break;
+        }
         offset += write_bytes;
     }
-    fclose(file);
+    closeBlockFile(fd, block_store);
 
     return offset;
 }
@@ -81,7 +228,7 @@ void BlockIO::deleteBlock(string block_path)
 {
     // remove file
     // std::remove(block_path.c_str());
-    printf("remove block %s\n", block_path.c_str());
+    LOG_DEBUG("remove block %s", block_path.c_str());
 }
 
 uint64_t BlockIO::sendBlock(sockpp::tcp_connector &connector, unsigned char *buffer, uint64_t block_size)
@@ -90,13 +237,15 @@ uint64_t BlockIO::sendBlock(sockpp::tcp_connector &connector, unsigned char *buf
     uint64_t bytes_left = block_size;
     while (offset < block_size)
     {
-        ssize_t send_bytes = connector.write_n(buffer + offset, TCP_BUFFER_SIZE * sizeof(unsigned char));
+        uint64_t send_size = min((uint64_t)TCP_BUFFER_SIZE, bytes_left);
+        ssize_t send_bytes = connector.write_n(buffer + offset, send_size * sizeof(unsigned char));
 
         if (send_bytes == -1)
         {
-            fprintf(stderr, "BlockIO::sendBlock error send data: %d, %s\n", connector.last_error(), connector.last_error_str().c_str());
+            LOG_ERROR("BlockIO::sendBlock error send data: %d, %s", connector.last_error(), connector.last_error_str().c_str());
             exit(EXIT_FAILURE);
         }
+        send_bucket.acquire(send_bytes); // charge the Bytes actually sent
 
         bytes_left -= send_bytes;
         offset += send_bytes;
@@ -111,13 +260,15 @@ uint64_t BlockIO::sendBlock(sockpp::tcp_socket &skt, unsigned char *buffer, uint
     uint64_t bytes_left = block_size;
     while (offset < block_size)
     {
-        ssize_t send_bytes = skt.write_n(buffer + offset, TCP_BUFFER_SIZE * sizeof(unsigned char));
+        uint64_t send_size = min((uint64_t)TCP_BUFFER_SIZE, bytes_left);
+        ssize_t send_bytes = skt.write_n(buffer + offset, send_size * sizeof(unsigned char));
 
         if (send_bytes == -1)
         {
-            fprintf(stderr, "BlockIO::sendBlock error send data: %d, %s\n", skt.last_error(), skt.last_error_str().c_str());
+            LOG_ERROR("BlockIO::sendBlock error send data: %d, %s", skt.last_error(), skt.last_error_str().c_str());
             exit(EXIT_FAILURE);
         }
+        send_bucket.acquire(send_bytes);
 
         bytes_left -= send_bytes;
         offset += send_bytes;
@@ -132,13 +283,15 @@ uint64_t BlockIO::recvBlock(sockpp::tcp_connector &connector, unsigned char *buf
     uint64_t bytes_left = block_size;
     while (offset < block_size)
     {
-        ssize_t recv_bytes = connector.read_n(buffer + offset, TCP_BUFFER_SIZE * sizeof(unsigned char));
+        uint64_t recv_size = min((uint64_t)TCP_BUFFER_SIZE, bytes_left);
+        ssize_t recv_bytes = connector.read_n(buffer + offset, recv_size * sizeof(unsigned char));
 
-        if (recv_bytes == -1)
-        {
-            fprintf(stderr, "BlockIO::recvBlock error recv data: %d, %s\n", connector.last_error(), connector.last_error_str().c_str());
+        if (recv_bytes == -1 || recv_bytes == 0)
+        { // the connection is closed by the peer before the whole block is received
+            LOG_ERROR("BlockIO::recvBlock error recv data: %d, %s", connector.last_error(), recv_bytes == 0 ? "connection closed" : connector.last_error_str().c_str());
             exit(EXIT_FAILURE);
         }
+        recv_bucket.acquire(recv_bytes); // charge the Bytes actually received
 
         bytes_left -= recv_bytes;
         offset += recv_bytes;
@@ -152,16 +305,397 @@ uint64_t BlockIO::recvBlock(sockpp::tcp_socket &skt, unsigned char *buffer, uint
     uint64_t bytes_left = block_size;
     while (offset < block_size)
     {
-        ssize_t recv_bytes = skt.read_n(buffer + offset, TCP_BUFFER_SIZE * sizeof(unsigned char));
+        uint64_t recv_size = min((uint64_t)TCP_BUFFER_SIZE, bytes_left);
+        ssize_t recv_bytes = skt.read_n(buffer + offset, recv_size * sizeof(unsigned char));
 
-        if (recv_bytes == -1)
+        if (recv_bytes == -1 || recv_bytes == 0)
         {
-            fprintf(stderr, "BlockIO::recvBlock error recv data: %d %s\n", skt.last_error(), skt.last_error_str().c_str());
+            LOG_ERROR("BlockIO::recvBlock error recv data: %d, %s", skt.last_error(), recv_bytes == 0 ? "connection closed" : skt.last_error_str().c_str());
             exit(EXIT_FAILURE);
         }
+        recv_bucket.acquire(recv_bytes);
 
         bytes_left -= recv_bytes;
         offset += recv_bytes;
     }
     return offset;
 }
+
+uint64_t BlockIO::readBlock(string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    FILE *file = fopen(block_path.c_str(), "r");
+    if (!file)
+    {
+        LOG_ERROR("BlockIO::readBlock failed to open file %s", block_path.c_str());
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t offset = 0;
+    for (uint64_t chunk_id = 0; offset < block_size; chunk_id++)
+    {
+        uint64_t cur_chunk_size = min(ring.chunk_size, block_size - offset);
+        ring.waitFreeSlot(chunk_id);
+        if (fread(ring.getSlot(chunk_id), 1, cur_chunk_size, file) != cur_chunk_size)
+        { // the consumer waits for the whole block
+            LOG_ERROR("BlockIO::readBlock error reading file %s at offset %lu", block_path.c_str(), offset);
+            exit(EXIT_FAILURE);
+        }
+        offset += cur_chunk_size;
+        ring.setProduced(chunk_id + 1);
+    }
+    fclose(file);
+
+    return offset;
+}
+
+uint64_t BlockIO::writeBlock(string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store)
+{
+    int fd = openBlockFile(block_path, block_size, block_store);
+    if (fd < 0)
+    {
+        LOG_ERROR("BlockIO::writeBlock failed to open file %s, error: %d", block_path.c_str(), errno);
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t offset = 0;
+    for (uint64_t chunk_id = 0; offset < block_size; chunk_id++)
+    {
+        uint64_t cur_chunk_size = min(ring.chunk_size, block_size - offset);
+        ring.waitFilledSlot(chunk_id);
+
+        unsigned char *chunk = ring.getSlot(chunk_id);
+        uint64_t chunk_offset = 0;
+        while (chunk_offset < cur_chunk_size)
+        {
+            ssize_t write_bytes = write(fd, chunk + chunk_offset, cur_chunk_size - chunk_offset);
+            if (write_bytes == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            if (write_bytes <= 0)
+            { // the producer waits for free slots
+                LOG_ERROR("BlockIO::writeBlock error writing file %s at offset %lu", block_path.c_str(), offset + chunk_offset);
+                exit(EXIT_FAILURE);
+            }
+            chunk_offset += write_bytes;
+        }
+
+        offset += cur_chunk_size;
+        ring.setConsumed(chunk_id + 1);
+    }
+    closeBlockFile(fd, block_store);
+
+    return offset;
+}
+
+template <typename SocketType>
+uint64_t BlockIO::sendBlockByChunk(SocketType &skt, uint64_t block_size, ChunkRing &ring)
+{
+    uint64_t offset = 0;
+    for (uint64_t chunk_id = 0; offset < block_size; chunk_id++)
+    {
+        uint64_t cur_chunk_size = min(ring.chunk_size, block_size - offset);
+        ring.waitFilledSlot(chunk_id);
+
+        unsigned char *chunk = ring.getSlot(chunk_id);
+        uint64_t chunk_offset = 0;
+        while (chunk_offset < cur_chunk_size)
+        {
+            uint64_t send_size = min((uint64_t)TCP_BUFFER_SIZE, cur_chunk_size - chunk_offset);
+            ssize_t send_bytes = skt.write_n(chunk + chunk_offset, send_size * sizeof(unsigned char));
+
+            if (send_bytes == -1)
+            {
+                LOG_ERROR("BlockIO::sendBlock error send data: %d, %s", skt.last_error(), skt.last_error_str().c_str());
+                exit(EXIT_FAILURE);
+            }
+            send_bucket.acquire(send_bytes);
+
+            chunk_offset += send_bytes;
+        }
+
+        offset += cur_chunk_size;
+        ring.setConsumed(chunk_id + 1);
+    }
+
+    return offset;
+}
+
+template <typename SocketType>
+uint64_t BlockIO::recvBlockByChunk(SocketType &skt, uint64_t block_size, ChunkRing &ring)
+{
+    uint64_t offset = 0;
+    for (uint64_t chunk_id = 0; offset < block_size; chunk_id++)
+    {
+        uint64_t cur_chunk_size = min(ring.chunk_size, block_size - offset);
+        ring.waitFreeSlot(chunk_id);
+
+        unsigned char *chunk = ring.getSlot(chunk_id);
+        uint64_t chunk_offset = 0;
+        while (chunk_offset < cur_chunk_size)
+        {
+            uint64_t recv_size = min((uint64_t)TCP_BUFFER_SIZE, cur_chunk_size - chunk_offset);
+            ssize_t recv_bytes = skt.read_n(chunk + chunk_offset, recv_size * sizeof(unsigned char));
+
+            if (recv_bytes == -1 || recv_bytes == 0)
+            { // the consumer waits for the whole block
+                LOG_ERROR("BlockIO::recvBlock error recv data: %d, %s", skt.last_error(), skt.last_error_str().c_str());
+                exit(EXIT_FAILURE);
+            }
+            recv_bucket.acquire(recv_bytes);
+
+            chunk_offset += recv_bytes;
+        }
+
+        offset += cur_chunk_size;
+        ring.setProduced(chunk_id + 1);
+    }
+
+    return offset;
+}
+
+template <typename SocketType>
+uint64_t BlockIO::readAndSendBlockByChunk(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    ring.reset();
+
+    thread read_thread([&]
+                       { readBlock(block_path, block_size, ring); });
+    uint64_t send_bytes = sendBlockByChunk(skt, block_size, ring);
+    read_thread.join();
+
+    return send_bytes;
+}
+
+template <typename SocketType>
+uint64_t BlockIO::recvAndWriteBlockByChunk(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store)
+{
+    ring.reset();
+
+    uint64_t write_bytes = 0;
+    thread write_thread([&]
+                        { write_bytes = writeBlock(block_path, block_size, ring, block_store); });
+    recvBlockByChunk(skt, block_size, ring);
+    write_thread.join();
+
+    return write_bytes;
+}
+
+bool BlockIO::isZeroCopyUnsupported(int err)
+{
+    return err == EINVAL || err == ENOSYS || err == EOPNOTSUPP;
+}
+
+template <typename SocketType>
+uint64_t BlockIO::sendBlockFileZeroCopy(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+#ifdef __linux__
+    int fd = open(block_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        LOG_ERROR("BlockIO::sendBlockFile failed to open file %s", block_path.c_str());
+        exit(EXIT_FAILURE);
+    }
+
+    off_t offset = 0; // advanced by sendfile
+    while ((uint64_t)offset < block_size)
+    {
+        // throttled: send a quantum per call to keep the rate smooth
+        uint64_t send_size = block_size - offset;
+        if (send_bucket.isLimited() == true)
+        {
+            send_size = min(send_size, (uint64_t)BW_THROTTLE_QUANTUM);
+        }
+        ssize_t send_bytes = sendfile(skt.handle(), fd, &offset, send_size);
+        if (send_bytes > 0)
+        { // charge the Bytes actually sent
+            send_bucket.acquire(send_bytes);
+            continue;
+        }
+        if (send_bytes == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (send_bytes == -1 && offset == 0 && isZeroCopyUnsupported(errno))
+        { // nothing is sent yet: fall back to the buffered path
+            close(fd);
+            return readAndSendBlockByChunk(skt, block_path, block_size, ring);
+        }
+
+        // the receiver waits for the whole block
+        LOG_ERROR("BlockIO::sendBlockFile error send file %s at offset %ld: %s", block_path.c_str(), (long)offset, send_bytes == 0 ? "unexpected end of file" : strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+
+    return offset;
+#else
+    return readAndSendBlockByChunk(skt, block_path, block_size, ring);
+#endif
+}
+
+template <typename SocketType>
+uint64_t BlockIO::recvBlockFileZeroCopy(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store)
+{
+#ifdef __linux__
+    int pipe_fds[2];
+    if (pipe(pipe_fds) == -1)
+    {
+        return recvAndWriteBlockByChunk(skt, block_path, block_size, ring, block_store);
+    }
+
+    // enlarge the pipe to a chunk to splice more data per call (best effort)
+    int pipe_size = fcntl(pipe_fds[1], F_SETPIPE_SZ, (int)min(ring.chunk_size, (uint64_t)INT_MAX));
+    if (pipe_size <= 0)
+    {
+        pipe_size = fcntl(pipe_fds[1], F_GETPIPE_SZ);
+    }
+    if (pipe_size <= 0)
+    {
+        pipe_size = TCP_BUFFER_SIZE;
+    }
+
+    int fd = openBlockFile(block_path, block_size, block_store);
+    if (fd < 0)
+    {
+        LOG_ERROR("BlockIO::recvBlockFile failed to open file %s, error: %d", block_path.c_str(), errno);
+        exit(EXIT_FAILURE);
+    }
+
+    bool is_splice_to_file = true; // false: the file system doesn't support splice; drain the pipe through a ring slot
+    uint64_t offset = 0;
+    while (offset < block_size)
+    {
+        // socket -> pipe (throttled: splice a quantum per call)
+        uint64_t recv_size = min((uint64_t)pipe_size, block_size - offset);
+        if (recv_bucket.isLimited() == true)
+        {
+            recv_size = min(recv_size, (uint64_t)BW_THROTTLE_QUANTUM);
+        }
+        ssize_t recv_bytes = splice(skt.handle(), NULL, pipe_fds[1], NULL, recv_size, SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (recv_bytes == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (recv_bytes == -1 && offset == 0 && isZeroCopyUnsupported(errno))
+        { // nothing is received yet: fall back to the buffered path
+            close(fd);
+            close(pipe_fds[0]);
+            close(pipe_fds[1]);
+            return recvAndWriteBlockByChunk(skt, block_path, block_size, ring, block_store);
+        }
+        if (recv_bytes <= 0)
+        { // the sender sends the whole block
+            LOG_ERROR("BlockIO::recvBlockFile error recv data at offset %lu: %s", offset, recv_bytes == 0 ? "connection closed" : strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+        recv_bucket.acquire(recv_bytes); // charge the Bytes actually received
+
+        // pipe -> file
+        uint64_t bytes_left = recv_bytes;
+        while (bytes_left > 0)
+        {
+            ssize_t write_bytes = -1;
+            if (is_splice_to_file == true)
+            {
+                write_bytes = splice(pipe_fds[0], NULL, fd, NULL, bytes_left, SPLICE_F_MOVE | SPLICE_F_MORE);
+                if (write_bytes == -1 && isZeroCopyUnsupported(errno))
+                {
+                    is_splice_to_file = false;
+                    continue;
+                }
+            }
+            else
+            {
+                unsigned char *buffer = ring.getSlot(0);
+                ssize_t read_bytes = read(pipe_fds[0], buffer, min(ring.chunk_size, bytes_left));
+                write_bytes = read_bytes <= 0 ? -1 : write(fd, buffer, read_bytes);
+                if (write_bytes != read_bytes)
+                {
+                    write_bytes = -1;
+                }
+            }
+
+            if (write_bytes == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            if (write_bytes <= 0)
+            {
+                LOG_ERROR("BlockIO::recvBlockFile error writing file %s at offset %lu: %s", block_path.c_str(), offset, strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+
+            bytes_left -= write_bytes;
+            offset += write_bytes;
+        }
+    }
+    closeBlockFile(fd, block_store);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+
+    return offset;
+#else
+    return recvAndWriteBlockByChunk(skt, block_path, block_size, ring, block_store);
+#endif
+}
+
+uint64_t BlockIO::sendBlock(sockpp::tcp_connector &connector, uint64_t block_size, ChunkRing &ring)
+{
+    return sendBlockByChunk(connector, block_size, ring);
+}
+
+uint64_t BlockIO::sendBlock(sockpp::tcp_socket &skt, uint64_t block_size, ChunkRing &ring)
+{
+    return sendBlockByChunk(skt, block_size, ring);
+}
+
+uint64_t BlockIO::recvBlock(sockpp::tcp_connector &connector, uint64_t block_size, ChunkRing &ring)
+{
+    return recvBlockByChunk(connector, block_size, ring);
+}
+
+uint64_t BlockIO::recvBlock(sockpp::tcp_socket &skt, uint64_t block_size, ChunkRing &ring)
+{
+    return recvBlockByChunk(skt, block_size, ring);
+}
+
+uint64_t BlockIO::readAndSendBlock(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    return readAndSendBlockByChunk(connector, block_path, block_size, ring);
+}
+
+uint64_t BlockIO::readAndSendBlock(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    return readAndSendBlockByChunk(skt, block_path, block_size, ring);
+}
+
+uint64_t BlockIO::recvAndWriteBlock(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store)
+{
+    return recvAndWriteBlockByChunk(connector, block_path, block_size, ring, block_store);
+}
+
+uint64_t BlockIO::recvAndWriteBlock(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store)
+{
+    return recvAndWriteBlockByChunk(skt, block_path, block_size, ring, block_store);
+}
+
+uint64_t BlockIO::sendBlockFile(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    return sendBlockFileZeroCopy(connector, block_path, block_size, ring);
+}
+
+uint64_t BlockIO::sendBlockFile(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring)
+{
+    return sendBlockFileZeroCopy(skt, block_path, block_size, ring);
+}
+
+uint64_t BlockIO::recvBlockFile(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store)
+{
+    return recvBlockFileZeroCopy(connector, block_path, block_size, ring, block_store);
+}
+
+uint64_t BlockIO::recvBlockFile(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store)
+{
+    return recvBlockFileZeroCopy(skt, block_path, block_size, ring, block_store);
+}
\ No newline at end of file
@@ -2,29 +2,293 @@
 #define __BLOCK_IO_HH__
 
 #include "../include/include.hh"
+#include "../util/Logger.hh"
+#include "../util/TokenBucket.hh"
 #include "sockpp/tcp_connector.h"
 #include "sockpp/tcp_socket.h"
+#include "BlockStore.hh"
 
 #include <iostream>
 #include <fstream>
 #include <cstdio>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+#define BW_THROTTLE_QUANTUM 65536 // maximum Bytes per sendfile / splice call under bandwidth throttling
+
+/**
+ * @brief progress counter shared by chunk rings, for a thread driving
+ * several rings to wait until any of them makes progress
+ */
+class RingProgress
+{
+private:
+    mutex progress_mtx;
+    condition_variable progress_cv;
+    uint64_t seq; // bumped on every progress
+
+public:
+    RingProgress();
+    ~RingProgress();
+
+    /**
+     * @brief get the current sequence number
+     *
+     * @return uint64_t
+     */
+    uint64_t get();
+
+    /**
+     * @brief bump the sequence number and wake up the waiter
+     *
+     */
+    void notify();
+
+    /**
+     * @brief wait until the sequence number differs from the observed one
+     *
+     * @param observed_seq
+     */
+    void waitChange(uint64_t observed_seq);
+};
+
+/**
+ * @brief ring of chunk slots over a block: a producer (reading, receiving
+ * or encoding thread) fills the chunks of a block in order, and a consumer
+ * (sending, encoding or writing thread) drains them in order; chunk i lives
+ * in slot (i % num_slots), so only num_slots chunks of the block are in
+ * memory (num_slots = number of chunks: the whole block is buffered). The
+ * slots are chunk buffers borrowed from the memory pool
+ */
+class ChunkRing
+{
+private:
+    mutex ring_mtx;
+    condition_variable ring_cv;
+    uint64_t num_produced_chunks; // chunks [0, num_produced_chunks) are filled
+    uint64_t num_consumed_chunks; // chunks [0, num_consumed_chunks) are drained
+    RingProgress *progress;       // (optional) notified on every progress
+
+public:
+    vector<unsigned char *> slots; // chunk buffers (not owned)
+    uint64_t chunk_size;
+    uint64_t num_slots;
+
+    ChunkRing();
+    ~ChunkRing();
+
+    /**
+     * @brief bind the ring to chunk buffers, and reset it
+     *
+     * @param _slots chunk buffers (num_slots)
+     * @param _num_slots
+     * @param _chunk_size
+     */
+    void bind(unsigned char **_slots, uint64_t _num_slots, uint64_t _chunk_size);
+
+    /**
+     * @brief reset the ring (before transferring a new block)
+     *
+     */
+    void reset();
+
+    /**
+     * @brief set the (optional) progress counter notified on every progress
+     *
+     * @param _progress NULL: none
+     */
+    void setProgress(RingProgress *_progress);
+
+    /**
+     * @brief check if the slot of the chunk is drained (non-blocking)
+     *
+     * @param chunk_id
+     * @return true
+     * @return false
+     */
+    bool isSlotFree(uint64_t chunk_id);
+
+    /**
+     * @brief check if the chunk is filled (non-blocking)
+     *
+     * @param chunk_id
+     * @return true
+     * @return false
+     */
+    bool isSlotFilled(uint64_t chunk_id);
+
+    /**
+     * @brief get the slot of the chunk
+     *
+     * @param chunk_id
+     * @return unsigned char*
+     */
+    unsigned char *getSlot(uint64_t chunk_id);
+
+    /**
+     * @brief wait until the slot of the chunk is drained (for the producer)
+     *
+     * @param chunk_id
+     */
+    void waitFreeSlot(uint64_t chunk_id);
+
+    /**
+     * @brief mark chunks [0, num_chunks) as filled
+     *
+     * @param num_chunks
+     */
+    void setProduced(uint64_t num_chunks);
+
+    /**
+     * @brief wait until the chunk is filled (for the consumer)
+     *
+     * @param chunk_id
+     */
+    void waitFilledSlot(uint64_t chunk_id);
+
+    /**
+     * @brief mark chunks [0, num_chunks) as drained
+     *
+     * @param num_chunks
+     */
+    void setConsumed(uint64_t num_chunks);
+};
 
 class BlockIO
 {
 private:
-    /* data */
+    // bandwidth throttling of the block transfers of this process (per
+    // direction; unlimited by default)
+    static TokenBucket send_bucket;
+    static TokenBucket recv_bucket;
+
+    template <typename SocketType>
+    static uint64_t sendBlockByChunk(SocketType &skt, uint64_t block_size, ChunkRing &ring);
+
+    template <typename SocketType>
+    static uint64_t recvBlockByChunk(SocketType &skt, uint64_t block_size, ChunkRing &ring);
+
+    template <typename SocketType>
+    static uint64_t readAndSendBlockByChunk(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring);
+
+    template <typename SocketType>
+    static uint64_t recvAndWriteBlockByChunk(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store);
+
+    template <typename SocketType>
+    static uint64_t sendBlockFileZeroCopy(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring);
+
+    template <typename SocketType>
+    static uint64_t recvBlockFileZeroCopy(SocketType &skt, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store);
+
+    /**
+     * @brief check if a sendfile / splice error means the call is not
+     * supported (by the platform, the socket or the file system)
+     *
+     * @param err errno
+     * @return true
+     * @return false
+     */
+    static bool isZeroCopyUnsupported(int err);
+
 public:
     BlockIO(/* args */);
     ~BlockIO();
 
+    /**
+     * @brief set the bandwidth limits of the block transfers (all sockets
+     * of this process share them); can be changed during transfers
+     *
+     * @param send_bw_limit Bytes per second (0: unlimited)
+     * @param recv_bw_limit Bytes per second (0: unlimited)
+     */
+    static void setBandwidthLimits(uint64_t send_bw_limit, uint64_t recv_bw_limit);
+
+    /**
+     * @brief throttle the Bytes sent / received outside BlockIO (e.g. by
+     * asynchronous block transfers)
+     *
+     * @param num_bytes
+     */
+    static void throttleSend(uint64_t num_bytes);
+    static void throttleRecv(uint64_t num_bytes);
+
     static uint64_t readBlock(string block_path, unsigned char *buffer, uint64_t block_size);
-    static uint64_t writeBlock(string block_path, unsigned char *buffer, uint64_t block_size);
+
+    static uint64_t writeBlock(string block_path, unsigned char *buffer, uint64_t block_size, BlockStore *block_store = NULL);
     static void deleteBlock(string block_path);
 
+    /**
+     * @brief open the file of the block for writing, through the block
+     * store (NULL: plain file, with its directory created)
+     *
+     * @param block_path
+     * @param block_size
+     * @param block_store (optional)
+     * @param is_direct open with O_DIRECT
+     * @return int fd (-1 on failure, with errno)
+     */
+    static int openBlockFile(string block_path, uint64_t block_size, BlockStore *block_store, bool is_direct = false);
+
+    /**
+     * @brief close the written file of the block, through the block store
+     * (applying its sync policy)
+     *
+     * @param fd
+     * @param block_store (optional)
+     */
+    static void closeBlockFile(int fd, BlockStore *block_store);
+
     static uint64_t sendBlock(sockpp::tcp_connector &connector, unsigned char *buffer, uint64_t block_size);
     static uint64_t sendBlock(sockpp::tcp_socket &skt, unsigned char *buffer, uint64_t block_size);
     static uint64_t recvBlock(sockpp::tcp_connector &connector, unsigned char *buffer, uint64_t block_size);
     static uint64_t recvBlock(sockpp::tcp_socket &skt, unsigned char *buffer, uint64_t block_size);
+
+    /**
+     * @brief chunked block I/O through a chunk ring: each chunk is produced
+     * into the ring as soon as it is read / received, or is written / sent
+     * (and its slot drained) as soon as it is produced, so the stages on a
+     * block overlap
+     */
+    static uint64_t readBlock(string block_path, uint64_t block_size, ChunkRing &ring);
+    static uint64_t writeBlock(string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store = NULL);
+
+    static uint64_t sendBlock(sockpp::tcp_connector &connector, uint64_t block_size, ChunkRing &ring);
+    static uint64_t sendBlock(sockpp::tcp_socket &skt, uint64_t block_size, ChunkRing &ring);
+    static uint64_t recvBlock(sockpp::tcp_connector &connector, uint64_t block_size, ChunkRing &ring);
+    static uint64_t recvBlock(sockpp::tcp_socket &skt, uint64_t block_size, ChunkRing &ring);
+
+    /**
+     * @brief read the block from disk and send it through the ring; the
+     * next chunks are read while the current chunk is being sent
+     */
+    static uint64_t readAndSendBlock(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring);
+    static uint64_t readAndSendBlock(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring);
+
+    /**
+     * @brief receive the block and write it to disk through the ring; the
+     * current chunk is written while the next chunks are being received
+     */
+    static uint64_t recvAndWriteBlock(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store = NULL);
+    static uint64_t recvAndWriteBlock(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store = NULL);
+
+    /**
+     * @brief zero-copy block transfer between the disk and the socket (for
+     * relocation and block serving, where the data is not touched): the
+     * block file is sent with sendfile, and received into the file with
+     * splice (socket -> pipe -> file), so the data never goes through user
+     * buffers; falls back to readAndSendBlock / recvAndWriteBlock through
+     * the ring if the platform doesn't support these calls
+     */
+    static uint64_t sendBlockFile(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring);
+    static uint64_t sendBlockFile(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring);
+    static uint64_t recvBlockFile(sockpp::tcp_connector &connector, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store = NULL);
+    static uint64_t recvBlockFile(sockpp::tcp_socket &skt, string block_path, uint64_t block_size, ChunkRing &ring, BlockStore *block_store = NULL);
 };
 
-#endif // __BLOCK_IO_HH__
\ No newline at end of file
+#endif // __BLOCK_IO_HH__
@@ -1,15 +1,13 @@
 #include "BlockReqHandler.hh"
 
-BlockReqHandler::BlockReqHandler(Config &_config, uint16_t _self_conn_id, unsigned int _num_workers) : ThreadPool(1), config(_config), self_conn_id(_self_conn_id), num_workers(_num_workers)
+BlockReqHandler::BlockReqHandler(Config &_config, uint16_t _self_conn_id, MemoryPool &_memory_pool, BlockStore &_block_store) : ThreadPool(1), config(_config), self_conn_id(_self_conn_id), memory_pool(_memory_pool), block_store(_block_store)
 {
-    // maximum allowed connections
-    max_conn = 100; // DEBUG
-    cur_conn = 0;
-
-    // queues for worker threads
-    for (unsigned int worker_id = 0; worker_id < num_workers; worker_id++)
+    // reserve the chunk rings of connections from the memory pool
+    max_conns = (config.settings.num_nodes - 1) * config.max_conns_per_peer;
+    memory_pool.getBlocks(max_conns * config.num_chunk_slots, ring_buffers);
+    for (unsigned int ring_id = 0; ring_id < max_conns; ring_id++)
     {
-        req_handler_queues[worker_id] = new MessageQueue<BlockReq>(MAX_MSG_QUEUE_LEN);
+        free_ring_ids.push_back(ring_id);
     }
 
     // add acceptor
@@ -27,38 +25,20 @@ BlockReqHandler::~BlockReqHandler()
     acceptor->close();
     delete acceptor;
 
-    for (unsigned int worker_id = 0; worker_id < num_workers; worker_id++)
-    {
-        delete req_handler_queues[worker_id];
-    }
+    memory_pool.freeBlocks(ring_buffers);
 }
 
 void BlockReqHandler::run()
 {
-    printf("[Node %u] BlockReqHandler::run start to handle block requests\n", self_conn_id);
+    LOG_INFO("[Node %u] BlockReqHandler::run start to handle block requests", self_conn_id);
 
-    // create block request handlers
-    for (unsigned int worker_id = 0; worker_id < num_workers; worker_id++)
-    {
-        req_handler_threads_map[worker_id] = new thread(&BlockReqHandler::handleBlockRequest, this, worker_id);
-    }
+    Tracer::setThreadName("BlockReqHandler");
 
     // stop counter
     uint16_t stop_counter = 0;
 
-    // block request counter
-    uint32_t block_request_counter = 0;
-
     while (finished() == false)
     {
-        // // check lock
-        // unique_lock<mutex> lck(max_conn_mutex);
-        // while (cur_conn > max_conn)
-        // {
-        //     max_conn_cv.wait(lck, [&]
-        //                      { return cur_conn <= max_conn; });
-        // }
-
         // accept socket
         sockpp::inet_address conn_addr;
         sockpp::tcp_socket *skt = new sockpp::tcp_socket();
@@ -66,7 +46,7 @@ void BlockReqHandler::run()
         *skt = acceptor->accept(&conn_addr);
         if (!skt)
         {
-            fprintf(stderr, "BlockReqHandler::run invalid socket: %s\n", acceptor->last_error_str().c_str());
+            LOG_ERROR("BlockReqHandler::run invalid socket: %s", acceptor->last_error_str().c_str());
             exit(EXIT_FAILURE);
         }
 
@@ -76,28 +56,27 @@ void BlockReqHandler::run()
         // command
         Command cmd;
 
-        ssize_t ret_val = skt->read_n(cmd.content, MAX_CMD_LEN * sizeof(unsigned char));
-        if (ret_val == -1 || ret_val == 0)
+        if (Command::recvCommand(*skt, cmd) <= 0)
         {
-            fprintf(stderr, "BlockReqHandler::run error reading command\n");
+            LOG_ERROR("BlockReqHandler::run error reading command");
             exit(EXIT_FAILURE);
         }
-
-        // parse the command
-        cmd.parse();
         // cmd.print();
 
         // validate command
         if (cmd.dst_conn_id != self_conn_id)
         {
             // fprintf(stderr, "BlockReqHandler::run error: invalid command content\n");
-            fprintf(stderr, "BlockReqHandler::run error: cmd.type: %u, cmd.src_conn_id: %u, cmd.dst_conn_id: %u\n", cmd.type, cmd.src_conn_id, cmd.dst_conn_id);
+            LOG_ERROR("BlockReqHandler::run error: cmd.type: %u, cmd.src_conn_id: %u, cmd.dst_conn_id: %u", cmd.type, cmd.src_conn_id, cmd.dst_conn_id);
             exit(EXIT_FAILURE);
         }
 
         // stop request
         if (cmd.type == CommandType::CMD_STOP)
         {
+            skt->close();
+            delete skt;
+
             stop_counter++;
             if (stop_counter == config.settings.num_nodes - 1)
             { // set finished if received stop command from other Agent nodes
@@ -106,136 +85,123 @@ void BlockReqHandler::run()
             continue;
         }
 
-        BlockReq req;
-        req.cmd = cmd;
-        req.skt = skt;
-
-        // distribute the socket to worker
-        unsigned int assigned_worker_id = block_request_counter % num_workers;
-
-        // obtain block request socket
-        printf("[Node %u] BlockReqHandler::run obtained block request, assign to Worker %u, post: (%u, %u)\n", self_conn_id, assigned_worker_id, cmd.post_stripe_id, cmd.post_block_id);
-
-        req_handler_queues[assigned_worker_id]->Push(req);
-
-        // increment counter
-        block_request_counter++;
-
-        // // increment number of connections
-        // cur_conn++;
+        // serve the persistent connection in a separate thread
+        conn_threads.push_back(new thread(&BlockReqHandler::handleConnection, this, skt, cmd));
     }
 
-    // distribute stop requests
-    Command cmd_stop;
-    cmd_stop.buildCommand(CommandType::CMD_STOP, self_conn_id, self_conn_id);
-
-    BlockReq req;
-    req.cmd = cmd_stop;
-    req.skt = NULL;
-    for (unsigned int worker_id = 0; worker_id < num_workers; worker_id++)
+    // join connection threads (peers close the pooled connections before sending stop requests)
+    for (auto conn_thread : conn_threads)
     {
-        req_handler_queues[worker_id]->Push(req);
+        conn_thread->join();
+        delete conn_thread;
     }
+    conn_threads.clear();
 
-    // join block request handlers
-    for (unsigned int worker_id = 0; worker_id < num_workers; worker_id++)
+    LOG_INFO("[Node %u] BlockReqHandler::run finished handling block requests", self_conn_id);
+}
+
+void BlockReqHandler::handleConnection(sockpp::tcp_socket *skt, Command first_cmd)
+{
+    // obtain a reserved chunk ring for the connection
+    unique_lock<mutex> lck(ring_buffers_mtx);
+    if (free_ring_ids.empty() == true)
     {
-        req_handler_threads_map[worker_id]->join();
-        delete req_handler_threads_map[worker_id];
+        LOG_ERROR("BlockReqHandler::handleConnection error: more than %u connections", max_conns);
+        exit(EXIT_FAILURE);
     }
+    unsigned int ring_id = free_ring_ids.back();
+    free_ring_ids.pop_back();
+    lck.unlock();
 
-    printf("[Node %u] BlockReqHandler::run finished handling block requests\n", self_conn_id);
-}
+    ChunkRing ring;
+    ring.bind(&ring_buffers[ring_id * config.num_chunk_slots], config.num_chunk_slots, config.chunk_size);
 
-void BlockReqHandler::handleBlockRequest(unsigned int self_worker_id)
-{
-    printf("[Node %u, Worker: %u] BlockReqHandler::handleBlockRequest start to handle block requests\n", self_conn_id, self_worker_id);
+    Tracer::setThreadName("BlockReqHandler connection");
 
-    auto &req_handler_queue = req_handler_queues[self_worker_id];
+    // disk I/Os are asynchronous in the connection thread
+    AsyncBlockIO async_io(config.io_queue_depth, config.use_io_uring, config.use_direct_io, &block_store);
+    if (async_io.registerBuffers(memory_pool) == false)
+    { // the memory pool cannot be shared: register the ring of the connection only
+        async_io.registerBuffers(&ring_buffers[ring_id * config.num_chunk_slots], config.num_chunk_slots, config.chunk_size);
+    }
 
-    bool is_finished = false;
-    unsigned char *data_buffer = (unsigned char *)malloc(config.block_size * sizeof(unsigned char));
+    Command cmd = first_cmd;
+    uint32_t num_handled_reqs = 0;
+    bool is_failed = false;
 
-    BlockReq req;
     while (true)
     {
-        // accept block request
-        if (is_finished == true && req_handler_queue->IsEmpty())
-        {
-            break;
-        }
+        LOG_DEBUG("[Node %u] BlockReqHandler::handleConnection obtained block request, type: %u, post: (%u, %u)", self_conn_id, cmd.type, cmd.post_stripe_id, cmd.post_block_id);
 
-        if (req_handler_queue->Pop(req) == true)
+        if (cmd.type == CommandType::CMD_TRANSFER_BLK)
         {
-            Command &cmd = req.cmd;
-            sockpp::tcp_socket *skt = req.skt;
-
-            // terminate signal
-            if (cmd.type == CommandType::CMD_STOP && skt == NULL)
-            {
-                is_finished = true;
-                continue;
+            TraceScope trace_scope("serve_block", cmd.post_stripe_id, cmd.post_block_id);
+
+            // read and send block (zero-copy, or pipelined by chunk)
+            uint64_t send_bytes = config.zero_copy ? BlockIO::sendBlockFile(*skt, cmd.getSrcBlockPath(), config.block_size, ring) : async_io.readAndSendBlock(*skt, cmd.getSrcBlockPath(), config.block_size, ring);
+            if (send_bytes != config.block_size)
+            { // drop the connection: the peer retries on a new connection
+                LOG_ERROR("BlockReqHandler::handleConnection error sending block: %s to ComputeWorker of Node %u", cmd.getSrcBlockPath().c_str(), cmd.src_conn_id);
+                is_failed = true;
+                break;
             }
 
-            // obtain block request socket
-            printf("[Node %u] BlockReqHandler::handleBlockRequest obtained block request, type: %u, post: (%u, %u)\n", self_conn_id, cmd.type, cmd.post_stripe_id, cmd.post_block_id);
-
-            if (cmd.type == CommandType::CMD_TRANSFER_BLK)
-            {
-                // read block
-                if (BlockIO::readBlock(cmd.src_block_path, data_buffer, config.block_size) != config.block_size)
-                {
-                    fprintf(stderr, "BlockReqHandler::handleBlockRequest error reading block: %s\n", cmd.src_block_path.c_str());
-                    exit(EXIT_FAILURE);
-                }
-
-                // send block
-                if (BlockIO::sendBlock(*skt, data_buffer, config.block_size) != config.block_size)
-                {
-                    fprintf(stderr, "BlockReqHandler::handleBlockRequest error sending block: %s to BlockReqHandler %u\n", cmd.src_block_path.c_str(), cmd.src_conn_id);
-                    exit(EXIT_FAILURE);
-                }
-
-                // obtain block request socket
-                printf("[Node %u, Worker: %u] BlockReqHandler::handleBlockRequest handled block transfer request, post: (%u, %u), src_block_path: %s\n", self_conn_id, self_worker_id, cmd.post_stripe_id, cmd.post_block_id, cmd.src_block_path.c_str());
+            LOG_DEBUG("[Node %u] BlockReqHandler::handleConnection handled block transfer request, post: (%u, %u), src_block_path: %s", self_conn_id, cmd.post_stripe_id, cmd.post_block_id, cmd.getSrcBlockPath().c_str());
+        }
+        else if (cmd.type == CommandType::CMD_TRANSFER_RELOC_BLK)
+        {
+            TraceScope trace_scope("recv_write_block", cmd.post_stripe_id, cmd.post_block_id);
+
+            // retrieve block from the same socket, and write to disk (zero-copy, or pipelined by chunk)
+            uint64_t write_bytes = config.zero_copy ? BlockIO::recvBlockFile(*skt, cmd.getDstBlockPath(), config.block_size, ring, &block_store) : async_io.recvAndWriteBlock(*skt, cmd.getDstBlockPath(), config.block_size, ring);
+            if (write_bytes != config.block_size)
+            { // drop the connection: the peer retries on a new connection
+                LOG_ERROR("BlockReqHandler::handleConnection error receiving and writing block: %s from RelocWorker of Node %u", cmd.getDstBlockPath().c_str(), cmd.src_conn_id);
+                is_failed = true;
+                break;
             }
-            else if (cmd.type == CommandType::CMD_TRANSFER_RELOC_BLK)
-            {
-                // retrieve block from the same socket, and write to disk
 
-                // recv block
-                if (BlockIO::recvBlock(*skt, data_buffer, config.block_size) != config.block_size)
-                {
-                    fprintf(stderr, "BlockReqHandler::handleBlockRequest error receiving block: %s to RelocWorker %u\n", cmd.src_block_path.c_str(), cmd.src_conn_id);
-                    exit(EXIT_FAILURE);
-                }
-
-                // write block
-                if (BlockIO::writeBlock(cmd.dst_block_path, data_buffer, config.block_size) != config.block_size)
-                {
-                    fprintf(stderr, "BlockReqHandler::handleBlockRequest error writing block: %s\n", cmd.dst_block_path.c_str());
-                    exit(EXIT_FAILURE);
-                }
-
-                // obtain block request socket
-                printf("[Node %u, Worker: %u] BlockReqHandler::handleBlockRequest handled block relocation request, post: (%u, %u), dst_block_path: %s\n", self_conn_id, self_worker_id, cmd.post_stripe_id, cmd.post_block_id, cmd.dst_block_path.c_str());
-            }
+            LOG_DEBUG("[Node %u] BlockReqHandler::handleConnection handled block relocation request, post: (%u, %u), dst_block_path: %s", self_conn_id, cmd.post_stripe_id, cmd.post_block_id, cmd.getDstBlockPath().c_str());
+        }
+        num_handled_reqs++;
 
-            // close socket
-            skt->close();
-            delete skt;
+        // read next command (connection closed by the peer)
+        ssize_t ret_val = Command::recvCommand(*skt, cmd);
+        if (ret_val == 0)
+        {
+            break;
+        }
+        else if (ret_val == -1)
+        { // drop the connection
+            LOG_ERROR("BlockReqHandler::handleConnection error reading command from Node %u", cmd.src_conn_id);
+            is_failed = true;
+            break;
+        }
 
-            // // reduce connections
-            // unique_lock<mutex> lck(max_conn_mutex);
-            // cur_conn--;
-            // lck.unlock();
-            // max_conn_cv.notify_one();
+        if (cmd.dst_conn_id != self_conn_id || (cmd.type != CommandType::CMD_TRANSFER_BLK && cmd.type != CommandType::CMD_TRANSFER_RELOC_BLK))
+        {
+            LOG_ERROR("BlockReqHandler::handleConnection error: cmd.type: %u, cmd.src_conn_id: %u, cmd.dst_conn_id: %u", cmd.type, cmd.src_conn_id, cmd.dst_conn_id);
+            exit(EXIT_FAILURE);
         }
     }
 
-    free(data_buffer);
+    if (is_failed == true)
+    {
+        LOG_WARN("[Node %u] BlockReqHandler::handleConnection dropped the failed connection of Node %u, handled %u requests", self_conn_id, cmd.src_conn_id, num_handled_reqs);
+    }
+    else
+    {
+        LOG_INFO("[Node %u] BlockReqHandler::handleConnection connection closed by Node %u, handled %u requests", self_conn_id, cmd.src_conn_id, num_handled_reqs);
+    }
 
-    printf("[Node %u, Worker: %u] BlockReqHandler::handleBlockRequest finished handling block requests\n", self_conn_id, self_worker_id);
+    // close socket
+    skt->close();
+    delete skt;
+
+    // return the chunk ring
+    lck.lock();
+    free_ring_ids.push_back(ring_id);
+    lck.unlock();
 }
 
 void BlockReqHandler::stopHandling()
@@ -253,9 +219,15 @@ void BlockReqHandler::stopHandling()
             unsigned int block_req_port = addr.second + config.settings.num_nodes; // DEBUG
 
             sockpp::tcp_connector connector;
+            unsigned int num_retries = 0;
             while (!(connector = sockpp::tcp_connector(sockpp::inet_address(block_req_ip, block_req_port))))
             {
-                this_thread::sleep_for(chrono::milliseconds(1));
+                if (++num_retries > CONN_MAX_RETRIES)
+                {
+                    LOG_ERROR("BlockReqHandler::stopHandling error: failed to connect to BlockReqHandler %u after %u retries", conn_id, CONN_MAX_RETRIES);
+                    exit(EXIT_FAILURE);
+                }
+                this_thread::sleep_for(chrono::milliseconds(CONN_RETRY_INTERVAL_MS));
             }
 
             // send stop request to block handlers of all other nodes
@@ -263,9 +235,9 @@ void BlockReqHandler::stopHandling()
             cmd_stop.buildCommand(CommandType::CMD_STOP, self_conn_id, conn_id);
 
             // send block transfer request
-            if (connector.write_n(cmd_stop.content, MAX_CMD_LEN * sizeof(unsigned char)) == -1)
+            if (Command::sendCommand(connector, cmd_stop) == false)
             {
-                fprintf(stderr, "ComputeWorker::requestDataFromAgent error sending cmd, type: %u, src_conn_id: %u, dst_conn_id: %u\n", cmd_stop.type, cmd_stop.src_conn_id, cmd_stop.dst_conn_id);
+                LOG_ERROR("BlockReqHandler::stopHandling error sending cmd, type: %u, src_conn_id: %u, dst_conn_id: %u", cmd_stop.type, cmd_stop.src_conn_id, cmd_stop.dst_conn_id);
                 exit(EXIT_FAILURE);
             }
 
@@ -273,5 +245,5 @@ void BlockReqHandler::stopHandling()
         }
     }
 
-    printf("[Node %u] BlockReqHandler::stopHandling trigger stop handling request\n", self_conn_id);
+    LOG_INFO("[Node %u] BlockReqHandler::stopHandling trigger stop handling request", self_conn_id);
 }
\ No newline at end of file
@@ -2,7 +2,6 @@
 #define __BLOCK_REQ_HANDLER_HH__
 
 #include <mutex>
-#include <condition_variable>
 
 #include "sockpp/tcp_connector.h"
 #include "sockpp/tcp_acceptor.h"
@@ -11,14 +10,13 @@
 #include "../util/Config.hh"
 #include "Command.hh"
 #include "../util/ThreadPool.hh"
-#include "../util/MessageQueue.hh"
+#include "../util/MemoryPool.hh"
+#include "../util/Tracer.hh"
+#include "../util/Logger.hh"
 #include "BlockIO.hh"
-
-typedef struct BlockReq
-{
-    Command cmd;
-    sockpp::tcp_socket *skt;
-} BlockReq;
+#include "AsyncBlockIO.hh"
+#include "BlockStore.hh"
+#include "ConnPool.hh"
 
 class BlockReqHandler : public ThreadPool
 {
@@ -31,23 +29,26 @@ public:
     // current connection id
     uint16_t self_conn_id;
 
-    // number of workers
-    unsigned int num_workers;
+    // agent-wide memory pool
+    MemoryPool &memory_pool;
 
-    mutex max_conn_mutex;
-    std::condition_variable max_conn_cv;
-    unsigned int cur_conn;
-    unsigned int max_conn;
+    // destination of relocated blocks
+    BlockStore &block_store;
 
     sockpp::tcp_acceptor *acceptor;
 
-    // message queues for request handlers
-    unordered_map<unsigned int, MessageQueue<BlockReq> *> req_handler_queues;
+    // chunk rings of connections, reserved from the memory pool at startup
+    // (at most max_conns_per_peer connections from each peer), so serving a
+    // request never waits for memory held by local tasks
+    unsigned int max_conns;
+    vector<unsigned char *> ring_buffers;
+    mutex ring_buffers_mtx;
+    vector<unsigned int> free_ring_ids;
 
-    // request handler threads
-    unordered_map<uint16_t, thread *> req_handler_threads_map;
+    // connection threads: each serves the requests on a persistent connection
+    vector<thread *> conn_threads;
 
-    BlockReqHandler(Config &_config, uint16_t _self_conn_id, unsigned int _num_workers);
+    BlockReqHandler(Config &_config, uint16_t _self_conn_id, MemoryPool &_memory_pool, BlockStore &_block_store);
     ~BlockReqHandler();
 
     /**
@@ -56,8 +57,16 @@ public:
      */
     void run() override;
 
-    // block request handler
-    void handleBlockRequest(unsigned int self_worker_id);
+    /**
+     * @brief serve the requests on a persistent connection (framed
+     * command, followed by the block) until the peer closes the
+     * connection; the blocks are streamed through the chunk ring of the
+     * connection, so a stalled stream only occupies its own connection
+     *
+     * @param skt
+     * @param first_cmd the first command read from the connection
+     */
+    void handleConnection(sockpp::tcp_socket *skt, Command first_cmd);
 
     // stop handling for the main thread
     void stopHandling();
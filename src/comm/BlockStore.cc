@@ -0,0 +1,174 @@
+#include "BlockStore.hh"
+
+BlockStore::BlockStore(SyncPolicy _sync_policy, unsigned int _sync_batch_size, bool _is_preallocate) : sync_policy(_sync_policy), sync_batch_size(max(_sync_batch_size, 1U)), is_preallocate(_is_preallocate)
+{
+}
+
+BlockStore::~BlockStore()
+{
+    flush();
+}
+
+void BlockStore::makeDirs(string dir)
+{
+    if (dir.empty() == true)
+    {
+        return;
+    }
+
+    // walk down the path components from the root (or the working directory)
+    int dir_fd = open(dir[0] == '/' ? "/" : ".", O_RDONLY | O_DIRECTORY);
+    if (dir_fd < 0)
+    {
+        LOG_ERROR("BlockStore::makeDirs error opening the parent of directory: %s, error: %d", dir.c_str(), errno);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t start = 0;
+    while (start < dir.size())
+    {
+        size_t end = dir.find('/', start);
+        if (end == string::npos)
+        {
+            end = dir.size();
+        }
+        string component = dir.substr(start, end - start);
+        start = end + 1;
+        if (component.empty() == true || component == ".")
+        {
+            continue;
+        }
+
+        if (mkdirat(dir_fd, component.c_str(), 0777) != 0 && errno != EEXIST)
+        {
+            LOG_ERROR("BlockStore::makeDirs error creating directory: %s (at %s), error: %d", dir.c_str(), component.c_str(), errno);
+            exit(EXIT_FAILURE);
+        }
+
+        int sub_dir_fd = openat(dir_fd, component.c_str(), O_RDONLY | O_DIRECTORY);
+        close(dir_fd);
+        if (sub_dir_fd < 0)
+        {
+            LOG_ERROR("BlockStore::makeDirs error opening directory: %s (at %s), error: %d", dir.c_str(), component.c_str(), errno);
+            exit(EXIT_FAILURE);
+        }
+        dir_fd = sub_dir_fd;
+    }
+    close(dir_fd);
+}
+
+void BlockStore::createBlockDir(string block_path)
+{
+    auto it = block_path.find_last_of("/");
+    if (it == string::npos)
+    { // in the working directory
+        return;
+    }
+    string block_dir = block_path.substr(0, it);
+
+    unique_lock<mutex> lck(dirs_mtx);
+    if (known_dirs.find(block_dir) != known_dirs.end())
+    {
+        return;
+    }
+    lck.unlock();
+
+    // concurrent creations of the same directory are fine (EEXIST)
+    makeDirs(block_dir);
+
+    lck.lock();
+    known_dirs.insert(block_dir);
+}
+
+int BlockStore::openBlock(string block_path, uint64_t block_size, bool is_direct)
+{
+    createBlockDir(block_path);
+
+    int fd = open(block_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | (is_direct ? O_DIRECT : 0), 0666);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    // preallocate the block (best effort: not all file systems support it)
+    if (is_preallocate == true && block_size > 0)
+    {
+        int ret_val = fallocate(fd, 0, 0, block_size);
+        if (ret_val != 0 && errno != EOPNOTSUPP && errno != ENOSYS)
+        {
+            LOG_ERROR("BlockStore::openBlock error preallocating %lu Bytes for block: %s, error: %d", block_size, block_path.c_str(), errno);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return fd;
+}
+
+void BlockStore::closeBlock(int fd)
+{
+    if (sync_policy == SyncPolicy::SYNC_PER_BLOCK)
+    {
+        if (fdatasync(fd) != 0)
+        {
+            LOG_ERROR("BlockStore::closeBlock error syncing block, error: %d", errno);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (sync_policy == SyncPolicy::SYNC_BATCHED)
+    {
+        unique_lock<mutex> lck(sync_mtx);
+        unsynced_fds.push_back(fd);
+        if (unsynced_fds.size() < sync_batch_size)
+        {
+            return;
+        }
+        vector<int> batch_fds;
+        batch_fds.swap(unsynced_fds);
+        lck.unlock();
+
+        syncBlocks(batch_fds);
+        return;
+    }
+
+    close(fd);
+}
+
+void BlockStore::syncBlocks(vector<int> &fds)
+{
+    // one syncfs per file system
+    vector<dev_t> synced_devs;
+    for (auto fd : fds)
+    {
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0)
+        {
+            LOG_ERROR("BlockStore::syncBlocks error stat block, error: %d", errno);
+            exit(EXIT_FAILURE);
+        }
+        if (find(synced_devs.begin(), synced_devs.end(), file_stat.st_dev) != synced_devs.end())
+        {
+            continue;
+        }
+        if (syncfs(fd) != 0)
+        {
+            LOG_ERROR("BlockStore::syncBlocks error syncing file system, error: %d", errno);
+            exit(EXIT_FAILURE);
+        }
+        synced_devs.push_back(file_stat.st_dev);
+    }
+
+    for (auto fd : fds)
+    {
+        close(fd);
+    }
+}
+
+void BlockStore::flush()
+{
+    unique_lock<mutex> lck(sync_mtx);
+    vector<int> batch_fds;
+    batch_fds.swap(unsynced_fds);
+    lck.unlock();
+
+    syncBlocks(batch_fds);
+}
@@ -0,0 +1,88 @@
+#ifndef __BLOCK_STORE_HH__
+#define __BLOCK_STORE_HH__
+
+#include "../include/include.hh"
+#include "../util/Config.hh"
+#include "../util/Logger.hh"
+
+#include <mutex>
+#include <unordered_set>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/**
+ * @brief destination of block writes on an Agent: the directories of
+ * blocks are created (with mkdirat) once and cached, the files of blocks
+ * are preallocated with fallocate, and the written blocks are made durable
+ * by the sync policy (none / fdatasync per block / syncfs per batch of
+ * blocks)
+ */
+class BlockStore
+{
+private:
+    SyncPolicy sync_policy;
+    unsigned int sync_batch_size; // number of blocks synced together (SYNC_BATCHED)
+    bool is_preallocate;
+
+    // directories known to exist
+    mutex dirs_mtx;
+    unordered_set<string> known_dirs;
+
+    // written but unsynced blocks (kept open until synced)
+    mutex sync_mtx;
+    vector<int> unsynced_fds;
+
+    /**
+     * @brief sync the blocks (one syncfs per file system), and close them
+     *
+     * @param fds
+     */
+    void syncBlocks(vector<int> &fds);
+
+public:
+    BlockStore(SyncPolicy _sync_policy, unsigned int _sync_batch_size, bool _is_preallocate);
+    ~BlockStore();
+
+    /**
+     * @brief create the directory and its missing parents (as mkdir -p),
+     * with mkdirat from the nearest existing parent
+     *
+     * @param dir
+     */
+    static void makeDirs(string dir);
+
+    /**
+     * @brief create the directory of the block, unless it is known to exist
+     *
+     * @param block_path
+     */
+    void createBlockDir(string block_path);
+
+    /**
+     * @brief create (or truncate) the file of the block for writing, and
+     * preallocate block_size Bytes
+     *
+     * @param block_path
+     * @param block_size
+     * @param is_direct open with O_DIRECT
+     * @return int fd (-1 on failure, with errno)
+     */
+    int openBlock(string block_path, uint64_t block_size, bool is_direct);
+
+    /**
+     * @brief finish writing the block, and close (or defer closing) it by
+     * the sync policy
+     *
+     * @param fd
+     */
+    void closeBlock(int fd);
+
+    /**
+     * @brief sync and close the unsynced blocks
+     *
+     */
+    void flush();
+};
+
+#endif // __BLOCK_STORE_HH__
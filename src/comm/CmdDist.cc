@@ -1,6 +1,6 @@
 #include "CmdDist.hh"
 
-CmdDist::CmdDist(Config &_config, uint16_t _self_conn_id, unordered_map<uint16_t, sockpp::tcp_connector> &_connectors_map, unordered_map<uint16_t, MessageQueue<Command> *> &_cmd_dist_queues) : ThreadPool(1), config(_config), self_conn_id(_self_conn_id), connectors_map(_connectors_map), cmd_dist_queues(_cmd_dist_queues)
+CmdDist::CmdDist(Config &_config, uint16_t _self_conn_id, unordered_map<uint16_t, sockpp::tcp_connector> &_connectors_map, unordered_map<uint16_t, MultiWriterQueue<Command> *> &_cmd_dist_queues) : ThreadPool(1), config(_config), self_conn_id(_self_conn_id), connectors_map(_connectors_map), cmd_dist_queues(_cmd_dist_queues)
 {
     for (auto &item : connectors_map)
     {
@@ -33,11 +33,20 @@ void CmdDist::run()
 
 void CmdDist::distCmdToNode(uint16_t dst_conn_id)
 {
-    printf("[Node %u] CmdDist::distCmdToNode start to distribute commands to Node %u\n", self_conn_id, dst_conn_id);
+    LOG_INFO("[Node %u] CmdDist::distCmdToNode start to distribute commands to Node %u", self_conn_id, dst_conn_id);
+
+    Tracer::setThreadName("CmdDist " + to_string(dst_conn_id));
 
     auto &connector = connectors_map[dst_conn_id];
-    MessageQueue<Command> &cmd_dist_queue = *cmd_dist_queues[dst_conn_id];
+    MultiWriterQueue<Command> &cmd_dist_queue = *cmd_dist_queues[dst_conn_id];
+
+    vector<Command> cmds;
+    unsigned char *send_buffer = (unsigned char *)malloc(Command::getMaxFrameSize(MAX_CMD_DIST_BATCH) * sizeof(unsigned char));
 
+    // the stop command is sent after all other commands (the queue has
+    // multiple writers, and the commands pushed before the stop command
+    // may be popped after it)
+    Command cmd_stop;
     bool is_finished = false;
     while (true)
     {
@@ -46,35 +55,64 @@ void CmdDist::distCmdToNode(uint16_t dst_conn_id)
             break;
         }
 
-        Command cmd;
-        if (cmd_dist_queue.Pop(cmd) == true)
+        // wait for commands (sleep when idle)
+        size_t num_cmds = cmd_dist_queue.WaitPopBulk(cmds, MAX_CMD_DIST_BATCH);
+
+        size_t num_send_cmds = 0;
+        for (size_t cmd_id = 0; cmd_id < num_cmds; cmd_id++)
         {
+            Command &cmd = cmds[cmd_id];
+
             // validate
             if (cmd.src_conn_id != self_conn_id || cmd.dst_conn_id != dst_conn_id)
             {
-                fprintf(stderr, "CmdDist::distControllerCmd error: invalid command content: %u, %u\n", cmd.src_conn_id, cmd.dst_conn_id);
+                LOG_ERROR("CmdDist::distCmdToNode error: invalid command content: %u, %u", cmd.src_conn_id, cmd.dst_conn_id);
                 exit(EXIT_FAILURE);
             }
 
             // cmd.print();
-            printf("CmdHandler::distControllerCmd get command, type: %u, (%u -> %u), post: (%u, %u)\n", cmd.type, cmd.src_conn_id, cmd.dst_conn_id, cmd.post_stripe_id, cmd.post_block_id);
-
-            // send the command
-            if (connector.write_n(cmd.content, MAX_CMD_LEN * sizeof(unsigned char)) == -1)
-            {
-                fprintf(stderr, "CmdDist::distCmdToNode error sending cmd, type: %u, src_conn_id: %u, dst_conn_id: %u\n", cmd.type, cmd.src_conn_id, cmd.dst_conn_id);
-                exit(EXIT_FAILURE);
-            }
+            LOG_DEBUG("CmdDist::distCmdToNode get command, type: %u, (%u -> %u), post: (%u, %u)", cmd.type, cmd.src_conn_id, cmd.dst_conn_id, cmd.post_stripe_id, cmd.post_block_id);
 
             if (cmd.type == CommandType::CMD_STOP)
             { // stop connection command
+                cmd_stop = cmd;
                 is_finished = true;
+                continue;
+            }
+
+            if (num_send_cmds != cmd_id)
+            {
+                cmds[num_send_cmds] = cmd;
             }
+            num_send_cmds++;
+        }
+
+        if (num_send_cmds == 0)
+        {
+            continue;
+        }
+
+        // send the commands (packed in one frame)
+        TraceScope trace_scope("send_frame");
+        uint64_t frame_size = Command::packFrame(cmds.data(), num_send_cmds, send_buffer);
+        if (connector.write_n(send_buffer, frame_size) != (ssize_t)frame_size)
+        {
+            LOG_ERROR("CmdDist::distCmdToNode error sending %lu cmds to Node %u", num_send_cmds, dst_conn_id);
+            exit(EXIT_FAILURE);
         }
     }
 
+    // send the stop command
+    if (Command::sendCommand(connector, cmd_stop) == false)
+    {
+        LOG_ERROR("CmdDist::distCmdToNode error sending stop cmd to Node %u", dst_conn_id);
+        exit(EXIT_FAILURE);
+    }
+
+    free(send_buffer);
+
     // close the connector
     connector.close();
 
-    printf("[Node %u] CmdDist::distCmdToNode finished distributing commands to Node %u\n", self_conn_id, dst_conn_id);
+    LOG_INFO("[Node %u] CmdDist::distCmdToNode finished distributing commands to Node %u", self_conn_id, dst_conn_id);
 }
\ No newline at end of file
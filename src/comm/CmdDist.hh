@@ -6,11 +6,16 @@
 #include "../include/include.hh"
 #include "../util/Utils.hh"
 #include "../util/MessageQueue.hh"
+#include "../util/MultiWriterQueue.h"
 #include "../util/ThreadPool.hh"
 #include "../util/Config.hh"
 #include "Command.hh"
 #include "BlockIO.hh"
 #include "../util/MemoryPool.hh"
+#include "../util/Tracer.hh"
+#include "../util/Logger.hh"
+
+#define MAX_CMD_DIST_BATCH 64 // maximum number of commands sent in one write
 
 class CmdDist : public ThreadPool
 {
@@ -27,12 +32,12 @@ public:
     unordered_map<uint16_t, sockpp::tcp_connector> &connectors_map;
 
     // command distribution queues: each retrieves command from CmdHandler and distributes commands to the corresponding CmdDist (CmdHandler -> CmdDist)
-    unordered_map<uint16_t, MessageQueue<Command> *> &cmd_dist_queues;
+    unordered_map<uint16_t, MultiWriterQueue<Command> *> &cmd_dist_queues;
 
     // command distributor threads
     unordered_map<uint16_t, thread *> dist_threads_map;
 
-    CmdDist(Config &_config, uint16_t _self_conn_id, unordered_map<uint16_t, sockpp::tcp_connector> &_connectors_map, unordered_map<uint16_t, MessageQueue<Command> *> &_cmd_dist_queues);
+    CmdDist(Config &_config, uint16_t _self_conn_id, unordered_map<uint16_t, sockpp::tcp_connector> &_connectors_map, unordered_map<uint16_t, MultiWriterQueue<Command> *> &_cmd_dist_queues);
     ~CmdDist();
 
     /**
@@ -42,7 +47,9 @@ public:
     void run() override;
 
     /**
-     * @brief distribute commands to Node <dst_conn_id>
+     * @brief distribute commands to Node <dst_conn_id>; the commands queued
+     * at a time (at most MAX_CMD_DIST_BATCH) are packed in one frame, and sent
+     * in one write
      *
      * @param dst_conn_id destination connection id
      */
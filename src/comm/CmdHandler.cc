@@ -2,9 +2,10 @@
 
 CmdHandler::CmdHandler(Config &_config, uint16_t _self_conn_id,
                        unordered_map<uint16_t, sockpp::tcp_socket> &_sockets_map,
-                       unordered_map<uint16_t, MessageQueue<Command> *> *_cmd_dist_queues,
+                       unordered_map<uint16_t, MultiWriterQueue<Command> *> *_cmd_dist_queues,
                        unordered_map<unsigned int, MessageQueue<Command> *> *_compute_task_queues,
-                       unordered_map<unsigned int, MultiWriterQueue<Command> *> *_reloc_task_queues) : ThreadPool(1), config(_config), self_conn_id(_self_conn_id), sockets_map(_sockets_map), cmd_dist_queues(_cmd_dist_queues), compute_task_queues(_compute_task_queues), reloc_task_queues(_reloc_task_queues)
+                       unordered_map<unsigned int, MultiWriterQueue<Command> *> *_reloc_task_queues,
+                       MultiWriterQueue<Command> *_report_queue) : ThreadPool(1), config(_config), self_conn_id(_self_conn_id), sockets_map(_sockets_map), cmd_dist_queues(_cmd_dist_queues), compute_task_queues(_compute_task_queues), reloc_task_queues(_reloc_task_queues), report_queue(_report_queue)
 {
     for (auto &item : sockets_map)
     {
@@ -50,7 +51,9 @@ void CmdHandler::run()
 
 void CmdHandler::handleCmdFromController()
 {
-    printf("[Node %u] CmdHandler::handleCmdFromController start to handle commands from Controller\n", self_conn_id);
+    LOG_INFO("[Node %u] CmdHandler::handleCmdFromController start to handle commands from Controller", self_conn_id);
+
+    Tracer::setThreadName("CmdHandler Controller");
 
     uint16_t src_conn_id = CTRL_NODE_ID;
     auto &skt = sockets_map[src_conn_id];
@@ -58,157 +61,215 @@ void CmdHandler::handleCmdFromController()
     unsigned int compute_task_counter = 0;
     unsigned int reloc_task_counter = 0;
 
-    while (true)
+    vector<unsigned char> frame_body; // receive buffer of frames
+    vector<Command> cmds;             // commands parsed from a frame
+
+    bool is_finished = false;
+    while (is_finished == false)
     {
-        Command cmd;
-        // retrieve command
-        ssize_t ret_val = skt.read_n(cmd.content, MAX_CMD_LEN * sizeof(unsigned char));
-        if (ret_val == -1)
+        // retrieve a frame of commands
+        ssize_t frame_len = Command::recvFrame(skt, frame_body);
+        if (frame_len == -1)
         {
-            fprintf(stderr, "CmdHandler::handleCmdFromController error reading command\n");
+            LOG_ERROR("CmdHandler::handleCmdFromController error reading command");
             exit(EXIT_FAILURE);
         }
-        else if (ret_val == 0)
+        else if (frame_len == 0)
         {
-            // currently, no cmd comming in
-            printf("CmdHandler::handleCmdFromController no command coming in, break\n");
+            // currently, no cmd coming in
+            LOG_INFO("CmdHandler::handleCmdFromController no command coming in, break");
             break;
         }
 
-        // parse the command
-        cmd.parse();
+        // tasks are queued in the Agent from here (reported in the task completion)
+        uint64_t recv_time_us = Utils::getTimeUs();
+        TraceScope trace_scope("handle_frame");
 
-        // cmd.print();
-        // printf("CmdHandler::handleCmdFromController handle command, type: %u, (%u -> %u), post: (%u, %u)\n", cmd.type, cmd.src_conn_id, cmd.dst_conn_id, cmd.post_stripe_id, cmd.post_block_id);
+        // parse the commands (in place in the frame)
+        size_t num_cmds = Command::unpackFrame(frame_body.data(), frame_len, cmds);
 
-        // validate command
-        if (cmd.src_conn_id != src_conn_id || cmd.dst_conn_id != self_conn_id)
+        for (size_t cmd_id = 0; cmd_id < num_cmds && is_finished == false; cmd_id++)
         {
-            fprintf(stderr, "CmdHandler::handleCmdFromController error: invalid command content\n");
-            exit(EXIT_FAILURE);
-        }
+            Command &cmd = cmds[cmd_id];
 
-        if (cmd.type == CommandType::CMD_COMPUTE_RE_BLK || cmd.type == CommandType::CMD_COMPUTE_PM_BLK)
-        { // parity block compute task
+            // cmd.print();
+            // printf("CmdHandler::handleCmdFromController handle command, type: %u, (%u -> %u), post: (%u, %u)\n", cmd.type, cmd.src_conn_id, cmd.dst_conn_id, cmd.post_stripe_id, cmd.post_block_id);
 
             // validate command
-            if (self_conn_id != cmd.src_node_id || cmd.src_node_id != cmd.dst_node_id)
+            if (cmd.src_conn_id != src_conn_id || cmd.dst_conn_id != self_conn_id)
             {
-                fprintf(stderr, "CmdHandler::handleCmdFromController error: invalid compute command content\n");
+                LOG_ERROR("CmdHandler::handleCmdFromController error: invalid command content");
                 exit(EXIT_FAILURE);
             }
 
-            // push the compute task to specific compute task queue
-            unsigned int assigned_worker_id = compute_task_counter % config.num_compute_workers;
-            (*compute_task_queues)[assigned_worker_id]->Push(cmd);
-
-            compute_task_counter++;
-
-            printf("CmdHandler::handleCmdFromController received parity computation task, forward to ComputeWorker %u, post: (%u, %u), enc_method: %u\n", assigned_worker_id, cmd.post_stripe_id, cmd.post_block_id, cmd.enc_method);
-        }
-        else if (cmd.type == CommandType::CMD_TRANSFER_RELOC_BLK)
-        { // relocate block task
-
-            // only parse for data block relocation; parity block relocation will be generated by ComputeWorker
-            if (cmd.type == CommandType::CMD_TRANSFER_RELOC_BLK && cmd.post_block_id >= config.code.k_f)
-            {
-                fprintf(stderr, "CmdHandler::handleCmdFromController error: invalid transfer command content\n");
-                exit(EXIT_FAILURE);
-            }
+            if (cmd.type == CommandType::CMD_COMPUTE_RE_BLK || cmd.type == CommandType::CMD_COMPUTE_PM_BLK)
+            { // parity block compute task
 
-            // forward the command to another node
-            Command cmd_reloc;
-            cmd_reloc.buildCommand(cmd.type, self_conn_id, cmd.dst_node_id, cmd.post_stripe_id, cmd.post_block_id, cmd.src_node_id, cmd.dst_node_id, cmd.src_block_path, cmd.dst_block_path);
+                // validate command
+                if (self_conn_id != cmd.src_node_id || cmd.src_node_id != cmd.dst_node_id)
+                {
+                    LOG_ERROR("CmdHandler::handleCmdFromController error: invalid compute command content");
+                    exit(EXIT_FAILURE);
+                }
 
-            // push the relocation task to specific relocation task queue
-            // unsigned int assigned_worker_id = cmd_reloc.post_stripe_id % config.num_reloc_workers;
-            unsigned int assigned_worker_id = reloc_task_counter % config.num_reloc_workers;
-            (*reloc_task_queues)[assigned_worker_id]->Push(cmd_reloc);
+                cmd.recv_time_us = recv_time_us;
+                cmd.keepContent(); // the frame buffer is reused
 
-            reloc_task_counter++;
+                // push the compute task to specific compute task queue
+                unsigned int assigned_worker_id = compute_task_counter % config.num_compute_workers;
+                if (config.dispatch_mode == DispatchMode::DISPATCH_PULL)
+                { // the least loaded worker (Controller bounds the tasks dispatched to the Agent)
+                    assigned_worker_id = getLeastLoadedWorker(*compute_task_queues, compute_task_counter);
+                }
+                (*compute_task_queues)[assigned_worker_id]->Push(cmd);
 
-            printf("CmdHandler::handleCmdFromAgent received relocation task, forward to RelocWorker %u, post: (%u, %u)\n", assigned_worker_id, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
-        }
-        else if (cmd.type == CommandType::CMD_DELETE_BLK)
-        { // delete block task
-            BlockIO::deleteBlock(cmd.src_block_path);
-        }
-        else if (cmd.type == CMD_STOP)
-        { // stop task
-            Command stop_cmd;
-            stop_cmd.buildCommand(CommandType::CMD_STOP, INVALID_NODE_ID, INVALID_NODE_ID);
+                compute_task_counter++;
 
-            // push stop tasks to compute queues
-            for (auto item : *compute_task_queues)
-            {
-                auto &compute_task_queue = item.second;
-                compute_task_queue->Push(stop_cmd);
+                LOG_DEBUG("CmdHandler::handleCmdFromController received parity computation task, forward to ComputeWorker %u, post: (%u, %u), enc_method: %u", assigned_worker_id, cmd.post_stripe_id, cmd.post_block_id, cmd.enc_method);
             }
-
-            // push stop tasks to reloc queues
-            for (auto item : *reloc_task_queues)
-            {
-                auto &reloc_task_queue = item.second;
-                reloc_task_queue->Push(stop_cmd);
+            else if (cmd.type == CommandType::CMD_TRANSFER_RELOC_BLK)
+            { // relocate block task
+
+                // only parse for data block relocation; parity block relocation will be generated by ComputeWorker
+                if (cmd.type == CommandType::CMD_TRANSFER_RELOC_BLK && cmd.post_block_id >= config.code.k_f)
+                {
+                    LOG_ERROR("CmdHandler::handleCmdFromController error: invalid transfer command content");
+                    exit(EXIT_FAILURE);
+                }
+
+                // forward the command to another node
+                Command cmd_reloc;
+                cmd_reloc.buildCommand(cmd.type, self_conn_id, cmd.dst_node_id, cmd.post_stripe_id, cmd.post_block_id, cmd.src_node_id, cmd.dst_node_id, cmd.getSrcBlockPath(), cmd.getDstBlockPath());
+                cmd_reloc.recv_time_us = recv_time_us;
+
+                // push the relocation task to specific relocation task queue
+                // unsigned int assigned_worker_id = cmd_reloc.post_stripe_id % config.num_reloc_workers;
+                unsigned int assigned_worker_id = reloc_task_counter % config.num_reloc_workers;
+                if (config.dispatch_mode == DispatchMode::DISPATCH_PULL)
+                { // the least loaded worker (Controller bounds the tasks dispatched to the Agent)
+                    assigned_worker_id = getLeastLoadedWorker(*reloc_task_queues, reloc_task_counter);
+                }
+                (*reloc_task_queues)[assigned_worker_id]->Push(cmd_reloc);
+
+                reloc_task_counter++;
+
+                LOG_DEBUG("CmdHandler::handleCmdFromController received relocation task, forward to RelocWorker %u, post: (%u, %u)", assigned_worker_id, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
             }
+            else if (cmd.type == CommandType::CMD_DELETE_BLK)
+            { // delete block task
+                uint64_t start_time_us = Utils::getTimeUs();
+                BlockIO::deleteBlock(cmd.getSrcBlockPath());
+
+                uint64_t end_time_us = Utils::getTimeUs();
+                Tracer::record("delete_block", start_time_us, end_time_us, cmd.post_stripe_id, cmd.post_block_id);
+
+                // report to Controller
+                uint32_t stage_time_us[NUM_TASK_STAGES] = {0};
+                stage_time_us[STAGE_QUEUE] = start_time_us - recv_time_us;
+                stage_time_us[STAGE_TOTAL] = end_time_us - start_time_us;
+
+                Command cmd_done;
+                cmd_done.buildCommand(CommandType::CMD_TASK_DONE, self_conn_id, CTRL_NODE_ID, cmd.type, cmd.post_stripe_id, cmd.post_block_id, 0, 0, stage_time_us, vector<uint16_t>());
+                (*cmd_dist_queues)[CTRL_NODE_ID]->Push(cmd_done);
+            }
+            else if (cmd.type == CommandType::CMD_SET_BW_LIMIT)
+            { // update bandwidth limits (applied to the ongoing transfers)
+                BlockIO::setBandwidthLimits(cmd.send_bw_limit, cmd.recv_bw_limit);
 
-            // close socket
-            skt.close();
-
-            // printf("CmdHandler::handleCmdFromController received stop command from Controller\n");
-            break;
+                LOG_INFO("CmdHandler::handleCmdFromController set bandwidth limits (send, recv): (%lu, %lu) Bytes/s", cmd.send_bw_limit, cmd.recv_bw_limit);
+            }
+            else if (cmd.type == CMD_STOP)
+            { // stop task
+                Command stop_cmd;
+                stop_cmd.buildCommand(CommandType::CMD_STOP, INVALID_NODE_ID, INVALID_NODE_ID);
+
+                // push stop tasks to compute queues
+                for (auto item : *compute_task_queues)
+                {
+                    auto &compute_task_queue = item.second;
+                    compute_task_queue->Push(stop_cmd);
+                }
+
+                // push stop tasks to reloc queues
+                for (auto item : *reloc_task_queues)
+                {
+                    auto &reloc_task_queue = item.second;
+                    reloc_task_queue->Push(stop_cmd);
+                }
+
+                // close socket
+                skt.close();
+
+                // printf("CmdHandler::handleCmdFromController received stop command from Controller\n");
+                is_finished = true;
+            }
         }
     }
 
-    printf("[Node %u] CmdHandler::handleCmdFromController finished handling commands from Controller\n", self_conn_id);
+    LOG_INFO("[Node %u] CmdHandler::handleCmdFromController finished handling commands from Controller", self_conn_id);
 }
 
 void CmdHandler::handleCmdFromAgent(uint16_t src_conn_id)
 {
-    printf("[Node %u] CmdHandler::handleCmdFromAgent start to handle commands from Agent %u\n", self_conn_id, src_conn_id);
+    LOG_INFO("[Node %u] CmdHandler::handleCmdFromAgent start to handle commands from Agent %u", self_conn_id, src_conn_id);
+
+    Tracer::setThreadName("CmdHandler " + to_string(src_conn_id));
 
     auto &skt = sockets_map[src_conn_id];
 
-    while (true)
-    {
-        Command cmd;
-        // retrieve command
+    vector<unsigned char> frame_body; // receive buffer of frames
+    vector<Command> cmds;             // commands parsed from a frame
 
-        ssize_t ret_val = skt.read_n(cmd.content, MAX_CMD_LEN * sizeof(unsigned char));
-        if (ret_val == -1)
+    bool is_finished = false;
+    while (is_finished == false)
+    {
+        // retrieve a frame of commands
+        ssize_t frame_len = Command::recvFrame(skt, frame_body);
+        if (frame_len == -1)
         {
-            fprintf(stderr, "CmdHandler::handleCmdFromAgent error reading command\n");
+            LOG_ERROR("CmdHandler::handleCmdFromAgent error reading command");
             exit(EXIT_FAILURE);
         }
-        else if (ret_val == 0)
+        else if (frame_len == 0)
         {
             // currently, no cmd coming in
-            printf("CmdHandler::handleCmdFromAgent no command coming in, break\n");
+            LOG_INFO("CmdHandler::handleCmdFromAgent no command coming in, break");
             break;
         }
 
-        // parse the command
-        cmd.parse();
+        TraceScope trace_scope("handle_frame");
 
-        // cmd.print();
-        // printf("CmdHandler::handleCmdFromAgent handle command, type: %u, (%u -> %u), post: (%u, %u)\n", cmd.type, cmd.src_conn_id, cmd.dst_conn_id, cmd.post_stripe_id, cmd.post_block_id);
+        // parse the commands (in place in the frame)
+        size_t num_cmds = Command::unpackFrame(frame_body.data(), frame_len, cmds);
 
-        // validate command
-        if (cmd.src_conn_id != src_conn_id || cmd.dst_conn_id != self_conn_id)
+        for (size_t cmd_id = 0; cmd_id < num_cmds && is_finished == false; cmd_id++)
         {
-            fprintf(stderr, "CmdHandler::handleCmdFromAgent error: invalid command content\n");
-            exit(EXIT_FAILURE);
-        }
+            Command &cmd = cmds[cmd_id];
 
-        if (cmd.type == CommandType::CMD_STOP)
-        {
-            // printf("CmdHandler::handleCmdFromAgent received stop command from Agent %u\n", cmd.src_conn_id);
-            skt.close();
-            break;
+            // cmd.print();
+            // printf("CmdHandler::handleCmdFromAgent handle command, type: %u, (%u -> %u), post: (%u, %u)\n", cmd.type, cmd.src_conn_id, cmd.dst_conn_id, cmd.post_stripe_id, cmd.post_block_id);
+
+            // validate command
+            if (cmd.src_conn_id != src_conn_id || cmd.dst_conn_id != self_conn_id)
+            {
+                LOG_ERROR("CmdHandler::handleCmdFromAgent error: invalid command content");
+                exit(EXIT_FAILURE);
+            }
+
+            if (cmd.type == CommandType::CMD_TASK_DONE && report_queue != NULL)
+            { // task completion report (Controller)
+                report_queue->Push(cmd);
+            }
+            else if (cmd.type == CommandType::CMD_STOP)
+            {
+                // printf("CmdHandler::handleCmdFromAgent received stop command from Agent %u\n", cmd.src_conn_id);
+                skt.close();
+                is_finished = true;
+            }
         }
     }
 
-    printf("[Node %u] CmdHandler::handleCmdFromAgent finished handling commands for Agent %u\n", self_conn_id, src_conn_id);
+    LOG_INFO("[Node %u] CmdHandler::handleCmdFromAgent finished handling commands for Agent %u", self_conn_id, src_conn_id);
 }
 
 void CmdHandler::distStopCmds()
@@ -217,6 +278,10 @@ void CmdHandler::distStopCmds()
     for (auto &item : sockets_map)
     {
         uint16_t dst_conn_id = item.first;
+        if (dst_conn_id == CTRL_NODE_ID)
+        { // sent after all tasks are finished (AgentNode::stop)
+            continue;
+        }
 
         Command cmd_disconnect;
         cmd_disconnect.buildCommand(CommandType::CMD_STOP, self_conn_id, dst_conn_id);
@@ -10,13 +10,41 @@
 #include "../util/ThreadPool.hh"
 #include "../util/MessageQueue.hh"
 #include "../util/MultiWriterQueue.h"
+#include "../util/Tracer.hh"
+#include "../util/Logger.hh"
 #include "Command.hh"
 #include "BlockIO.hh"
 
 class CmdHandler : public ThreadPool
 {
 private:
-    /* data */
+    /**
+     * @brief get the worker with the fewest queued tasks (ties are broken
+     * round-robin from start_worker_id)
+     *
+     * @param task_queues
+     * @param start_worker_id
+     * @return unsigned int
+     */
+    template <typename QueueType>
+    static unsigned int getLeastLoadedWorker(unordered_map<unsigned int, QueueType *> &task_queues, unsigned int start_worker_id)
+    {
+        unsigned int num_workers = task_queues.size();
+        unsigned int assigned_worker_id = start_worker_id % num_workers;
+        size_t min_num_tasks = task_queues[assigned_worker_id]->Size();
+        for (unsigned int offset = 1; offset < num_workers && min_num_tasks > 0; offset++)
+        {
+            unsigned int worker_id = (start_worker_id + offset) % num_workers;
+            size_t num_tasks = task_queues[worker_id]->Size();
+            if (num_tasks < min_num_tasks)
+            {
+                assigned_worker_id = worker_id;
+                min_num_tasks = num_tasks;
+            }
+        }
+        return assigned_worker_id;
+    }
+
 public:
     // config
     Config &config;
@@ -28,7 +56,7 @@ public:
     unordered_map<uint16_t, sockpp::tcp_socket> &sockets_map;
 
     // command distribution queues: each retrieves command from CmdHandler and distributes commands to the corresponding CmdDist (CmdHandler -> CmdDist)
-    unordered_map<uint16_t, MessageQueue<Command> *> *cmd_dist_queues;
+    unordered_map<uint16_t, MultiWriterQueue<Command> *> *cmd_dist_queues;
 
     // compute task queues: each retrieves computation task from Controller, and pass to a ComputeWorker (CmdHandler -> ComputeWorker<worker_id>)
     unordered_map<unsigned int, MessageQueue<Command> *> *compute_task_queues;
@@ -36,14 +64,18 @@ public:
     // parity block relocation task queue: each retrieves block relocation task (from both CmdHandler and ComputeWorker), and pass to a RelocWorker (ComputerWorker / CmdHandler -> RelocWorker<worker_id>)
     unordered_map<unsigned int, MultiWriterQueue<Command> *> *reloc_task_queues;
 
+    // task completion reports from Agents (Controller only): passed to the dispatch and progress tracking of Controller
+    MultiWriterQueue<Command> *report_queue;
+
     // command handler threads
     unordered_map<uint16_t, thread *> handler_threads_map;
 
     CmdHandler(Config &_config, uint16_t _self_conn_id,
                unordered_map<uint16_t, sockpp::tcp_socket> &_sockets_map,
-               unordered_map<uint16_t, MessageQueue<Command> *> *_cmd_dist_queues,
+               unordered_map<uint16_t, MultiWriterQueue<Command> *> *_cmd_dist_queues,
                unordered_map<unsigned int, MessageQueue<Command> *> *_compute_task_queues,
-               unordered_map<unsigned int, MultiWriterQueue<Command> *> *_reloc_task_queues);
+               unordered_map<unsigned int, MultiWriterQueue<Command> *> *_reloc_task_queues,
+               MultiWriterQueue<Command> *_report_queue);
     ~CmdHandler();
 
     /**
@@ -65,6 +97,11 @@ public:
      */
     void handleCmdFromAgent(uint16_t src_conn_id);
 
+    /**
+     * @brief distribute stop commands to the other Agents (the stop command
+     * to Controller is sent by AgentNode after all tasks are finished)
+     *
+     */
     void distStopCmds();
 };
 
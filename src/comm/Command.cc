@@ -3,8 +3,17 @@
 Command::Command(/* args */)
 {
     type = CommandType::CMD_UNKNOWN;
-    len = 0; // command length
-    memset(content, 0, MAX_CMD_LEN);
+    task_type = CommandType::CMD_UNKNOWN;
+    num_net_bytes = 0;
+    num_disk_bytes = 0;
+    memset(stage_time_us, 0, NUM_TASK_STAGES * sizeof(uint32_t));
+    send_bw_limit = 0;
+    recv_bw_limit = 0;
+    recv_time_us = 0;
+    len = 0; // command length (only the encoded bytes are sent)
+    parsed_buf = NULL;
+    src_block_path = {0, 0};
+    dst_block_path = {0, 0};
 }
 
 Command::~Command()
@@ -13,7 +22,6 @@ Command::~Command()
 
 void Command::print()
 {
-    printf("Command %u, conn: (%u -> %u)", type, src_conn_id, dst_conn_id);
     switch (type)
     {
     case CommandType::CMD_CONN:
@@ -21,7 +29,7 @@ void Command::print()
     case CommandType::CMD_STOP:
     case CommandType::CMD_UNKNOWN:
     {
-        printf("\n");
+        LOG_DEBUG("Command %u, conn: (%u -> %u)", type, src_conn_id, dst_conn_id);
         break;
     }
     case CommandType::CMD_COMPUTE_RE_BLK:
@@ -32,34 +40,59 @@ void Command::print()
     case CommandType::CMD_READ_COMPUTE_BLK:
     case CommandType::CMD_TRANSFER_COMPUTE_BLK:
     {
-        printf(", post_stripe: (%u, %u), transfer(%u, %u), enc_method: %u, num_src_blocks: %u, num_parity_reloc_blocks: %u\n", post_stripe_id, post_block_id, src_node_id, dst_node_id, enc_method, num_src_blocks, num_parity_reloc_blocks);
-        printf("src_block_path: %s\n", src_block_path.c_str());
-        printf("dst_block_path: %s\n", dst_block_path.c_str());
+        LOG_DEBUG("Command %u, conn: (%u -> %u), post_stripe: (%u, %u), transfer(%u, %u), enc_method: %u, num_src_blocks: %u, num_parity_reloc_blocks: %u", type, src_conn_id, dst_conn_id, post_stripe_id, post_block_id, src_node_id, dst_node_id, enc_method, num_src_blocks, num_parity_reloc_blocks);
+        LOG_DEBUG("src_block_path: %s", getSrcBlockPath().c_str());
+        LOG_DEBUG("dst_block_path: %s", getDstBlockPath().c_str());
 
         if (type == CommandType::CMD_COMPUTE_RE_BLK || type == CommandType::CMD_COMPUTE_PM_BLK)
         {
-            printf("src_block_nodes:\n");
-            Utils::printVector(src_block_nodes);
-            printf("parity_reloc_nodes:\n");
-            Utils::printVector(parity_reloc_nodes);
+            LOG_DEBUG("src_block_nodes: %s", Utils::vectorToString(src_block_nodes).c_str());
+            LOG_DEBUG("parity_reloc_nodes: %s", Utils::vectorToString(parity_reloc_nodes).c_str());
         }
 
         break;
     }
+    case CommandType::CMD_TASK_DONE:
+    {
+        LOG_DEBUG("Command %u, conn: (%u -> %u), task_type: %u, post_stripe: (%u, %u), net_bytes: %lu, disk_bytes: %lu, stage_time_us (queue, retrieve, encode, write, total): (%u, %u, %u, %u, %u)", type, src_conn_id, dst_conn_id, task_type, post_stripe_id, post_block_id, num_net_bytes, num_disk_bytes, stage_time_us[STAGE_QUEUE], stage_time_us[STAGE_RETRIEVE], stage_time_us[STAGE_ENCODE], stage_time_us[STAGE_WRITE], stage_time_us[STAGE_TOTAL]);
+        LOG_DEBUG("peer_nodes: %s", Utils::vectorToString(peer_nodes).c_str());
+        break;
+    }
+    case CommandType::CMD_SET_BW_LIMIT:
+    {
+        LOG_DEBUG("Command %u, conn: (%u -> %u), bw_limit (send, recv): (%lu, %lu) Bytes/s", type, src_conn_id, dst_conn_id, send_bw_limit, recv_bw_limit);
+        break;
+    }
+    }
+}
+
+void Command::appendContent(const void *val, uint64_t val_len)
+{
+    if (len + val_len > MAX_CMD_LEN)
+    {
+        LOG_ERROR("Command::appendContent error: command too long (%lu / %d)", len + val_len, MAX_CMD_LEN);
+        exit(EXIT_FAILURE);
     }
+    content.resize(len + val_len);
+    memcpy(content.data() + len, val, val_len);
+    len += val_len;
 }
 
 void Command::writeUInt(unsigned int val)
 {
     unsigned int ns_val = htonl(val);
-    memcpy(content + len, (unsigned char *)&ns_val, sizeof(unsigned int));
-    len += sizeof(unsigned int);
+    appendContent(&ns_val, sizeof(unsigned int));
 }
 
-unsigned int Command::readUInt()
+unsigned int Command::readUInt(const unsigned char *buf, uint64_t buf_len)
 {
+    if (len + sizeof(unsigned int) > buf_len)
+    {
+        LOG_ERROR("Command::readUInt error: truncated command (%lu / %lu)", len, buf_len);
+        exit(EXIT_FAILURE);
+    }
     unsigned int val;
-    memcpy((unsigned char *)&val, content + len, sizeof(unsigned int));
+    memcpy((unsigned char *)&val, buf + len, sizeof(unsigned int));
     len += sizeof(unsigned int);
     return ntohl(val);
 }
@@ -67,106 +100,224 @@ unsigned int Command::readUInt()
 void Command::writeUInt16(uint16_t val)
 {
     uint16_t ns_val = htons(val);
-    memcpy(content + len, (unsigned char *)&ns_val, sizeof(uint16_t));
-    len += sizeof(uint16_t);
+    appendContent(&ns_val, sizeof(uint16_t));
 }
 
-uint16_t Command::readUInt16()
+uint16_t Command::readUInt16(const unsigned char *buf, uint64_t buf_len)
 {
+    if (len + sizeof(uint16_t) > buf_len)
+    {
+        LOG_ERROR("Command::readUInt16 error: truncated command (%lu / %lu)", len, buf_len);
+        exit(EXIT_FAILURE);
+    }
     uint16_t val;
-    memcpy((unsigned char *)&val, content + len, sizeof(uint16_t));
+    memcpy((unsigned char *)&val, buf + len, sizeof(uint16_t));
     len += sizeof(uint16_t);
     return ntohs(val);
 }
 
-void Command::writeString(string &val)
+void Command::writeUInt64(uint64_t val)
+{
+    // higher 32 bits, followed by lower 32 bits
+    writeUInt((unsigned int)(val >> 32));
+    writeUInt((unsigned int)(val & 0xffffffff));
+}
+
+uint64_t Command::readUInt64(const unsigned char *buf, uint64_t buf_len)
+{
+    uint64_t high = readUInt(buf, buf_len);
+    uint64_t low = readUInt(buf, buf_len);
+    return (high << 32) | low;
+}
+
+CmdStrView Command::writeString(string &val)
 {
     uint32_t slen = val.length();
     writeUInt(slen);
     // string
+    CmdStrView view = {(uint32_t)len, slen};
     if (slen > 0)
     {
-        memcpy(content + len, val.c_str(), slen);
-        len += slen;
+        appendContent(val.c_str(), slen);
     }
+    return view;
 }
 
-string Command::readString()
+CmdStrView Command::readString(const unsigned char *buf, uint64_t buf_len)
 {
-    string val;
-    unsigned int slen = readUInt();
-    if (slen > 0)
+    unsigned int slen = readUInt(buf, buf_len);
+    if (len + slen > buf_len)
     {
-        char *raw_str = (char *)calloc(sizeof(char), slen + 1);
-        memcpy(raw_str, content + len, slen);
-        len += slen;
-        val = string(raw_str);
-        free(raw_str);
+        LOG_ERROR("Command::readString error: truncated command (%lu / %lu)", len + slen, buf_len);
+        exit(EXIT_FAILURE);
     }
-    return val;
+    // the string is viewed in the buffer (not copied)
+    CmdStrView view = {(uint32_t)len, slen};
+    len += slen;
+    return view;
 }
 
-void Command::parse()
+void Command::parse(const unsigned char *buf, uint64_t buf_len)
 {
-    // the command string has been stored in content
+    // the command is parsed from buf (and not copied to content)
+    len = 0;
+    content.clear();
+    parsed_buf = buf;
+    src_block_path = {0, 0};
+    dst_block_path = {0, 0};
 
-    type = (CommandType)readUInt(); // type
-    src_conn_id = readUInt16();     // src conn id
-    dst_conn_id = readUInt16();     // dst conn id
+    type = (CommandType)readUInt(buf, buf_len); // type
+    src_conn_id = readUInt16(buf, buf_len);     // src conn id
+    dst_conn_id = readUInt16(buf, buf_len);     // dst conn id
     switch (type)
     {
     case CommandType::CMD_CONN:
     case CommandType::CMD_ACK:
+    case CommandType::CMD_STOP:
     {
         break;
     }
     case CommandType::CMD_COMPUTE_RE_BLK:
     case CommandType::CMD_COMPUTE_PM_BLK:
-    case CommandType::CMD_STOP:
     case CommandType::CMD_TRANSFER_BLK:
     case CommandType::CMD_TRANSFER_RELOC_BLK:
     case CommandType::CMD_DELETE_BLK:
     case CommandType::CMD_READ_COMPUTE_BLK:
     case CommandType::CMD_TRANSFER_COMPUTE_BLK:
     {
-        post_stripe_id = readUInt();
-        post_block_id = readUInt16();
-        src_node_id = readUInt16();
-        dst_node_id = readUInt16();
-        src_block_path = readString();
-        dst_block_path = readString();
+        post_stripe_id = readUInt(buf, buf_len);
+        post_block_id = readUInt16(buf, buf_len);
+        src_node_id = readUInt16(buf, buf_len);
+        dst_node_id = readUInt16(buf, buf_len);
+        src_block_path = readString(buf, buf_len);
+        dst_block_path = readString(buf, buf_len);
 
         // additional information for parity compute and relocation
         if (type == CommandType::CMD_COMPUTE_RE_BLK || type == CommandType::CMD_COMPUTE_PM_BLK)
         {
 
-            enc_method = (EncodeMethod)readUInt();
-            num_src_blocks = readUInt();
+            enc_method = (EncodeMethod)readUInt(buf, buf_len);
+            num_src_blocks = readUInt(buf, buf_len);
             src_block_nodes.resize(num_src_blocks);
             for (uint8_t idx = 0; idx < num_src_blocks; idx++)
             {
-                src_block_nodes[idx] = readUInt16();
+                src_block_nodes[idx] = readUInt16(buf, buf_len);
             }
-            num_parity_reloc_blocks = readUInt();
+            num_parity_reloc_blocks = readUInt(buf, buf_len);
             parity_reloc_nodes.resize(num_parity_reloc_blocks);
             for (uint8_t idx = 0; idx < num_parity_reloc_blocks; idx++)
             {
-                parity_reloc_nodes[idx] = readUInt16();
+                parity_reloc_nodes[idx] = readUInt16(buf, buf_len);
             }
         }
 
         break;
     }
+    case CommandType::CMD_TASK_DONE:
+    {
+        task_type = (CommandType)readUInt(buf, buf_len);
+        post_stripe_id = readUInt(buf, buf_len);
+        post_block_id = readUInt16(buf, buf_len);
+        num_net_bytes = readUInt64(buf, buf_len);
+        num_disk_bytes = readUInt64(buf, buf_len);
+        for (int stage = 0; stage < NUM_TASK_STAGES; stage++)
+        {
+            stage_time_us[stage] = readUInt(buf, buf_len);
+        }
+        peer_nodes.resize(readUInt16(buf, buf_len));
+        for (size_t idx = 0; idx < peer_nodes.size(); idx++)
+        {
+            peer_nodes[idx] = readUInt16(buf, buf_len);
+        }
+        break;
+    }
+    case CommandType::CMD_SET_BW_LIMIT:
+    {
+        send_bw_limit = readUInt64(buf, buf_len);
+        recv_bw_limit = readUInt64(buf, buf_len);
+        break;
+    }
     case CommandType::CMD_UNKNOWN:
     {
-        fprintf(stderr, "invalid command type\n");
+        LOG_ERROR("invalid command type");
         exit(EXIT_FAILURE);
     }
     }
 }
 
+uint64_t Command::getMaxFrameSize(size_t num_cmds)
+{
+    return CMD_FRAME_HEADER_LEN + num_cmds * (CMD_LEN_HEADER_LEN + MAX_CMD_LEN);
+}
+
+uint64_t Command::packFrame(Command *cmds, size_t num_cmds, unsigned char *frame)
+{
+    uint64_t frame_size = CMD_FRAME_HEADER_LEN;
+    for (size_t cmd_id = 0; cmd_id < num_cmds; cmd_id++)
+    {
+        Command &cmd = cmds[cmd_id];
+        uint16_t ns_cmd_len = htons(cmd.len);
+        memcpy(frame + frame_size, (unsigned char *)&ns_cmd_len, CMD_LEN_HEADER_LEN);
+        frame_size += CMD_LEN_HEADER_LEN;
+        memcpy(frame + frame_size, cmd.getEncoded(), cmd.len);
+        frame_size += cmd.len;
+    }
+
+    uint32_t ns_frame_len = htonl(frame_size - CMD_FRAME_HEADER_LEN);
+    memcpy(frame, (unsigned char *)&ns_frame_len, CMD_FRAME_HEADER_LEN);
+
+    return frame_size;
+}
+
+size_t Command::unpackFrame(const unsigned char *frame_body, uint64_t frame_len, vector<Command> &cmds)
+{
+    size_t num_cmds = 0;
+    uint64_t offset = 0;
+    while (offset < frame_len)
+    {
+        if (offset + CMD_LEN_HEADER_LEN > frame_len)
+        {
+            LOG_ERROR("Command::unpackFrame error: truncated frame (%lu / %lu)", offset, frame_len);
+            exit(EXIT_FAILURE);
+        }
+        uint16_t cmd_len;
+        memcpy((unsigned char *)&cmd_len, frame_body + offset, CMD_LEN_HEADER_LEN);
+        cmd_len = ntohs(cmd_len);
+        offset += CMD_LEN_HEADER_LEN;
+        if (offset + cmd_len > frame_len)
+        {
+            LOG_ERROR("Command::unpackFrame error: truncated command (%lu / %lu)", offset + cmd_len, frame_len);
+            exit(EXIT_FAILURE);
+        }
+
+        if (cmds.size() <= num_cmds)
+        {
+            cmds.resize(num_cmds + 1);
+        }
+        cmds[num_cmds].parse(frame_body + offset, cmd_len);
+        offset += cmd_len;
+        num_cmds++;
+    }
+
+    return num_cmds;
+}
+
+void Command::keepContent()
+{
+    if (parsed_buf != NULL)
+    {
+        content.assign(parsed_buf, parsed_buf + len);
+        parsed_buf = NULL;
+    }
+}
+
 void Command::buildCommand(CommandType _type, uint16_t _src_conn_id, uint16_t _dst_conn_id)
 {
+    // encode from scratch (the content is sized to the encoded bytes)
+    len = 0;
+    content.clear();
+    parsed_buf = NULL;
+
     type = _type;
     src_conn_id = _src_conn_id;
     dst_conn_id = _dst_conn_id;
@@ -184,15 +335,13 @@ void Command::buildCommand(CommandType _type, uint16_t _src_conn_id, uint16_t _d
     post_block_id = _post_block_id;
     src_node_id = _src_node_id;
     dst_node_id = _dst_node_id;
-    src_block_path = _src_block_path;
-    dst_block_path = _dst_block_path;
 
     writeUInt(post_stripe_id);
     writeUInt16(post_block_id);
     writeUInt16(src_node_id);
     writeUInt16(dst_node_id);
-    writeString(src_block_path);
-    writeString(dst_block_path);
+    src_block_path = writeString(_src_block_path);
+    dst_block_path = writeString(_dst_block_path);
 }
 
 // CMD_COMPUTE_RE_BLK, CMD_COMPUTE_PM_BLK
@@ -218,4 +367,45 @@ void Command::buildCommand(CommandType _type, uint16_t _src_conn_id, uint16_t _d
     {
         writeUInt16(parity_reloc_nodes[idx]);
     }
+}
+
+// CMD_TASK_DONE
+void Command::buildCommand(CommandType _type, uint16_t _src_conn_id, uint16_t _dst_conn_id, CommandType _task_type, uint32_t _post_stripe_id, uint8_t _post_block_id, uint64_t _num_net_bytes, uint64_t _num_disk_bytes, uint32_t *_stage_time_us, vector<uint16_t> _peer_nodes)
+{
+    buildCommand(_type, _src_conn_id, _dst_conn_id);
+
+    task_type = _task_type;
+    post_stripe_id = _post_stripe_id;
+    post_block_id = _post_block_id;
+    num_net_bytes = _num_net_bytes;
+    num_disk_bytes = _num_disk_bytes;
+    memcpy(stage_time_us, _stage_time_us, NUM_TASK_STAGES * sizeof(uint32_t));
+    peer_nodes = _peer_nodes;
+
+    writeUInt(task_type);
+    writeUInt(post_stripe_id);
+    writeUInt16(post_block_id);
+    writeUInt64(num_net_bytes);
+    writeUInt64(num_disk_bytes);
+    for (int stage = 0; stage < NUM_TASK_STAGES; stage++)
+    {
+        writeUInt(stage_time_us[stage]);
+    }
+    writeUInt16(peer_nodes.size());
+    for (size_t idx = 0; idx < peer_nodes.size(); idx++)
+    {
+        writeUInt16(peer_nodes[idx]);
+    }
+}
+
+// CMD_SET_BW_LIMIT
+void Command::buildCommand(CommandType _type, uint16_t _src_conn_id, uint16_t _dst_conn_id, uint64_t _send_bw_limit, uint64_t _recv_bw_limit)
+{
+    buildCommand(_type, _src_conn_id, _dst_conn_id);
+
+    send_bw_limit = _send_bw_limit;
+    recv_bw_limit = _recv_bw_limit;
+
+    writeUInt64(send_bw_limit);
+    writeUInt64(recv_bw_limit);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <arpa/inet.h>
 #include "../include/include.hh"
+#include "../util/Logger.hh"
 #include "../model/StripeGroup.hh"
 
 enum CommandType
@@ -25,26 +26,97 @@ enum CommandType
     CMD_DELETE_BLK,           // delete
     CMD_READ_COMPUTE_BLK,     // read -> compute -> write
     CMD_TRANSFER_COMPUTE_BLK, // read -> transfer -> compute -> write
+    /**
+     * @brief task completion (from Agent to Controller)
+     * format: <type | src_conn_id | dst_conn_id | task_type | post_stripe_id | post_block_id | num_net_bytes | num_disk_bytes | stage_time_us (NUM_TASK_STAGES) | num_peer_nodes | peer_nodes>
+     */
+    CMD_TASK_DONE,
+    /**
+     * @brief bandwidth limits of block transfers (from Controller to Agent)
+     * format: <type | src_conn_id | dst_conn_id | send_bw_limit (uint64) | recv_bw_limit (uint64)>
+     */
+    CMD_SET_BW_LIMIT,
     CMD_UNKNOWN,
 };
 
+/**
+ * @brief stages of a task, timed by the Agent and reported in CMD_TASK_DONE
+ */
+enum TaskStage
+{
+    STAGE_QUEUE,    // queued in the Agent (received -> started)
+    STAGE_RETRIEVE, // compute: source blocks retrieved; relocation: block read and sent
+    STAGE_ENCODE,   // parity encoding (summed over chunks)
+    STAGE_WRITE,    // parity blocks written (after the source blocks are retrieved)
+    STAGE_TOTAL,    // started -> finished
+    NUM_TASK_STAGES
+};
+
+/**
+ * @brief wire format of commands: a frame carries one or more commands,
+ * each with only its encoded bytes;
+ * frame format: <frame_len (uint32) | cmd_len (uint16) | cmd | cmd_len (uint16) | cmd | ...>
+ * where frame_len is the length of the frame after the frame header
+ */
+#define CMD_FRAME_HEADER_LEN sizeof(uint32_t) // frame length
+#define CMD_LEN_HEADER_LEN sizeof(uint16_t)   // command length
+
+/**
+ * @brief view of a string field (e.g., a block path) in the encoded bytes
+ * of a command
+ */
+struct CmdStrView
+{
+    uint32_t offset; // offset in the encoded bytes
+    uint32_t len;    // string length
+};
+
 class Command
 {
 private:
-    /* data */
+    /**
+     * @brief receive the header of a frame
+     *
+     * @param skt
+     * @param frame_len length of the frame (after the header)
+     * @return ssize_t header length; 0: connection closed; -1: error
+     */
+    template <typename SocketType>
+    static ssize_t recvFrameHeader(SocketType &skt, uint32_t &frame_len)
+    {
+        ssize_t ret_val = skt.read_n(&frame_len, CMD_FRAME_HEADER_LEN);
+        if (ret_val == 0)
+        {
+            return 0;
+        }
+        else if (ret_val != (ssize_t)CMD_FRAME_HEADER_LEN)
+        {
+            return -1;
+        }
+
+        frame_len = ntohl(frame_len);
+        if (frame_len == 0)
+        {
+            return -1;
+        }
+
+        return ret_val;
+    }
+
 public:
     CommandType type;
-    uint64_t len;                       // command length
-    unsigned char content[MAX_CMD_LEN]; // content
-    uint16_t src_conn_id;               // source connection id
-    uint16_t dst_conn_id;               // dst connection id
-
-    uint32_t post_stripe_id; // post-transition stripe id (or stripe group id)
-    uint8_t post_block_id;   // post-transition stripe block id
-    uint16_t src_node_id;    // source node id
-    uint16_t dst_node_id;    // destination node id
-    string src_block_path;   // source block physical path (in the source node)
-    string dst_block_path;   // destination block physical path (in the destination node)
+    uint64_t len;                    // command length (encoded bytes)
+    vector<unsigned char> content;   // encoded bytes (len) of a built command, or of a parsed command kept by keepContent()
+    const unsigned char *parsed_buf; // encoded bytes of a parsed command, not owned and valid until the buffer is reused (NULL: in content)
+    uint16_t src_conn_id;            // source connection id
+    uint16_t dst_conn_id;            // dst connection id
+
+    uint32_t post_stripe_id;   // post-transition stripe id (or stripe group id)
+    uint8_t post_block_id;     // post-transition stripe block id
+    uint16_t src_node_id;      // source node id
+    uint16_t dst_node_id;      // destination node id
+    CmdStrView src_block_path; // source block physical path (in the source node)
+    CmdStrView dst_block_path; // destination block physical path (in the destination node)
 
     EncodeMethod enc_method;          // encode method
     uint8_t num_src_blocks;           // number of source blocks (re-encoding: code.k_f; parity merging: code.m_f)
@@ -53,21 +125,196 @@ public:
     uint8_t num_parity_reloc_blocks;     // number of nodes for parity relocation
     vector<uint16_t> parity_reloc_nodes; // parity relocation nodes (for re-encoding, reloc_nodes stores code.m_f nodes; for parity merging, reloc_nodes store the corresponding parity node only)
 
+    // task completion report (CMD_TASK_DONE)
+    CommandType task_type;                   // type of the finished task
+    uint64_t num_net_bytes;                  // Bytes sent / received over the network by the task
+    uint64_t num_disk_bytes;                 // Bytes read / written on disk by the task
+    uint32_t stage_time_us[NUM_TASK_STAGES]; // time of each stage (in us)
+    vector<uint16_t> peer_nodes;             // nodes on the other side of the network Bytes (each serves / receives an equal share, read from / written to its disk)
+
+    // bandwidth limits (CMD_SET_BW_LIMIT)
+    uint64_t send_bw_limit; // Bytes per second (0: unlimited)
+    uint64_t recv_bw_limit; // Bytes per second (0: unlimited)
+
+    uint64_t recv_time_us; // (local, not sent) time the task is received in the Agent (Utils::getTimeUs())
+
     Command();
     ~Command();
 
     void print();
 
-    // type parsing
+    // type parsing (writes are appended to content; reads are from the
+    // buffer at offset len, bounded by buf_len)
+    void appendContent(const void *val, uint64_t val_len);
     void writeUInt(unsigned int val);
-    unsigned int readUInt();
+    unsigned int readUInt(const unsigned char *buf, uint64_t buf_len);
     void writeUInt16(uint16_t val);
-    uint16_t readUInt16();
-    void writeString(string &val);
-    string readString();
+    uint16_t readUInt16(const unsigned char *buf, uint64_t buf_len);
+    void writeUInt64(uint64_t val);
+    uint64_t readUInt64(const unsigned char *buf, uint64_t buf_len);
+    CmdStrView writeString(string &val);
+    CmdStrView readString(const unsigned char *buf, uint64_t buf_len);
+
+    /**
+     * @brief parse the command from its encoded bytes (in place: the fields
+     * are read directly from the buffer, e.g., the receive buffer of a frame,
+     * and the string fields are views into it; content is not filled)
+     *
+     * @param buf encoded command
+     * @param buf_len length of the encoded command
+     */
+    void parse(const unsigned char *buf, uint64_t buf_len);
+
+    /**
+     * @brief keep the encoded bytes of a parsed command in content, so that
+     * the string fields stay valid after the buffer it is parsed from is
+     * reused (e.g., before the command is queued)
+     */
+    void keepContent();
+
+    /**
+     * @brief get the encoded bytes of the command
+     *
+     * @return const unsigned char*
+     */
+    const unsigned char *getEncoded()
+    {
+        return parsed_buf != NULL ? parsed_buf : content.data();
+    }
 
-    // command types
-    void parse();
+    /**
+     * @brief get a string field (copied from the encoded bytes)
+     *
+     * @param view
+     * @return string
+     */
+    string getString(CmdStrView &view)
+    {
+        return string((const char *)getEncoded() + view.offset, view.len);
+    }
+
+    string getSrcBlockPath()
+    {
+        return getString(src_block_path);
+    }
+
+    string getDstBlockPath()
+    {
+        return getString(dst_block_path);
+    }
+
+    /**
+     * @brief get the maximum size of a frame of commands
+     *
+     * @param num_cmds
+     * @return uint64_t
+     */
+    static uint64_t getMaxFrameSize(size_t num_cmds);
+
+    /**
+     * @brief pack the (built) commands into a frame
+     *
+     * @param cmds
+     * @param num_cmds
+     * @param frame buffer of at least getMaxFrameSize(num_cmds) Bytes
+     * @return uint64_t frame size (including the frame header)
+     */
+    static uint64_t packFrame(Command *cmds, size_t num_cmds, unsigned char *frame);
+
+    /**
+     * @brief parse the commands of a frame
+     *
+     * @param frame_body frame (after the frame header)
+     * @param frame_len
+     * @param cmds parsed commands (reused across frames)
+     * @return size_t number of commands
+     */
+    static size_t unpackFrame(const unsigned char *frame_body, uint64_t frame_len, vector<Command> &cmds);
+
+    /**
+     * @brief receive a frame (header and body)
+     *
+     * @param skt
+     * @param frame_body frame (after the frame header), resized as needed
+     * @return ssize_t frame length; 0: connection closed; -1: error
+     */
+    template <typename SocketType>
+    static ssize_t recvFrame(SocketType &skt, vector<unsigned char> &frame_body)
+    {
+        uint32_t frame_len = 0;
+        ssize_t ret_val = recvFrameHeader(skt, frame_len);
+        if (ret_val <= 0)
+        {
+            return ret_val;
+        }
+
+        if (frame_body.size() < frame_len)
+        {
+            frame_body.resize(frame_len);
+        }
+        if (skt.read_n(frame_body.data(), frame_len) != (ssize_t)frame_len)
+        {
+            return -1;
+        }
+
+        return frame_len;
+    }
+
+    /**
+     * @brief send a command in a frame of its own
+     *
+     * @param skt
+     * @param cmd built command
+     * @return true
+     * @return false
+     */
+    template <typename SocketType>
+    static bool sendCommand(SocketType &skt, Command &cmd)
+    {
+        unsigned char frame[CMD_FRAME_HEADER_LEN + CMD_LEN_HEADER_LEN + MAX_CMD_LEN];
+        uint64_t frame_size = packFrame(&cmd, 1, frame);
+        return skt.write_n(frame, frame_size) == (ssize_t)frame_size;
+    }
+
+    /**
+     * @brief receive a command sent in a frame of its own
+     *
+     * @param skt
+     * @param cmd parsed command
+     * @return ssize_t frame length; 0: connection closed; -1: error
+     */
+    template <typename SocketType>
+    static ssize_t recvCommand(SocketType &skt, Command &cmd)
+    {
+        uint32_t frame_len = 0;
+        ssize_t ret_val = recvFrameHeader(skt, frame_len);
+        if (ret_val <= 0)
+        {
+            return ret_val;
+        }
+        if (frame_len < CMD_LEN_HEADER_LEN || frame_len > CMD_LEN_HEADER_LEN + MAX_CMD_LEN)
+        {
+            return -1;
+        }
+
+        unsigned char frame_body[CMD_LEN_HEADER_LEN + MAX_CMD_LEN];
+        if (skt.read_n(frame_body, frame_len) != (ssize_t)frame_len)
+        {
+            return -1;
+        }
+
+        uint16_t cmd_len = 0;
+        memcpy(&cmd_len, frame_body, CMD_LEN_HEADER_LEN);
+        cmd_len = ntohs(cmd_len);
+        if (CMD_LEN_HEADER_LEN + cmd_len != frame_len)
+        {
+            return -1;
+        }
+        cmd.parse(frame_body + CMD_LEN_HEADER_LEN, cmd_len);
+        cmd.keepContent(); // frame_body is local
+
+        return frame_len;
+    }
 
     // CMD_CONN, CMD_ACK, CMD_STOP
     void buildCommand(CommandType _type, uint16_t _src_conn_id, uint16_t _dst_conn_id);
@@ -77,6 +324,12 @@ public:
 
     // CMD_COMPUTE_RE_BLK, CMD_COMPUTE_PM_BLK
     void buildCommand(CommandType _type, uint16_t _src_conn_id, uint16_t _dst_conn_id, uint32_t _post_stripe_id, uint8_t _post_block_id, uint16_t _src_node_id, uint16_t _dst_node_id, string _src_block_path, string _dst_block_path, EncodeMethod _enc_method, uint8_t _num_src_blocks, vector<uint16_t> _src_block_nodes, uint8_t _num_parity_reloc_blocks, vector<uint16_t> _parity_reloc_nodes);
+
+    // CMD_TASK_DONE
+    void buildCommand(CommandType _type, uint16_t _src_conn_id, uint16_t _dst_conn_id, CommandType _task_type, uint32_t _post_stripe_id, uint8_t _post_block_id, uint64_t _num_net_bytes, uint64_t _num_disk_bytes, uint32_t *_stage_time_us, vector<uint16_t> _peer_nodes);
+
+    // CMD_SET_BW_LIMIT
+    void buildCommand(CommandType _type, uint16_t _src_conn_id, uint16_t _dst_conn_id, uint64_t _send_bw_limit, uint64_t _recv_bw_limit);
 };
 
 #endif // __COMMAND_HH__
\ No newline at end of file
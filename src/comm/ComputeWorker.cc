@@ -1,45 +1,41 @@
 #include "ComputeWorker.hh"
 
-ComputeWorker::ComputeWorker(Config &_config, unsigned int _self_worker_id, uint16_t _self_conn_id, MessageQueue<Command> &_compute_task_queue, unordered_map<unsigned int, MultiWriterQueue<Command> *> &_reloc_task_queues) : ThreadPool(1), config(_config), self_worker_id(_self_worker_id), self_conn_id(_self_conn_id), compute_task_queue(_compute_task_queue), reloc_task_queues(_reloc_task_queues)
+ComputeWorker::ComputeWorker(Config &_config, unsigned int _self_worker_id, uint16_t _self_conn_id, MessageQueue<Command> &_compute_task_queue, unordered_map<unsigned int, MultiWriterQueue<Command> *> &_reloc_task_queues, MultiWriterQueue<Command> *_report_queue, ConnPool &_conn_pool, MemoryPool &_memory_pool, BlockStore &_block_store) : ThreadPool(1), config(_config), self_worker_id(_self_worker_id), self_conn_id(_self_conn_id), compute_task_queue(_compute_task_queue), reloc_task_queues(_reloc_task_queues), report_queue(_report_queue), conn_pool(_conn_pool), memory_pool(_memory_pool), block_store(_block_store)
 {
     ConvertibleCode &code = config.code;
 
     // initialize EC tables (for both re-encoding and parity merging)
     initECTables();
 
-    // init buffers for encoding
-    unsigned int buffer_size = code.n_f > (code.lambda_i + 1) ? code.n_f : (code.lambda_i + 1);
-    block_buffer = (unsigned char *)malloc(buffer_size * config.block_size * sizeof(unsigned char));
-    re_buffers = (unsigned char **)malloc(code.n_f * sizeof(unsigned char *));
-    for (uint8_t block_id = 0; block_id < code.n_f; block_id++)
-    {
-        re_buffers[block_id] = &block_buffer[block_id * config.block_size];
-    }
+    // chunk rings (bound to the buffers borrowed from the memory pool per task)
+    unsigned int num_rings = code.n_f > (code.lambda_i + 1) ? code.n_f : (code.lambda_i + 1);
+    block_rings = new ChunkRing[num_rings];
 
-    pm_buffers = (unsigned char **)malloc((code.lambda_i + 1) * sizeof(unsigned char *));
-    for (uint8_t block_id = 0; block_id < code.lambda_i + 1; block_id++)
+    parity_accumulator = NULL;
+    if (config.incremental_encoding == true)
     {
-        pm_buffers[block_id] = &block_buffer[block_id * config.block_size];
+        parity_accumulator = new ParityAccumulator(config.block_size, config.chunk_size);
     }
 
-    // // create memory pools for parity writes
-    // memory_pool = new MemoryPool(5, config.block_size);
+    async_io = new AsyncBlockIO(config.io_queue_depth, config.use_io_uring, config.use_direct_io, &block_store);
+    async_io->registerBuffers(memory_pool);
 
-    printf("[Node %u, Worker %u] ComputeWorker::ComputeWorker finished initialization\n", self_conn_id, self_worker_id);
+    LOG_INFO("[Node %u, Worker %u] ComputeWorker::ComputeWorker finished initialization", self_conn_id, self_worker_id);
 }
 
 ComputeWorker::~ComputeWorker()
 {
-    // delete memory_pool;
-    free(pm_buffers);
-    free(re_buffers);
-    free(block_buffer);
+    delete async_io;
+    delete parity_accumulator;
+    delete[] block_rings;
     destroyECTables();
 }
 
 void ComputeWorker::run()
 {
-    printf("[Node %u, Worker %u] ComputeWorker::run start to handle parity computation tasks\n", self_conn_id, self_worker_id);
+    LOG_INFO("[Node %u, Worker %u] ComputeWorker::run start to handle parity computation tasks", self_conn_id, self_worker_id);
+
+    Tracer::setThreadName("ComputeWorker " + to_string(self_worker_id));
 
     ConvertibleCode &code = config.code;
 
@@ -54,7 +50,8 @@ void ComputeWorker::run()
             break;
         }
 
-        if (compute_task_queue.Pop(cmd_compute) == true)
+        // wait for a task (sleep when idle)
+        if (compute_task_queue.WaitPop(cmd_compute) == true)
         {
             // terminate signal
             if (cmd_compute.type == CommandType::CMD_STOP)
@@ -75,55 +72,20 @@ void ComputeWorker::run()
             vector<string> dst_block_paths;
             parseBlockPaths(cmd_compute, src_block_paths, dst_block_paths);
 
-            printf("[Node %u, Worker %u] ComputeWorker::run received parity computation task, post: (%u, %u)\n", self_conn_id, self_worker_id, cmd_compute.post_stripe_id, cmd_compute.post_block_id);
+            LOG_DEBUG("[Node %u, Worker %u] ComputeWorker::run received parity computation task, post: (%u, %u)", self_conn_id, self_worker_id, cmd_compute.post_stripe_id, cmd_compute.post_block_id);
+
+            uint64_t start_time_us = Utils::getTimeUs();
+            uint64_t num_net_bytes = 0;
+            uint64_t num_disk_bytes = 0;
+            uint32_t stage_time_us[NUM_TASK_STAGES] = {0};
+            Tracer::record("queue_wait", cmd_compute.recv_time_us, start_time_us, cmd_compute.post_stripe_id, cmd_compute.post_block_id);
 
             if (cmd_compute.enc_method == EncodeMethod::RE_ENCODE)
             { // compute re-encoding
 
-                // step 1: retrieve data
-                // find nodes to retrieve data
-                unordered_map<uint16_t, vector<unsigned char *>> src_node_block_buffers_map;
-                for (uint8_t data_block_id = 0; data_block_id < code.k_f; data_block_id++)
-                {
-                    uint16_t src_node_id = cmd_compute.src_block_nodes[data_block_id];
-                    src_node_block_buffers_map[src_node_id].push_back(re_buffers[data_block_id]);
-                }
-
-                // printf("ComputeWorker::run start to retrieve all required data for re-encoding, post: (%u, %u)\n", cmd_compute.post_stripe_id, cmd_compute.post_block_id);
-
-                // create threads to retrieve data
-                thread *data_request_threads = new thread[src_node_block_buffers_map.size()];
-                uint8_t thread_id = 0;
-                for (auto &item : src_node_block_buffers_map)
-                {
-                    data_request_threads[thread_id++] = thread(&ComputeWorker::requestDataFromAgent, this, &cmd_compute, item.first, item.second);
-                }
-
-                // join threads
-                for (uint idx = 0; idx < src_node_block_buffers_map.size(); idx++)
-                {
-                    data_request_threads[idx].join();
-                }
-                delete[] data_request_threads;
-
-                // printf("ComputeWorker::run finished retrieving all required data for re-encoding, post: (%u, %u)\n", cmd_compute.post_stripe_id, cmd_compute.post_block_id);
-
-                // step 2: encode data
-                ec_encode_data(config.block_size, code.k_f, code.m_f, re_encode_gftbl, re_buffers, &re_buffers[code.k_f]);
-
-                // step 3: write parity blocks to disk
-                for (uint8_t parity_id = 0; parity_id < code.m_f; parity_id++)
-                {
-                    // write parity_id to disk
-                    string dst_block_path = dst_block_paths[parity_id];
-                    if (BlockIO::writeBlock(dst_block_path, re_buffers[code.k_f + parity_id], config.block_size) != config.block_size)
-                    {
-                        fprintf(stderr, "ComputeWorker::run error writing block: %s\n", dst_block_path.c_str());
-                        exit(EXIT_FAILURE);
-                    }
-
-                    // printf("ComputeWorker::run finished writing parity block %s\n", dst_block_path.c_str());
-                }
+                // step 1-3: retrieve data, encode data and write parity blocks
+                // to disk (chunk by chunk, while the data is being retrieved)
+                retrieveAndEncode(cmd_compute, code.k_f, code.m_f, re_encode_gftbl, src_block_paths, dst_block_paths, num_net_bytes, num_disk_bytes, stage_time_us);
 
                 // step 4: relocate parity blocks
 
@@ -141,100 +103,27 @@ void ComputeWorker::run()
                     {
                         Command cmd_reloc;
                         cmd_reloc.buildCommand(CommandType::CMD_TRANSFER_RELOC_BLK, self_conn_id, dst_conn_id, cmd_compute.post_stripe_id, cmd_compute.post_block_id, self_conn_id, dst_conn_id, dst_block_path, dst_block_path);
+                        cmd_reloc.recv_time_us = Utils::getTimeUs();
 
                         // pass to corresponding relocation worker
                         reloc_task_queues[assigned_worker_id]->Push(cmd_reloc);
 
                         reloc_task_counter++;
 
-                        printf("[Node %u, Worker %u] ComputeWorker::run created parity block relocation task (type: %u, Node %u -> %u), forwarded to RelocWorker %u\n", self_conn_id, self_worker_id, cmd_reloc.type, cmd_reloc.src_node_id, cmd_reloc.dst_node_id, assigned_worker_id);
+                        LOG_DEBUG("[Node %u, Worker %u] ComputeWorker::run created parity block relocation task (type: %u, Node %u -> %u), forwarded to RelocWorker %u", self_conn_id, self_worker_id, cmd_reloc.type, cmd_reloc.src_node_id, cmd_reloc.dst_node_id, assigned_worker_id);
                     }
                 }
             }
             else if (cmd_compute.enc_method == EncodeMethod::PARITY_MERGE)
             {
-                // step 1: retrieve data
-                // find nodes to retrieve data
-                unordered_map<uint16_t, vector<unsigned char *>> src_node_block_buffers_map;
-                for (uint8_t pre_stripe_id = 0; pre_stripe_id < code.lambda_i; pre_stripe_id++)
-                {
-                    uint16_t src_node_id = cmd_compute.src_block_nodes[pre_stripe_id];
-                    src_node_block_buffers_map[src_node_id].push_back(pm_buffers[pre_stripe_id]);
-                }
-
-                // printf("ComputeWorker::run start to retrieve all required data for parity merging, post: (%u, %u)\n", cmd_compute.post_stripe_id, cmd_compute.post_block_id);
-
-                // create threads to retrieve data
-                thread *data_request_threads = new thread[src_node_block_buffers_map.size()];
-                uint8_t thread_id = 0;
-                for (auto &item : src_node_block_buffers_map)
-                {
-                    data_request_threads[thread_id++] = thread(&ComputeWorker::requestDataFromAgent, this, &cmd_compute, item.first, item.second);
-                }
-
-                // join threads
-                for (uint idx = 0; idx < src_node_block_buffers_map.size(); idx++)
-                {
-                    data_request_threads[idx].join();
-                }
-                delete[] data_request_threads;
-
-                // printf("ComputeWorker::run finished retrieve all required data for parity merging, post: (%u, %u)\n", cmd_compute.post_stripe_id, cmd_compute.post_block_id);
-
-                // step 2: encode data
                 uint8_t parity_id = cmd_compute.post_block_id - code.k_f;
                 uint16_t dst_conn_id = cmd_compute.parity_reloc_nodes[0];
-                ec_encode_data(config.block_size, code.lambda_i, 1, pm_encode_gftbl[parity_id], pm_buffers, &pm_buffers[code.lambda_i]);
-
-                // // use memory pool
-                // unsigned char *req_buffer;
-                // if (self_conn_id == dst_conn_id)
-                // {
-                //     // temporarily hold the memory
-                //     unsigned char *temp_buffer = pm_buffers[code.lambda_i];
-
-                //     // request memory
-                //     req_buffer = memory_pool->getBlock();
-
-                //     // temporarily assign memory
-                //     pm_buffers[code.lambda_i] = req_buffer;
-
-                //     // encode
-                //     ec_encode_data(config.block_size, code.lambda_i, 1, pm_encode_gftbl[parity_id], pm_buffers, &pm_buffers[code.lambda_i]);
-
-                //     // return the memory
-                //     pm_buffers[code.lambda_i] = temp_buffer;
-                // }
-                // else
-                // {
-                //     ec_encode_data(config.block_size, code.lambda_i, 1, pm_encode_gftbl[parity_id], pm_buffers, &pm_buffers[code.lambda_i]);
-                // }
-
-                // step 3: write data to disk
-                // write the parity block to disk
                 string dst_block_path = dst_block_paths[0];
-                if (BlockIO::writeBlock(dst_block_path, pm_buffers[code.lambda_i], config.block_size) != config.block_size)
-                {
-                    fprintf(stderr, "error writing block: %s\n", dst_block_path.c_str());
-                    exit(EXIT_FAILURE);
-                }
 
-                // // use memory pool
-                // if (self_conn_id == dst_conn_id)
-                // { // need to write to disk, and can be detached
-                //     thread write_data_thread(&ComputeWorker::writeBlockToDisk, this, dst_block_path, req_buffer, config.block_size);
-                //     write_data_thread.detach();
-                // }
-                // else
-                // { // need to write to disk, and cannot be detached
-                //     if (BlockIO::writeBlock(dst_block_path, pm_buffers[code.lambda_i], config.block_size) != config.block_size)
-                //     {
-                //         fprintf(stderr, "error writing block: %s\n", dst_block_path.c_str());
-                //         exit(EXIT_FAILURE);
-                //     }
-                // }
-
-                // printf("ComputeWorker::run finished writing parity block %s\n", dst_block_path.c_str());
+                // step 1-3: retrieve data, encode data and write the parity
+                // block to disk (chunk by chunk, while the data is being
+                // retrieved)
+                retrieveAndEncode(cmd_compute, code.lambda_i, 1, pm_encode_gftbl[parity_id], src_block_paths, dst_block_paths, num_net_bytes, num_disk_bytes, stage_time_us);
 
                 // step 4: relocate parity blocks
                 // unsigned int assigned_worker_id = cmd_compute.post_stripe_id % config.num_reloc_workers;
@@ -245,181 +134,335 @@ void ComputeWorker::run()
                 {
                     Command cmd_reloc;
                     cmd_reloc.buildCommand(CommandType::CMD_TRANSFER_RELOC_BLK, self_conn_id, dst_conn_id, cmd_compute.post_stripe_id, cmd_compute.post_block_id, self_conn_id, dst_conn_id, dst_block_path, dst_block_path);
+                    cmd_reloc.recv_time_us = Utils::getTimeUs();
 
                     // // pass to corresponding relocation worker
                     reloc_task_queues[assigned_worker_id]->Push(cmd_reloc);
 
                     reloc_task_counter++;
 
-                    printf("[Node %u, Worker %u] ComputeWorker::run created parity block relocation task (type: %u, Node %u -> %u), forwarded to RelocWorker %u\n", self_conn_id, self_worker_id, cmd_reloc.type, cmd_reloc.src_node_id, cmd_reloc.dst_node_id, assigned_worker_id);
+                    LOG_DEBUG("[Node %u, Worker %u] ComputeWorker::run created parity block relocation task (type: %u, Node %u -> %u), forwarded to RelocWorker %u", self_conn_id, self_worker_id, cmd_reloc.type, cmd_reloc.src_node_id, cmd_reloc.dst_node_id, assigned_worker_id);
                 }
             }
 
-            printf("[Node %u, Worker %u] ComputeWorker::run finished parity computation task, post(%u, %u)\n", self_conn_id, self_worker_id, cmd_compute.post_stripe_id, cmd_compute.post_block_id);
+            LOG_DEBUG("[Node %u, Worker %u] ComputeWorker::run finished parity computation task, post(%u, %u)", self_conn_id, self_worker_id, cmd_compute.post_stripe_id, cmd_compute.post_block_id);
+
+            uint64_t end_time_us = Utils::getTimeUs();
+            Tracer::record("compute_task", start_time_us, end_time_us, cmd_compute.post_stripe_id, cmd_compute.post_block_id);
+
+            if (report_queue != NULL)
+            { // report to Controller
+                stage_time_us[STAGE_QUEUE] = start_time_us - cmd_compute.recv_time_us;
+                stage_time_us[STAGE_TOTAL] = end_time_us - start_time_us;
+
+                // the remote source nodes read their blocks from disk and send them
+                vector<uint16_t> peer_nodes;
+                for (auto src_node_id : cmd_compute.src_block_nodes)
+                {
+                    if (src_node_id != self_conn_id)
+                    {
+                        peer_nodes.push_back(src_node_id);
+                    }
+                }
+
+                Command cmd_done;
+                cmd_done.buildCommand(CommandType::CMD_TASK_DONE, self_conn_id, CTRL_NODE_ID, cmd_compute.type, cmd_compute.post_stripe_id, cmd_compute.post_block_id, num_net_bytes, num_disk_bytes, stage_time_us, peer_nodes);
+                report_queue->Push(cmd_done);
+            }
         }
     }
 
-    printf("[Node %u, Worker %u] ComputeWorker::run finished handling parity computation tasks\n", self_conn_id, self_worker_id);
+    LOG_INFO("[Node %u, Worker %u] ComputeWorker::run finished handling parity computation tasks", self_conn_id, self_worker_id);
 }
 
-void ComputeWorker::requestDataFromAgent(Command *cmd_compute, uint16_t src_node_id, vector<unsigned char *> data_buffers)
+unsigned int ComputeWorker::getTaskNumBuffers(Config &config, int k, int m)
 {
-    vector<string> src_block_paths;
-    vector<string> dst_block_paths;
-    parseBlockPaths(*cmd_compute, src_block_paths, dst_block_paths);
+    unsigned int num_src_buffers = config.incremental_encoding ? 1 : config.num_chunk_slots;
 
-    uint8_t num_blocks_to_retrieve = INVALID_BLK_ID;
-    if (cmd_compute->enc_method == EncodeMethod::RE_ENCODE)
-    {
-        num_blocks_to_retrieve = config.code.k_f;
-    }
-    else if (cmd_compute->enc_method == EncodeMethod::PARITY_MERGE)
-    {
-        num_blocks_to_retrieve = config.code.lambda_i;
-    }
-    uint8_t cur_buffer_id = 0;
+    return k * num_src_buffers + m * config.num_chunk_slots;
+}
 
-    for (uint8_t block_id = 0; block_id < num_blocks_to_retrieve; block_id++)
-    {
-        uint16_t block_src_node_id = cmd_compute->src_block_nodes[block_id];
-        string src_block_path = src_block_paths[block_id];
-        unsigned char *data_buffer = data_buffers[cur_buffer_id];
+void ComputeWorker::requestDataFromAgent(Command *cmd_compute, uint8_t src_id, string src_block_path, sockpp::tcp_connector **connector, ChunkRing *data_ring, unsigned char *chunk_buffer)
+{
+    uint16_t src_node_id = cmd_compute->src_block_nodes[src_id];
+
+    Tracer::setThreadName("ComputeWorker data request");
+    TraceScope trace_scope("recv_block", cmd_compute->post_stripe_id, cmd_compute->post_block_id);
+
+    LOG_DEBUG("ComputeWorker::requestDataFromAgent start to retrieve data from Node %u, post: (%u, %u), src_block_path: %s", src_node_id, cmd_compute->post_stripe_id, cmd_compute->post_block_id, src_block_path.c_str());
+
+    // send command to the node to retrieve data
+    Command cmd_transfer;
+    cmd_transfer.buildCommand(CommandType::CMD_TRANSFER_BLK, self_conn_id, src_node_id, cmd_compute->post_stripe_id, cmd_compute->post_block_id, src_node_id, self_conn_id, src_block_path, string());
 
-        // only retrieve the block from src_node_id
-        if (src_node_id != block_src_node_id)
+    // send block transfer request (on a new connection if the pooled
+    // connection has failed)
+    unsigned int num_retries = 0;
+    while (Command::sendCommand(**connector, cmd_transfer) == false)
+    {
+        if (++num_retries > CONN_MAX_TRANSFER_RETRIES)
         {
-            continue;
+            LOG_ERROR("ComputeWorker::requestDataFromAgent error sending cmd, type: %u, src_conn_id: %u, dst_conn_id: %u", cmd_transfer.type, cmd_transfer.src_conn_id, cmd_transfer.dst_conn_id);
+            exit(EXIT_FAILURE);
         }
+        *connector = conn_pool.reconnect(src_node_id, *connector);
+    }
 
-        if (src_node_id == self_conn_id)
-        { // read data from disk
-            if (BlockIO::readBlock(src_block_path, data_buffer, config.block_size) != config.block_size)
+    if (config.incremental_encoding == true)
+    { // retrieve the block chunk by chunk, and accumulate each chunk into the parity blocks
+        for (uint64_t offset = 0; offset < config.block_size; offset += config.chunk_size)
+        {
+            uint64_t cur_chunk_size = min(config.chunk_size, config.block_size - offset);
+            if (BlockIO::recvBlock(**connector, chunk_buffer, cur_chunk_size) != cur_chunk_size)
             {
-                fprintf(stderr, "ComputeWorker::requestDataFromAgent error reading local block: %s\n", src_block_path.c_str());
+                LOG_ERROR("ComputeWorker::requestDataFromAgent error retrieving block: %s from Node %u", src_block_path.c_str(), src_node_id);
                 exit(EXIT_FAILURE);
             }
 
-            printf("ComputeWorker::requestDataFromAgent finished read local data at Node %u, post: (%u, %u), src_block_path: %s\n", src_node_id, cmd_compute->post_stripe_id, cmd_compute->post_block_id, src_block_path.c_str());
+            parity_accumulator->accumulate(src_id, offset, cur_chunk_size, chunk_buffer);
         }
-        else
-        { // retrieve data from other Nodes
-
-            printf("ComputeWorker::requestDataFromAgent start to retrieve data from Node %u, post: (%u, %u), src_block_path: %s\n", src_node_id, cmd_compute->post_stripe_id, cmd_compute->post_block_id, src_block_path.c_str());
 
-            // send command to the node to retrieve data
-            Command cmd_transfer;
-            cmd_transfer.buildCommand(CommandType::CMD_TRANSFER_BLK, self_conn_id, src_node_id, cmd_compute->post_stripe_id, cmd_compute->post_block_id, src_node_id, self_conn_id, src_block_path, string());
-
-            // create connection to block request handler
-            string block_req_ip = config.agent_addr_map[src_node_id].first;
-            unsigned int block_req_port = config.agent_addr_map[src_node_id].second + config.settings.num_nodes; // DEBUG
-
-            sockpp::tcp_connector connector;
-            int on = 1;
-            connector.set_option(SOL_SOCKET, SO_REUSEADDR, &on);
-            connector.set_option(SOL_SOCKET, SO_REUSEPORT, &on);
-            connector.set_option(SOL_SOCKET, SO_KEEPALIVE, &on);
+        LOG_DEBUG("ComputeWorker::requestDataFromAgent finished retrieving and accumulating data from Node %u, post: (%u, %u), src_block_path: %s", src_node_id, cmd_compute->post_stripe_id, cmd_compute->post_block_id, src_block_path.c_str());
+    }
+    else
+    { // receive block
+        if (BlockIO::recvBlock(**connector, config.block_size, *data_ring) != config.block_size)
+        {
+            LOG_ERROR("ComputeWorker::requestDataFromAgent error receiving block: %s from BlockReqHandler of Node %u", src_block_path.c_str(), src_node_id);
+            exit(EXIT_FAILURE);
+        }
 
-            while (!(connector = sockpp::tcp_connector(sockpp::inet_address(block_req_ip, block_req_port))))
-            {
-                this_thread::sleep_for(chrono::milliseconds(1));
-            }
+        LOG_DEBUG("ComputeWorker::requestDataFromAgent finished retrieving data from Node %u, post: (%u, %u), src_block_path: %s", src_node_id, cmd_compute->post_stripe_id, cmd_compute->post_block_id, src_block_path.c_str());
+    }
+}
 
-            // send block transfer request
-            if (connector.write_n(cmd_transfer.content, MAX_CMD_LEN * sizeof(unsigned char)) == -1)
-            {
-                fprintf(stderr, "ComputeWorker::requestDataFromAgent error sending cmd, type: %u, src_conn_id: %u, dst_conn_id: %u\n", cmd_transfer.type, cmd_transfer.src_conn_id, cmd_transfer.dst_conn_id);
-                exit(EXIT_FAILURE);
-            }
+void ComputeWorker::retrieveAndEncode(Command &cmd_compute, int k, int m, unsigned char *encode_gftbl, vector<string> &src_block_paths, vector<string> &dst_block_paths, uint64_t &num_net_bytes, uint64_t &num_disk_bytes, uint32_t *stage_time_us)
+{
+    uint64_t start_time_us = Utils::getTimeUs();
+
+    bool is_incremental = config.incremental_encoding;
+    uint64_t num_slots = config.num_chunk_slots;
+
+    // borrow the buffers of the task from the memory pool (before acquiring
+    // connections, so a task holding connections never waits for memory)
+    vector<unsigned char *> task_buffers;
+    memory_pool.getBlocks(getTaskNumBuffers(config, k, m), task_buffers);
+    Tracer::record("acquire_buffers", start_time_us, Utils::getTimeUs(), cmd_compute.post_stripe_id, cmd_compute.post_block_id);
+
+    // source rings (of a single chunk buffer for incremental encoding),
+    // followed by parity rings
+    uint64_t num_src_slots = (is_incremental == true) ? 1 : num_slots;
+    vector<unsigned char *> chunk_buffers(k, NULL);
+    unsigned char **buffer_ptr = &task_buffers[0];
+    for (int src_id = 0; src_id < k; src_id++)
+    {
+        chunk_buffers[src_id] = *buffer_ptr;
+        block_rings[src_id].bind(buffer_ptr, num_src_slots, config.chunk_size);
+        buffer_ptr += num_src_slots;
+    }
 
-            // receive block
-            if (BlockIO::recvBlock(connector, data_buffer, config.block_size) != config.block_size)
-            {
-                fprintf(stderr, "ComputeWorker::retrieveData error recv block from ComputeWorker (%u)\n", src_node_id);
-                exit(EXIT_FAILURE);
-            }
+    ChunkRing *parity_rings = &block_rings[k];
+    for (int parity_id = 0; parity_id < m; parity_id++)
+    {
+        parity_rings[parity_id].bind(buffer_ptr, num_slots, config.chunk_size);
+        buffer_ptr += num_slots;
+    }
 
-            connector.close();
+    if (is_incremental == true)
+    {
+        parity_accumulator->reset(k, m, encode_gftbl, parity_rings);
+    }
 
-            printf("ComputeWorker::requestDataFromAgent finished retrieving data from Node %u, post: (%u, %u), src_block_path: %s\n", src_node_id, cmd_compute->post_stripe_id, cmd_compute->post_block_id, src_block_path.c_str());
+    // acquire connections to the source nodes all at once: one per remote
+    // source block, so that all source blocks are streamed concurrently
+    vector<uint16_t> src_conn_ids;
+    for (int src_id = 0; src_id < k; src_id++)
+    {
+        if (cmd_compute.src_block_nodes[src_id] != self_conn_id)
+        {
+            src_conn_ids.push_back(cmd_compute.src_block_nodes[src_id]);
         }
+    }
+    vector<sockpp::tcp_connector *> connectors;
+    if (src_conn_ids.empty() == false)
+    {
+        TraceScope trace_scope("acquire_conns", cmd_compute.post_stripe_id, cmd_compute.post_block_id);
+        conn_pool.acquire(src_conn_ids, connectors);
+    }
 
-        cur_buffer_id++;
+    // create threads to retrieve data (one per remote source block); local
+    // source rings are filled by the disk thread
+    vector<BlockFileTransfer> disk_transfers;
+    vector<thread> data_request_threads;
+    vector<int> local_src_ids;
+    uint8_t conn_idx = 0;
+    for (int src_id = 0; src_id < k; src_id++)
+    {
+        if (cmd_compute.src_block_nodes[src_id] == self_conn_id)
+        {
+            disk_transfers.push_back(BlockFileTransfer(src_block_paths[src_id], &block_rings[src_id], false));
+            local_src_ids.push_back(src_id);
+            continue;
+        }
+        sockpp::tcp_connector **connector = &connectors[conn_idx++];
+        data_request_threads.push_back(thread(&ComputeWorker::requestDataFromAgent, this, &cmd_compute, src_id, src_block_paths[src_id], connector, is_incremental ? NULL : &block_rings[src_id], chunk_buffers[src_id]));
     }
 
-    printf("ComputeWorker::requestDataFromAgent finished retrieving %u blocks from Agent %u\n", cur_buffer_id, src_node_id);
-}
+    // read the local source blocks and write the parity blocks chunk by
+    // chunk, with the chunk I/Os in flight together
+    for (int parity_id = 0; parity_id < m; parity_id++)
+    {
+        disk_transfers.push_back(BlockFileTransfer(dst_block_paths[parity_id], &parity_rings[parity_id], true));
+    }
+    thread disk_thread([&]
+                       {
+                           Tracer::setThreadName("ComputeWorker disk");
+                           TraceScope trace_scope("disk_io", cmd_compute.post_stripe_id, cmd_compute.post_block_id);
+                           async_io->transferBlocks(disk_transfers, config.block_size); });
+
+    // encode chunk by chunk (incremental encoding is done by the data
+    // request threads as chunks arrive, and here for the local chunks as
+    // they are read)
+    uint64_t encode_time_us = 0;
+    uint64_t retrieved_time_us = 0;
+    if (is_incremental == false)
+    {
+        encodeByChunk(k, m, encode_gftbl, block_rings, encode_time_us, retrieved_time_us);
+    }
+    else
+    {
+        accumulateByChunk(local_src_ids, block_rings);
+    }
 
-void ComputeWorker::writeBlockToDisk(string block_path, unsigned char *data_buffer, uint64_t block_size)
-{
-    if (BlockIO::writeBlock(block_path, data_buffer, block_size) != block_size)
+    // join threads (the disk thread exits on I/O errors)
+    for (auto &data_request_thread : data_request_threads)
     {
-        fprintf(stderr, "error writing block: %s\n", block_path.c_str());
-        exit(EXIT_FAILURE);
+        data_request_thread.join();
+    }
+    if (is_incremental == true)
+    {
+        encode_time_us = parity_accumulator->encode_time_us;
+        retrieved_time_us = Utils::getTimeUs();
+    }
+    disk_thread.join();
+
+    // remote source blocks are received, and local source blocks (read) and
+    // parity blocks (written) go through the disk
+    num_net_bytes = src_conn_ids.size() * config.block_size;
+    num_disk_bytes = (k - src_conn_ids.size() + m) * config.block_size;
+    stage_time_us[STAGE_RETRIEVE] = retrieved_time_us - start_time_us;
+    stage_time_us[STAGE_ENCODE] = encode_time_us;
+    stage_time_us[STAGE_WRITE] = Utils::getTimeUs() - retrieved_time_us;
+
+    // return the connections and buffers
+    for (size_t idx = 0; idx < src_conn_ids.size(); idx++)
+    {
+        conn_pool.release(src_conn_ids[idx], connectors[idx]);
     }
 
-    memory_pool->freeBlock(data_buffer);
+    memory_pool.freeBlocks(task_buffers);
 }
 
-void ComputeWorker::parseBlockPaths(Command &cmd_compute, vector<string> &src_block_paths, vector<string> &dst_block_paths)
+void ComputeWorker::encodeByChunk(int k, int m, unsigned char *encode_gftbl, ChunkRing *rings, uint64_t &encode_time_us, uint64_t &retrieved_time_us)
 {
-    ConvertibleCode &code = config.code;
-
-    string delimiter_char = ":";
-    size_t pos = 0;
-    string token;
+    encode_time_us = 0;
+    vector<unsigned char *> chunk_buffers(k + m, NULL);
+    uint64_t offset = 0;
+    for (uint64_t chunk_id = 0; offset < config.block_size; chunk_id++)
+    {
+        uint64_t cur_chunk_size = min(config.chunk_size, config.block_size - offset);
 
-    string raw_src_block_path = cmd_compute.src_block_path;
-    string raw_dst_block_path = cmd_compute.dst_block_path;
+        // wait for the chunk of all source rings, and the free slots of parity rings
+        for (int data_id = 0; data_id < k; data_id++)
+        {
+            rings[data_id].waitFilledSlot(chunk_id);
+        }
+        for (int parity_id = 0; parity_id < m; parity_id++)
+        {
+            rings[k + parity_id].waitFreeSlot(chunk_id);
+        }
 
-    // process the paths
-    if (cmd_compute.enc_method == EncodeMethod::RE_ENCODE)
-    {
-        // src block paths
-        src_block_paths.resize(code.k_f);
-        pos = 0;
-        uint8_t data_block_id = 0;
-        while ((pos = raw_src_block_path.find(delimiter_char)) != std::string::npos)
+        // the source blocks are retrieved with their last chunks
+        uint64_t encode_start_time_us = Utils::getTimeUs();
+        if (offset + cur_chunk_size >= config.block_size)
         {
-            token = raw_src_block_path.substr(0, pos);
-            src_block_paths[data_block_id] = token;
-            raw_src_block_path.erase(0, pos + delimiter_char.length());
-            data_block_id++;
+            retrieved_time_us = encode_start_time_us;
         }
-        src_block_paths[code.k_f - 1] = raw_src_block_path;
 
-        // dst block paths
-        dst_block_paths.resize(code.m_f);
-        pos = 0;
-        uint8_t parity_id = 0;
+        for (int block_id = 0; block_id < k + m; block_id++)
+        {
+            chunk_buffers[block_id] = rings[block_id].getSlot(chunk_id);
+        }
+        ec_encode_data(cur_chunk_size, k, m, encode_gftbl, &chunk_buffers[0], &chunk_buffers[k]);
+        uint64_t encode_end_time_us = Utils::getTimeUs();
+        encode_time_us += encode_end_time_us - encode_start_time_us;
+        Tracer::record("encode_chunk", encode_start_time_us, encode_end_time_us);
 
-        while ((pos = raw_dst_block_path.find(delimiter_char)) != std::string::npos)
+        // drain the source slots, and the chunk of parity rings is ready to write
+        for (int data_id = 0; data_id < k; data_id++)
+        {
+            rings[data_id].setConsumed(chunk_id + 1);
+        }
+        for (int parity_id = 0; parity_id < m; parity_id++)
         {
-            token = raw_dst_block_path.substr(0, pos);
-            dst_block_paths[parity_id] = token;
-            raw_dst_block_path.erase(0, pos + delimiter_char.length());
-            parity_id++;
+            rings[k + parity_id].setProduced(chunk_id + 1);
         }
-        dst_block_paths[code.m_f - 1] = raw_dst_block_path;
+
+        offset += cur_chunk_size;
     }
-    else if (cmd_compute.enc_method == EncodeMethod::PARITY_MERGE)
+}
+
+void ComputeWorker::accumulateByChunk(vector<int> &src_ids, ChunkRing *rings)
+{
+    uint64_t offset = 0;
+    for (uint64_t chunk_id = 0; offset < config.block_size; chunk_id++)
     {
-        // src block paths
-        src_block_paths.resize(code.lambda_i);
-        pos = 0;
-        uint8_t pre_stripe_id = 0;
-        while ((pos = raw_src_block_path.find(delimiter_char)) != std::string::npos)
+        uint64_t cur_chunk_size = min(config.chunk_size, config.block_size - offset);
+
+        // accumulate the chunk of each local source ring, and drain its slot
+        // for the next read
+        for (int src_id : src_ids)
         {
-            token = raw_src_block_path.substr(0, pos);
-            src_block_paths[pre_stripe_id] = token;
-            raw_src_block_path.erase(0, pos + delimiter_char.length());
-            pre_stripe_id++;
+            ChunkRing &ring = rings[src_id];
+            ring.waitFilledSlot(chunk_id);
+            parity_accumulator->accumulate(src_id, offset, cur_chunk_size, ring.getSlot(chunk_id));
+            ring.setConsumed(chunk_id + 1);
         }
-        src_block_paths[code.lambda_i - 1] = raw_src_block_path;
 
-        // dst block paths
-        dst_block_paths.resize(1);
-        dst_block_paths[0] = raw_dst_block_path;
+        offset += cur_chunk_size;
+    }
+}
+
+void ComputeWorker::parseBlockPaths(Command &cmd_compute, vector<string> &src_block_paths, vector<string> &dst_block_paths)
+{
+    ConvertibleCode &code = config.code;
+
+    // process the paths
+    if (cmd_compute.enc_method == EncodeMethod::RE_ENCODE)
+    {
+        splitBlockPaths(cmd_compute, cmd_compute.src_block_path, code.k_f, src_block_paths);
+        splitBlockPaths(cmd_compute, cmd_compute.dst_block_path, code.m_f, dst_block_paths);
+    }
+    else if (cmd_compute.enc_method == EncodeMethod::PARITY_MERGE)
+    {
+        splitBlockPaths(cmd_compute, cmd_compute.src_block_path, code.lambda_i, src_block_paths);
+        splitBlockPaths(cmd_compute, cmd_compute.dst_block_path, 1, dst_block_paths);
+    }
+}
+
+void ComputeWorker::splitBlockPaths(Command &cmd_compute, CmdStrView &raw_block_paths, int num_paths, vector<string> &block_paths)
+{
+    // the paths are delimited by ':', and the last path takes the rest
+    const char *raw_ptr = (const char *)cmd_compute.getEncoded() + raw_block_paths.offset;
+    const char *raw_end = raw_ptr + raw_block_paths.len;
+
+    block_paths.resize(num_paths);
+    for (int path_id = 0; path_id < num_paths; path_id++)
+    {
+        const char *delimiter = (path_id < num_paths - 1) ? (const char *)memchr(raw_ptr, ':', raw_end - raw_ptr) : NULL;
+        const char *path_end = (delimiter != NULL) ? delimiter : raw_end;
+        block_paths[path_id].assign(raw_ptr, path_end - raw_ptr);
+        raw_ptr = (delimiter != NULL) ? delimiter + 1 : path_end;
     }
 }
 
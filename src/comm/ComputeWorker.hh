@@ -11,9 +11,15 @@
 #include "../util/MessageQueue.hh"
 #include "../util/MultiWriterQueue.h"
 #include "../util/MemoryPool.hh"
+#include "../util/Tracer.hh"
+#include "../util/Logger.hh"
 #include "Command.hh"
 #include "Node.hh"
 #include "BlockIO.hh"
+#include "AsyncBlockIO.hh"
+#include "BlockStore.hh"
+#include "ConnPool.hh"
+#include "ParityAccumulator.hh"
 
 class ComputeWorker : public ThreadPool
 {
@@ -35,6 +41,12 @@ public:
     // block relocation task queue: each retrieves block relocation task (from both CmdHandler and ComputeWorker), and pass to a RelocWorker (ComputerWorker / CmdHandler -> RelocWorker<worker_id>)
     unordered_map<unsigned int, MultiWriterQueue<Command> *> &reloc_task_queues;
 
+    // (optional) task completion reports to Controller (ComputeWorker -> CmdDist<CTRL_NODE_ID>)
+    MultiWriterQueue<Command> *report_queue;
+
+    // persistent connections to block request handlers of other nodes
+    ConnPool &conn_pool;
+
     // coding matrix
     unsigned char *re_matrix;
     unsigned char *re_encode_gftbl;
@@ -42,15 +54,22 @@ public:
     unsigned char **pm_matrix;
     unsigned char **pm_encode_gftbl;
 
-    // block buffers for re-encoding and parity merging
-    unsigned char *block_buffer;
-    unsigned char **re_buffers;
-    unsigned char **pm_buffers;
+    // agent-wide memory pool (chunk buffers are borrowed per task)
+    MemoryPool &memory_pool;
+
+    // chunk rings of the current task: k source blocks, followed by m parity blocks
+    ChunkRing *block_rings;
+
+    // parity accumulator for incremental encoding (replaces the source rings)
+    ParityAccumulator *parity_accumulator;
 
-    // memory pool
-    MemoryPool *memory_pool;
+    // destination of parity blocks
+    BlockStore &block_store;
 
-    ComputeWorker(Config &_config, unsigned int _self_worker_id, uint16_t _self_conn_id, MessageQueue<Command> &_compute_task_queue, unordered_map<unsigned int, MultiWriterQueue<Command> *> &_reloc_task_queues);
+    // asynchronous disk I/O engine (driven by the disk thread of a task)
+    AsyncBlockIO *async_io;
+
+    ComputeWorker(Config &_config, unsigned int _self_worker_id, uint16_t _self_conn_id, MessageQueue<Command> &_compute_task_queue, unordered_map<unsigned int, MultiWriterQueue<Command> *> &_reloc_task_queues, MultiWriterQueue<Command> *_report_queue, ConnPool &_conn_pool, MemoryPool &_memory_pool, BlockStore &_block_store);
     ~ComputeWorker();
 
     /**
@@ -59,15 +78,94 @@ public:
      */
     void run() override;
 
-    // data request thread
-    void requestDataFromAgent(Command *cmd_compute, uint16_t src_node_id, vector<unsigned char *> data_buffers);
+    /**
+     * @brief get the number of chunk buffers borrowed by a parity
+     * computation task: chunk rings of the source and parity blocks (with
+     * incremental encoding: one chunk per source block, and rings of the
+     * parity blocks)
+     *
+     * @param config
+     * @param k number of source blocks
+     * @param m number of parity blocks
+     * @return unsigned int
+     */
+    static unsigned int getTaskNumBuffers(Config &config, int k, int m);
 
-    // detach write
-    void writeBlockToDisk(string block_path, unsigned char *data_buffer, uint64_t block_size);
+    /**
+     * @brief retrieve a remote source block chunk by chunk (data request
+     * thread)
+     *
+     * @param cmd_compute
+     * @param src_id source block id
+     * @param src_block_path
+     * @param connector (in/out) connection to the source node (replaced by a
+     * new connection if the request cannot be sent)
+     * @param data_ring ring of the source block (not used for incremental encoding)
+     * @param chunk_buffer chunk buffer (for incremental encoding only)
+     */
+    void requestDataFromAgent(Command *cmd_compute, uint8_t src_id, string src_block_path, sockpp::tcp_connector **connector, ChunkRing *data_ring, unsigned char *chunk_buffer);
+
+    /**
+     * @brief retrieve the source blocks, encode the parity blocks and write
+     * them to disk, chunk by chunk: with incremental encoding, each retrieved
+     * chunk is accumulated into the parity blocks; otherwise, a chunk is
+     * encoded once it is retrieved in all source rings. The buffers of the
+     * task are borrowed from the memory pool, and the connections to the
+     * source nodes are acquired all at once (one per source block). Remote
+     * source blocks are received by one thread each, while the local source
+     * blocks (in rings) and the parity blocks are read / written by a single
+     * disk thread through the asynchronous I/O engine (with incremental
+     * encoding, the local source chunks are accumulated by the calling
+     * thread)
+     *
+     * @param cmd_compute
+     * @param k number of source blocks
+     * @param m number of parity blocks
+     * @param encode_gftbl
+     * @param src_block_paths source block paths (k)
+     * @param dst_block_paths parity block paths (m)
+     * @param num_net_bytes (out) Bytes received over the network
+     * @param num_disk_bytes (out) Bytes read / written on disk
+     * @param stage_time_us (out) time of the retrieve, encode and write stages
+     */
+    void retrieveAndEncode(Command &cmd_compute, int k, int m, unsigned char *encode_gftbl, vector<string> &src_block_paths, vector<string> &dst_block_paths, uint64_t &num_net_bytes, uint64_t &num_disk_bytes, uint32_t *stage_time_us);
+
+    /**
+     * @brief encode the parity rings chunk by chunk, once a chunk is
+     * retrieved in all source rings
+     *
+     * @param k number of source rings
+     * @param m number of parity rings
+     * @param encode_gftbl
+     * @param rings k source rings, followed by m parity rings
+     * @param encode_time_us (out) time spent in encoding
+     * @param retrieved_time_us (out) time all source chunks are retrieved
+     */
+    void encodeByChunk(int k, int m, unsigned char *encode_gftbl, ChunkRing *rings, uint64_t &encode_time_us, uint64_t &retrieved_time_us);
+
+    /**
+     * @brief accumulate the local source rings into the parity blocks chunk
+     * by chunk (incremental encoding), as the chunks are read
+     *
+     * @param src_ids ids of the local source blocks
+     * @param rings source rings (indexed by source block id)
+     */
+    void accumulateByChunk(vector<int> &src_ids, ChunkRing *rings);
 
     // parse block paths
     void parseBlockPaths(Command &cmd_compute, vector<string> &src_block_paths, vector<string> &dst_block_paths);
 
+    /**
+     * @brief split the ':'-delimited paths of a command (read from its
+     * encoded bytes directly)
+     *
+     * @param cmd_compute
+     * @param raw_block_paths view of the delimited paths in the command
+     * @param num_paths
+     * @param block_paths (out) num_paths paths
+     */
+    void splitBlockPaths(Command &cmd_compute, CmdStrView &raw_block_paths, int num_paths, vector<string> &block_paths);
+
     // erasure coding initializer
     void initECTables();
     void destroyECTables();
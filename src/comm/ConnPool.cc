@@ -0,0 +1,189 @@
+#include "ConnPool.hh"
+
+ConnPool::ConnPool(Config &_config, uint16_t _self_conn_id, unsigned int _max_conns_per_peer) : config(_config), self_conn_id(_self_conn_id), max_conns_per_peer(_max_conns_per_peer)
+{
+    if (max_conns_per_peer == 0)
+    {
+        max_conns_per_peer = 1;
+    }
+
+    for (auto &item : config.agent_addr_map)
+    {
+        uint16_t conn_id = item.first;
+        if (conn_id != self_conn_id)
+        {
+            peer_conns_map[conn_id] = new PeerConns();
+        }
+    }
+}
+
+ConnPool::~ConnPool()
+{
+    closeAll();
+
+    for (auto &item : peer_conns_map)
+    {
+        delete item.second;
+    }
+}
+
+sockpp::tcp_connector *ConnPool::connect(uint16_t dst_conn_id)
+{
+    // create connection to the block request handler
+    string block_req_ip = config.agent_addr_map[dst_conn_id].first;
+    unsigned int block_req_port = config.agent_addr_map[dst_conn_id].second + config.settings.num_nodes; // DEBUG
+
+    // connect (retry until the peer is up)
+    TraceScope trace_scope("connect");
+    sockpp::tcp_connector *connector = new sockpp::tcp_connector();
+    unsigned int num_retries = 0;
+    while (!(*connector = sockpp::tcp_connector(sockpp::inet_address(block_req_ip, block_req_port))))
+    {
+        if (++num_retries > CONN_MAX_RETRIES)
+        {
+            LOG_ERROR("ConnPool::connect error: failed to connect to BlockReqHandler %u (%s:%u) after %u retries: %s", dst_conn_id, block_req_ip.c_str(), block_req_port, CONN_MAX_RETRIES, connector->last_error_str().c_str());
+            exit(EXIT_FAILURE);
+        }
+        this_thread::sleep_for(chrono::milliseconds(CONN_RETRY_INTERVAL_MS));
+    }
+
+    if (num_retries > 0)
+    {
+        LOG_DEBUG("[Node %u] ConnPool::connect connected to BlockReqHandler %u after %u retries", self_conn_id, dst_conn_id, num_retries);
+    }
+
+    int on = 1;
+    connector->set_option(SOL_SOCKET, SO_KEEPALIVE, &on);
+
+    LOG_DEBUG("[Node %u] ConnPool::connect created connection to BlockReqHandler %u", self_conn_id, dst_conn_id);
+
+    return connector;
+}
+
+sockpp::tcp_connector *ConnPool::acquire(uint16_t dst_conn_id)
+{
+    vector<uint16_t> dst_conn_ids(1, dst_conn_id);
+    vector<sockpp::tcp_connector *> connectors;
+    acquire(dst_conn_ids, connectors);
+
+    return connectors[0];
+}
+
+void ConnPool::acquire(vector<uint16_t> &dst_conn_ids, vector<sockpp::tcp_connector *> &connectors)
+{
+    // number of connections to each peer
+    unordered_map<uint16_t, unsigned int> num_req_conns_map;
+    for (auto dst_conn_id : dst_conn_ids)
+    {
+        if (peer_conns_map.find(dst_conn_id) == peer_conns_map.end())
+        {
+            LOG_ERROR("ConnPool::acquire error: invalid dst_conn_id: %u", dst_conn_id);
+            exit(EXIT_FAILURE);
+        }
+        if (++num_req_conns_map[dst_conn_id] > max_conns_per_peer)
+        {
+            LOG_ERROR("ConnPool::acquire error: more than %u connections to BlockReqHandler %u are requested", max_conns_per_peer, dst_conn_id);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    unique_lock<mutex> lck(pool_mtx);
+    pool_cv.wait(lck, [&]
+                 {
+                     for (auto &item : num_req_conns_map)
+                     {
+                         PeerConns &peer_conns = *peer_conns_map[item.first];
+                         if (peer_conns.idle_conns.size() + max_conns_per_peer - peer_conns.num_conns < item.second)
+                         {
+                             return false;
+                         }
+                     }
+                     return true; });
+
+    // reuse warm connections, and reserve new connections for the rest
+    connectors.assign(dst_conn_ids.size(), NULL);
+    for (size_t idx = 0; idx < dst_conn_ids.size(); idx++)
+    {
+        PeerConns &peer_conns = *peer_conns_map[dst_conn_ids[idx]];
+        if (peer_conns.idle_conns.empty() == false)
+        {
+            connectors[idx] = peer_conns.idle_conns.back();
+            peer_conns.idle_conns.pop_back();
+        }
+        else
+        {
+            peer_conns.num_conns++;
+        }
+    }
+
+    // open the new connections (outside the lock)
+    lck.unlock();
+
+    for (size_t idx = 0; idx < dst_conn_ids.size(); idx++)
+    {
+        if (connectors[idx] == NULL)
+        {
+            connectors[idx] = connect(dst_conn_ids[idx]);
+        }
+    }
+}
+
+void ConnPool::release(uint16_t dst_conn_id, sockpp::tcp_connector *connector)
+{
+    PeerConns &peer_conns = *peer_conns_map[dst_conn_id];
+
+    unique_lock<mutex> lck(pool_mtx);
+    peer_conns.idle_conns.push_back(connector);
+    lck.unlock();
+
+    pool_cv.notify_all();
+}
+
+void ConnPool::discard(uint16_t dst_conn_id, sockpp::tcp_connector *connector)
+{
+    PeerConns &peer_conns = *peer_conns_map[dst_conn_id];
+
+    connector->close();
+    delete connector;
+
+    LOG_WARN("[Node %u] ConnPool::discard dropped a failed connection to BlockReqHandler %u", self_conn_id, dst_conn_id);
+
+    unique_lock<mutex> lck(pool_mtx);
+    peer_conns.num_conns--;
+    lck.unlock();
+
+    pool_cv.notify_all();
+}
+
+sockpp::tcp_connector *ConnPool::reconnect(uint16_t dst_conn_id, sockpp::tcp_connector *connector)
+{
+    connector->close();
+    delete connector;
+
+    LOG_WARN("[Node %u] ConnPool::reconnect reconnecting a failed connection to BlockReqHandler %u", self_conn_id, dst_conn_id);
+
+    return connect(dst_conn_id);
+}
+
+void ConnPool::closeAll()
+{
+    unique_lock<mutex> lck(pool_mtx);
+    for (auto &item : peer_conns_map)
+    {
+        PeerConns &peer_conns = *item.second;
+
+        if (peer_conns.idle_conns.size() != peer_conns.num_conns)
+        {
+            LOG_ERROR("ConnPool::closeAll error: %lu connections to BlockReqHandler %u are in use", peer_conns.num_conns - peer_conns.idle_conns.size(), item.first);
+            exit(EXIT_FAILURE);
+        }
+
+        for (auto connector : peer_conns.idle_conns)
+        {
+            connector->close();
+            delete connector;
+        }
+        peer_conns.idle_conns.clear();
+        peer_conns.num_conns = 0;
+    }
+}
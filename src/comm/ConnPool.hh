@@ -0,0 +1,127 @@
+#ifndef __CONN_POOL_HH__
+#define __CONN_POOL_HH__
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <sys/socket.h>
+
+#include "sockpp/tcp_connector.h"
+
+#include "../include/include.hh"
+#include "../util/Config.hh"
+#include "../util/Tracer.hh"
+#include "../util/Logger.hh"
+
+#define CONN_RETRY_INTERVAL_MS 1      // interval between connection attempts
+#define CONN_MAX_RETRIES 10000        // give up connecting to a peer after the retries (about 10 seconds)
+#define CONN_MAX_TRANSFER_RETRIES 3   // number of times a failed transfer is retried on a new connection
+
+/**
+ * @brief connections to the block request handler of a peer
+ */
+typedef struct PeerConns
+{
+    vector<sockpp::tcp_connector *> idle_conns; // warm connections
+    unsigned int num_conns;                     // number of opened connections (idle and in-use)
+
+    PeerConns() : num_conns(0) {}
+} PeerConns;
+
+/**
+ * @brief per-agent pool of persistent connections to the block request
+ * handlers of peers. A connection carries a sequence of requests (framed
+ * command, followed by the block), and is returned to the pool
+ * after each transfer; at most max_conns_per_peer connections are opened to
+ * each peer, and further requests wait for an idle connection. The
+ * connections of a task are acquired all at once, so tasks never hold some
+ * connections while waiting for others
+ */
+class ConnPool
+{
+private:
+    /**
+     * @brief connect to the block request handler of the peer (retry until
+     * the peer is up, and give up after CONN_MAX_RETRIES retries)
+     *
+     * @param dst_conn_id
+     * @return sockpp::tcp_connector*
+     */
+    sockpp::tcp_connector *connect(uint16_t dst_conn_id);
+
+    mutex pool_mtx;
+    condition_variable pool_cv;
+
+public:
+    // config
+    Config &config;
+
+    // current connection id
+    uint16_t self_conn_id;
+
+    // maximum number of connections to each peer
+    unsigned int max_conns_per_peer;
+
+    // <conn_id, connections>
+    unordered_map<uint16_t, PeerConns *> peer_conns_map;
+
+    ConnPool(Config &_config, uint16_t _self_conn_id, unsigned int _max_conns_per_peer);
+    ~ConnPool();
+
+    /**
+     * @brief acquire a connection to the peer (reuse an idle connection,
+     * open a new one, or wait until a connection is released)
+     *
+     * @param dst_conn_id
+     * @return sockpp::tcp_connector*
+     */
+    sockpp::tcp_connector *acquire(uint16_t dst_conn_id);
+
+    /**
+     * @brief acquire connections to peers all at once (wait until all of
+     * them are available)
+     *
+     * @param dst_conn_ids one connection per entry (a peer can appear
+     * multiple times)
+     * @param connectors (out) connections, in the order of dst_conn_ids
+     */
+    void acquire(vector<uint16_t> &dst_conn_ids, vector<sockpp::tcp_connector *> &connectors);
+
+    /**
+     * @brief return the connection to the pool
+     *
+     * @param dst_conn_id
+     * @param connector
+     */
+    void release(uint16_t dst_conn_id, sockpp::tcp_connector *connector);
+
+    /**
+     * @brief close and drop a connection that failed mid-transfer (instead of
+     * returning it to the pool); a new connection is opened by the next
+     * acquire
+     *
+     * @param dst_conn_id
+     * @param connector
+     */
+    void discard(uint16_t dst_conn_id, sockpp::tcp_connector *connector);
+
+    /**
+     * @brief replace a connection that failed mid-transfer with a new
+     * connection to the same peer (the slot of the connection is kept)
+     *
+     * @param dst_conn_id
+     * @param connector
+     * @return sockpp::tcp_connector* new connection
+     */
+    sockpp::tcp_connector *reconnect(uint16_t dst_conn_id, sockpp::tcp_connector *connector);
+
+    /**
+     * @brief close all idle connections (all connections should have been
+     * released); the block request handlers of peers will see the connections
+     * closed
+     *
+     */
+    void closeAll();
+};
+
+#endif // __CONN_POOL_HH__
@@ -1,19 +1,22 @@
 #include "CtrlNode.hh"
 
-CtrlNode::CtrlNode(uint16_t _self_conn_id, Config &_config) : Node(_self_conn_id, _config)
+CtrlNode::CtrlNode(uint16_t _self_conn_id, Config &_config) : Node(_self_conn_id, _config), bw_limit_mtime_ns(-1), last_bw_limit_check_us(0)
 {
     // create command distribution queues
     for (auto &item : connectors_map)
     {
         uint16_t conn_id = item.first;
-        cmd_dist_queues[conn_id] = new MessageQueue<Command>(MAX_MSG_QUEUE_LEN);
+        cmd_dist_queues[conn_id] = new MultiWriterQueue<Command>(MAX_MSG_QUEUE_LEN);
     }
 
     // create command distributor
     cmd_distributor = new CmdDist(config, self_conn_id, connectors_map, cmd_dist_queues);
 
+    // create task report queue
+    report_queue = new MultiWriterQueue<Command>(MAX_MSG_QUEUE_LEN);
+
     // create command handler
-    cmd_handler = new CmdHandler(config, self_conn_id, sockets_map, NULL, NULL, NULL);
+    cmd_handler = new CmdHandler(config, self_conn_id, sockets_map, NULL, NULL, NULL, report_queue);
 }
 
 CtrlNode::~CtrlNode()
@@ -24,6 +27,9 @@ CtrlNode::~CtrlNode()
     // delete command handler
     delete cmd_handler;
 
+    // delete task report queue
+    delete report_queue;
+
     // delete command distribution queues
     for (auto &item : connectors_map)
     {
@@ -68,51 +74,144 @@ void CtrlNode::genTransSolution()
     // block mapping file for post-stripes
     vector<vector<pair<uint16_t, string>>> post_block_mapping;
 
-    // load pre-stripe placement and block mapping
-    generator.loadStripes(code.n_i, config.pre_placement_filename, stripe_batch.pre_stripes);
-    generator.loadBlockMapping(code.n_i, settings.num_stripes, config.pre_block_mapping_filename, pre_block_mapping);
+    // binary plan file (the stripes are views into the mapped placements,
+    // so it stays mapped while the stripe batch is in use)
+    PlanFile plan_file;
+
+    if (config.plan_filename.empty() == false)
+    {
+        // map the binary plan file
+        if (plan_file.open(config.plan_filename, code, settings) == false)
+        {
+            LOG_ERROR("error: failed to load plan file %s", config.plan_filename.c_str());
+            exit(EXIT_FAILURE);
+        }
+
+        // check the plan against the text metadata (if available): a plan
+        // generated in another run is refused
+        vector<string> meta_filenames = {config.pre_placement_filename, config.post_placement_filename, config.sg_meta_filename};
+        if (plan_file.hasSection(PlanSectionType::PRE_BLOCK_MAPPING) == true)
+        {
+            meta_filenames.push_back(config.pre_block_mapping_filename);
+        }
+        uint64_t meta_stamp = 0;
+        if (PlanFile::stampFiles(meta_filenames, meta_stamp) == false)
+        {
+            LOG_WARN("text metadata is not available, use plan file %s without checking it", config.plan_filename.c_str());
+        }
+        else if (plan_file.isMetaMatched(meta_stamp) == false)
+        {
+            LOG_ERROR("error: plan file %s doesn't match the text metadata (generated in another run, or the metadata is modified?)", config.plan_filename.c_str());
+            exit(EXIT_FAILURE);
+        }
+
+        // bind pre-stripes and post-stripes to the mapped placements
+        if (plan_file.bindStripes(PlanSectionType::PRE_PLACEMENT, code.n_i, stripe_batch.pre_stripes) == false || plan_file.bindStripes(PlanSectionType::POST_PLACEMENT, code.n_f, stripe_batch.post_stripes) == false)
+        {
+            LOG_ERROR("error: failed to load placements from plan file %s", config.plan_filename.c_str());
+            exit(EXIT_FAILURE);
+        }
 
-    // load post-stripe placement and block mapping
-    generator.loadStripes(code.n_f, config.post_placement_filename, stripe_batch.post_stripes);
-    generator.loadBlockMapping(code.n_f, settings.num_stripes / code.lambda_i, config.post_block_mapping_filename, post_block_mapping);
+        // load block mappings (fall back to the text block mapping files if
+        // they are not stored in the plan file, or are corrupted)
+        if (plan_file.loadBlockMapping(PlanSectionType::PRE_BLOCK_MAPPING, code.n_i, settings.num_stripes, pre_block_mapping) == false)
+        {
+            generator.loadBlockMapping(code.n_i, settings.num_stripes, config.pre_block_mapping_filename, pre_block_mapping);
+        }
+        if (plan_file.loadBlockMapping(PlanSectionType::POST_BLOCK_MAPPING, code.n_f, settings.num_stripes / code.lambda_i, post_block_mapping) == false)
+        {
+            generator.loadBlockMapping(code.n_f, settings.num_stripes / code.lambda_i, config.post_block_mapping_filename, post_block_mapping);
+        }
 
-    // load stripe group metadata
-    stripe_batch.loadSGMetadata(config.sg_meta_filename);
+        // load stripe group metadata
+        if (plan_file.loadSGMetadata(stripe_batch) == false)
+        {
+            LOG_ERROR("error: failed to load stripe group metadata from plan file %s", config.plan_filename.c_str());
+            exit(EXIT_FAILURE);
+        }
+    }
+    else
+    {
+        // load pre-stripe placement and block mapping
+        generator.loadStripes(code.n_i, config.pre_placement_filename, stripe_batch.pre_stripes);
+        generator.loadBlockMapping(code.n_i, settings.num_stripes, config.pre_block_mapping_filename, pre_block_mapping);
+
+        // load post-stripe placement and block mapping
+        generator.loadStripes(code.n_f, config.post_placement_filename, stripe_batch.post_stripes);
+        generator.loadBlockMapping(code.n_f, settings.num_stripes / code.lambda_i, config.post_block_mapping_filename, post_block_mapping);
+
+        // load stripe group metadata
+        stripe_batch.loadSGMetadata(config.sg_meta_filename);
+    }
     // stripe_batch.print();
 
     // build transition tasks
     trans_solution.buildTransTasks(stripe_batch);
-    trans_solution.print();
+    if (LOG_IS_ENABLED(LOG_LEVEL_DEBUG))
+    {
+        trans_solution.print();
+    }
 
     vector<Command> commands;
 
     // // generate transition commands
+    uint64_t gen_start_time_us = Utils::getTimeUs();
     genCommands(stripe_batch, trans_solution, pre_block_mapping, post_block_mapping, commands);
+    Tracer::record("gen_commands", gen_start_time_us, Utils::getTimeUs());
     // genSampleCommands(commands);
 
-    // generate stop commands
-    for (auto &item : connectors_map)
+    // print commands (debug only: a few lines per command)
+    if (LOG_IS_ENABLED(LOG_LEVEL_DEBUG))
     {
-        uint16_t dst_conn_id = item.first;
+        LOG_DEBUG("Generated Commands:");
+        for (auto &command : commands)
+        {
+            command.print();
+        }
+    }
 
-        Command cmd_disconnect;
-        cmd_disconnect.buildCommand(CommandType::CMD_STOP, self_conn_id, dst_conn_id);
+    // track the progress with the task completion reports
+    ProgressTracker progress_tracker(commands);
+    progress_tracker.start();
 
-        commands.push_back(cmd_disconnect);
-    }
+    // send the bandwidth limits before the tasks (and when they change)
+    checkBWLimits();
+    uint64_t dispatch_start_time_us = Utils::getTimeUs();
 
-    // print commands
-    printf("Generated Commands:\n");
-    for (auto &command : commands)
+    if (config.dispatch_mode == DispatchMode::DISPATCH_PULL)
+    {
+        dispatchCommands(commands, progress_tracker);
+        waitForTasks(progress_tracker);
+    }
+    else
     {
-        command.print();
+        // push all commands in another thread, so the reports are collected
+        // meanwhile (otherwise, the queued-up reports block the Agents)
+        thread push_thread([&]
+                           {
+                               for (auto &command : commands)
+                               {
+                                   // command.print();
+                                   cmd_dist_queues[command.dst_conn_id]->Push(command);
+                               } });
+        waitForTasks(progress_tracker);
+        push_thread.join();
     }
-    printf("\n\n");
 
-    for (auto &command : commands)
+    Tracer::record("dispatch", dispatch_start_time_us, Utils::getTimeUs());
+
+    progress_tracker.printProgress();
+    progress_tracker.printSummary();
+
+    // distribute stop commands
+    for (auto &item : connectors_map)
     {
-        // command.print();
-        cmd_dist_queues[command.dst_conn_id]->Push(command);
+        uint16_t dst_conn_id = item.first;
+
+        Command cmd_disconnect;
+        cmd_disconnect.buildCommand(CommandType::CMD_STOP, self_conn_id, dst_conn_id);
+
+        cmd_dist_queues[dst_conn_id]->Push(cmd_disconnect);
     }
 }
 
@@ -336,5 +435,298 @@ void CtrlNode::genCommands(StripeBatch &stripe_batch, TransSolution &trans_solut
         }
     }
 
-    printf("generated %lu commands\n", commands.size());
+    LOG_INFO("generated %lu commands", commands.size());
+}
+
+void CtrlNode::orderStripeGroups(vector<Command> &commands, vector<vector<Command *>> &sg_cmds)
+{
+    // group the commands by stripe group
+    unordered_map<uint32_t, size_t> sg_idx_map;
+    vector<uint32_t> sg_ids;
+    vector<vector<Command *>> grouped_cmds;
+    for (auto &cmd : commands)
+    {
+        auto it = sg_idx_map.find(cmd.post_stripe_id);
+        if (it == sg_idx_map.end())
+        {
+            it = sg_idx_map.insert(pair<uint32_t, size_t>(cmd.post_stripe_id, grouped_cmds.size())).first;
+            sg_ids.push_back(cmd.post_stripe_id);
+            grouped_cmds.push_back(vector<Command *>());
+        }
+        grouped_cmds[it->second].push_back(&cmd);
+    }
+
+    // block transfers of each stripe group on each node: a block read or
+    // sent counts at the source node, and a block received or written
+    // counts at the destination node
+    size_t num_sgs = grouped_cmds.size();
+    vector<unordered_map<uint16_t, uint64_t>> sg_node_loads(num_sgs);
+    for (size_t sg_idx = 0; sg_idx < num_sgs; sg_idx++)
+    {
+        auto &node_loads = sg_node_loads[sg_idx];
+        for (auto cmd : grouped_cmds[sg_idx])
+        {
+            if (cmd->type == CommandType::CMD_COMPUTE_RE_BLK || cmd->type == CommandType::CMD_COMPUTE_PM_BLK)
+            {
+                uint16_t compute_node_id = cmd->dst_conn_id;
+                for (auto src_node_id : cmd->src_block_nodes)
+                {
+                    node_loads[src_node_id]++;
+                    if (src_node_id != compute_node_id)
+                    {
+                        node_loads[compute_node_id]++;
+                    }
+                }
+                for (auto reloc_node_id : cmd->parity_reloc_nodes)
+                {
+                    node_loads[compute_node_id]++;
+                    if (reloc_node_id != compute_node_id)
+                    {
+                        node_loads[reloc_node_id]++;
+                    }
+                }
+            }
+            else if (cmd->type == CommandType::CMD_TRANSFER_RELOC_BLK)
+            {
+                node_loads[cmd->src_node_id]++;
+                node_loads[cmd->dst_node_id]++;
+            }
+        }
+    }
+
+    // total block transfers of each node
+    unordered_map<uint16_t, uint64_t> node_loads;
+    for (auto &sg_loads : sg_node_loads)
+    {
+        for (auto &item : sg_loads)
+        {
+            node_loads[item.first] += item.second;
+        }
+    }
+
+    // priority of a stripe group: <load of its most loaded node, its own
+    // block transfers>
+    vector<pair<uint64_t, uint64_t>> sg_priorities(num_sgs, pair<uint64_t, uint64_t>(0, 0));
+    for (size_t sg_idx = 0; sg_idx < num_sgs; sg_idx++)
+    {
+        for (auto &item : sg_node_loads[sg_idx])
+        {
+            sg_priorities[sg_idx].first = max(sg_priorities[sg_idx].first, node_loads[item.first]);
+            sg_priorities[sg_idx].second += item.second;
+        }
+    }
+
+    vector<size_t> sg_order(num_sgs);
+    for (size_t sg_idx = 0; sg_idx < num_sgs; sg_idx++)
+    {
+        sg_order[sg_idx] = sg_idx;
+    }
+    stable_sort(sg_order.begin(), sg_order.end(), [&](size_t lhs, size_t rhs)
+                { return sg_priorities[lhs] > sg_priorities[rhs]; });
+
+    sg_cmds.clear();
+    sg_cmds.reserve(num_sgs);
+    for (auto sg_idx : sg_order)
+    {
+        sg_cmds.push_back(grouped_cmds[sg_idx]);
+    }
+}
+
+void CtrlNode::dispatchCommands(vector<Command> &commands, ProgressTracker &progress_tracker)
+{
+    vector<vector<Command *>> sg_cmds;
+    orderStripeGroups(commands, sg_cmds);
+
+    LOG_INFO("CtrlNode::dispatchCommands start to dispatch %lu stripe groups (%lu commands) on demand", sg_cmds.size(), commands.size());
+
+    // worker slots of each Agent: compute tasks and relocation (other) tasks
+    unsigned int compute_slots = config.num_compute_workers * config.dispatch_tasks_per_worker;
+    unsigned int reloc_slots = config.num_reloc_workers * config.dispatch_tasks_per_worker;
+    unordered_map<uint16_t, unsigned int> num_compute_tasks; // dispatched but unfinished compute tasks of each Agent
+    unordered_map<uint16_t, unsigned int> num_reloc_tasks;   // dispatched but unfinished relocation tasks of each Agent
+
+    list<size_t> pending_sgs;
+    for (size_t sg_idx = 0; sg_idx < sg_cmds.size(); sg_idx++)
+    {
+        pending_sgs.push_back(sg_idx);
+    }
+
+    uint64_t num_inflight_tasks = 0;
+    while (pending_sgs.empty() == false || num_inflight_tasks > 0)
+    {
+        // hand out the pending stripe groups (in order) whose Agents have
+        // free slots; with nothing in flight, the first one is handed out
+        // regardless, so a stripe group larger than the slots still runs
+        unsigned int num_scanned_sgs = 0;
+        for (auto it = pending_sgs.begin(); it != pending_sgs.end() && num_scanned_sgs < DISPATCH_SCAN_WINDOW;)
+        {
+            auto &cmds = sg_cmds[*it];
+
+            bool is_free = true;
+            for (auto cmd : cmds)
+            {
+                bool is_compute = (cmd->type == CommandType::CMD_COMPUTE_RE_BLK || cmd->type == CommandType::CMD_COMPUTE_PM_BLK);
+                if ((is_compute == true && num_compute_tasks[cmd->dst_conn_id] >= compute_slots) || (is_compute == false && num_reloc_tasks[cmd->dst_conn_id] >= reloc_slots))
+                {
+                    is_free = false;
+                    break;
+                }
+            }
+
+            if (is_free == false && num_inflight_tasks > 0)
+            {
+                it++;
+                num_scanned_sgs++;
+                continue;
+            }
+
+            for (auto cmd : cmds)
+            {
+                bool is_compute = (cmd->type == CommandType::CMD_COMPUTE_RE_BLK || cmd->type == CommandType::CMD_COMPUTE_PM_BLK);
+                if (is_compute == true)
+                {
+                    num_compute_tasks[cmd->dst_conn_id]++;
+                }
+                else
+                {
+                    num_reloc_tasks[cmd->dst_conn_id]++;
+                }
+                cmd_dist_queues[cmd->dst_conn_id]->Push(*cmd);
+                num_inflight_tasks++;
+            }
+            it = pending_sgs.erase(it);
+        }
+
+        if (num_inflight_tasks == 0)
+        {
+            continue;
+        }
+
+        // wait for a finished task, and collect the other reported ones
+        // (print the progress meanwhile)
+        Command cmd_done;
+        if (report_queue->WaitPop(cmd_done, PROGRESS_PRINT_INTERVAL_US) == false)
+        {
+            progress_tracker.tick();
+            checkBWLimits();
+            continue;
+        }
+        do
+        {
+            progress_tracker.update(cmd_done);
+
+            if (cmd_done.task_type == CommandType::CMD_COMPUTE_RE_BLK || cmd_done.task_type == CommandType::CMD_COMPUTE_PM_BLK)
+            {
+                num_compute_tasks[cmd_done.src_conn_id]--;
+                num_inflight_tasks--;
+            }
+            else if (cmd_done.task_type != CommandType::CMD_TRANSFER_RELOC_BLK || cmd_done.post_block_id < config.code.k_f)
+            { // parity block relocations are not dispatched (created by ComputeWorker)
+                num_reloc_tasks[cmd_done.src_conn_id]--;
+                num_inflight_tasks--;
+            }
+        } while (report_queue->Pop(cmd_done) == true);
+        progress_tracker.tick();
+        checkBWLimits();
+    }
+
+    LOG_INFO("CtrlNode::dispatchCommands finished dispatching %lu stripe groups", sg_cmds.size());
+}
+
+void CtrlNode::waitForTasks(ProgressTracker &progress_tracker)
+{
+    Command cmd_done;
+    while (progress_tracker.isFinished() == false)
+    {
+        if (report_queue->WaitPop(cmd_done, PROGRESS_PRINT_INTERVAL_US) == true)
+        {
+            progress_tracker.update(cmd_done);
+        }
+        progress_tracker.tick();
+        checkBWLimits();
+    }
+}
+
+void CtrlNode::checkBWLimits()
+{
+    if (config.bw_limit_filename.empty() == true)
+    {
+        return;
+    }
+
+    uint64_t cur_time_us = Utils::getTimeUs();
+    if (last_bw_limit_check_us != 0 && cur_time_us - last_bw_limit_check_us < BW_LIMIT_CHECK_INTERVAL_US)
+    {
+        return;
+    }
+    last_bw_limit_check_us = cur_time_us;
+
+    struct stat file_stat;
+    if (stat(config.bw_limit_filename.c_str(), &file_stat) != 0)
+    {
+        return;
+    }
+    int64_t mtime_ns = (int64_t)file_stat.st_mtim.tv_sec * 1000000000 + file_stat.st_mtim.tv_nsec;
+    if (mtime_ns == bw_limit_mtime_ns)
+    {
+        return;
+    }
+
+    map<uint16_t, pair<uint64_t, uint64_t>> bw_limits;
+    if (loadBWLimits(config.bw_limit_filename, bw_limits) == false)
+    { // retry on the next change
+        bw_limit_mtime_ns = mtime_ns;
+        return;
+    }
+    bw_limit_mtime_ns = mtime_ns;
+
+    for (auto &item : bw_limits)
+    {
+        uint16_t agent_id = item.first;
+        if (cmd_dist_queues.find(agent_id) == cmd_dist_queues.end())
+        {
+            LOG_WARN("CtrlNode::checkBWLimits unknown Agent %u in %s", agent_id, config.bw_limit_filename.c_str());
+            continue;
+        }
+
+        Command cmd_bw_limit;
+        cmd_bw_limit.buildCommand(CommandType::CMD_SET_BW_LIMIT, self_conn_id, agent_id, item.second.first, item.second.second);
+        cmd_dist_queues[agent_id]->Push(cmd_bw_limit);
+
+        LOG_INFO("CtrlNode::checkBWLimits Agent %u bandwidth limits (send, recv): (%lu, %lu) Bytes/s", agent_id, item.second.first, item.second.second);
+    }
+}
+
+bool CtrlNode::loadBWLimits(string bw_limit_filename, map<uint16_t, pair<uint64_t, uint64_t>> &bw_limits)
+{
+    ifstream ifs(bw_limit_filename.c_str());
+    if (ifs.fail())
+    {
+        LOG_WARN("CtrlNode::loadBWLimits failed to open file %s", bw_limit_filename.c_str());
+        return false;
+    }
+
+    string line;
+    unsigned int line_id = 0;
+    while (getline(ifs, line))
+    {
+        line_id++;
+        size_t pos = line.find_first_not_of(" \t\r");
+        if (pos == string::npos || line[pos] == '#')
+        {
+            continue;
+        }
+
+        istringstream iss(line);
+        unsigned int agent_id;
+        uint64_t send_bw_limit, recv_bw_limit;
+        if (!(iss >> agent_id >> send_bw_limit >> recv_bw_limit))
+        {
+            LOG_WARN("CtrlNode::loadBWLimits invalid line %u in %s: %s", line_id, bw_limit_filename.c_str(), line.c_str());
+            return false;
+        }
+        bw_limits[agent_id] = pair<uint64_t, uint64_t>(send_bw_limit, recv_bw_limit);
+    }
+
+    return true;
 }
\ No newline at end of file
@@ -6,20 +6,32 @@
 #include "Node.hh"
 #include "CmdHandler.hh"
 #include "CmdDist.hh"
+#include "ProgressTracker.hh"
 #include "../util/MessageQueue.hh"
+#include "../util/MultiWriterQueue.h"
 #include "../util/StripeGenerator.hh"
+#include "../util/Logger.hh"
 #include "../model/TransSolution.hh"
 #include "../model/RandomSolution.hh"
 #include "../model/BWOptSolution.hh"
 #include "../model/BART.hh"
+#include "../model/PlanFile.hh"
+
+#include <list>
+#include <sys/stat.h>
+
+#define DISPATCH_SCAN_WINDOW 64          // maximum number of pending stripe groups checked for free slots at a time (pull dispatch)
+#define BW_LIMIT_CHECK_INTERVAL_US 1000000 // interval of checking the bandwidth limit file for changes
 
 class CtrlNode : public Node
 {
 private:
-    /* data */
+    int64_t bw_limit_mtime_ns;       // modification time of the loaded bandwidth limit file (-1: not loaded)
+    uint64_t last_bw_limit_check_us; // time of the last check of the bandwidth limit file
+
 public:
     // command distribution queues: each retrieves command from CmdHandler and distributes commands to the corresponding CmdDist (CmdHandler<conn_id> -> CmdDist<conn_id>)
-    unordered_map<uint16_t, MessageQueue<Command> *> cmd_dist_queues;
+    unordered_map<uint16_t, MultiWriterQueue<Command> *> cmd_dist_queues;
 
     // distribute commands
     CmdDist *cmd_distributor;
@@ -27,6 +39,9 @@ public:
     // handler commands
     CmdHandler *cmd_handler;
 
+    // task completion reports from Agents (CmdHandler -> dispatch and progress tracking)
+    MultiWriterQueue<Command> *report_queue;
+
     CtrlNode(uint16_t _self_conn_id, Config &_config);
     ~CtrlNode();
 
@@ -35,6 +50,55 @@ public:
 
     void genTransSolution();
     void genCommands(StripeBatch &stripe_batch, TransSolution &trans_solution, vector<vector<pair<uint16_t, string>>> &pre_block_mapping, vector<vector<pair<uint16_t, string>>> &post_block_mapping, vector<Command> &commands);
+
+    /**
+     * @brief order the stripe groups critical path first: the stripe groups
+     * touching the nodes with the most block transfers (sent or received)
+     * come first, so the busiest nodes are kept busy from the start
+     *
+     * @param commands
+     * @param sg_cmds commands of each stripe group (in the returned order)
+     */
+    void orderStripeGroups(vector<Command> &commands, vector<vector<Command *>> &sg_cmds);
+
+    /**
+     * @brief dispatch the commands on demand (DISPATCH_PULL): stripe groups
+     * are handed out in order while the Agents they run on have free worker
+     * slots, and slots are freed as the Agents report finished tasks
+     *
+     * @param commands
+     * @param progress_tracker updated with the reported tasks
+     */
+    void dispatchCommands(vector<Command> &commands, ProgressTracker &progress_tracker);
+
+    /**
+     * @brief wait until all tasks are reported, and print the progress
+     * meanwhile
+     *
+     * @param progress_tracker
+     */
+    void waitForTasks(ProgressTracker &progress_tracker);
+
+    /**
+     * @brief check the bandwidth limit file (every BW_LIMIT_CHECK_INTERVAL_US),
+     * and send the limits of Agents to them if it's changed since the last
+     * load (no-op without config.bw_limit_filename)
+     *
+     */
+    void checkBWLimits();
+
+    /**
+     * @brief load the bandwidth limits of Agents from file; format: one
+     * Agent per line: <agent_id> <send_bw_limit> <recv_bw_limit> (in Bytes
+     * per second, 0: unlimited); empty lines and lines starting with '#' are
+     * skipped
+     *
+     * @param bw_limit_filename
+     * @param bw_limits limits (send, recv) of each listed Agent
+     * @return true
+     * @return false
+     */
+    bool loadBWLimits(string bw_limit_filename, map<uint16_t, pair<uint64_t, uint64_t>> &bw_limits);
 };
 
 #endif // __CTRL_NODE_HH__
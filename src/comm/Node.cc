@@ -39,7 +39,7 @@ Node::Node(uint16_t _self_conn_id, Config &_config) : self_conn_id(_self_conn_id
 
     acceptor = new sockpp::tcp_acceptor(self_port);
 
-    printf("Node %u: start connection\n", self_conn_id);
+    LOG_INFO("Node %u: start connection", self_conn_id);
 
     // create ack connector threads
     thread ack_conn_thread(Node::ackConnAllSockets, self_conn_id, &sockets_map, acceptor);
@@ -90,7 +90,7 @@ void Node::connectAllSockets(uint16_t self_conn_id, unordered_map<uint16_t, sock
         delete item.second;
     }
 
-    printf("Node::connectAllSockets successfully connected to %lu nodes\n", connectors_map->size());
+    LOG_INFO("Node::connectAllSockets successfully connected to %lu nodes", connectors_map->size());
 }
 
 void Node::connectOneSocket(uint16_t self_conn_id, unordered_map<uint16_t, sockpp::tcp_connector> *connectors_map, uint16_t conn_id, string ip, uint16_t port)
@@ -108,9 +108,9 @@ void Node::connectOneSocket(uint16_t self_conn_id, unordered_map<uint16_t, sockp
     Command cmd_conn;
     cmd_conn.buildCommand(CommandType::CMD_CONN, self_conn_id, conn_id);
 
-    if (connector.write_n(cmd_conn.content, MAX_CMD_LEN * sizeof(unsigned char)) == -1)
+    if (Command::sendCommand(connector, cmd_conn) == false)
     {
-        fprintf(stderr, "Node::connectOneSocket error send cmd_conn\n");
+        LOG_ERROR("Node::connectOneSocket error send cmd_conn");
         exit(EXIT_FAILURE);
     }
 
@@ -124,23 +124,22 @@ void Node::handleAckOneSocket(uint16_t self_conn_id, unordered_map<uint16_t, soc
 
     // parse the ack command
     Command cmd_ack;
-    if (connector.read_n(cmd_ack.content, MAX_CMD_LEN * sizeof(unsigned char)) == -1)
+    if (Command::recvCommand(connector, cmd_ack) <= 0)
     {
-        fprintf(stderr, "Node::handleAckOneSocket error reading cmd_ack from %u\n", conn_id);
+        LOG_ERROR("Node::handleAckOneSocket error reading cmd_ack from %u", conn_id);
         exit(EXIT_FAILURE);
     }
-    cmd_ack.parse();
 
     // printf("Node::handleAckOneSocket received command from %u \n", conn_id);
     // Utils::printUCharBuffer(cmd_ack.content, MAX_CMD_LEN);
 
     if (cmd_ack.type != CommandType::CMD_ACK)
     {
-        fprintf(stderr, "Node::handleAckOneSocket invalid command type %d from connection %u\n", cmd_ack.type, conn_id);
+        LOG_ERROR("Node::handleAckOneSocket invalid command type %d from connection %u", cmd_ack.type, conn_id);
         exit(EXIT_FAILURE);
     }
 
-    printf("Node::handleAckOneSocket successfully build connection: (%u <-> %u)\n", self_conn_id, conn_id);
+    LOG_INFO("Node::handleAckOneSocket successfully build connection: (%u <-> %u)", self_conn_id, conn_id);
 }
 
 void Node::ackConnAllSockets(uint16_t self_conn_id, unordered_map<uint16_t, sockpp::tcp_socket> *sockets_map, sockpp::tcp_acceptor *acceptor)
@@ -154,7 +153,7 @@ void Node::ackConnAllSockets(uint16_t self_conn_id, unordered_map<uint16_t, sock
 
         if (!skt)
         {
-            fprintf(stderr, "Node::ackConnAllSockets invalid socket: %s\n", acceptor->last_error_str().c_str());
+            LOG_ERROR("Node::ackConnAllSockets invalid socket: %s", acceptor->last_error_str().c_str());
             exit(EXIT_FAILURE);
         }
 
@@ -162,17 +161,15 @@ void Node::ackConnAllSockets(uint16_t self_conn_id, unordered_map<uint16_t, sock
 
         // parse the connection command
         Command cmd_conn;
-        if (skt.read_n(cmd_conn.content, MAX_CMD_LEN * sizeof(unsigned char)) == -1)
+        if (Command::recvCommand(skt, cmd_conn) <= 0)
         {
-            fprintf(stderr, "Node::ackConnAllSockets error reading cmd_conn\n");
+            LOG_ERROR("Node::ackConnAllSockets error reading cmd_conn");
             exit(EXIT_FAILURE);
         }
 
-        cmd_conn.parse();
-
         if (cmd_conn.type != CommandType::CMD_CONN || cmd_conn.dst_conn_id != self_conn_id)
         {
-            fprintf(stderr, "Node::ackConnAllSockets invalid cmd_conn: type: %u, dst_conn_id: %u\n", cmd_conn.type, cmd_conn.dst_conn_id);
+            LOG_ERROR("Node::ackConnAllSockets invalid cmd_conn: type: %u, dst_conn_id: %u", cmd_conn.type, cmd_conn.dst_conn_id);
             exit(EXIT_FAILURE);
         }
 
@@ -189,9 +186,9 @@ void Node::ackConnAllSockets(uint16_t self_conn_id, unordered_map<uint16_t, sock
         Command cmd_ack;
         cmd_ack.buildCommand(CommandType::CMD_ACK, self_conn_id, conn_id);
 
-        if (reply_skt.write_n(cmd_ack.content, MAX_CMD_LEN * sizeof(unsigned char)) == -1)
+        if (Command::sendCommand(reply_skt, cmd_ack) == false)
         {
-            fprintf(stderr, "Node::ackConnAllSockets error send cmd_ack\n");
+            LOG_ERROR("Node::ackConnAllSockets error send cmd_ack");
             exit(EXIT_FAILURE);
         }
 
@@ -7,6 +7,7 @@
 #include "sockpp/tcp_connector.h"
 #include "sockpp/tcp_acceptor.h"
 #include "../util/Config.hh"
+#include "../util/Logger.hh"
 #include "Command.hh"
 
 class Node
@@ -0,0 +1,110 @@
+#include "ParityAccumulator.hh"
+
+ParityAccumulator::ParityAccumulator(uint64_t _block_size, uint64_t _chunk_size) : block_size(_block_size), chunk_size(_chunk_size)
+{
+    num_chunks = (block_size + chunk_size - 1) / chunk_size;
+    num_accumulated_srcs.assign(num_chunks, 0);
+    num_ready_chunks = 0;
+    num_slots = 0;
+
+    k = 0;
+    m = 0;
+    encode_gftbl = NULL;
+    parity_rings = NULL;
+    encode_time_us = 0;
+}
+
+ParityAccumulator::~ParityAccumulator()
+{
+}
+
+void ParityAccumulator::reset(int _k, int _m, unsigned char *_encode_gftbl, ChunkRing *_parity_rings)
+{
+    unique_lock<mutex> lck(acc_mtx);
+    k = _k;
+    m = _m;
+    encode_gftbl = _encode_gftbl;
+    parity_rings = _parity_rings;
+    num_accumulated_srcs.assign(num_chunks, 0);
+    num_ready_chunks = 0;
+    encode_time_us = 0;
+    for (int parity_id = 0; parity_id < m; parity_id++)
+    {
+        parity_rings[parity_id].reset();
+    }
+
+    // locks and states of parity chunks (a slot holds one chunk at a time);
+    // the locks are only grown, and kept across computations
+    num_slots = (m > 0) ? parity_rings[0].num_slots : 0;
+    uint64_t num_parity_chunks = num_slots * m;
+    if (num_parity_chunks > parity_chunk_num_srcs.size())
+    {
+        parity_chunk_mtxs.reset(new mutex[num_parity_chunks]);
+        parity_chunk_num_srcs.resize(num_parity_chunks);
+    }
+    std::fill(parity_chunk_num_srcs.begin(), parity_chunk_num_srcs.end(), 0);
+}
+
+void ParityAccumulator::accumulate(int src_id, uint64_t offset, uint64_t len, unsigned char *src_chunk)
+{
+    uint64_t chunk_id = offset / chunk_size;
+
+    // wait for the slots of the chunk (drained by the parity writers)
+    vector<unsigned char *> parity_chunks(m, NULL);
+    for (int parity_id = 0; parity_id < m; parity_id++)
+    {
+        parity_rings[parity_id].waitFreeSlot(chunk_id);
+        parity_chunks[parity_id] = parity_rings[parity_id].getSlot(chunk_id);
+    }
+
+    // parity_chunks += coef(src_id) * src_chunk, one parity chunk at a time
+    // (starting from a different parity chunk for each source)
+    uint64_t slot_id = chunk_id % num_slots;
+    uint64_t cur_encode_time_us = 0;
+    for (int idx = 0; idx < m; idx++)
+    {
+        int parity_id = (src_id + idx) % m;
+        uint64_t parity_chunk_idx = slot_id * m + parity_id;
+
+        unique_lock<mutex> parity_lck(parity_chunk_mtxs[parity_chunk_idx]);
+
+        // clear the accumulator of the chunk on the first source chunk
+        if (parity_chunk_num_srcs[parity_chunk_idx] == 0)
+        {
+            memset(parity_chunks[parity_id], 0, len * sizeof(unsigned char));
+        }
+
+        uint64_t encode_start_time_us = Utils::getTimeUs();
+        ec_encode_data_update(len, k, 1, src_id, encode_gftbl + parity_id * k * 32, src_chunk, &parity_chunks[parity_id]);
+        uint64_t encode_end_time_us = Utils::getTimeUs();
+        cur_encode_time_us += encode_end_time_us - encode_start_time_us;
+        Tracer::record("accumulate_chunk", encode_start_time_us, encode_end_time_us);
+
+        // the slot is reused by a later chunk once all sources are accumulated
+        parity_chunk_num_srcs[parity_chunk_idx]++;
+        if (parity_chunk_num_srcs[parity_chunk_idx] == k)
+        {
+            parity_chunk_num_srcs[parity_chunk_idx] = 0;
+        }
+    }
+
+    unique_lock<mutex> lck(acc_mtx);
+    encode_time_us += cur_encode_time_us;
+    num_accumulated_srcs[chunk_id]++;
+
+    // produce the finished prefix of chunks (under the lock, so the rings
+    // only move forward)
+    uint64_t prev_num_ready_chunks = num_ready_chunks;
+    while (num_ready_chunks < num_chunks && num_accumulated_srcs[num_ready_chunks] == k)
+    {
+        num_ready_chunks++;
+    }
+
+    if (num_ready_chunks != prev_num_ready_chunks)
+    {
+        for (int parity_id = 0; parity_id < m; parity_id++)
+        {
+            parity_rings[parity_id].setProduced(num_ready_chunks);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef __PARITY_ACCUMULATOR_HH__
+#define __PARITY_ACCUMULATOR_HH__
+
+#include <isa-l.h>
+#include <mutex>
+#include <memory>
+
+#include "../include/include.hh"
+#include "../util/Tracer.hh"
+#include "BlockIO.hh"
+
+/**
+ * @brief incremental parity computation: each source chunk is multiplied
+ * and accumulated into the output parity blocks (ec_encode_data_update) as
+ * soon as it arrives, in any order, so only one chunk is buffered per source
+ * block. The output parity blocks are accumulated in chunk rings; a parity
+ * chunk is produced (for writing) once all source chunks of it are
+ * accumulated, in the order of chunks.
+ *
+ * Sources are accumulated concurrently: each parity chunk (in a slot of the
+ * parity rings) has its own lock, and a source goes through the parity
+ * chunks starting from a different one (by src_id), so the k sources
+ * multiply-accumulate into different parity chunks at the same time; only
+ * the bookkeeping of the ready chunks is serialized.
+ */
+class ParityAccumulator
+{
+private:
+    mutex acc_mtx;                        // protects the bookkeeping of chunks (and encode_time_us)
+    vector<uint8_t> num_accumulated_srcs; // number of accumulated sources of each chunk
+    uint64_t num_ready_chunks;            // chunks [0, num_ready_chunks) are ready
+
+    // per parity chunk (slot of a parity ring) state: (slot * m + parity_id)
+    uint64_t num_slots;                     // number of slots of the parity rings
+    unique_ptr<mutex[]> parity_chunk_mtxs;  // serializes accumulation into the parity chunk
+    vector<uint8_t> parity_chunk_num_srcs;  // number of sources accumulated into the parity chunk (of the current chunk in the slot)
+
+public:
+    uint64_t block_size;
+    uint64_t chunk_size;
+    uint64_t num_chunks;
+
+    // current computation
+    int k;                       // number of source blocks
+    int m;                       // number of output parity blocks
+    unsigned char *encode_gftbl; // table from ec_init_tables(k, m, ...)
+    ChunkRing *parity_rings;     // accumulators of output parity blocks (m)
+    uint64_t encode_time_us;     // time spent in encoding (since reset)
+
+    ParityAccumulator(uint64_t _block_size, uint64_t _chunk_size);
+    ~ParityAccumulator();
+
+    /**
+     * @brief reset for a new parity computation (accumulators are cleared
+     * lazily by chunk); no accumulation should be in progress
+     *
+     * @param _k number of source blocks
+     * @param _m number of output parity blocks
+     * @param _encode_gftbl
+     * @param _parity_rings rings of output parity blocks (m)
+     */
+    void reset(int _k, int _m, unsigned char *_encode_gftbl, ChunkRing *_parity_rings);
+
+    /**
+     * @brief accumulate a chunk of a source block (wait until the chunk has
+     * a free slot in the parity rings)
+     *
+     * @param src_id source block id (column of the coding matrix)
+     * @param offset chunk offset in the block (aligned to chunk_size)
+     * @param len chunk length
+     * @param src_chunk
+     */
+    void accumulate(int src_id, uint64_t offset, uint64_t len, unsigned char *src_chunk);
+};
+
+#endif // __PARITY_ACCUMULATOR_HH__
@@ -79,24 +79,21 @@ ParityComputeTask::~ParityComputeTask()
 
 void ParityComputeTask::print()
 {
-    printf("\nParityComputeTask post-stripe: (%u, %u), enc_method: %u\n", post_stripe_id, post_block_id, enc_method);
+    LOG_DEBUG("ParityComputeTask post-stripe: (%u, %u), enc_method: %u", post_stripe_id, post_block_id, enc_method);
 
-    printf("src_block_nodes:\n");
-    Utils::printVector(src_block_nodes);
+    LOG_DEBUG("src_block_nodes: %s", Utils::vectorToString(src_block_nodes).c_str());
 
-    printf("parity_reloc_nodes\n");
-    Utils::printVector(parity_reloc_nodes);
+    LOG_DEBUG("parity_reloc_nodes: %s", Utils::vectorToString(parity_reloc_nodes).c_str());
 
-    printf("src_block_paths:\n");
+    LOG_DEBUG("src_block_paths:");
     for (auto path : src_block_paths)
     {
-        printf("%s\n", path.c_str());
+        LOG_DEBUG("%s", path.c_str());
     }
 
-    printf("dst_block_paths:\n");
+    LOG_DEBUG("dst_block_paths:");
     for (auto path : dst_block_paths)
     {
-        printf("%s\n", path.c_str());
+        LOG_DEBUG("%s", path.c_str());
     }
-    printf("\n\n");
 }
\ No newline at end of file
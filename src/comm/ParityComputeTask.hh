@@ -2,6 +2,7 @@
 #define __PARITY_COMPUTE_TASK_HH__
 
 #include "../include/include.hh"
+#include "../util/Logger.hh"
 #include "../model/ConvertibleCode.hh"
 #include "../model/StripeGroup.hh"
 
@@ -0,0 +1,166 @@
+#include "ProgressTracker.hh"
+
+ProgressTracker::ProgressTracker(vector<Command> &commands)
+{
+    start_time_us = Utils::getTimeUs();
+    last_print_time_us = start_time_us;
+
+    num_tasks = 0;
+    num_finished_tasks = 0;
+    for (auto &cmd : commands)
+    {
+        uint64_t num_cmd_tasks = 1;
+        if (cmd.type == CommandType::CMD_COMPUTE_RE_BLK || cmd.type == CommandType::CMD_COMPUTE_PM_BLK)
+        { // parity block relocations (the command is sent to the compute node)
+            for (auto reloc_node_id : cmd.parity_reloc_nodes)
+            {
+                if (reloc_node_id != cmd.dst_conn_id)
+                {
+                    num_cmd_tasks++;
+                }
+            }
+        }
+
+        sg_num_pending_tasks[cmd.post_stripe_id] += num_cmd_tasks;
+        num_tasks += num_cmd_tasks;
+    }
+
+    num_sgs = sg_num_pending_tasks.size();
+    num_finished_sgs = 0;
+    last_num_finished_sgs = 0;
+}
+
+ProgressTracker::~ProgressTracker()
+{
+}
+
+void ProgressTracker::start()
+{
+    start_time_us = Utils::getTimeUs();
+    last_print_time_us = start_time_us;
+}
+
+void ProgressTracker::update(Command &cmd_done)
+{
+    auto it = sg_num_pending_tasks.find(cmd_done.post_stripe_id);
+    if (it == sg_num_pending_tasks.end() || it->second == 0)
+    {
+        LOG_ERROR("ProgressTracker::update error: unexpected task report, type: %u, post: (%u, %u), from Node %u", cmd_done.task_type, cmd_done.post_stripe_id, cmd_done.post_block_id, cmd_done.src_conn_id);
+        exit(EXIT_FAILURE);
+    }
+
+    it->second--;
+    if (it->second == 0)
+    {
+        num_finished_sgs++;
+    }
+    num_finished_tasks++;
+
+    uint16_t node_id = cmd_done.src_conn_id;
+    node_net_bytes[node_id] += cmd_done.num_net_bytes;
+    node_disk_bytes[node_id] += cmd_done.num_disk_bytes;
+
+    // the peer nodes serve / receive the network Bytes of the task (in
+    // equal shares), and read them from / write them to their disks
+    if (cmd_done.peer_nodes.empty() == false)
+    {
+        uint64_t peer_bytes = cmd_done.num_net_bytes / cmd_done.peer_nodes.size();
+        for (auto peer_node_id : cmd_done.peer_nodes)
+        {
+            node_net_bytes[peer_node_id] += peer_bytes;
+            node_disk_bytes[peer_node_id] += peer_bytes;
+        }
+    }
+
+    type_num_tasks[cmd_done.task_type]++;
+    auto &stage_time_us = type_stage_time_us[cmd_done.task_type];
+    stage_time_us.resize(NUM_TASK_STAGES, 0);
+    for (int stage = 0; stage < NUM_TASK_STAGES; stage++)
+    {
+        stage_time_us[stage] += cmd_done.stage_time_us[stage];
+    }
+}
+
+bool ProgressTracker::isFinished()
+{
+    return num_finished_tasks == num_tasks;
+}
+
+void ProgressTracker::tick()
+{
+    if (Utils::getTimeUs() - last_print_time_us >= PROGRESS_PRINT_INTERVAL_US)
+    {
+        printProgress();
+    }
+}
+
+void ProgressTracker::printProgress()
+{
+    uint64_t cur_time_us = Utils::getTimeUs();
+    double interval_sec = (cur_time_us - last_print_time_us) / 1000000.0;
+    double elapsed_sec = (cur_time_us - start_time_us) / 1000000.0;
+    if (interval_sec <= 0 || elapsed_sec <= 0)
+    {
+        return;
+    }
+
+    // stripe groups finished per second (since the last print), and the
+    // estimated time to finish (at the average rate since the start)
+    double sg_rate = (num_finished_sgs - last_num_finished_sgs) / interval_sec;
+    double avg_sg_rate = num_finished_sgs / elapsed_sec;
+
+    char eta[32];
+    if (num_finished_sgs == num_sgs)
+    {
+        snprintf(eta, sizeof(eta), "0.0 s");
+    }
+    else if (avg_sg_rate > 0)
+    {
+        snprintf(eta, sizeof(eta), "%.1f s", (num_sgs - num_finished_sgs) / avg_sg_rate);
+    }
+    else
+    {
+        snprintf(eta, sizeof(eta), "n/a");
+    }
+    LOG_INFO("[Progress] %.1f s: stripe groups: %lu / %lu (%.2f / s), tasks: %lu / %lu, ETA: %s", elapsed_sec, num_finished_sgs, num_sgs, sg_rate, num_finished_tasks, num_tasks, eta);
+
+    // throughput of each node (since the last print)
+    for (auto &item : node_net_bytes)
+    {
+        uint16_t node_id = item.first;
+        double net_rate = (item.second - last_node_net_bytes[node_id]) / interval_sec / 1048576;
+        double disk_rate = (node_disk_bytes[node_id] - last_node_disk_bytes[node_id]) / interval_sec / 1048576;
+        LOG_INFO("[Progress] Node %u: network: %.2f MiB/s, disk: %.2f MiB/s", node_id, net_rate, disk_rate);
+
+        last_node_net_bytes[node_id] = item.second;
+        last_node_disk_bytes[node_id] = node_disk_bytes[node_id];
+    }
+
+    last_num_finished_sgs = num_finished_sgs;
+    last_print_time_us = cur_time_us;
+}
+
+void ProgressTracker::printSummary()
+{
+    double elapsed_sec = (Utils::getTimeUs() - start_time_us) / 1000000.0;
+
+    LOG_INFO("[Progress] finished %lu / %lu stripe groups (%lu / %lu tasks) in %.3f s (%.2f stripe groups / s)", num_finished_sgs, num_sgs, num_finished_tasks, num_tasks, elapsed_sec, elapsed_sec > 0 ? num_finished_sgs / elapsed_sec : 0);
+
+    // Bytes moved and average throughput of each node
+    for (auto &item : node_net_bytes)
+    {
+        uint16_t node_id = item.first;
+        double net_mib = item.second / 1048576.0;
+        double disk_mib = node_disk_bytes[node_id] / 1048576.0;
+        LOG_INFO("[Progress] Node %u: network: %.2f MiB (%.2f MiB/s), disk: %.2f MiB (%.2f MiB/s)", node_id, net_mib, elapsed_sec > 0 ? net_mib / elapsed_sec : 0, disk_mib, elapsed_sec > 0 ? disk_mib / elapsed_sec : 0);
+    }
+
+    // average stage timings of each type of task
+    for (auto &item : type_num_tasks)
+    {
+        CommandType task_type = item.first;
+        uint64_t num_type_tasks = item.second;
+        vector<uint64_t> &stage_time_us = type_stage_time_us[task_type];
+        LOG_INFO("[Progress] task type %u: %lu tasks, average stage time (ms): queue: %.3f, retrieve: %.3f, encode: %.3f, write: %.3f, total: %.3f", task_type, num_type_tasks, stage_time_us[STAGE_QUEUE] / 1000.0 / num_type_tasks, stage_time_us[STAGE_RETRIEVE] / 1000.0 / num_type_tasks, stage_time_us[STAGE_ENCODE] / 1000.0 / num_type_tasks, stage_time_us[STAGE_WRITE] / 1000.0 / num_type_tasks, stage_time_us[STAGE_TOTAL] / 1000.0 / num_type_tasks);
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef __PROGRESS_TRACKER_HH__
+#define __PROGRESS_TRACKER_HH__
+
+#include "../include/include.hh"
+#include "../util/Utils.hh"
+#include "../util/Logger.hh"
+#include "Command.hh"
+
+#define PROGRESS_PRINT_INTERVAL_US 1000000 // interval of printing the progress (1 second)
+
+/**
+ * @brief progress of the transition on Controller, aggregated from the task
+ * completion reports (CMD_TASK_DONE) of Agents: the throughput of each node
+ * (Bytes sent / received over the network and read / written on disk by its
+ * tasks, and by serving / receiving the blocks of the tasks of other nodes), the stripe groups finished per second, the estimated time to
+ * finish, and the average stage timings of each type of task. A stripe group
+ * is finished once all its tasks are reported, including the parity block
+ * relocations created by ComputeWorker.
+ *
+ * A tracker is updated by a single thread.
+ */
+class ProgressTracker
+{
+private:
+    uint64_t start_time_us;      // time of the first dispatch
+    uint64_t last_print_time_us; // time of the last print
+
+    // stripe groups
+    unordered_map<uint32_t, uint64_t> sg_num_pending_tasks; // unreported tasks of each stripe group
+    uint64_t num_sgs;
+    uint64_t num_finished_sgs;
+    uint64_t last_num_finished_sgs; // at the last print
+
+    // tasks
+    uint64_t num_tasks;
+    uint64_t num_finished_tasks;
+
+    // Bytes moved by the tasks of each node (ordered by node id)
+    map<uint16_t, uint64_t> node_net_bytes;
+    map<uint16_t, uint64_t> node_disk_bytes;
+    map<uint16_t, uint64_t> last_node_net_bytes;  // at the last print
+    map<uint16_t, uint64_t> last_node_disk_bytes; // at the last print
+
+    // stage timings of each type of task
+    map<CommandType, uint64_t> type_num_tasks;
+    map<CommandType, vector<uint64_t>> type_stage_time_us; // sum of each stage (NUM_TASK_STAGES)
+
+public:
+    /**
+     * @brief Construct a new ProgressTracker: each command is reported once,
+     * and each parity computation is followed by the relocations of its
+     * parity blocks placed on other nodes
+     *
+     * @param commands commands to dispatch
+     */
+    ProgressTracker(vector<Command> &commands);
+    ~ProgressTracker();
+
+    /**
+     * @brief start the clock (when the commands start to be dispatched)
+     *
+     */
+    void start();
+
+    /**
+     * @brief aggregate a task completion report
+     *
+     * @param cmd_done CMD_TASK_DONE
+     */
+    void update(Command &cmd_done);
+
+    /**
+     * @brief check if all tasks are reported
+     *
+     * @return true
+     * @return false
+     */
+    bool isFinished();
+
+    /**
+     * @brief print the progress if PROGRESS_PRINT_INTERVAL_US has passed
+     * since the last print
+     *
+     */
+    void tick();
+
+    /**
+     * @brief print the progress: live throughput of each node and stripe
+     * groups finished per second (since the last print), and the estimated
+     * time to finish (at the average rate since the start)
+     *
+     */
+    void printProgress();
+
+    /**
+     * @brief print the summary: total Bytes moved and average throughput of
+     * each node, and average stage timings of each type of task
+     *
+     */
+    void printSummary();
+};
+
+#endif // __PROGRESS_TRACKER_HH__
@@ -1,6 +1,6 @@
 #include "RelocWorker.hh"
 
-RelocWorker::RelocWorker(Config &_config, unsigned int _self_worker_id, uint16_t _self_conn_id, MultiWriterQueue<Command> &_reloc_task_queue) : ThreadPool(1), config(_config), self_worker_id(_self_worker_id), self_conn_id(_self_conn_id), reloc_task_queue(_reloc_task_queue)
+RelocWorker::RelocWorker(Config &_config, unsigned int _self_worker_id, uint16_t _self_conn_id, MultiWriterQueue<Command> &_reloc_task_queue, MultiWriterQueue<Command> *_report_queue, ConnPool &_conn_pool, MemoryPool &_memory_pool) : ThreadPool(1), config(_config), self_worker_id(_self_worker_id), self_conn_id(_self_conn_id), reloc_task_queue(_reloc_task_queue), report_queue(_report_queue), conn_pool(_conn_pool), memory_pool(_memory_pool)
 {
 }
 
@@ -10,9 +10,16 @@ RelocWorker::~RelocWorker()
 
 void RelocWorker::run()
 {
-    printf("[Node %u, Worker %u] RelocWorker::run start to handle relocation tasks\n", self_conn_id, self_worker_id);
+    LOG_INFO("[Node %u, Worker %u] RelocWorker::run start to handle relocation tasks", self_conn_id, self_worker_id);
 
-    unsigned char *data_buffer = (unsigned char *)malloc(config.block_size * sizeof(unsigned char));
+    Tracer::setThreadName("RelocWorker " + to_string(self_worker_id));
+
+    ChunkRing ring;
+    vector<unsigned char *> ring_buffers;
+
+    // disk reads are asynchronous in the worker thread
+    AsyncBlockIO async_io(config.io_queue_depth, config.use_io_uring, config.use_direct_io);
+    async_io.registerBuffers(memory_pool);
 
     unsigned int num_term_signals = 0;
 
@@ -25,7 +32,8 @@ void RelocWorker::run()
 
         Command cmd_reloc;
 
-        if (reloc_task_queue.Pop(cmd_reloc) == true)
+        // wait for a task (sleep when idle)
+        if (reloc_task_queue.WaitPop(cmd_reloc) == true)
         {
             // terminate signal
             if (cmd_reloc.type == CommandType::CMD_STOP)
@@ -43,54 +51,86 @@ void RelocWorker::run()
 
             if (cmd_reloc.type != CommandType::CMD_TRANSFER_RELOC_BLK)
             {
-                fprintf(stderr, "RelocWorker::run error invalid command type: %u\n", cmd_reloc.type);
+                LOG_ERROR("RelocWorker::run error invalid command type: %u", cmd_reloc.type);
                 exit(EXIT_FAILURE);
             }
 
-            printf("[Node %u, Worker %u] RelocWorker::run received relocation task, post: (%u, %u)\n", self_conn_id, self_worker_id, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
-
-            // read block
-            if (BlockIO::readBlock(cmd_reloc.src_block_path, data_buffer, config.block_size) != config.block_size)
+            LOG_DEBUG("[Node %u, Worker %u] RelocWorker::run received relocation task, post: (%u, %u)", self_conn_id, self_worker_id, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
+
+            uint64_t start_time_us = Utils::getTimeUs();
+            Tracer::record("queue_wait", cmd_reloc.recv_time_us, start_time_us, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
+
+            // borrow the chunk ring from the memory pool (before acquiring
+            // the connection)
+            memory_pool.getBlocks(config.num_chunk_slots, ring_buffers);
+            ring.bind(&ring_buffers[0], config.num_chunk_slots, config.chunk_size);
+            uint64_t conn_start_time_us = Utils::getTimeUs();
+            Tracer::record("acquire_buffers", start_time_us, conn_start_time_us, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
+
+            // obtain a pooled connection to the block request handler
+            sockpp::tcp_connector *connector = conn_pool.acquire(cmd_reloc.dst_conn_id);
+            Tracer::record("acquire_conn", conn_start_time_us, Utils::getTimeUs(), cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
+
+            // send the command, then read and send block (zero-copy, or
+            // pipelined by chunk); if the connection fails mid-transfer, the
+            // transfer is retried on a new connection
+            uint64_t send_start_time_us = Utils::getTimeUs();
+            uint64_t send_bytes = 0;
+            unsigned int num_retries = 0;
+            while (true)
             {
-                fprintf(stderr, "RelocWorker::handleDataTransfer error reading block: %s\n", cmd_reloc.src_block_path.c_str());
-                exit(EXIT_FAILURE);
+                if (Command::sendCommand(*connector, cmd_reloc) == false)
+                {
+                    LOG_WARN("RelocWorker::run error sending cmd, type: %u, src_conn_id: %u, dst_conn_id: %u", cmd_reloc.type, cmd_reloc.src_conn_id, cmd_reloc.dst_conn_id);
+                }
+                else
+                {
+                    send_bytes = config.zero_copy ? BlockIO::sendBlockFile(*connector, cmd_reloc.getSrcBlockPath(), config.block_size, ring) : async_io.readAndSendBlock(*connector, cmd_reloc.getSrcBlockPath(), config.block_size, ring);
+                    if (send_bytes == config.block_size)
+                    {
+                        break;
+                    }
+                    LOG_WARN("RelocWorker::run error sending block: %s to BlockReqHandler of Node %u", cmd_reloc.getDstBlockPath().c_str(), cmd_reloc.dst_conn_id);
+                }
+
+                if (++num_retries > CONN_MAX_TRANSFER_RETRIES)
+                {
+                    LOG_ERROR("RelocWorker::run error relocating block: %s to BlockReqHandler of Node %u after %u retries", cmd_reloc.getDstBlockPath().c_str(), cmd_reloc.dst_conn_id, CONN_MAX_TRANSFER_RETRIES);
+                    exit(EXIT_FAILURE);
+                }
+                connector = conn_pool.reconnect(cmd_reloc.dst_conn_id, connector);
             }
 
-            // create connection to the block request handler
-            string block_req_ip = config.agent_addr_map[cmd_reloc.dst_conn_id].first;
-            unsigned int block_req_port = config.agent_addr_map[cmd_reloc.dst_conn_id].second + config.settings.num_nodes; // DEBUG
+            uint64_t send_end_time_us = Utils::getTimeUs();
+            Tracer::record("send_block", send_start_time_us, send_end_time_us, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
 
-            sockpp::tcp_connector connector;
-            int on = 1;
-            connector.set_option(SOL_SOCKET, SO_REUSEADDR, &on);
-            connector.set_option(SOL_SOCKET, SO_REUSEPORT, &on);
-            connector.set_option(SOL_SOCKET, SO_KEEPALIVE, &on);
+            conn_pool.release(cmd_reloc.dst_conn_id, connector);
+            memory_pool.freeBlocks(ring_buffers);
 
-            while (!(connector = sockpp::tcp_connector(sockpp::inet_address(block_req_ip, block_req_port))))
-            {
-                this_thread::sleep_for(chrono::milliseconds(1));
-            }
+            LOG_DEBUG("[Node %u, Worker %u] RelocWorker::run finished relocation task, post: (%u, %u)", self_conn_id, self_worker_id, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
 
-            if (connector.write_n(cmd_reloc.content, MAX_CMD_LEN * sizeof(unsigned char)) == -1)
-            {
-                fprintf(stderr, "RelocWorker::run error sending cmd, type: %u, src_conn_id: %u, dst_conn_id: %u\n", cmd_reloc.type, cmd_reloc.src_conn_id, cmd_reloc.dst_conn_id);
-                exit(EXIT_FAILURE);
-            }
+            uint64_t end_time_us = Utils::getTimeUs();
+            Tracer::record("reloc_task", start_time_us, end_time_us, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
 
-            // send block
-            if (BlockIO::sendBlock(connector, data_buffer, config.block_size) != config.block_size)
+            // report the relocation (of data blocks dispatched by
+            // Controller, and of parity blocks created by ComputeWorker) to
+            // Controller: the block is read from disk and sent over the network
+            if (report_queue != NULL)
             {
-                fprintf(stderr, "RelocWorker::handleDataTransfer error sending block: %s to RelocWorker %u\n", cmd_reloc.dst_block_path.c_str(), cmd_reloc.src_conn_id);
-                exit(EXIT_FAILURE);
-            }
+                uint32_t stage_time_us[NUM_TASK_STAGES] = {0};
+                stage_time_us[STAGE_QUEUE] = start_time_us - cmd_reloc.recv_time_us;
+                stage_time_us[STAGE_RETRIEVE] = send_end_time_us - send_start_time_us;
+                stage_time_us[STAGE_TOTAL] = end_time_us - start_time_us;
 
-            connector.close();
+                // the destination node receives the block and writes it to disk
+                vector<uint16_t> peer_nodes(1, cmd_reloc.dst_conn_id);
 
-            printf("[Node %u, Worker %u] RelocWorker::run finished relocation task, post: (%u, %u)\n", self_conn_id, self_worker_id, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id);
+                Command cmd_done;
+                cmd_done.buildCommand(CommandType::CMD_TASK_DONE, self_conn_id, CTRL_NODE_ID, cmd_reloc.type, cmd_reloc.post_stripe_id, cmd_reloc.post_block_id, send_bytes, send_bytes, stage_time_us, peer_nodes);
+                report_queue->Push(cmd_done);
+            }
         }
     }
 
-    free(data_buffer);
-
-    printf("[Node %u, Worker %u] RelocWorker::run finished handling relocation tasks\n", self_conn_id, self_worker_id);
+    LOG_INFO("[Node %u, Worker %u] RelocWorker::run finished handling relocation tasks", self_conn_id, self_worker_id);
 }
\ No newline at end of file
@@ -8,9 +8,14 @@
 #include "../util/ThreadPool.hh"
 #include "../util/Config.hh"
 #include "../util/MultiWriterQueue.h"
+#include "../util/MemoryPool.hh"
+#include "../util/Tracer.hh"
+#include "../util/Logger.hh"
 #include "Command.hh"
 #include "Node.hh"
 #include "BlockIO.hh"
+#include "AsyncBlockIO.hh"
+#include "ConnPool.hh"
 
 class RelocWorker : public ThreadPool
 {
@@ -29,7 +34,16 @@ public:
     // relocation task queue
     MultiWriterQueue<Command> &reloc_task_queue;
 
-    RelocWorker(Config &_config, unsigned int _self_worker_id, uint16_t _self_conn_id, MultiWriterQueue<Command> &_reloc_task_queue);
+    // (optional) task completion reports to Controller (RelocWorker -> CmdDist<CTRL_NODE_ID>)
+    MultiWriterQueue<Command> *report_queue;
+
+    // persistent connections to block request handlers of other nodes
+    ConnPool &conn_pool;
+
+    // agent-wide memory pool (the chunk ring is borrowed per task)
+    MemoryPool &memory_pool;
+
+    RelocWorker(Config &_config, unsigned int _self_worker_id, uint16_t _self_conn_id, MultiWriterQueue<Command> &_reloc_task_queue, MultiWriterQueue<Command> *_report_queue, ConnPool &_conn_pool, MemoryPool &_memory_pool);
     ~RelocWorker();
 
     /**
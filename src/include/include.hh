@@ -33,6 +33,7 @@ using namespace std;
 #define INVALID_NODE_ID UINT16_MAX
 #define INVALID_BLK_ID UINT8_MAX
 #define INVALID_VTX_ID UINT64_MAX
+#define INVALID_EDGE_ID UINT64_MAX
 
 #define MAX_MSG_QUEUE_LEN 1024
 #define MAX_CMD_LEN 1024
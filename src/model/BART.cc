@@ -8,18 +8,18 @@ BART::~BART()
 {
 }
 
-void BART::genSolution(StripeBatch &stripe_batch, string approach)
+void BART::genSolution(StripeBatch &stripe_batch, TransApproach approach)
 {
     // Step 1: construct stripe groups
-    printf("Step 1: stripe group construction\n");
+    LOG_INFO("Step 1: stripe group construction");
     // stripe_batch.constructSGByBWBF(approach);
     stripe_batch.constructSGByBWPartial(approach);
     // stripe_batch.print();
 
     // Step 2: generate parity computation scheme (parity computation method and nodes)
-    printf("Step 2: parity block generation\n");
+    LOG_INFO("Step 2: parity block generation");
     // genParityComputationHybrid(stripe_batch, approach);
-    if (approach == "BTWeighted")
+    if (approach == TransApproach::BT_WEIGHTED)
     {
         genWeightedParityGenerationForPM(stripe_batch);
     }
@@ -29,9 +29,9 @@ void BART::genSolution(StripeBatch &stripe_batch, string approach)
     }
 
     // Step 3: schedule (data and parity) block relocation
-    printf("Step 3: stripe redistribution\n");
+    LOG_INFO("Step 3: stripe redistribution");
 
-    if (approach == "BTWeighted")
+    if (approach == TransApproach::BT_WEIGHTED)
     {
         genWeightedStripeRedistribution(stripe_batch);
     }
@@ -110,15 +110,13 @@ void BART::genParityGenerationForPM(StripeBatch &stripe_batch)
     gettimeofday(&end_time, nullptr);
     finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                   (end_time.tv_usec - start_time.tv_usec) / 1000;
-    printf("finished finding parity computation scheme for %u stripe groups, time: %f ms\n", num_stripe_groups, finish_time);
-
-    printf("final load table with data relocation (send load only), parity generation (both send and receive load) and parity relocation (send load only):\n");
-    printf("send load: ");
-    Utils::printVector(cur_lt.slt);
-    printf("recv load: ");
-    Utils::printVector(cur_lt.rlt);
-    printf("bandwidth: %u\n", cur_lt.bw);
-    printf("number of re-encoding groups: (%u / %u), number of parity merging groups: (%u / %u)\n", num_re_groups, num_stripe_groups, (num_stripe_groups - num_re_groups), num_stripe_groups);
+    LOG_INFO("finished finding parity computation scheme for %u stripe groups, time: %f ms", num_stripe_groups, finish_time);
+
+    LOG_INFO("final load table with data relocation (send load only), parity generation (both send and receive load) and parity relocation (send load only):");
+    LOG_INFO("send load: %s", Utils::vectorToString(cur_lt.slt).c_str());
+    LOG_INFO("recv load: %s", Utils::vectorToString(cur_lt.rlt).c_str());
+    LOG_INFO("bandwidth: %u", cur_lt.bw);
+    LOG_INFO("number of re-encoding groups: (%u / %u), number of parity merging groups: (%u / %u)", num_re_groups, num_stripe_groups, (num_stripe_groups - num_re_groups), num_stripe_groups);
 }
 
 void BART::genWeightedParityGenerationForPM(StripeBatch &stripe_batch)
@@ -191,9 +189,9 @@ void BART::genWeightedParityGenerationForPM(StripeBatch &stripe_batch)
     gettimeofday(&end_time, nullptr);
     finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                   (end_time.tv_usec - start_time.tv_usec) / 1000;
-    printf("finished finding parity computation scheme for %u stripe groups, time: %f ms\n", num_stripe_groups, finish_time);
+    LOG_INFO("finished finding parity computation scheme for %u stripe groups, time: %f ms", num_stripe_groups, finish_time);
 
-    printf("final weighted load table with data relocation (send load only), parity generation (both send and receive load) and parity relocation (send load only):\n");
+    LOG_INFO("final weighted load table with data relocation (send load only), parity generation (both send and receive load) and parity relocation (send load only):");
 
     // weighted load table
     vector<double> weighted_slt(settings.num_nodes);
@@ -204,14 +202,12 @@ void BART::genWeightedParityGenerationForPM(StripeBatch &stripe_batch)
         weighted_slt[node_id] = 1.0 * cur_lt.slt[node_id] / settings.bw_profile.upload[node_id];
         weighted_rlt[node_id] = 1.0 * cur_lt.rlt[node_id] / settings.bw_profile.download[node_id];
     }
-    printf("final weighted load table:\n");
-    printf("send load: ");
-    Utils::printVector(weighted_slt);
-    printf("recv load: ");
-    Utils::printVector(weighted_rlt);
-
-    printf("bandwidth: %u\n", cur_lt.bw);
-    printf("number of re-encoding groups: (%u / %u), number of parity merging groups: (%u / %u)\n", num_re_groups, num_stripe_groups, (num_stripe_groups - num_re_groups), num_stripe_groups);
+    LOG_INFO("final weighted load table:");
+    LOG_INFO("send load: %s", Utils::vectorToString(weighted_slt).c_str());
+    LOG_INFO("recv load: %s", Utils::vectorToString(weighted_rlt).c_str());
+
+    LOG_INFO("bandwidth: %u", cur_lt.bw);
+    LOG_INFO("number of re-encoding groups: (%u / %u), number of parity merging groups: (%u / %u)", num_re_groups, num_stripe_groups, (num_stripe_groups - num_re_groups), num_stripe_groups);
 }
 
 void BART::initLTForParityGeneration(StripeBatch &stripe_batch, LoadTable &cur_lt)
@@ -266,12 +262,10 @@ void BART::initLTForParityGeneration(StripeBatch &stripe_batch, LoadTable &cur_l
     // calculate bandwidth with data relocation (for send load table)
     cur_lt.bw = accumulate(cur_lt.slt.begin(), cur_lt.slt.end(), 0);
 
-    printf("initialization of load table, cur_lt:\n");
-    printf("send load: ");
-    Utils::printVector(cur_lt.slt);
-    printf("recv load: ");
-    Utils::printVector(cur_lt.rlt);
-    printf("bandwidth: %u\n", cur_lt.bw);
+    LOG_INFO("initialization of load table, cur_lt:");
+    LOG_INFO("send load: %s", Utils::vectorToString(cur_lt.slt).c_str());
+    LOG_INFO("recv load: %s", Utils::vectorToString(cur_lt.rlt).c_str());
+    LOG_INFO("bandwidth: %u", cur_lt.bw);
 }
 
 void BART::initLTForParityGenerationData(StripeBatch &stripe_batch, LoadTable &cur_lt)
@@ -314,12 +308,10 @@ void BART::initLTForParityGenerationData(StripeBatch &stripe_batch, LoadTable &c
     // calculate bandwidth with data relocation (for send load table)
     cur_lt.bw = accumulate(cur_lt.slt.begin(), cur_lt.slt.end(), 0);
 
-    printf("initialization of load table, cur_lt:\n");
-    printf("send load: ");
-    Utils::printVector(cur_lt.slt);
-    printf("recv load: ");
-    Utils::printVector(cur_lt.rlt);
-    printf("bandwidth: %u\n", cur_lt.bw);
+    LOG_INFO("initialization of load table, cur_lt:");
+    LOG_INFO("send load: %s", Utils::vectorToString(cur_lt.slt).c_str());
+    LOG_INFO("recv load: %s", Utils::vectorToString(cur_lt.rlt).c_str());
+    LOG_INFO("bandwidth: %u", cur_lt.bw);
 }
 
 void BART::initSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vector<bool>> &is_perfect_pm, LoadTable &cur_lt)
@@ -338,6 +330,9 @@ void BART::initSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vect
     struct timeval start_time, end_time;
     gettimeofday(&start_time, nullptr);
 
+    // track the max load of the current load table
+    LoadTableTracker<uint32_t> cur_lt_tracker(cur_lt);
+
     for (auto &item : stripe_batch.selected_sgs)
     {
         uint32_t sg_id = item.first;
@@ -359,7 +354,7 @@ void BART::initSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vect
 
                 // subtract send load on the perfect_pm_node for retrieving
                 // original data blocks
-                cur_lt.slt[perfect_pm_node] -= code.lambda_i;
+                cur_lt_tracker.addLoad(perfect_pm_node, -code.lambda_i, 0);
                 // subtract additional bandwidth for retrieving original data
                 // blocks
                 cur_lt.bw -= code.lambda_i;
@@ -369,51 +364,25 @@ void BART::initSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vect
 
             uint32_t min_max_load_pm = UINT32_MAX;
             uint8_t min_bw_pm = UINT8_MAX;
-            vector<pair<uint16_t, LoadTable>> best_pm_nodes;
+            vector<uint16_t> best_pm_nodes;
 
             for (uint16_t cand_pm_node = 0; cand_pm_node < num_nodes; cand_pm_node++)
             {
-                // load table after applying the pm node
-                LoadTable cur_lt_after_pm = cur_lt;
-
-                uint8_t num_parities_stored_pm_node = stripe_group.parity_dists[parity_id][cand_pm_node];
-
-                // bandwidth for the current solution
-                uint8_t bw_pm = code.lambda_i - num_parities_stored_pm_node;
-
-                // update the send load table
-                // subtract the parity blocks to send
-                for (auto &stripe : stripe_group.pre_stripes)
-                {
-                    uint16_t parity_stored_node = stripe->indices[code.k_i + parity_id];
-                    if (parity_stored_node == cand_pm_node)
-                    {
-                        cur_lt_after_pm.slt[parity_stored_node]--;
-                    }
-                }
-
-                // check if parity block relocation is needed
-                if (cur_block_placement[cand_pm_node] > 0)
-                {
-                    cur_lt_after_pm.slt[cand_pm_node]++;
-                    bw_pm++;
-                }
-
-                // update the recv load table
-                cur_lt_after_pm.rlt[cand_pm_node] += (code.lambda_i - num_parities_stored_pm_node);
+                // load on the pm node and bandwidth for the current solution
+                int32_t send_load_pm = 0, recv_load_pm = 0;
+                uint8_t bw_pm = getPMLoad(stripe_group, parity_id, cand_pm_node, cur_block_placement, send_load_pm, recv_load_pm);
 
-                // maximum load for the current solution
-                uint32_t max_send_load_pm = *max_element(cur_lt_after_pm.slt.begin(), cur_lt_after_pm.slt.end());
-                uint32_t max_recv_load_pm = *max_element(cur_lt_after_pm.rlt.begin(), cur_lt_after_pm.rlt.end());
-
-                // maximum load and bandwidth
-                uint32_t max_load_pm = max(max_send_load_pm, max_recv_load_pm);
+                // maximum load for the current solution (only the loads of
+                // the pm node are changed)
+                cur_lt_tracker.addLoad(cand_pm_node, send_load_pm, recv_load_pm);
+                uint32_t max_load_pm = cur_lt_tracker.getMaxLoad();
+                cur_lt_tracker.addLoad(cand_pm_node, -send_load_pm, -recv_load_pm);
 
                 // check if the results are preserved
                 bool is_preserved = (max_load_pm < min_max_load_pm || (max_load_pm == min_max_load_pm && bw_pm <= min_bw_pm));
                 if (is_preserved == true)
                 { // append to the candidate results
-                    best_pm_nodes.push_back(pair<uint16_t, LoadTable>(cand_pm_node, cur_lt_after_pm));
+                    best_pm_nodes.push_back(cand_pm_node);
                 }
 
                 // check if the results are improved
@@ -425,18 +394,21 @@ void BART::initSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vect
 
                     // clear previous results and append the new one
                     best_pm_nodes.clear();
-                    best_pm_nodes.push_back(pair<uint16_t, LoadTable>(cand_pm_node, cur_lt_after_pm));
+                    best_pm_nodes.push_back(cand_pm_node);
                 }
             }
 
             // randomly choose a best parity compute node
             size_t random_pos = Utils::randomUInt(0, best_pm_nodes.size() - 1, random_generator);
-            uint32_t selected_pm_node = best_pm_nodes[random_pos].first;
-            LoadTable &selected_cur_lt_after_pm = best_pm_nodes[random_pos].second;
+            uint32_t selected_pm_node = best_pm_nodes[random_pos];
 
             // update metadata
             selected_pm_nodes[parity_id] = selected_pm_node; // choose to compute parity block at the node
-            cur_lt = selected_cur_lt_after_pm;               // update the current load table
+
+            // update the current load table
+            int32_t selected_send_load_pm = 0, selected_recv_load_pm = 0;
+            getPMLoad(stripe_group, parity_id, selected_pm_node, cur_block_placement, selected_send_load_pm, selected_recv_load_pm);
+            cur_lt_tracker.addLoad(selected_pm_node, selected_send_load_pm, selected_recv_load_pm);
 
             // subtract the bandwidth to retrieve original parity block
             uint8_t num_parities_stored_pm_node = stripe_group.parity_dists[parity_id][selected_pm_node];
@@ -448,8 +420,6 @@ void BART::initSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vect
             cur_block_placement[selected_pm_node]++; // place the computed parity block at the node
 
             // printf("stripe group: %u, compute parity %u at node %u, cur_lt: (max_load: %u, bw: %u, bw_sum: %u)\n", stripe_group.id, parity_id, selected_pm_node, min_max_load_pm, min_bw_pm, cur_lt.bw);
-            // Utils::printVector(selected_cur_lt_after_pm.slt);
-            // Utils::printVector(selected_cur_lt_after_pm.rlt);
         }
 
         // apply the load table for stripe group
@@ -459,14 +429,12 @@ void BART::initSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vect
     gettimeofday(&end_time, nullptr);
     double finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                          (end_time.tv_usec - start_time.tv_usec) / 1000;
-    printf("finished initialization for %lu stripe groups, time: %f ms\n", stripe_batch.selected_sgs.size(), finish_time);
-
-    printf("find initial solution, cur_lt:\n");
-    printf("send load: ");
-    Utils::printVector(cur_lt.slt);
-    printf("recv load: ");
-    Utils::printVector(cur_lt.rlt);
-    printf("bandwidth: %u\n", cur_lt.bw);
+    LOG_INFO("finished initialization for %lu stripe groups, time: %f ms", stripe_batch.selected_sgs.size(), finish_time);
+
+    LOG_INFO("find initial solution, cur_lt:");
+    LOG_INFO("send load: %s", Utils::vectorToString(cur_lt.slt).c_str());
+    LOG_INFO("recv load: %s", Utils::vectorToString(cur_lt.rlt).c_str());
+    LOG_INFO("bandwidth: %u", cur_lt.bw);
 }
 
 void BART::initWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vector<bool>> &is_perfect_pm, LoadTable &cur_lt)
@@ -488,6 +456,9 @@ void BART::initWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch, vec
     struct timeval start_time, end_time;
     gettimeofday(&start_time, nullptr);
 
+    // track the max weighted load of the current load table
+    LoadTableTracker<double> cur_lt_tracker(cur_lt, &settings.bw_profile.upload, &settings.bw_profile.download);
+
     for (auto &item : stripe_batch.selected_sgs)
     {
         uint32_t sg_id = item.first;
@@ -509,7 +480,7 @@ void BART::initWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch, vec
 
                 // subtract send load on the perfect_pm_node for retrieving
                 // original data blocks
-                cur_lt.slt[perfect_pm_node] -= code.lambda_i;
+                cur_lt_tracker.addLoad(perfect_pm_node, -code.lambda_i, 0);
                 // subtract additional bandwidth for retrieving original data
                 // blocks
                 cur_lt.bw -= code.lambda_i;
@@ -520,54 +491,25 @@ void BART::initWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch, vec
             // min max weighted load
             double min_max_weighted_load_pm = DBL_MAX;
             uint8_t min_bw_pm = UINT8_MAX;
-            vector<pair<uint16_t, LoadTable>> best_pm_nodes;
+            vector<uint16_t> best_pm_nodes;
 
             for (uint16_t cand_pm_node = 0; cand_pm_node < num_nodes; cand_pm_node++)
             {
-                // load table after applying the pm node
-                LoadTable cur_lt_after_pm = cur_lt;
-
-                uint8_t num_parities_stored_pm_node = stripe_group.parity_dists[parity_id][cand_pm_node];
-
-                // bandwidth for the current solution
-                uint8_t bw_pm = code.lambda_i - num_parities_stored_pm_node;
-
-                // update the send load table
-                // subtract the parity blocks to send
-                for (auto &stripe : stripe_group.pre_stripes)
-                {
-                    uint16_t parity_stored_node = stripe->indices[code.k_i + parity_id];
-                    if (parity_stored_node == cand_pm_node)
-                    {
-                        cur_lt_after_pm.slt[parity_stored_node]--;
-                    }
-                }
-
-                // check if parity block relocation is needed
-                if (cur_block_placement[cand_pm_node] > 0)
-                {
-                    cur_lt_after_pm.slt[cand_pm_node]++;
-                    bw_pm++;
-                }
-
-                // update the recv load table
-                cur_lt_after_pm.rlt[cand_pm_node] += (code.lambda_i - num_parities_stored_pm_node);
+                // load on the pm node and bandwidth for the current solution
+                int32_t send_load_pm = 0, recv_load_pm = 0;
+                uint8_t bw_pm = getPMLoad(stripe_group, parity_id, cand_pm_node, cur_block_placement, send_load_pm, recv_load_pm);
 
-                // compute maximum weighted load
-                double max_weighted_load_pm = 0;
-                for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
-                {
-                    // weighted_load = load / bw
-                    double weighted_send_load = 1.0 * cur_lt_after_pm.slt[node_id] / settings.bw_profile.upload[node_id];
-                    double weighted_recv_load = 1.0 * cur_lt_after_pm.rlt[node_id] / settings.bw_profile.download[node_id];
-                    max_weighted_load_pm = max({max_weighted_load_pm, weighted_send_load, weighted_recv_load});
-                }
+                // compute maximum weighted load for the current solution
+                // (only the loads of the pm node are changed)
+                cur_lt_tracker.addLoad(cand_pm_node, send_load_pm, recv_load_pm);
+                double max_weighted_load_pm = cur_lt_tracker.getMaxLoad();
+                cur_lt_tracker.addLoad(cand_pm_node, -send_load_pm, -recv_load_pm);
 
                 // check if the results are preserved
                 bool is_preserved = (max_weighted_load_pm < min_max_weighted_load_pm || (max_weighted_load_pm == min_max_weighted_load_pm && bw_pm <= min_bw_pm));
                 if (is_preserved == true)
                 { // append to the candidate results
-                    best_pm_nodes.push_back(pair<uint16_t, LoadTable>(cand_pm_node, cur_lt_after_pm));
+                    best_pm_nodes.push_back(cand_pm_node);
                 }
 
                 // check if the results are improved
@@ -579,18 +521,21 @@ void BART::initWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch, vec
 
                     // clear previous results and append the new one
                     best_pm_nodes.clear();
-                    best_pm_nodes.push_back(pair<uint16_t, LoadTable>(cand_pm_node, cur_lt_after_pm));
+                    best_pm_nodes.push_back(cand_pm_node);
                 }
             }
 
             // randomly choose a best parity compute node
             size_t random_pos = Utils::randomUInt(0, best_pm_nodes.size() - 1, random_generator);
-            uint32_t selected_pm_node = best_pm_nodes[random_pos].first;
-            LoadTable &selected_cur_lt_after_pm = best_pm_nodes[random_pos].second;
+            uint32_t selected_pm_node = best_pm_nodes[random_pos];
 
             // update metadata
             selected_pm_nodes[parity_id] = selected_pm_node; // choose to compute parity block at the node
-            cur_lt = selected_cur_lt_after_pm;               // update the current load table
+
+            // update the current load table
+            int32_t selected_send_load_pm = 0, selected_recv_load_pm = 0;
+            getPMLoad(stripe_group, parity_id, selected_pm_node, cur_block_placement, selected_send_load_pm, selected_recv_load_pm);
+            cur_lt_tracker.addLoad(selected_pm_node, selected_send_load_pm, selected_recv_load_pm);
 
             // subtract the bandwidth to retrieve original parity block
             uint8_t num_parities_stored_pm_node = stripe_group.parity_dists[parity_id][selected_pm_node];
@@ -602,8 +547,6 @@ void BART::initWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch, vec
             cur_block_placement[selected_pm_node]++; // place the computed parity block at the node
 
             // printf("stripe group: %u, compute parity %u at node %u, cur_lt: (max_load: %u, bw: %u, bw_sum: %u)\n", stripe_group.id, parity_id, selected_pm_node, min_max_load_pm, min_bw_pm, cur_lt.bw);
-            // Utils::printVector(selected_cur_lt_after_pm.slt);
-            // Utils::printVector(selected_cur_lt_after_pm.rlt);
         }
 
         // apply the load table for stripe group
@@ -623,15 +566,13 @@ void BART::initWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch, vec
     gettimeofday(&end_time, nullptr);
     double finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                          (end_time.tv_usec - start_time.tv_usec) / 1000;
-    printf("finished initialization for %lu stripe groups, time: %f ms\n", stripe_batch.selected_sgs.size(), finish_time);
+    LOG_INFO("finished initialization for %lu stripe groups, time: %f ms", stripe_batch.selected_sgs.size(), finish_time);
 
-    printf("find initial solution, weighted_lt:\n");
-    printf("send load: ");
-    Utils::printVector(weighted_slt);
-    printf("recv load: ");
-    Utils::printVector(weighted_rlt);
+    LOG_INFO("find initial solution, weighted_lt:");
+    LOG_INFO("send load: %s", Utils::vectorToString(weighted_slt).c_str());
+    LOG_INFO("recv load: %s", Utils::vectorToString(weighted_rlt).c_str());
 
-    printf("bandwidth: %u\n", cur_lt.bw);
+    LOG_INFO("bandwidth: %u", cur_lt.bw);
 }
 
 void BART::initSolOfParityGenerationForPMData(StripeBatch &stripe_batch, vector<vector<bool>> &is_perfect_pm, LoadTable &cur_lt)
@@ -749,12 +690,10 @@ void BART::initSolOfParityGenerationForPMData(StripeBatch &stripe_batch, vector<
         stripe_group.applied_lt = stripe_group.genPartialLTForParityCompute(EncodeMethod::PARITY_MERGE, selected_pm_nodes);
     }
 
-    printf("find initial solution, cur_lt:\n");
-    printf("send load: ");
-    Utils::printVector(cur_lt.slt);
-    printf("recv load: ");
-    Utils::printVector(cur_lt.rlt);
-    printf("bandwidth: %u\n", cur_lt.bw);
+    LOG_INFO("find initial solution, cur_lt:");
+    LOG_INFO("send load: %s", Utils::vectorToString(cur_lt.slt).c_str());
+    LOG_INFO("recv load: %s", Utils::vectorToString(cur_lt.rlt).c_str());
+    LOG_INFO("bandwidth: %u", cur_lt.bw);
 }
 
 void BART::optimizeSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vector<bool>> &is_perfect_pm, LoadTable &cur_lt)
@@ -769,12 +708,14 @@ void BART::optimizeSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<
     ConvertibleCode &code = stripe_batch.code;
     uint16_t num_nodes = stripe_batch.settings.num_nodes;
 
-    printf("start optimization of parity block generation\n");
+    LOG_INFO("start optimization of parity block generation");
+
+    // track the max load of the current load table; each move only updates
+    // the loads of the current and candidate pm nodes
+    LoadTableTracker<uint32_t> cur_lt_tracker(cur_lt);
 
     // use a while loop until the solution cannot be further optimized (i.e., cannot further improve load balance and then bandwidth)
-    uint32_t max_send_load_iter = *max_element(cur_lt.slt.begin(), cur_lt.slt.end());
-    uint32_t max_recv_load_iter = *max_element(cur_lt.rlt.begin(), cur_lt.rlt.end());
-    uint32_t max_load_iter = max(max_send_load_iter, max_recv_load_iter);
+    uint32_t max_load_iter = cur_lt_tracker.getMaxLoad();
     uint32_t bw_iter = cur_lt.bw;
     uint64_t iter = 0;
     while (true)
@@ -782,7 +723,7 @@ void BART::optimizeSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<
         struct timeval start_time, end_time;
         gettimeofday(&start_time, nullptr);
 
-        printf("start iteration %ld, cur_lt: (max_load: %u, bw: %u)\n", iter, max_load_iter, bw_iter);
+        LOG_INFO("start iteration %ld, cur_lt: (max_load: %u, bw: %u)", iter, max_load_iter, bw_iter);
         for (auto &item : stripe_batch.selected_sgs)
         {
             uint32_t sg_id = item.first;
@@ -808,28 +749,17 @@ void BART::optimizeSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<
                 // current pm node
                 uint16_t cur_pm_node = stripe_group.applied_lt.enc_nodes[parity_id];
 
-                // load table with removed load for current pm node
-                LoadTable cur_lt_rm = cur_lt;
-
                 // subtract the load for current pm node
                 uint8_t num_parities_stored_cur_pm_node = stripe_group.parity_dists[parity_id][cur_pm_node];
 
                 // original max load and bandwidth for the current solution
-                uint32_t cur_max_send_load_pm = *max_element(cur_lt.slt.begin(), cur_lt.slt.end());
-                uint32_t cur_max_recv_load_pm = *max_element(cur_lt.rlt.begin(), cur_lt.rlt.end());
-                uint32_t cur_max_load_pm = max(cur_max_send_load_pm, cur_max_recv_load_pm);
+                uint32_t cur_max_load_pm = cur_lt_tracker.getMaxLoad();
                 uint8_t cur_bw_pm = code.lambda_i - num_parities_stored_cur_pm_node;
 
-                // update the send load table
-                // subtract the parity blocks to send
-                for (auto &stripe : stripe_group.pre_stripes)
-                {
-                    uint16_t parity_stored_node = stripe->indices[code.k_i + parity_id];
-                    if (parity_stored_node != cur_pm_node)
-                    {
-                        cur_lt_rm.slt[parity_stored_node]--;
-                    }
-                }
+                // load table with removed load for current pm node, where all
+                // the parity blocks are counted as sent: the parity blocks
+                // stored at the current pm node are to send
+                int32_t rm_send_load_pm = num_parities_stored_cur_pm_node;
 
                 // check if parity block relocation is needed
                 // subtract back the relocation bw
@@ -837,107 +767,53 @@ void BART::optimizeSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<
                 {
                     // mark the block as not relocated
                     cur_block_placement[cur_pm_node]--;
-                    cur_lt_rm.slt[cur_pm_node]--;
+                    rm_send_load_pm--;
                     cur_bw_pm++;
                 }
 
                 // update the recv load table
                 // subtract the parity blocks received
-                cur_lt_rm.rlt[cur_pm_node] -= (code.lambda_i - num_parities_stored_cur_pm_node);
+                int32_t rm_recv_load_pm = -(code.lambda_i - num_parities_stored_cur_pm_node);
+                cur_lt_tracker.addLoad(cur_pm_node, rm_send_load_pm, rm_recv_load_pm);
 
                 // set min_max_load and bw as of before optimization
                 uint32_t min_max_load_pm = cur_max_load_pm;
                 uint8_t min_bw_pm = cur_bw_pm;
 
-                // double min_stddev_pm = UINT_MAX;
-
-                vector<pair<uint16_t, LoadTable>> best_pm_nodes;
+                vector<uint16_t> best_pm_nodes;
 
                 for (uint16_t cand_pm_node = 0; cand_pm_node < num_nodes; cand_pm_node++)
                 {
-                    // load table after applying the pm node
-                    LoadTable cur_lt_after_pm = cur_lt_rm;
+                    // load on the pm node and bandwidth for the current solution
+                    int32_t send_load_pm = 0, recv_load_pm = 0;
+                    uint8_t bw_pm = getPMLoad(stripe_group, parity_id, cand_pm_node, cur_block_placement, send_load_pm, recv_load_pm);
 
-                    uint8_t num_parities_stored_pm_node = stripe_group.parity_dists[parity_id][cand_pm_node];
-
-                    // bandwidth for the current solution
-                    uint8_t bw_pm = code.lambda_i - num_parities_stored_pm_node;
-
-                    // update the send load table
-                    // add the parity blocks to send
-                    for (auto &stripe : stripe_group.pre_stripes)
-                    {
-                        uint16_t parity_stored_node = stripe->indices[code.k_i + parity_id];
-                        if (parity_stored_node != cand_pm_node)
-                        {
-                            cur_lt_after_pm.slt[parity_stored_node]++;
-                        }
-                    }
-
-                    // check if parity block relocation is needed
-                    if (cur_block_placement[cand_pm_node] > 0)
-                    {
-                        cur_lt_after_pm.slt[cand_pm_node]++;
-                        bw_pm++;
-                    }
-
-                    // update the recv load table
-                    cur_lt_after_pm.rlt[cand_pm_node] += (code.lambda_i - num_parities_stored_pm_node);
-
-                    // maximum load for the current solution
-                    uint32_t max_send_load_pm = *max_element(cur_lt_after_pm.slt.begin(), cur_lt_after_pm.slt.end());
-                    uint32_t max_recv_load_pm = *max_element(cur_lt_after_pm.rlt.begin(), cur_lt_after_pm.rlt.end());
-
-                    // maximum load and bandwidth
-                    uint32_t max_load_pm = max(max_send_load_pm, max_recv_load_pm);
-
-                    //*****************consider stddev**********************//
-                    // // mean, stddev, cv (send)
-                    // double mean_load_send_pm = 1.0 * std::accumulate(cur_lt_after_pm.slt.begin(), cur_lt_after_pm.slt.end(), 0) / cur_lt_after_pm.slt.size();
-                    // double sqr_send = 0;
-                    // for (auto &item : cur_lt_after_pm.slt)
-                    // {
-                    //     sqr_send += pow((double)item - mean_load_send_pm, 2);
-                    // }
-                    // double stddev_send = std::sqrt(sqr_send / cur_lt_after_pm.slt.size());
-
-                    // // mean, stddev, cv (recv)
-                    // double mean_load_recv_pm = 1.0 * std::accumulate(cur_lt_after_pm.rlt.begin(), cur_lt_after_pm.rlt.end(), 0) / cur_lt_after_pm.rlt.size();
-                    // double sqr_recv = 0;
-                    // for (auto &item : cur_lt_after_pm.rlt)
-                    // {
-                    //     sqr_recv += pow((double)item - mean_load_recv_pm, 2);
-                    // }
-                    // double stddev_recv = std::sqrt(sqr_recv / cur_lt_after_pm.rlt.size());
-
-                    // // max stddev
-                    // double stddev_max = max(stddev_send, stddev_recv);
-                    //*********************************************//
+                    // maximum load for the current solution (only the loads
+                    // of the pm node are changed)
+                    cur_lt_tracker.addLoad(cand_pm_node, send_load_pm, recv_load_pm);
+                    uint32_t max_load_pm = cur_lt_tracker.getMaxLoad();
+                    cur_lt_tracker.addLoad(cand_pm_node, -send_load_pm, -recv_load_pm);
 
                     // check if the results are preserved
                     bool is_preserved = (max_load_pm < min_max_load_pm || (max_load_pm == min_max_load_pm && bw_pm <= min_bw_pm));
-                    // bool is_preserved = (max_load_pm < min_max_load_pm || (max_load_pm == min_max_load_pm && bw_pm < min_bw_pm) || (max_load_pm == min_max_load_pm && bw_pm == min_bw_pm && stddev_max <= min_stddev_pm));
                     if (is_preserved == true)
                     { // append to the candidate results
                         if (cand_pm_node != cur_pm_node)
                         { // check if we can find a different node
-                            best_pm_nodes.push_back(pair<uint16_t, LoadTable>(cand_pm_node, cur_lt_after_pm));
+                            best_pm_nodes.push_back(cand_pm_node);
                         }
                     }
 
                     // check if the results are improved
                     bool is_improved = (max_load_pm < min_max_load_pm || (max_load_pm == min_max_load_pm && bw_pm < min_bw_pm));
-                    // bool is_improved = (max_load_pm < min_max_load_pm || (max_load_pm == min_max_load_pm && bw_pm < min_bw_pm) || (max_load_pm == min_max_load_pm && bw_pm == min_bw_pm && stddev_max < min_stddev_pm));
                     if (is_improved == true)
                     {
                         min_max_load_pm = max_load_pm;
                         min_bw_pm = bw_pm;
 
-                        // min_stddev_pm = stddev_max;
-
                         // clear previous results and append the new one
                         best_pm_nodes.clear();
-                        best_pm_nodes.push_back(pair<uint16_t, LoadTable>(cand_pm_node, cur_lt_after_pm));
+                        best_pm_nodes.push_back(cand_pm_node);
                     }
                 }
 
@@ -946,24 +822,29 @@ void BART::optimizeSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<
                 { // we cannot identify such a node
                   // mark the block as relocated again
                     cur_block_placement[cur_pm_node]++;
+
+                    // add back the load for current pm node
+                    cur_lt_tracker.addLoad(cur_pm_node, -rm_send_load_pm, -rm_recv_load_pm);
                 }
                 else
                 { // we can identify such a node
                     // randomly choose a best parity compute node
                     size_t random_pos = Utils::randomUInt(0, best_pm_nodes.size() - 1, random_generator);
-                    uint32_t selected_pm_node = best_pm_nodes[random_pos].first;
-                    LoadTable &selected_cur_lt_after_pm = best_pm_nodes[random_pos].second;
+                    uint32_t selected_pm_node = best_pm_nodes[random_pos];
 
                     // update metadata
                     is_sg_updated = true;
                     stripe_group.applied_lt.enc_nodes[parity_id] = selected_pm_node; // choose to compute parity block at the node
-                    cur_lt = selected_cur_lt_after_pm;                               // update the current load table
-                    cur_lt.bw = cur_lt.bw - cur_bw_pm + min_bw_pm;                   // update the bandwidth
-                    cur_block_placement[selected_pm_node]++;                         // place the computed parity block at the node
+
+                    // update the current load table
+                    int32_t selected_send_load_pm = 0, selected_recv_load_pm = 0;
+                    getPMLoad(stripe_group, parity_id, selected_pm_node, cur_block_placement, selected_send_load_pm, selected_recv_load_pm);
+                    cur_lt_tracker.addLoad(selected_pm_node, selected_send_load_pm, selected_recv_load_pm);
+
+                    cur_lt.bw = cur_lt.bw - cur_bw_pm + min_bw_pm; // update the bandwidth
+                    cur_block_placement[selected_pm_node]++;       // place the computed parity block at the node
 
                     // printf("stripe group: %u, change for parity %u: (%u -> %u), original_cur_lt: (max_load: %u, bw: %u) new_cur_lt: (max_load: %u, bw: %u), bw_sum: %u\n", stripe_group.id, parity_id, cur_pm_node, selected_pm_node, cur_max_load_pm, cur_bw_pm, min_max_load_pm, min_bw_pm, cur_lt.bw);
-                    // Utils::printVector(selected_cur_lt_after_pm.slt);
-                    // Utils::printVector(selected_cur_lt_after_pm.rlt);
                 }
             }
 
@@ -976,23 +857,19 @@ void BART::optimizeSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<
         }
 
         // summarize the max load and bw after the current iteration
-        uint32_t max_send_load_after_opt = *max_element(cur_lt.slt.begin(), cur_lt.slt.end());
-        uint32_t max_recv_load_after_opt = *max_element(cur_lt.rlt.begin(), cur_lt.rlt.end());
-        uint32_t max_load_after_opt = max(max_send_load_after_opt, max_recv_load_after_opt);
+        uint32_t max_load_after_opt = cur_lt_tracker.getMaxLoad();
         uint32_t bw_after_opt = cur_lt.bw;
         bool improved = max_load_after_opt < max_load_iter || (max_load_after_opt == max_load_iter && bw_after_opt < bw_iter);
 
-        printf("end iteration: %ld, cur_lt: (max_load: %u, bw: %u), improved: %u\n", iter, max_load_after_opt, bw_after_opt, improved);
-        printf("send load: ");
-        Utils::printVector(cur_lt.slt);
-        printf("recv load: ");
-        Utils::printVector(cur_lt.rlt);
-        printf("bandwidth: %u\n", cur_lt.bw);
+        LOG_INFO("end iteration: %ld, cur_lt: (max_load: %u, bw: %u), improved: %u", iter, max_load_after_opt, bw_after_opt, improved);
+        LOG_INFO("send load: %s", Utils::vectorToString(cur_lt.slt).c_str());
+        LOG_INFO("recv load: %s", Utils::vectorToString(cur_lt.rlt).c_str());
+        LOG_INFO("bandwidth: %u", cur_lt.bw);
 
         gettimeofday(&end_time, nullptr);
         double finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                              (end_time.tv_usec - start_time.tv_usec) / 1000;
-        printf("finished running the iteration %lu for %lu stripe groups, time: %f ms\n", iter, stripe_batch.selected_sgs.size(), finish_time);
+        LOG_INFO("finished running the iteration %lu for %lu stripe groups, time: %f ms", iter, stripe_batch.selected_sgs.size(), finish_time);
 
         if (improved == true)
         {
@@ -1008,7 +885,7 @@ void BART::optimizeSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<
         }
     }
 
-    printf("finished optimization of parity block generation\n");
+    LOG_INFO("finished optimization of parity block generation");
 }
 
 void BART::optimizeWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vector<bool>> &is_perfect_pm, LoadTable &cur_lt)
@@ -1026,20 +903,17 @@ void BART::optimizeWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch,
     ClusterSettings &settings = stripe_batch.settings;
     uint16_t num_nodes = stripe_batch.settings.num_nodes;
 
-    printf("start optimization of parity block generation\n");
+    LOG_INFO("start optimization of parity block generation");
+
+    // track the max weighted load of the current load table; each move only
+    // updates the loads of the current and candidate pm nodes
+    LoadTableTracker<double> cur_lt_tracker(cur_lt, &settings.bw_profile.upload, &settings.bw_profile.download);
 
     // use a while loop until the solution cannot be further optimized (i.e.,
     // cannot further improve load balance and then bandwidth)
 
     // compute maximum weighted load for the iteration
-    double max_weighted_load_iter = 0;
-    for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
-    {
-        // weighted_load = load / bw
-        double weighted_send_load = 1.0 * cur_lt.slt[node_id] / settings.bw_profile.upload[node_id];
-        double weighted_recv_load = 1.0 * cur_lt.rlt[node_id] / settings.bw_profile.download[node_id];
-        max_weighted_load_iter = max({max_weighted_load_iter, weighted_send_load, weighted_recv_load});
-    }
+    double max_weighted_load_iter = cur_lt_tracker.getMaxLoad();
 
     uint32_t bw_iter = cur_lt.bw;
     uint64_t iter = 0;
@@ -1048,7 +922,7 @@ void BART::optimizeWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch,
         struct timeval start_time, end_time;
         gettimeofday(&start_time, nullptr);
 
-        printf("start iteration %ld, cur_lt: (max_load: %f, bw: %u)\n", iter, max_weighted_load_iter, bw_iter);
+        LOG_INFO("start iteration %ld, cur_lt: (max_load: %f, bw: %u)", iter, max_weighted_load_iter, bw_iter);
         // printf("start iteration %ld, cur_lt: (max_load: %u, bw: %u)\n", iter, max_load_iter, bw_iter);
         for (auto &item : stripe_batch.selected_sgs)
         {
@@ -1075,34 +949,17 @@ void BART::optimizeWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch,
                 // current pm node
                 uint16_t cur_pm_node = stripe_group.applied_lt.enc_nodes[parity_id];
 
-                // load table with removed load for current pm node
-                LoadTable cur_lt_rm = cur_lt;
-
                 // subtract the load for current pm node
                 uint8_t num_parities_stored_cur_pm_node = stripe_group.parity_dists[parity_id][cur_pm_node];
 
-                // compute original max weighted load and bandwidth for the current solution
-                double cur_max_weighted_load_pm = 0;
-                for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
-                {
-                    // weighted_load = load / bw
-                    double weighted_send_load = 1.0 * cur_lt.slt[node_id] / settings.bw_profile.upload[node_id];
-                    double weighted_recv_load = 1.0 * cur_lt.rlt[node_id] / settings.bw_profile.download[node_id];
-                    cur_max_weighted_load_pm = max({cur_max_weighted_load_pm, weighted_send_load, weighted_recv_load});
-                }
-
+                // original max weighted load and bandwidth for the current solution
+                double cur_max_weighted_load_pm = cur_lt_tracker.getMaxLoad();
                 uint8_t cur_bw_pm = code.lambda_i - num_parities_stored_cur_pm_node;
 
-                // update the send load table
-                // subtract the parity blocks to send
-                for (auto &stripe : stripe_group.pre_stripes)
-                {
-                    uint16_t parity_stored_node = stripe->indices[code.k_i + parity_id];
-                    if (parity_stored_node != cur_pm_node)
-                    {
-                        cur_lt_rm.slt[parity_stored_node]--;
-                    }
-                }
+                // load table with removed load for current pm node, where all
+                // the parity blocks are counted as sent: the parity blocks
+                // stored at the current pm node are to send
+                int32_t rm_send_load_pm = num_parities_stored_cur_pm_node;
 
                 // check if parity block relocation is needed
                 // subtract back the relocation bw
@@ -1110,110 +967,53 @@ void BART::optimizeWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch,
                 {
                     // mark the block as not relocated
                     cur_block_placement[cur_pm_node]--;
-                    cur_lt_rm.slt[cur_pm_node]--;
+                    rm_send_load_pm--;
                     cur_bw_pm++;
                 }
 
                 // update the recv load table
                 // subtract the parity blocks received
-                cur_lt_rm.rlt[cur_pm_node] -= (code.lambda_i - num_parities_stored_cur_pm_node);
+                int32_t rm_recv_load_pm = -(code.lambda_i - num_parities_stored_cur_pm_node);
+                cur_lt_tracker.addLoad(cur_pm_node, rm_send_load_pm, rm_recv_load_pm);
 
                 // set min_max_weighted_load and bw as of before optimization
                 double min_max_weighted_load_pm = cur_max_weighted_load_pm;
                 uint8_t min_bw_pm = cur_bw_pm;
 
-                // double min_stddev_pm = UINT_MAX;
-
-                vector<pair<uint16_t, LoadTable>> best_pm_nodes;
+                vector<uint16_t> best_pm_nodes;
 
                 for (uint16_t cand_pm_node = 0; cand_pm_node < num_nodes; cand_pm_node++)
                 {
-                    // load table after applying the pm node
-                    LoadTable cur_lt_after_pm = cur_lt_rm;
-
-                    uint8_t num_parities_stored_pm_node = stripe_group.parity_dists[parity_id][cand_pm_node];
-
-                    // bandwidth for the current solution
-                    uint8_t bw_pm = code.lambda_i - num_parities_stored_pm_node;
-
-                    // update the send load table
-                    // add the parity blocks to send
-                    for (auto &stripe : stripe_group.pre_stripes)
-                    {
-                        uint16_t parity_stored_node = stripe->indices[code.k_i + parity_id];
-                        if (parity_stored_node != cand_pm_node)
-                        {
-                            cur_lt_after_pm.slt[parity_stored_node]++;
-                        }
-                    }
-
-                    // check if parity block relocation is needed
-                    if (cur_block_placement[cand_pm_node] > 0)
-                    {
-                        cur_lt_after_pm.slt[cand_pm_node]++;
-                        bw_pm++;
-                    }
-
-                    // update the recv load table
-                    cur_lt_after_pm.rlt[cand_pm_node] += (code.lambda_i - num_parities_stored_pm_node);
+                    // load on the pm node and bandwidth for the current solution
+                    int32_t send_load_pm = 0, recv_load_pm = 0;
+                    uint8_t bw_pm = getPMLoad(stripe_group, parity_id, cand_pm_node, cur_block_placement, send_load_pm, recv_load_pm);
 
                     // compute maximum weighted load for the current solution
-                    double max_weighted_load_pm = 0;
-                    for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
-                    {
-                        // weighted_load = load / bw
-                        double weighted_send_load = 1.0 * cur_lt_after_pm.slt[node_id] / settings.bw_profile.upload[node_id];
-                        double weighted_recv_load = 1.0 * cur_lt_after_pm.rlt[node_id] / settings.bw_profile.download[node_id];
-                        max_weighted_load_pm = max({max_weighted_load_pm, weighted_send_load, weighted_recv_load});
-                    }
-
-                    //*****************consider stddev**********************//
-                    // // mean, stddev, cv (send)
-                    // double mean_load_send_pm = 1.0 * std::accumulate(cur_lt_after_pm.slt.begin(), cur_lt_after_pm.slt.end(), 0) / cur_lt_after_pm.slt.size();
-                    // double sqr_send = 0;
-                    // for (auto &item : cur_lt_after_pm.slt)
-                    // {
-                    //     sqr_send += pow((double)item - mean_load_send_pm, 2);
-                    // }
-                    // double stddev_send = std::sqrt(sqr_send / cur_lt_after_pm.slt.size());
-
-                    // // mean, stddev, cv (recv)
-                    // double mean_load_recv_pm = 1.0 * std::accumulate(cur_lt_after_pm.rlt.begin(), cur_lt_after_pm.rlt.end(), 0) / cur_lt_after_pm.rlt.size();
-                    // double sqr_recv = 0;
-                    // for (auto &item : cur_lt_after_pm.rlt)
-                    // {
-                    //     sqr_recv += pow((double)item - mean_load_recv_pm, 2);
-                    // }
-                    // double stddev_recv = std::sqrt(sqr_recv / cur_lt_after_pm.rlt.size());
-
-                    // // max stddev
-                    // double stddev_max = max(stddev_send, stddev_recv);
-                    //*********************************************//
+                    // (only the loads of the pm node are changed)
+                    cur_lt_tracker.addLoad(cand_pm_node, send_load_pm, recv_load_pm);
+                    double max_weighted_load_pm = cur_lt_tracker.getMaxLoad();
+                    cur_lt_tracker.addLoad(cand_pm_node, -send_load_pm, -recv_load_pm);
 
                     // check if the results are preserved
                     bool is_preserved = (max_weighted_load_pm < min_max_weighted_load_pm || (max_weighted_load_pm == min_max_weighted_load_pm && bw_pm <= min_bw_pm));
-                    // bool is_preserved = (max_load_pm < min_max_load_pm || (max_load_pm == min_max_load_pm && bw_pm < min_bw_pm) || (max_load_pm == min_max_load_pm && bw_pm == min_bw_pm && stddev_max <= min_stddev_pm));
                     if (is_preserved == true)
                     { // append to the candidate results
                         if (cand_pm_node != cur_pm_node)
                         { // check if we can find a different node
-                            best_pm_nodes.push_back(pair<uint16_t, LoadTable>(cand_pm_node, cur_lt_after_pm));
+                            best_pm_nodes.push_back(cand_pm_node);
                         }
                     }
 
                     // check if the results are improved
                     bool is_improved = (max_weighted_load_pm < min_max_weighted_load_pm || (max_weighted_load_pm == min_max_weighted_load_pm && bw_pm < min_bw_pm));
-                    // bool is_improved = (max_load_pm < min_max_load_pm || (max_load_pm == min_max_load_pm && bw_pm < min_bw_pm) || (max_load_pm == min_max_load_pm && bw_pm == min_bw_pm && stddev_max < min_stddev_pm));
                     if (is_improved == true)
                     {
                         min_max_weighted_load_pm = max_weighted_load_pm;
                         min_bw_pm = bw_pm;
 
-                        // min_stddev_pm = stddev_max;
-
                         // clear previous results and append the new one
                         best_pm_nodes.clear();
-                        best_pm_nodes.push_back(pair<uint16_t, LoadTable>(cand_pm_node, cur_lt_after_pm));
+                        best_pm_nodes.push_back(cand_pm_node);
                     }
                 }
 
@@ -1222,24 +1022,29 @@ void BART::optimizeWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch,
                 { // we cannot identify such a node
                   // mark the block as relocated again
                     cur_block_placement[cur_pm_node]++;
+
+                    // add back the load for current pm node
+                    cur_lt_tracker.addLoad(cur_pm_node, -rm_send_load_pm, -rm_recv_load_pm);
                 }
                 else
                 { // we can identify such a node
                     // randomly choose a best parity compute node
                     size_t random_pos = Utils::randomUInt(0, best_pm_nodes.size() - 1, random_generator);
-                    uint32_t selected_pm_node = best_pm_nodes[random_pos].first;
-                    LoadTable &selected_cur_lt_after_pm = best_pm_nodes[random_pos].second;
+                    uint32_t selected_pm_node = best_pm_nodes[random_pos];
 
                     // update metadata
                     is_sg_updated = true;
                     stripe_group.applied_lt.enc_nodes[parity_id] = selected_pm_node; // choose to compute parity block at the node
-                    cur_lt = selected_cur_lt_after_pm;                               // update the current load table
-                    cur_lt.bw = cur_lt.bw - cur_bw_pm + min_bw_pm;                   // update the bandwidth
-                    cur_block_placement[selected_pm_node]++;                         // place the computed parity block at the node
+
+                    // update the current load table
+                    int32_t selected_send_load_pm = 0, selected_recv_load_pm = 0;
+                    getPMLoad(stripe_group, parity_id, selected_pm_node, cur_block_placement, selected_send_load_pm, selected_recv_load_pm);
+                    cur_lt_tracker.addLoad(selected_pm_node, selected_send_load_pm, selected_recv_load_pm);
+
+                    cur_lt.bw = cur_lt.bw - cur_bw_pm + min_bw_pm; // update the bandwidth
+                    cur_block_placement[selected_pm_node]++;       // place the computed parity block at the node
 
                     // printf("stripe group: %u, change for parity %u: (%u -> %u), original_cur_lt: (max_load: %u, bw: %u) new_cur_lt: (max_load: %u, bw: %u), bw_sum: %u\n", stripe_group.id, parity_id, cur_pm_node, selected_pm_node, cur_max_load_pm, cur_bw_pm, min_max_load_pm, min_bw_pm, cur_lt.bw);
-                    // Utils::printVector(selected_cur_lt_after_pm.slt);
-                    // Utils::printVector(selected_cur_lt_after_pm.rlt);
                 }
             }
 
@@ -1252,20 +1057,13 @@ void BART::optimizeWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch,
         }
 
         // summarize the max weighted load and bw after the current iteration
-        double max_weighted_load_after_opt = 0;
-        for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
-        {
-            // weighted_load = load / bw
-            double weighted_send_load = 1.0 * cur_lt.slt[node_id] / settings.bw_profile.upload[node_id];
-            double weighted_recv_load = 1.0 * cur_lt.rlt[node_id] / settings.bw_profile.download[node_id];
-            max_weighted_load_after_opt = max({max_weighted_load_after_opt, weighted_send_load, weighted_recv_load});
-        }
+        double max_weighted_load_after_opt = cur_lt_tracker.getMaxLoad();
 
         uint32_t bw_after_opt = cur_lt.bw;
 
         bool improved = max_weighted_load_after_opt < max_weighted_load_iter || (max_weighted_load_after_opt == max_weighted_load_iter && bw_after_opt < bw_iter);
 
-        printf("end iteration: %ld, cur_lt: (max_load: %f, bw: %u), improved: %u\n", iter, max_weighted_load_after_opt, bw_after_opt, improved);
+        LOG_INFO("end iteration: %ld, cur_lt: (max_load: %f, bw: %u), improved: %u", iter, max_weighted_load_after_opt, bw_after_opt, improved);
 
         // weighted load table
         vector<double> weighted_slt(settings.num_nodes);
@@ -1277,18 +1075,16 @@ void BART::optimizeWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch,
             weighted_rlt[node_id] = 1.0 * cur_lt.rlt[node_id] / settings.bw_profile.download[node_id];
         }
 
-        printf("optimized weighted_lt:\n");
-        printf("send load: ");
-        Utils::printVector(weighted_slt);
-        printf("recv load: ");
-        Utils::printVector(weighted_rlt);
+        LOG_INFO("optimized weighted_lt:");
+        LOG_INFO("send load: %s", Utils::vectorToString(weighted_slt).c_str());
+        LOG_INFO("recv load: %s", Utils::vectorToString(weighted_rlt).c_str());
 
-        printf("bandwidth: %u\n", cur_lt.bw);
+        LOG_INFO("bandwidth: %u", cur_lt.bw);
 
         gettimeofday(&end_time, nullptr);
         double finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                              (end_time.tv_usec - start_time.tv_usec) / 1000;
-        printf("finished running the iteration %lu for %lu stripe groups, time: %f ms\n", iter, stripe_batch.selected_sgs.size(), finish_time);
+        LOG_INFO("finished running the iteration %lu for %lu stripe groups, time: %f ms", iter, stripe_batch.selected_sgs.size(), finish_time);
 
         if (improved == true)
         {
@@ -1304,10 +1100,36 @@ void BART::optimizeWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch,
         }
     }
 
-    printf("finished optimization of parity block generation\n");
+    LOG_INFO("finished optimization of parity block generation");
+}
+
+uint8_t BART::getPMLoad(StripeGroup &stripe_group, uint8_t parity_id, uint16_t pm_node, u16string &cur_block_placement, int32_t &send_load, int32_t &recv_load)
+{
+    ConvertibleCode &code = stripe_group.code;
+
+    uint8_t num_parities_stored_pm_node = stripe_group.parity_dists[parity_id][pm_node];
+
+    // bandwidth for the current solution
+    uint8_t bw_pm = code.lambda_i - num_parities_stored_pm_node;
+
+    // update the send load table
+    // subtract the parity blocks stored at the pm node (no need to send)
+    send_load = -num_parities_stored_pm_node;
+
+    // check if parity block relocation is needed
+    if (cur_block_placement[pm_node] > 0)
+    {
+        send_load++;
+        bw_pm++;
+    }
+
+    // update the recv load table
+    recv_load = code.lambda_i - num_parities_stored_pm_node;
+
+    return bw_pm;
 }
 
-void BART::genParityComputationHybrid(StripeBatch &stripe_batch, string approach)
+void BART::genParityComputationHybrid(StripeBatch &stripe_batch, TransApproach approach)
 {
     ConvertibleCode &code = stripe_batch.code;
     uint16_t num_nodes = stripe_batch.settings.num_nodes;
@@ -1348,7 +1170,7 @@ void BART::genParityComputationHybrid(StripeBatch &stripe_batch, string approach
 
     // check whether the stripe can be perfectly merged by parity merging
     vector<bool> is_sg_perfect_pm(stripe_batch.selected_sgs.size(), false);
-    if (approach == "BTPM" || approach == "BT")
+    if (approach == TransApproach::BTPM || approach == TransApproach::BT)
     {
         for (auto &item : stripe_batch.selected_sgs)
         {
@@ -1373,7 +1195,7 @@ void BART::genParityComputationHybrid(StripeBatch &stripe_batch, string approach
     while (true)
     {
         iter++;
-        printf("iteration: %ld\n", iter);
+        LOG_INFO("iteration: %ld", iter);
         for (auto &item : stripe_batch.selected_sgs)
         {
             uint32_t sg_id = item.first;
@@ -1402,26 +1224,26 @@ void BART::genParityComputationHybrid(StripeBatch &stripe_batch, string approach
                 Utils::dotSubVectors(cur_lt_after.rlt, stripe_group.applied_lt.rlt, cur_lt_after.rlt);
             }
 
-            if (approach == "BTRE" || approach == "BT")
+            if (approach == TransApproach::BTRE || approach == TransApproach::BT)
             { // re-encoding
 
-                LoadTable cur_lt_after_re_base = cur_lt_after;
-
-                // add data distribution to form the base re-encoding solution
-                Utils::dotAddVectors(cur_lt_after_re_base.slt, stripe_group.data_dist, cur_lt_after_re_base.slt);
-
-                // maximum send load with base solution for re-encoding
-                uint32_t max_send_load_re_base = *max_element(cur_lt_after_re_base.slt.begin(), cur_lt_after_re_base.slt.end());
-                uint32_t max_recv_load_re_base = *max_element(cur_lt_after_re_base.rlt.begin(), cur_lt_after_re_base.rlt.end());
+                // maximum load of the base re-encoding solution (all data blocks
+                // are sent), evaluated without materializing the load table
+                uint32_t max_send_load_re_base = 0;
+                for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
+                {
+                    max_send_load_re_base = max(max_send_load_re_base, (uint32_t)(cur_lt_after.slt[node_id] + stripe_group.data_dist[node_id]));
+                }
+                uint32_t max_recv_load_re_base = *max_element(cur_lt_after.rlt.begin(), cur_lt_after.rlt.end());
 
                 for (uint16_t encode_node_id = 0; encode_node_id < num_nodes; encode_node_id++)
                 {
                     // send load: subtract the locally stored data blocks to send, and add the parity blocks for distribution
                     uint8_t num_transferred_data_blocks = code.k_f - stripe_group.data_dist[encode_node_id];
-                    uint32_t send_load_at_node = cur_lt_after_re_base.slt[encode_node_id] - stripe_group.data_dist[encode_node_id] + code.m_f;
+                    uint32_t send_load_at_node = cur_lt_after.slt[encode_node_id] + code.m_f;
 
                     // recv load: add the data blocks received
-                    uint32_t recv_load_at_node = cur_lt_after_re_base.rlt[encode_node_id] + num_transferred_data_blocks;
+                    uint32_t recv_load_at_node = cur_lt_after.rlt[encode_node_id] + num_transferred_data_blocks;
 
                     // maximum load and bandwidth
                     uint32_t max_load = max(max(max_send_load_re_base, max_recv_load_re_base), max(send_load_at_node, recv_load_at_node));
@@ -1447,7 +1269,7 @@ void BART::genParityComputationHybrid(StripeBatch &stripe_batch, string approach
                 }
             }
 
-            if (approach == "BTPM" || approach == "BT")
+            if (approach == TransApproach::BTPM || approach == TransApproach::BT)
             { // parity merging
 
                 // For the brute-force method, we need to enumerate all possible parity block compute nodes (M ^ code.m_f solutions);
@@ -1464,42 +1286,53 @@ void BART::genParityComputationHybrid(StripeBatch &stripe_batch, string approach
                 {
                     uint32_t min_max_load_pm_parity = UINT32_MAX;
                     uint8_t min_bw_pm_parity = UINT8_MAX;
-                    vector<pair<uint16_t, LoadTable>> best_parity_compute_nodes;
+                    vector<uint16_t> best_parity_compute_nodes;
+
+                    // computing the parity block at a node only adds loads: the
+                    // parity blocks are sent from the nodes storing them (except
+                    // the compute node), and the compute node receives them (and
+                    // sends the computed block if relocation is needed); so the
+                    // maximum load of a candidate is evaluated from the current
+                    // maximum loads and the few changed nodes, without copying
+                    // the load table
+                    u16string &parity_dist = stripe_group.parity_dists[parity_id];
+                    vector<uint16_t> parity_stored_nodes;
+                    for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
+                    {
+                        if (parity_dist[node_id] > 0)
+                        {
+                            parity_stored_nodes.push_back(node_id);
+                        }
+                    }
+                    uint32_t max_send_load_pm_base = *max_element(cur_lt_after_pm.slt.begin(), cur_lt_after_pm.slt.end());
+                    uint32_t max_recv_load_pm_base = *max_element(cur_lt_after_pm.rlt.begin(), cur_lt_after_pm.rlt.end());
 
                     for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
                     {
                         uint16_t parity_compute_node = node_id;
-                        uint8_t num_stored_parity_cmp_node = stripe_group.parity_dists[parity_id][parity_compute_node];
-
-                        // record cur_lt_after_pm_parity after compute the parity block at node_id
-                        LoadTable cur_lt_after_pm_parity = cur_lt_after_pm;
+                        uint8_t num_stored_parity_cmp_node = parity_dist[parity_compute_node];
 
                         // bandwidth for the current solution
                         uint8_t bw_pm_parity = code.lambda_i - num_stored_parity_cmp_node;
 
-                        // update the send load table
-                        // add the parity blocks to send
-                        for (auto &stripe : stripe_group.pre_stripes)
+                        // send load: add the parity blocks to send
+                        uint32_t max_send_load_pm_parity = max_send_load_pm_base;
+                        for (auto parity_stored_node : parity_stored_nodes)
                         {
-                            uint16_t parity_stored_node = stripe->indices[code.k_i + parity_id];
                             if (parity_stored_node != parity_compute_node)
                             {
-                                cur_lt_after_pm_parity.slt[parity_stored_node]++;
+                                max_send_load_pm_parity = max(max_send_load_pm_parity, (uint32_t)(cur_lt_after_pm.slt[parity_stored_node] + parity_dist[parity_stored_node]));
                             }
                         }
 
                         if (cur_block_placement[parity_compute_node] > 0)
                         { // check if parity block relocation is needed
-                            cur_lt_after_pm_parity.slt[parity_compute_node]++;
+                            max_send_load_pm_parity = max(max_send_load_pm_parity, (uint32_t)(cur_lt_after_pm.slt[parity_compute_node] + 1));
                             bw_pm_parity++;
                         }
 
-                        // update the recv load table
-                        cur_lt_after_pm_parity.rlt[parity_compute_node] += (code.lambda_i - num_stored_parity_cmp_node);
-
-                        // maximum load for the current solution
-                        uint32_t max_send_load_pm_parity = *max_element(cur_lt_after_pm_parity.slt.begin(), cur_lt_after_pm_parity.slt.end());
-                        uint32_t max_recv_load_pm_parity = *max_element(cur_lt_after_pm_parity.rlt.begin(), cur_lt_after_pm_parity.rlt.end());
+                        // recv load: add the parity blocks received
+                        uint32_t max_recv_load_pm_parity = max(max_recv_load_pm_base, (uint32_t)(cur_lt_after_pm.rlt[parity_compute_node] + code.lambda_i - num_stored_parity_cmp_node));
 
                         // maximum load and bandwidth
                         uint32_t max_load_pm_parity = max(max_send_load_pm_parity, max_recv_load_pm_parity);
@@ -1516,19 +1349,31 @@ void BART::genParityComputationHybrid(StripeBatch &stripe_batch, string approach
                             }
                             if (bw_pm_parity <= min_bw_pm_parity)
                             {
-                                best_parity_compute_nodes.push_back(pair<uint16_t, LoadTable>(parity_compute_node, cur_lt_after_pm_parity));
+                                best_parity_compute_nodes.push_back(parity_compute_node);
                             }
                         }
                     }
 
                     // randomly choose a best parity compute node
                     size_t random_pos = Utils::randomUInt(0, best_parity_compute_nodes.size() - 1, random_generator);
-                    uint32_t selected_parity_compute_node = best_parity_compute_nodes[random_pos].first;
-                    LoadTable &selected_cur_lt_after_pm_parity = best_parity_compute_nodes[random_pos].second;
+                    uint16_t selected_parity_compute_node = best_parity_compute_nodes[random_pos];
+
+                    // apply the loads of the selected node to the current load table
+                    for (auto parity_stored_node : parity_stored_nodes)
+                    {
+                        if (parity_stored_node != selected_parity_compute_node)
+                        {
+                            cur_lt_after_pm.slt[parity_stored_node] += parity_dist[parity_stored_node];
+                        }
+                    }
+                    if (cur_block_placement[selected_parity_compute_node] > 0)
+                    {
+                        cur_lt_after_pm.slt[selected_parity_compute_node]++;
+                    }
+                    cur_lt_after_pm.rlt[selected_parity_compute_node] += code.lambda_i - parity_dist[selected_parity_compute_node];
 
                     // update metadata
                     pm_nodes[parity_id] = selected_parity_compute_node;  // choose to compute parity block at the node
-                    cur_lt_after_pm = selected_cur_lt_after_pm_parity;   // update the current load table
                     cur_pm_bw += min_bw_pm_parity;                       // add bandwidth
                     cur_block_placement[selected_parity_compute_node]++; // place the computed parity block at the node
 
@@ -1586,10 +1431,6 @@ void BART::genParityComputationHybrid(StripeBatch &stripe_batch, string approach
             // apply the load table for stripe group
             stripe_group.applied_lt = selected_lt;
 
-            // free up the memory
-            stripe_group.cand_partial_lts.resize(0);
-            stripe_group.cand_partial_lts.shrink_to_fit();
-
             // printf("applied_lt for stripe group %u:\n", stripe_group.id);
             // printf("send load: ");
             // Utils::printVector(stripe_group.applied_lt.slt);
@@ -1633,9 +1474,6 @@ void BART::genParityComputationHybrid(StripeBatch &stripe_batch, string approach
         StripeGroup &stripe_group = item.second;
         stripe_group.parity_comp_method = stripe_group.applied_lt.approach;
         stripe_group.parity_comp_nodes = stripe_group.applied_lt.enc_nodes;
-
-        // clear the candidate load tables for memory saving
-        stripe_group.cand_partial_lts.clear();
     }
 
     uint32_t num_re_groups = 0;
@@ -1647,15 +1485,13 @@ void BART::genParityComputationHybrid(StripeBatch &stripe_batch, string approach
     gettimeofday(&end_time, nullptr);
     finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                   (end_time.tv_usec - start_time.tv_usec) / 1000;
-    printf("finished finding parity computation scheme for %lu stripe groups, time: %f ms\n", stripe_batch.selected_sgs.size(), finish_time);
-
-    printf("final load table with data relocation (send load only), parity generation (both send and receive load) and parity relocation (send load only):\n");
-    printf("send load: ");
-    Utils::printVector(cur_lt.slt);
-    printf("recv load: ");
-    Utils::printVector(cur_lt.rlt);
-    printf("bandwidth: %u\n", cur_lt.bw);
-    printf("number of re-encoding groups: (%u / %lu), number of parity merging groups: (%lu / %lu)\n", num_re_groups, stripe_batch.selected_sgs.size(), (stripe_batch.selected_sgs.size() - num_re_groups), stripe_batch.selected_sgs.size());
+    LOG_INFO("finished finding parity computation scheme for %lu stripe groups, time: %f ms", stripe_batch.selected_sgs.size(), finish_time);
+
+    LOG_INFO("final load table with data relocation (send load only), parity generation (both send and receive load) and parity relocation (send load only):");
+    LOG_INFO("send load: %s", Utils::vectorToString(cur_lt.slt).c_str());
+    LOG_INFO("recv load: %s", Utils::vectorToString(cur_lt.rlt).c_str());
+    LOG_INFO("bandwidth: %u", cur_lt.bw);
+    LOG_INFO("number of re-encoding groups: (%u / %lu), number of parity merging groups: (%lu / %lu)", num_re_groups, stripe_batch.selected_sgs.size(), (stripe_batch.selected_sgs.size() - num_re_groups), stripe_batch.selected_sgs.size());
 }
 
 void BART::genStripeRedistribution(StripeBatch &stripe_batch)
@@ -1791,25 +1627,25 @@ void BART::genStripeRedistribution(StripeBatch &stripe_batch)
     // initialize bipartite right vertices in_degrees with the receive load of parity generation
     for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
     {
-        Vertex &rvtx = bipartite.right_vertices_map[node2rvtx_map[node_id]];
+        Vertex &rvtx = bipartite.right_vertices[node2rvtx_map[node_id]];
         rvtx.in_degree = lt.rlt[node_id];
     }
 
-    printf("finished constructing bipartite graph\n");
+    LOG_INFO("finished constructing bipartite graph");
 
-    printf("bipartite.left_vertices (size: %ld):\n", bipartite.left_vertices_map.size());
-    printf("bipartite.right_vertices (size: %ld):\n", bipartite.right_vertices_map.size());
+    LOG_INFO("bipartite.left_vertices (size: %ld):", bipartite.left_vertices.size());
+    LOG_INFO("bipartite.right_vertices (size: %ld):", bipartite.right_vertices.size());
 
     // step 3: find optimal semi-matching (based on the initial receive load)
     vector<uint64_t> sm_edges = bipartite.findOptSemiMatching(lvtx2sg_map, sg2lvtx_map);
 
-    printf("finished finding semi-matching solutions\n");
+    LOG_INFO("finished finding semi-matching solutions");
 
     // update the final_block_placement from chosen edges
     for (auto edge_id : sm_edges)
     {
-        Edge &edge = bipartite.edges_map[edge_id];
-        Vertex &lvtx = bipartite.left_vertices_map[edge.lvtx_id];
+        Edge &edge = bipartite.edges[edge_id];
+        Vertex &lvtx = bipartite.left_vertices[edge.lvtx_id];
         uint32_t sg_id = lvtx2sg_map[lvtx.id].first;
         uint8_t final_block_id = lvtx2sg_map[lvtx.id].second;
         uint16_t reloc_node_id = rvtx2node_map[edge.rvtx_id];
@@ -1828,7 +1664,7 @@ void BART::genStripeRedistribution(StripeBatch &stripe_batch)
     gettimeofday(&end_time, nullptr);
     finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                   (end_time.tv_usec - start_time.tv_usec) / 1000;
-    printf("finished finding block relocation scheme for %lu stripe groups, time: %f ms\n", stripe_batch.selected_sgs.size(), finish_time);
+    LOG_INFO("finished finding block relocation scheme for %lu stripe groups, time: %f ms", stripe_batch.selected_sgs.size(), finish_time);
 }
 
 void BART::genWeightedStripeRedistribution(StripeBatch &stripe_batch)
@@ -1969,14 +1805,14 @@ void BART::genWeightedStripeRedistribution(StripeBatch &stripe_batch)
     // initialize bipartite right vertices in_degrees with the receive load of parity generation
     for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
     {
-        Vertex &rvtx = bipartite.right_vertices_map[node2rvtx_map[node_id]];
+        Vertex &rvtx = bipartite.right_vertices[node2rvtx_map[node_id]];
         rvtx.in_degree = lt.rlt[node_id];
     }
 
-    printf("finished constructing bipartite graph\n");
+    LOG_INFO("finished constructing bipartite graph");
 
-    printf("bipartite.left_vertices (size: %ld):\n", bipartite.left_vertices_map.size());
-    printf("bipartite.right_vertices (size: %ld):\n", bipartite.right_vertices_map.size());
+    LOG_INFO("bipartite.left_vertices (size: %ld):", bipartite.left_vertices.size());
+    LOG_INFO("bipartite.right_vertices (size: %ld):", bipartite.right_vertices.size());
 
     // create rvtx to weight map, each item: <rvtx_id, node_weight (download bandwidth)>
     // weight equals the download bandwidth of the node
@@ -1991,13 +1827,13 @@ void BART::genWeightedStripeRedistribution(StripeBatch &stripe_batch)
     vector<uint64_t>
         sm_edges = bipartite.findOptWeightedSemiMatching(lvtx2sg_map, sg2lvtx_map, rvtx2weight_map);
 
-    printf("finished finding weighted semi-matching solutions\n");
+    LOG_INFO("finished finding weighted semi-matching solutions");
 
     // update the final_block_placement from chosen edges
     for (auto edge_id : sm_edges)
     {
-        Edge &edge = bipartite.edges_map[edge_id];
-        Vertex &lvtx = bipartite.left_vertices_map[edge.lvtx_id];
+        Edge &edge = bipartite.edges[edge_id];
+        Vertex &lvtx = bipartite.left_vertices[edge.lvtx_id];
         uint32_t sg_id = lvtx2sg_map[lvtx.id].first;
         uint8_t final_block_id = lvtx2sg_map[lvtx.id].second;
         uint16_t reloc_node_id = rvtx2node_map[edge.rvtx_id];
@@ -2016,5 +1852,5 @@ void BART::genWeightedStripeRedistribution(StripeBatch &stripe_batch)
     gettimeofday(&end_time, nullptr);
     finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                   (end_time.tv_usec - start_time.tv_usec) / 1000;
-    printf("finished finding block relocation scheme for %lu stripe groups, time: %f ms\n", stripe_batch.selected_sgs.size(), finish_time);
+    LOG_INFO("finished finding block relocation scheme for %lu stripe groups, time: %f ms", stripe_batch.selected_sgs.size(), finish_time);
 }
\ No newline at end of file
@@ -2,9 +2,11 @@
 #define __BART_HH__
 
 #include "../util/Utils.hh"
+#include "../util/Logger.hh"
 #include "StripeBatch.hh"
 #include "TransSolution.hh"
 #include "Bipartite.hh"
+#include "LoadTableTracker.hh"
 // #include "RecvBipartite.hh"
 
 class BART
@@ -24,7 +26,7 @@ public:
      * @param stripe_batch
      * @param approach transitioning approach (re-encoding, parity merging)
      */
-    void genSolution(StripeBatch &stripe_batch, string approach);
+    void genSolution(StripeBatch &stripe_batch, TransApproach approach);
 
     /**
      * @brief generate solution for parity block generation for the stripe
@@ -113,6 +115,22 @@ public:
      */
     void optimizeWeightedSolOfParityGenerationForPM(StripeBatch &stripe_batch, vector<vector<bool>> &is_perfect_pm, LoadTable &cur_lt);
 
+    /**
+     * @brief get the load on pm_node and bandwidth for generating the parity
+     * block at pm_node with parity merging; the load is relative to the load
+     * table where all original parity blocks are counted as sent (only the
+     * loads of pm_node are changed)
+     *
+     * @param stripe_group
+     * @param parity_id
+     * @param pm_node parity merging node
+     * @param cur_block_placement current block placement of the stripe group
+     * @param send_load (out) send load on pm_node
+     * @param recv_load (out) receive load on pm_node
+     * @return uint8_t bandwidth
+     */
+    uint8_t getPMLoad(StripeGroup &stripe_group, uint8_t parity_id, uint16_t pm_node, u16string &cur_block_placement, int32_t &send_load, int32_t &recv_load);
+
     /**
      * @brief generate solution for parity block generation for the stripe
      * batch (hybrid with re-encoding and parity merging)
@@ -120,7 +138,7 @@ public:
      * @param stripe_batch
      * @param approach
      */
-    void genParityComputationHybrid(StripeBatch &stripe_batch, string approach);
+    void genParityComputationHybrid(StripeBatch &stripe_batch, TransApproach approach);
 
     /**
      * @brief generate solution for stripe re-distribution for the stripe batch
@@ -8,25 +8,25 @@ BWOptSolution::~BWOptSolution()
 {
 }
 
-void BWOptSolution::genSolution(StripeBatch &stripe_batch, string approach)
+void BWOptSolution::genSolution(StripeBatch &stripe_batch, TransApproach approach)
 {
     // Step 1: enumerate a sufficiently large number of possible stripe
     // groups; pick non-overlapped stripe groups in ascending order of
     // transitioning bandwidth
-    printf("Step 1: construct stripe groups\n");
+    LOG_INFO("Step 1: construct stripe groups");
     stripe_batch.constructSGByBWPartial(approach);
     // stripe_batch.constructSGByBWBF(approach);
     // stripe_batch.print();
 
     // Step 2: generate transition solutions from all stripe groups
-    printf("Step 2: generate transition solution\n");
+    LOG_INFO("Step 2: generate transition solution");
     for (auto &item : stripe_batch.selected_sgs)
     {
         genSolution(item.second, approach);
     }
 }
 
-void BWOptSolution::genSolution(StripeGroup &stripe_group, string approach)
+void BWOptSolution::genSolution(StripeGroup &stripe_group, TransApproach approach)
 {
     ConvertibleCode &code = stripe_group.code;
     uint16_t num_nodes = stripe_group.settings.num_nodes;
@@ -39,11 +39,11 @@ void BWOptSolution::genSolution(StripeGroup &stripe_group, string approach)
     // record minimum bw and corresponding placement
     u16string enc_nodes(code.m_f, INVALID_NODE_ID);
 
-    if (approach == "BWRE")
+    if (approach == TransApproach::BWRE)
     { // re-encoding only
         stripe_group.getREBW(enc_nodes);
     }
-    else if (approach == "BWPM")
+    else if (approach == TransApproach::BWPM)
     { // parity merging only
         stripe_group.getPMBW(enc_nodes);
     }
@@ -112,11 +112,11 @@ void BWOptSolution::genSolution(StripeGroup &stripe_group, string approach)
     }
 
     // update stripe group metadata
-    if (approach == "BWRE")
+    if (approach == TransApproach::BWRE)
     {
         stripe_group.parity_comp_method = EncodeMethod::RE_ENCODE;
     }
-    else if (approach == "BWPM")
+    else if (approach == TransApproach::BWPM)
     {
         stripe_group.parity_comp_method = EncodeMethod::PARITY_MERGE;
     }
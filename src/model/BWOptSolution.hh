@@ -3,6 +3,7 @@
 
 #include "../include/include.hh"
 #include "../util/Utils.hh"
+#include "../util/Logger.hh"
 #include "StripeBatch.hh"
 #include "StripeGroup.hh"
 
@@ -26,7 +27,7 @@ public:
      * @param stripe_batch
      * @param approach transitioning approach (re-encoding, parity merging)
      */
-    void genSolution(StripeBatch &stripe_batch, string approach);
+    void genSolution(StripeBatch &stripe_batch, TransApproach approach);
 
     /**
      * @brief generate transitioning solution for the stripe group
@@ -34,7 +35,7 @@ public:
      * @param stripe_group
      * @param approach transitioning approach (re-encoding, parity merging)
      */
-    void genSolution(StripeGroup &stripe_group, string approach);
+    void genSolution(StripeGroup &stripe_group, TransApproach approach);
 };
 
 #endif // __BW_OPT_SOLUTION_HH__
\ No newline at end of file
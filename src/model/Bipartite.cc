@@ -10,24 +10,25 @@ Bipartite::~Bipartite()
 
 uint64_t Bipartite::addVertex(VertexType type)
 {
-    unordered_map<uint64_t, Vertex> *vtx_map_ptr = NULL;
+    vector<Vertex> *vertices_ptr = NULL;
     if (type == VertexType::LEFT)
     { // left vertex
-        vtx_map_ptr = &left_vertices_map;
+        vertices_ptr = &left_vertices;
     }
     else if (type == VertexType::RIGHT)
     { // right vertex
-        vtx_map_ptr = &right_vertices_map;
+        vertices_ptr = &right_vertices;
     }
     else
     {
-        printf("invalid vertex type: %d\n", type);
+        LOG_ERROR("invalid vertex type: %d", type);
         return INVALID_VTX_ID;
     }
 
     // create new vertex
-    uint64_t new_vtx_id = vtx_map_ptr->size(); // vertex id
-    Vertex &vtx = (*vtx_map_ptr)[new_vtx_id];
+    uint64_t new_vtx_id = vertices_ptr->size(); // vertex id
+    vertices_ptr->push_back(Vertex());
+    Vertex &vtx = vertices_ptr->back();
     vtx.id = new_vtx_id;
     vtx.type = type;
 
@@ -37,401 +38,259 @@ uint64_t Bipartite::addVertex(VertexType type)
 uint64_t Bipartite::addEdge(uint64_t lvtx_id, uint64_t rvtx_id)
 {
 
-    // create new vertex
-    uint64_t new_edge_id = edges_map.size(); // edge id
-    Edge &edge = edges_map[new_edge_id];
+    // create new edge
+    uint64_t new_edge_id = edges.size(); // edge id
+    edges.push_back(Edge());
+    Edge &edge = edges.back();
     edge.id = new_edge_id;
     edge.lvtx_id = lvtx_id;
     edge.rvtx_id = rvtx_id;
 
-    // create references
-    lvtx_edges_map[lvtx_id].push_back(edge.id);
-    rvtx_edges_map[rvtx_id].push_back(edge.id);
-
     return new_edge_id;
 }
 
-vector<uint64_t> Bipartite::findOptSemiMatching(unordered_map<uint64_t, pair<uint32_t, uint8_t>> &lvtx2sg_map, unordered_map<uint32_t, vector<uint64_t>> &sg2lvtx_map)
+void Bipartite::buildCSR()
 {
-    vector<uint64_t> sol_edges;
-
-    uint64_t num_lvtxes = left_vertices_map.size();
-    uint64_t num_rvtxes = right_vertices_map.size();
-    bool *adjacency_matrix = (bool *)calloc(num_lvtxes * num_rvtxes, sizeof(bool));            // adjacency matrix
-    uint64_t *edge_id_adj_mat = (uint64_t *)calloc(num_lvtxes * num_rvtxes, sizeof(uint64_t)); // map edge_id with items in adjacency matrix
-    bool *cur_sm_matrix = (bool *)calloc(num_lvtxes * num_rvtxes, sizeof(bool));               // current semi-matching matrix (record current semi-matching)
+    buildCSR(left_vertices.size(), true, lvtx_edge_offsets, lvtx_edge_ids);
+    buildCSR(right_vertices.size(), false, rvtx_edge_offsets, rvtx_edge_ids);
+}
 
-    // mark the adjacency matrix
-    // lvtx: [idx: 0 to num_lvtxes - 1]
-    // rvtx: [idx: 0 to num_rvtxes - 1]
-    for (auto &item : edges_map)
+void Bipartite::buildCSR(uint64_t num_vtxes, bool is_left, vector<uint64_t> &offsets, vector<uint64_t> &edge_ids)
+{
+    // count the degree of each vertex
+    offsets.assign(num_vtxes + 1, 0);
+    for (auto &edge : edges)
     {
-        uint64_t edge_id = item.first;
-        uint64_t lvtx_id = item.second.lvtx_id;
-        uint64_t rvtx_id = item.second.rvtx_id;
-        adjacency_matrix[lvtx_id * num_rvtxes + rvtx_id] = true;   // mark the edge in adjacent matrix
-        edge_id_adj_mat[lvtx_id * num_rvtxes + rvtx_id] = edge_id; // record edge_id for the item in adjacent matrix
+        uint64_t vtx_id = is_left == true ? edge.lvtx_id : edge.rvtx_id;
+        offsets[vtx_id + 1]++;
     }
 
-    // printf("adjacency matrix:\n");
-    // for (uint64_t lvtx_id = 0; lvtx_id < num_lvtxes; lvtx_id++)
-    // {
-    //     for (uint64_t rvtx_id = 0; rvtx_id < num_rvtxes; rvtx_id++)
-    //     {
-    //         printf("%d ", adjacency_matrix[lvtx_id * num_rvtxes + rvtx_id]);
-    //     }
-    //     printf("\n");
-    // }
-    // printf("\n");
+    // prefix sum
+    for (uint64_t vtx_id = 0; vtx_id < num_vtxes; vtx_id++)
+    {
+        offsets[vtx_id + 1] += offsets[vtx_id];
+    }
 
-    // loop each left vertex (as root)
-    for (uint64_t idx = 0; idx < num_lvtxes; idx++)
+    // fill in the edges (in insertion order)
+    edge_ids.assign(edges.size(), INVALID_EDGE_ID);
+    vector<uint64_t> pos(offsets.begin(), offsets.end() - 1);
+    for (auto &edge : edges)
     {
-        Vertex &root_lvtx = left_vertices_map[idx];
+        uint64_t vtx_id = is_left == true ? edge.lvtx_id : edge.rvtx_id;
+        edge_ids[pos[vtx_id]++] = edge.id;
+    }
+}
 
-        // build alternating search tree with lvtx as the root
-        queue<Vertex *> bfs_queue;
-        bfs_queue.push(&root_lvtx);                   // enqueue root lvtx
-        vector<bool> lvtx_visited(num_lvtxes, false); // record whether the lvtx is visited
-        vector<bool> rvtx_visited(num_rvtxes, false);
-        Vertex *least_load_rvtx = NULL;                    // least load rvtx
-        unordered_map<uint64_t, uint64_t> lvtx_parent_map; // trace the alternating path
-        unordered_map<uint64_t, uint64_t> rvtx_parent_map; // trace the alternating path
-
-        while (bfs_queue.empty() == false)
-        {
-            Vertex &vtx = *bfs_queue.front();
-            bfs_queue.pop();
-            vector<uint64_t> neighbors; // for lvtxes, find unmatched neighbors; for rvtxes, find matched neighbors
+vector<uint64_t> Bipartite::findOptSemiMatching(unordered_map<uint64_t, pair<uint32_t, uint8_t>> &lvtx2sg_map, unordered_map<uint32_t, vector<uint64_t>> &sg2lvtx_map)
+{
+    return findOptSemiMatching(lvtx2sg_map, sg2lvtx_map, NULL);
+}
 
-            // check if it's left or right vertex
-            if (vtx.type == VertexType::LEFT)
-            {
-                uint64_t sg_id = lvtx2sg_map[vtx.id].first;
-                vector<uint64_t> sg_lvtxes = sg2lvtx_map[sg_id];
-                // find unmatched rvtxes, which is not connected by lvtxes of the same stripe group
-                vector<uint64_t> &connected_edges = lvtx_edges_map[vtx.id];
+vector<uint64_t> Bipartite::findOptWeightedSemiMatching(unordered_map<uint64_t, pair<uint32_t, uint8_t>> &lvtx2sg_map, unordered_map<uint32_t, vector<uint64_t>> &sg2lvtx_map, unordered_map<uint64_t, double> &rvtx2weight_map)
+{
+    // weight of each right vertex
+    vector<double> rvtx_weights(right_vertices.size(), 0);
+    for (uint64_t rvtx_id = 0; rvtx_id < right_vertices.size(); rvtx_id++)
+    {
+        rvtx_weights[rvtx_id] = rvtx2weight_map[rvtx_id];
+    }
 
-                for (auto edge_id : connected_edges)
-                {
-                    uint64_t rvtx_id = edges_map[edge_id].rvtx_id;
-
-                    assert(adjacency_matrix[vtx.id * num_rvtxes + rvtx_id] == true); // make sure the item in adjacency matrix is valid
-
-                    // find an unmatched edge
-                    if (cur_sm_matrix[vtx.id * num_rvtxes + rvtx_id] == false)
-                    {
-                        // we don't allow the lvtx connect to a rvtx which is already connected with a lvtx of the same stripe group, as alternating the paths within the two lvtxes in the same stripe group doesn't help reducing the load
-                        bool is_rvtx_valid = true;
-
-                        for (auto sg_lvtx : sg_lvtxes)
-                        {
-                            if (cur_sm_matrix[sg_lvtx * num_rvtxes + rvtx_id] == true) // rvtx already been matched by sg_lvtx of the same stripe group
-                            {
-                                is_rvtx_valid = false; // mark the edge as not valid
-                                break;
-                            }
-                        }
-
-                        // if the edge is unmatched
-                        if (is_rvtx_valid == true)
-                        {
-                            neighbors.push_back(rvtx_id); // obtain unmatched rvtx
-                        }
-                    }
-                }
-            }
-            else if (vtx.type == VertexType::RIGHT)
-            {
-                // find matched lvtxes, which is connected by some lvtxes
-                vector<uint64_t> &connected_edges = rvtx_edges_map[vtx.id];
-                for (auto edge_id : connected_edges)
-                {
-                    uint64_t lvtx_id = edges_map[edge_id].lvtx_id; // corresponding lvtx
+    return findOptSemiMatching(lvtx2sg_map, sg2lvtx_map, &rvtx_weights);
+}
 
-                    assert(adjacency_matrix[lvtx_id * num_rvtxes + vtx.id] == true); // make sure the item in adjacency matrix is valid
+vector<uint64_t> Bipartite::findOptSemiMatching(unordered_map<uint64_t, pair<uint32_t, uint8_t>> &lvtx2sg_map, unordered_map<uint32_t, vector<uint64_t>> &sg2lvtx_map, vector<double> *rvtx_weights)
+{
+    // For each root lvtx, we search an alternating path (with BFS) to the
+    // least (weighted) load rvtx (first found in BFS order), and update the
+    // semi-matching along the path (cost-reducing path). As rvtxes are kept
+    // ordered by load, the search stops early once no undiscovered rvtx has
+    // a lower load than the selected one, as the selection can no longer
+    // change
 
-                    if (cur_sm_matrix[lvtx_id * num_rvtxes + vtx.id] == true) // find matched edge
-                    {
-                        neighbors.push_back(lvtx_id); // obtain matched lvtx
-                    }
-                }
+    vector<uint64_t> sol_edges;
 
-                // if currently least_load_rvtx is not selected, or current rvtx has lower load than least_load_rvtx, set current rvtx as the least load rvtx
-                if (least_load_rvtx == NULL || vtx.in_degree < least_load_rvtx->in_degree)
-                {
-                    least_load_rvtx = &vtx;
-                }
-            }
+    uint64_t num_lvtxes = left_vertices.size();
+    uint64_t num_rvtxes = right_vertices.size();
 
-            // loop the neighbors if they are not visited
-            for (auto neighbor_vtx_id : neighbors)
-            {
-                Vertex *nvtx = NULL;
-                if (vtx.type == VertexType::LEFT)
-                {
-                    // the neighbor is a rvtx
-                    if (rvtx_visited[neighbor_vtx_id] == true) // skip visited neighbor
-                    {
-                        continue;
-                    }
-                    nvtx = &right_vertices_map[neighbor_vtx_id]; // obtain nvtx
-                    rvtx_parent_map[neighbor_vtx_id] = vtx.id;   // mark parent
-                    rvtx_visited[neighbor_vtx_id] = true;        // mark visited
-                }
-                else if (vtx.type == VertexType::RIGHT)
-                {
-                    // the neighbor is a lvtx
-                    if (lvtx_visited[neighbor_vtx_id] == true) // skip visited neighbor
-                    {
-                        continue;
-                    }
-                    nvtx = &left_vertices_map[neighbor_vtx_id]; // obtain nvtx
-                    lvtx_parent_map[neighbor_vtx_id] = vtx.id;  // mark parent
-                    lvtx_visited[neighbor_vtx_id] = true;       // mark visited
-                }
+    // build adjacency
+    buildCSR();
 
-                bfs_queue.push(nvtx); // enqueue the neighbor
-            }
-        }
+    // stripe group lvtxes of each lvtx
+    vector<vector<uint64_t> *> lvtx_sg_lvtxes(num_lvtxes, NULL);
+    for (uint64_t lvtx_id = 0; lvtx_id < num_lvtxes; lvtx_id++)
+    {
+        lvtx_sg_lvtxes[lvtx_id] = &sg2lvtx_map[lvtx2sg_map[lvtx_id].first];
+    }
 
-        // we already found an alternating path from root to selected_rvtx, thus we choose the edges along the path
-        // for edges chosen before (in alternating path, it's pointed from rvtx to lvtx), we mark the cur_sm_matrix[lvtx][rvtx] as false; for newly added edge (in alternating path, it's pointed from lvtx to rvtx), we mark cur_sm_matrix[lvtx][rvtx] as true
-        Vertex *v = least_load_rvtx;
-        Vertex *u = &left_vertices_map[rvtx_parent_map[v->id]];
-        cur_sm_matrix[u->id * num_rvtxes + v->id] = true;
-        v->in_degree++; // increase load of v only
-        while (u->id != root_lvtx.id)
-        {
-            // remove v->u
-            v = &right_vertices_map[lvtx_parent_map[u->id]];
-            cur_sm_matrix[u->id * num_rvtxes + v->id] = false;
-            // add u->v
-            u = &left_vertices_map[rvtx_parent_map[v->id]];
-            cur_sm_matrix[u->id * num_rvtxes + v->id] = true;
-        }
+    // current semi-matching (record the matched edge of each lvtx, and the
+    // matched edges of each rvtx ordered by edge id)
+    lvtx_matched_edge.assign(num_lvtxes, INVALID_EDGE_ID);
+    vector<set<uint64_t>> rvtx_matched_edges(num_rvtxes);
+
+    // rvtxes ordered by (weighted) load: <load, rvtx_id>
+    set<pair<double, uint64_t>> rvtx_loads;
+    for (auto &rvtx : right_vertices)
+    {
+        rvtx_loads.insert(pair<double, uint64_t>(getRvtxLoad(rvtx, rvtx_weights), rvtx.id));
     }
 
-    // record the edges in the semi-matching
-    for (uint64_t lvtx_id = 0; lvtx_id < num_lvtxes; lvtx_id++)
+    // search states (reused across roots; a vertex is visited in the
+    // current search iff its stamp equals the search stamp)
+    vector<uint64_t> bfs_rvtx_queue;
+    bfs_rvtx_queue.reserve(num_rvtxes);
+    vector<uint64_t> rvtx_visited_stamp(num_rvtxes, 0);
+    vector<uint64_t> rvtx_sg_stamp(num_rvtxes, 0);                 // mark rvtxes matched by lvtxes of the same stripe group
+    vector<uint64_t> rvtx_parent_edge(num_rvtxes, INVALID_EDGE_ID); // trace the alternating path (unmatched edge from the parent lvtx)
+    uint64_t search_stamp = 0;
+    uint64_t sg_stamp = 0;
+
+    set<pair<double, uint64_t>>::iterator undiscovered_it; // least (weighted) load undiscovered rvtx
+    Vertex *least_load_rvtx = NULL;                        // least (weighted) load rvtx
+    double least_load = 0;
+
+    // visit a lvtx in the alternating search tree: find unmatched rvtxes,
+    // which is not connected by lvtxes of the same stripe group; return
+    // whether the search is done
+    auto visitLvtx = [&](uint64_t lvtx_id) -> bool
     {
-        for (uint64_t rvtx_id = 0; rvtx_id < num_rvtxes; rvtx_id++)
+        // we don't allow the lvtx connect to a rvtx which is already connected with a lvtx of the same stripe group, as alternating the paths within the two lvtxes in the same stripe group doesn't help reducing the load
+        sg_stamp++;
+        for (auto sg_lvtx : *lvtx_sg_lvtxes[lvtx_id])
         {
-            if (cur_sm_matrix[lvtx_id * num_rvtxes + rvtx_id] == true)
+            uint64_t sg_matched_edge_id = lvtx_matched_edge[sg_lvtx];
+            if (sg_matched_edge_id != INVALID_EDGE_ID)
             {
-                uint64_t edge_id = edge_id_adj_mat[lvtx_id * num_rvtxes + rvtx_id];
-                sol_edges.push_back(edge_id);
+                rvtx_sg_stamp[edges[sg_matched_edge_id].rvtx_id] = sg_stamp;
             }
         }
-    }
 
-    free(adjacency_matrix);
-    free(edge_id_adj_mat);
-    free(cur_sm_matrix);
+        for (uint64_t pos = lvtx_edge_offsets[lvtx_id]; pos < lvtx_edge_offsets[lvtx_id + 1]; pos++)
+        {
+            uint64_t edge_id = lvtx_edge_ids[pos];
+            uint64_t rvtx_id = edges[edge_id].rvtx_id;
 
-    return sol_edges;
-}
+            // the neighbor is a rvtx; skip invalid or visited neighbor
+            if (rvtx_sg_stamp[rvtx_id] == sg_stamp || rvtx_visited_stamp[rvtx_id] == search_stamp)
+            {
+                continue;
+            }
 
-vector<uint64_t> Bipartite::findOptWeightedSemiMatching(unordered_map<uint64_t, pair<uint32_t, uint8_t>> &lvtx2sg_map, unordered_map<uint32_t, vector<uint64_t>> &sg2lvtx_map, unordered_map<uint64_t, double> &rvtx2weight_map)
-{
-    vector<uint64_t> sol_edges;
+            rvtx_parent_edge[rvtx_id] = edge_id;        // mark parent
+            rvtx_visited_stamp[rvtx_id] = search_stamp; // mark visited
+            bfs_rvtx_queue.push_back(rvtx_id);          // enqueue the neighbor
 
-    uint64_t num_lvtxes = left_vertices_map.size();
-    uint64_t num_rvtxes = right_vertices_map.size();
-    bool *adjacency_matrix = (bool *)calloc(num_lvtxes * num_rvtxes, sizeof(bool));            // adjacency matrix
-    uint64_t *edge_id_adj_mat = (uint64_t *)calloc(num_lvtxes * num_rvtxes, sizeof(uint64_t)); // map edge_id with items in adjacency matrix
-    bool *cur_sm_matrix = (bool *)calloc(num_lvtxes * num_rvtxes, sizeof(bool));               // current semi-matching matrix (record current semi-matching)
+            // rvtxes are checked in BFS order; if currently least_load_rvtx is not selected, or current rvtx has lower (weighted) load than least_load_rvtx, set current rvtx as the least load rvtx
+            double rvtx_load = getRvtxLoad(right_vertices[rvtx_id], rvtx_weights);
+            if (least_load_rvtx == NULL || rvtx_load < least_load)
+            {
+                least_load_rvtx = &right_vertices[rvtx_id];
+                least_load = rvtx_load;
+            }
 
-    // mark the adjacency matrix
-    // lvtx: [idx: 0 to num_lvtxes - 1]
-    // rvtx: [idx: 0 to num_rvtxes - 1]
-    for (auto &item : edges_map)
-    {
-        uint64_t edge_id = item.first;
-        uint64_t lvtx_id = item.second.lvtx_id;
-        uint64_t rvtx_id = item.second.rvtx_id;
-        adjacency_matrix[lvtx_id * num_rvtxes + rvtx_id] = true;   // mark the edge in adjacent matrix
-        edge_id_adj_mat[lvtx_id * num_rvtxes + rvtx_id] = edge_id; // record edge_id for the item in adjacent matrix
-    }
+            // no undiscovered rvtx has lower load than least_load_rvtx
+            while (undiscovered_it != rvtx_loads.end() && rvtx_visited_stamp[undiscovered_it->second] == search_stamp)
+            {
+                undiscovered_it++;
+            }
+            if (undiscovered_it == rvtx_loads.end() || least_load <= undiscovered_it->first)
+            {
+                return true;
+            }
+        }
 
-    // printf("adjacency matrix:\n");
-    // for (uint64_t lvtx_id = 0; lvtx_id < num_lvtxes; lvtx_id++)
-    // {
-    //     for (uint64_t rvtx_id = 0; rvtx_id < num_rvtxes; rvtx_id++)
-    //     {
-    //         printf("%d ", adjacency_matrix[lvtx_id * num_rvtxes + rvtx_id]);
-    //     }
-    //     printf("\n");
-    // }
-    // printf("\n");
+        return false;
+    };
 
     // loop each left vertex (as root)
     for (uint64_t idx = 0; idx < num_lvtxes; idx++)
     {
-        Vertex &root_lvtx = left_vertices_map[idx];
+        Vertex &root_lvtx = left_vertices[idx];
 
         // build alternating search tree with lvtx as the root
-        queue<Vertex *> bfs_queue;
-        bfs_queue.push(&root_lvtx);                   // enqueue root lvtx
-        vector<bool> lvtx_visited(num_lvtxes, false); // record whether the lvtx is visited
-        vector<bool> rvtx_visited(num_rvtxes, false);
-        Vertex *least_load_rvtx = NULL;                    // least (weightd) load rvtx
-        unordered_map<uint64_t, uint64_t> lvtx_parent_map; // trace the alternating path
-        unordered_map<uint64_t, uint64_t> rvtx_parent_map; // trace the alternating path
-
-        while (bfs_queue.empty() == false)
+        search_stamp++;
+        bfs_rvtx_queue.clear();
+        undiscovered_it = rvtx_loads.begin();
+        least_load_rvtx = NULL;
+        least_load = 0;
+
+        // each lvtx (except the root) is matched to exactly one rvtx, so it
+        // is visited only once, right after its matched rvtx (in the order of
+        // edge id); we only need to enqueue rvtxes
+        bool is_search_done = visitLvtx(root_lvtx.id);
+        for (size_t head = 0; head < bfs_rvtx_queue.size() && is_search_done == false; head++)
         {
-            Vertex &vtx = *bfs_queue.front();
-            bfs_queue.pop();
-            vector<uint64_t> neighbors; // for lvtxes, find unmatched neighbors; for rvtxes, find matched neighbors
-
-            // check if it's left or right vertex
-            if (vtx.type == VertexType::LEFT)
+            // find matched lvtxes
+            for (auto edge_id : rvtx_matched_edges[bfs_rvtx_queue[head]])
             {
-                uint64_t sg_id = lvtx2sg_map[vtx.id].first;
-                vector<uint64_t> sg_lvtxes = sg2lvtx_map[sg_id];
-                // find unmatched rvtxes, which is not connected by lvtxes of the same stripe group
-                vector<uint64_t> &connected_edges = lvtx_edges_map[vtx.id];
-
-                for (auto edge_id : connected_edges)
+                is_search_done = visitLvtx(edges[edge_id].lvtx_id);
+                if (is_search_done == true)
                 {
-                    uint64_t rvtx_id = edges_map[edge_id].rvtx_id;
-
-                    assert(adjacency_matrix[vtx.id * num_rvtxes + rvtx_id] == true); // make sure the item in adjacency matrix is valid
-
-                    // find an unmatched edge
-                    if (cur_sm_matrix[vtx.id * num_rvtxes + rvtx_id] == false)
-                    {
-                        // we don't allow the lvtx connect to a rvtx which is already connected with a lvtx of the same stripe group, as alternating the paths within the two lvtxes in the same stripe group doesn't help reducing the load
-                        bool is_rvtx_valid = true;
-
-                        for (auto sg_lvtx : sg_lvtxes)
-                        {
-                            if (cur_sm_matrix[sg_lvtx * num_rvtxes + rvtx_id] == true) // rvtx already been matched by sg_lvtx of the same stripe group
-                            {
-                                is_rvtx_valid = false; // mark the edge as not valid
-                                break;
-                            }
-                        }
-
-                        // if the edge is unmatched
-                        if (is_rvtx_valid == true)
-                        {
-                            neighbors.push_back(rvtx_id); // obtain unmatched rvtx
-                        }
-                    }
+                    break;
                 }
             }
-            else if (vtx.type == VertexType::RIGHT)
-            {
-                // find matched lvtxes, which is connected by some lvtxes
-                vector<uint64_t> &connected_edges = rvtx_edges_map[vtx.id];
-                for (auto edge_id : connected_edges)
-                {
-                    uint64_t lvtx_id = edges_map[edge_id].lvtx_id; // corresponding lvtx
-
-                    assert(adjacency_matrix[lvtx_id * num_rvtxes + vtx.id] == true); // make sure the item in adjacency matrix is valid
-
-                    if (cur_sm_matrix[lvtx_id * num_rvtxes + vtx.id] == true) // find matched edge
-                    {
-                        neighbors.push_back(lvtx_id); // obtain matched lvtx
-                    }
-                }
+        }
 
-                // if currently least_load_rvtx is not selected, or current
-                // rvtx has lower weighted load than least_load_rvtx, set
-                // current rvtx as the least load rvtx
+        // we already found an alternating path from root to selected_rvtx, thus we choose the edges along the path
+        // for edges chosen before (in alternating path, it's pointed from rvtx to lvtx), they are replaced by newly added edges (in alternating path, it's pointed from lvtx to rvtx)
+        Vertex *v = least_load_rvtx;
+        uint64_t edge_id = rvtx_parent_edge[v->id];
+        Vertex *u = &left_vertices[edges[edge_id].lvtx_id];
 
-                // weight_val = in_degree / bw_download
-                double vtx_weighted_val = 1.0 * vtx.in_degree / rvtx2weight_map[vtx.id];
-                if (least_load_rvtx == NULL)
-                {
-                    least_load_rvtx = &vtx;
-                }
-                else
-                {
-                    double least_load_rvtx_weighted_val = 1.0 * least_load_rvtx->in_degree / rvtx2weight_map[least_load_rvtx->id];
+        // increase load of v only
+        rvtx_loads.erase(pair<double, uint64_t>(getRvtxLoad(*v, rvtx_weights), v->id));
+        v->in_degree++;
+        rvtx_loads.insert(pair<double, uint64_t>(getRvtxLoad(*v, rvtx_weights), v->id));
 
-                    if (vtx_weighted_val < least_load_rvtx_weighted_val)
-                    {
-                        least_load_rvtx = &vtx;
-                    }
-                }
-            }
+        while (true)
+        {
+            // add u->v
+            uint64_t prev_edge_id = lvtx_matched_edge[u->id];
+            lvtx_matched_edge[u->id] = edge_id;
+            rvtx_matched_edges[v->id].insert(edge_id);
 
-            // loop the neighbors if they are not visited
-            for (auto neighbor_vtx_id : neighbors)
+            if (u->id == root_lvtx.id)
             {
-                Vertex *nvtx = NULL;
-                if (vtx.type == VertexType::LEFT)
-                {
-                    // the neighbor is a rvtx
-                    if (rvtx_visited[neighbor_vtx_id] == true) // skip visited neighbor
-                    {
-                        continue;
-                    }
-                    nvtx = &right_vertices_map[neighbor_vtx_id]; // obtain nvtx
-                    rvtx_parent_map[neighbor_vtx_id] = vtx.id;   // mark parent
-                    rvtx_visited[neighbor_vtx_id] = true;        // mark visited
-                }
-                else if (vtx.type == VertexType::RIGHT)
-                {
-                    // the neighbor is a lvtx
-                    if (lvtx_visited[neighbor_vtx_id] == true) // skip visited neighbor
-                    {
-                        continue;
-                    }
-                    nvtx = &left_vertices_map[neighbor_vtx_id]; // obtain nvtx
-                    lvtx_parent_map[neighbor_vtx_id] = vtx.id;  // mark parent
-                    lvtx_visited[neighbor_vtx_id] = true;       // mark visited
-                }
-
-                bfs_queue.push(nvtx); // enqueue the neighbor
+                break;
             }
-        }
 
-        // we already found an alternating path from root to selected_rvtx, thus we choose the edges along the path
-        // for edges chosen before (in alternating path, it's pointed from rvtx to lvtx), we mark the cur_sm_matrix[lvtx][rvtx] as false; for newly added edge (in alternating path, it's pointed from lvtx to rvtx), we mark cur_sm_matrix[lvtx][rvtx] as true
-        Vertex *v = least_load_rvtx;
-        Vertex *u = &left_vertices_map[rvtx_parent_map[v->id]];
-        cur_sm_matrix[u->id * num_rvtxes + v->id] = true;
-        v->in_degree++; // increase load of v only
-        while (u->id != root_lvtx.id)
-        {
             // remove v->u
-            v = &right_vertices_map[lvtx_parent_map[u->id]];
-            cur_sm_matrix[u->id * num_rvtxes + v->id] = false;
-            // add u->v
-            u = &left_vertices_map[rvtx_parent_map[v->id]];
-            cur_sm_matrix[u->id * num_rvtxes + v->id] = true;
+            v = &right_vertices[edges[prev_edge_id].rvtx_id];
+            rvtx_matched_edges[v->id].erase(prev_edge_id);
+
+            edge_id = rvtx_parent_edge[v->id];
+            u = &left_vertices[edges[edge_id].lvtx_id];
         }
     }
 
     // record the edges in the semi-matching
     for (uint64_t lvtx_id = 0; lvtx_id < num_lvtxes; lvtx_id++)
     {
-        for (uint64_t rvtx_id = 0; rvtx_id < num_rvtxes; rvtx_id++)
+        if (lvtx_matched_edge[lvtx_id] != INVALID_EDGE_ID)
         {
-            if (cur_sm_matrix[lvtx_id * num_rvtxes + rvtx_id] == true)
-            {
-                uint64_t edge_id = edge_id_adj_mat[lvtx_id * num_rvtxes + rvtx_id];
-                sol_edges.push_back(edge_id);
-            }
+            sol_edges.push_back(lvtx_matched_edge[lvtx_id]);
         }
     }
 
-    free(adjacency_matrix);
-    free(edge_id_adj_mat);
-    free(cur_sm_matrix);
-
     return sol_edges;
 }
 
+double Bipartite::getRvtxLoad(Vertex &rvtx, vector<double> *rvtx_weights)
+{
+    // weight_val = in_degree / bw_download
+    return rvtx_weights == NULL ? rvtx.in_degree : 1.0 * rvtx.in_degree / (*rvtx_weights)[rvtx.id];
+}
+
 void Bipartite::clear()
 {
-    left_vertices_map.clear();
-    right_vertices_map.clear();
-    edges_map.clear();
+    left_vertices.clear();
+    right_vertices.clear();
+    edges.clear();
+
+    lvtx_edge_offsets.clear();
+    lvtx_edge_ids.clear();
+    rvtx_edge_offsets.clear();
+    rvtx_edge_ids.clear();
+    lvtx_matched_edge.clear();
 }
 
 void Bipartite::print()
@@ -442,28 +301,26 @@ void Bipartite::print()
 
 void Bipartite::printVertices()
 {
-    printf("left_vertices (size: %ld):\n", left_vertices_map.size());
-    printVertices(left_vertices_map);
+    LOG_DEBUG("left_vertices (size: %ld):", left_vertices.size());
+    printVertices(left_vertices);
 
-    printf("right_vertices (size: %ld):\n", right_vertices_map.size());
-    printVertices(right_vertices_map);
+    LOG_DEBUG("right_vertices (size: %ld):", right_vertices.size());
+    printVertices(right_vertices);
 }
 
-void Bipartite::printVertices(unordered_map<uint64_t, Vertex> &vtx_map)
+void Bipartite::printVertices(vector<Vertex> &vertices)
 {
-    for (auto it = vtx_map.begin(); it != vtx_map.end(); it++)
+    for (auto &vtx : vertices)
     {
-        Vertex &vtx = it->second;
-        printf("id: %ld, in_degree: %d, out_degree: %d\n", vtx.id, vtx.in_degree, vtx.out_degree);
+        LOG_DEBUG("id: %ld, in_degree: %d, out_degree: %d", vtx.id, vtx.in_degree, vtx.out_degree);
     }
 }
 
 void Bipartite::printEdges()
 {
-    printf("edges (size: %ld):\n", edges_map.size());
-    for (auto it = edges_map.begin(); it != edges_map.end(); it++)
+    LOG_DEBUG("edges (size: %ld):", edges.size());
+    for (auto &edge : edges)
     {
-        Edge &edge = it->second;
-        printf("id: %ld, lvtx(.id): %ld, rvtx(.id): %ld\n", edge.id, edge.lvtx_id, edge.rvtx_id);
+        LOG_DEBUG("id: %ld, lvtx(.id): %ld, rvtx(.id): %ld", edge.id, edge.lvtx_id, edge.rvtx_id);
     }
-}
\ No newline at end of file
+}
@@ -2,10 +2,12 @@
 #define __BIPARTITE_HH__
 
 #include <queue>
+#include <set>
 
 #include "../include/include.hh"
 #include "StripeBatch.hh"
 #include "../util/Utils.hh"
+#include "../util/Logger.hh"
 
 enum VertexType
 {
@@ -30,12 +32,50 @@ typedef struct Edge
     uint64_t lvtx_id; // left vertex id
     uint64_t rvtx_id; // right vertex id
 
-    Edge() : id(INVALID_VTX_ID), lvtx_id(INVALID_VTX_ID), rvtx_id(INVALID_VTX_ID){};
+    Edge() : id(INVALID_EDGE_ID), lvtx_id(INVALID_VTX_ID), rvtx_id(INVALID_VTX_ID){};
 } Edge;
 
 class Bipartite
 {
 private:
+    /**
+     * @brief build compressed sparse row (CSR) adjacency of left and right
+     * vertices from the edges (edges of a vertex are in insertion order)
+     *
+     */
+    void buildCSR();
+
+    /**
+     * @brief build CSR adjacency for one side of vertices
+     *
+     * @param num_vtxes number of vertices
+     * @param is_left build for left vertices
+     * @param offsets (out) edges of vertex i: edge_ids[offsets[i], offsets[i + 1])
+     * @param edge_ids (out)
+     */
+    void buildCSR(uint64_t num_vtxes, bool is_left, vector<uint64_t> &offsets, vector<uint64_t> &edge_ids);
+
+    /**
+     * @brief get the (weighted) load of a right vertex
+     *
+     * @param rvtx
+     * @param rvtx_weights weight of each right vertex (NULL for unweighted)
+     * @return double load (weighted: in_degree / weight)
+     */
+    double getRvtxLoad(Vertex &rvtx, vector<double> *rvtx_weights);
+
+    /**
+     * @brief find (optimal) semi-matching; weighted if rvtx_weights is
+     * given (weight_val = in_degree / weight)
+     *
+     * @param lvtx2sg_map left vertex to stripe group construction mapping
+     * @param sg2lvtx_map stripe group to left vertex mapping
+     * @param rvtx_weights weight of each right vertex, indexed by rvtx_id
+     * (NULL for unweighted semi-matching)
+     * @return vector<uint64_t>
+     */
+    vector<uint64_t> findOptSemiMatching(unordered_map<uint64_t, pair<uint32_t, uint8_t>> &lvtx2sg_map, unordered_map<uint32_t, vector<uint64_t>> &sg2lvtx_map, vector<double> *rvtx_weights);
+
 public:
     Bipartite();
     ~Bipartite();
@@ -64,15 +104,21 @@ public:
     void clear();
     void print();
     void printVertices();
-    void printVertices(unordered_map<uint64_t, Vertex> &vertex_map);
+    void printVertices(vector<Vertex> &vertices);
     void printEdges();
 
-    unordered_map<uint64_t, Vertex> left_vertices_map;  // left vertices map
-    unordered_map<uint64_t, Vertex> right_vertices_map; // right vertices map
-    unordered_map<uint64_t, Edge> edges_map;
+    vector<Vertex> left_vertices;  // left vertices (indexed by lvtx_id)
+    vector<Vertex> right_vertices; // right vertices (indexed by rvtx_id)
+    vector<Edge> edges;            // edges (indexed by edge_id)
+
+    // CSR adjacency: edges connected to left (right) vertex i are
+    // lvtx_edge_ids[lvtx_edge_offsets[i], lvtx_edge_offsets[i + 1])
+    vector<uint64_t> lvtx_edge_offsets;
+    vector<uint64_t> lvtx_edge_ids;
+    vector<uint64_t> rvtx_edge_offsets;
+    vector<uint64_t> rvtx_edge_ids;
 
-    unordered_map<uint64_t, vector<uint64_t>> lvtx_edges_map; // edges connected to left vertices <lvtx, <edges>>
-    unordered_map<uint64_t, vector<uint64_t>> rvtx_edges_map; // edges connected to right vertices <rvtx, <edges>>
+    vector<uint64_t> lvtx_matched_edge; // current semi-matching: the matched edge of each left vertex (INVALID_EDGE_ID: unmatched)
 };
 
 #endif // __BIPARTITE_HH__
\ No newline at end of file
@@ -15,7 +15,7 @@ bool ClusterSettings::loadBWProfile(string bw_filename)
 
     if (ifs.fail())
     {
-        printf("invalid bandwidth file: %s\n", bw_filename.c_str());
+        LOG_ERROR("invalid bandwidth file: %s", bw_filename.c_str());
         return false;
     }
 
@@ -47,7 +47,7 @@ bool ClusterSettings::loadBWProfile(string bw_filename)
 
     ifs.close();
 
-    printf("finished loading bandwidth profile from %s\n", bw_filename.c_str());
+    LOG_INFO("finished loading bandwidth profile from %s", bw_filename.c_str());
 
     return true;
 }
@@ -58,15 +58,13 @@ ClusterSettings::~ClusterSettings()
 
 void ClusterSettings::print()
 {
-    printf("ClusterSettings: num_nodes: %u, num_stripes: %u\n", num_nodes, num_stripes);
+    LOG_INFO("ClusterSettings: num_nodes: %u, num_stripes: %u", num_nodes, num_stripes);
 
     if (is_heterogeneous == true)
     {
-        printf("bw_profile:\n");
-        printf("Upload: ");
-        Utils::printVector(bw_profile.upload);
-        printf("Download: ");
-        Utils::printVector(bw_profile.download);
+        LOG_INFO("bw_profile:");
+        LOG_INFO("Upload: %s", Utils::vectorToString(bw_profile.upload).c_str());
+        LOG_INFO("Download: %s", Utils::vectorToString(bw_profile.download).c_str());
     }
 }
 
@@ -2,6 +2,7 @@
 #define __CLUSTER_SETTINGS_HH__
 
 #include "../include/include.hh"
+#include "../util/Logger.hh"
 #include "ConvertibleCode.hh"
 
 typedef struct BWProfile
@@ -3,6 +3,7 @@
 
 #include "../include/include.hh"
 #include "../util/Utils.hh"
+#include "../util/Logger.hh"
 
 class ConvertibleCode
 {
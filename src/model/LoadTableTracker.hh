@@ -0,0 +1,112 @@
+#ifndef __LOAD_TABLE_TRACKER_HH__
+#define __LOAD_TABLE_TRACKER_HH__
+
+#include "../include/include.hh"
+#include "StripeGroup.hh"
+
+/**
+ * @brief incremental load table engine: it tracks the (weighted) send and
+ * receive loads of a load table with a max segment tree over nodes, so that
+ * updating the load of a node takes O(log N), and querying the maximum load
+ * across all nodes takes O(1)
+ *
+ * @tparam LoadType load type (uint32_t for load; double for weighted load)
+ */
+template <typename LoadType>
+class LoadTableTracker
+{
+private:
+    LoadTable &lt;                  // tracked load table (updated in place)
+    const vector<double> *upload;   // upload bandwidth (NULL for unweighted load)
+    const vector<double> *download; // download bandwidth (NULL for unweighted load)
+
+    uint32_t num_leaves;            // number of leaves in max_tree (power of 2)
+    vector<LoadType> max_tree;      // max segment tree; leaf for node_id: max(send load, recv load)
+
+    /**
+     * @brief get (weighted) load of a node
+     *
+     * @param load
+     * @param bw bandwidth of nodes (NULL for unweighted load)
+     * @param node_id
+     * @return LoadType
+     */
+    inline LoadType getLoad(uint16_t load, const vector<double> *bw, uint16_t node_id)
+    {
+        // weighted_load = load / bw
+        return bw == NULL ? (LoadType)load : (LoadType)(1.0 * load / (*bw)[node_id]);
+    }
+
+public:
+    LoadTableTracker(LoadTable &_lt, const vector<double> *_upload = NULL, const vector<double> *_download = NULL) : lt(_lt), upload(_upload), download(_download)
+    {
+        num_leaves = 1;
+        while (num_leaves < lt.slt.size())
+        {
+            num_leaves <<= 1;
+        }
+        rebuild();
+    }
+
+    ~LoadTableTracker()
+    {
+    }
+
+    /**
+     * @brief rebuild the max tree from the load table
+     *
+     */
+    void rebuild()
+    {
+        max_tree.assign(2 * num_leaves, 0);
+        for (uint16_t node_id = 0; node_id < lt.slt.size(); node_id++)
+        {
+            max_tree[num_leaves + node_id] = max(getLoad(lt.slt[node_id], upload, node_id), getLoad(lt.rlt[node_id], download, node_id));
+        }
+        for (uint32_t pos = num_leaves - 1; pos > 0; pos--)
+        {
+            max_tree[pos] = max(max_tree[2 * pos], max_tree[2 * pos + 1]);
+        }
+    }
+
+    /**
+     * @brief refresh the max tree after the loads of node_id are changed
+     *
+     * @param node_id
+     */
+    void update(uint16_t node_id)
+    {
+        uint32_t pos = num_leaves + node_id;
+        max_tree[pos] = max(getLoad(lt.slt[node_id], upload, node_id), getLoad(lt.rlt[node_id], download, node_id));
+        for (pos >>= 1; pos > 0; pos >>= 1)
+        {
+            max_tree[pos] = max(max_tree[2 * pos], max_tree[2 * pos + 1]);
+        }
+    }
+
+    /**
+     * @brief add send and receive load to node_id (negative for subtraction)
+     *
+     * @param node_id
+     * @param send_load
+     * @param recv_load
+     */
+    void addLoad(uint16_t node_id, int32_t send_load, int32_t recv_load)
+    {
+        lt.slt[node_id] += send_load;
+        lt.rlt[node_id] += recv_load;
+        update(node_id);
+    }
+
+    /**
+     * @brief get maximum (weighted) load of send and receive load tables
+     *
+     * @return LoadType
+     */
+    LoadType getMaxLoad()
+    {
+        return max_tree[1];
+    }
+};
+
+#endif // __LOAD_TABLE_TRACKER_HH__
@@ -0,0 +1,445 @@
+#include "PlanFile.hh"
+
+PlanFile::PlanFile()
+{
+    fd = -1;
+    data = NULL;
+    data_len = 0;
+    memset(&header, 0, sizeof(PlanHeader));
+}
+
+PlanFile::~PlanFile()
+{
+    close();
+}
+
+uint32_t PlanFile::getSGRecordSize(ConvertibleCode &code)
+{
+    uint32_t record_size = code.lambda_i * sizeof(uint32_t) + code.m_f * sizeof(uint16_t) + sizeof(uint8_t);
+
+    // pad to 4 bytes
+    return (record_size + 3) / 4 * 4;
+}
+
+string PlanFile::serializePlacement(vector<Stripe> &stripes, uint8_t ecn)
+{
+    string buf(stripes.size() * ecn * sizeof(uint16_t), 0);
+    uint16_t *indices = (uint16_t *)&buf[0];
+    for (uint32_t stripe_id = 0; stripe_id < stripes.size(); stripe_id++)
+    {
+        for (uint8_t block_id = 0; block_id < ecn; block_id++)
+        {
+            indices[stripe_id * ecn + block_id] = stripes[stripe_id].indices[block_id];
+        }
+    }
+
+    return buf;
+}
+
+void PlanFile::serializeBlockMapping(vector<vector<pair<uint16_t, string>>> &block_mapping, string &records, string &paths)
+{
+    records.clear();
+    paths.clear();
+
+    for (auto &stripe_blocks : block_mapping)
+    {
+        for (auto &block : stripe_blocks)
+        {
+            PlanBlockRecord record;
+            record.node_id = block.first;
+            record.reserved = 0;
+            record.path_len = block.second.size();
+            record.path_offset = paths.size();
+
+            records.append((char *)&record, sizeof(PlanBlockRecord));
+            paths.append(block.second);
+        }
+    }
+}
+
+bool PlanFile::store(string plan_filename, StripeBatch &stripe_batch, vector<vector<pair<uint16_t, string>>> *pre_block_mapping, vector<vector<pair<uint16_t, string>>> *post_block_mapping, uint64_t meta_stamp)
+{
+    ConvertibleCode &code = stripe_batch.code;
+    ClusterSettings &settings = stripe_batch.settings;
+
+    // serialize sections
+    vector<pair<PlanSectionType, string>> section_bufs;
+
+    section_bufs.push_back(pair<PlanSectionType, string>(PlanSectionType::PRE_PLACEMENT, serializePlacement(stripe_batch.pre_stripes, code.n_i)));
+    section_bufs.push_back(pair<PlanSectionType, string>(PlanSectionType::POST_PLACEMENT, serializePlacement(stripe_batch.post_stripes, code.n_f)));
+
+    // stripe group metadata
+    uint32_t sg_record_size = getSGRecordSize(code);
+    string sg_meta_buf(stripe_batch.selected_sgs.size() * sg_record_size, 0);
+    uint32_t sg_idx = 0;
+    for (auto &item : stripe_batch.selected_sgs)
+    {
+        StripeGroup &stripe_group = item.second;
+        char *record = &sg_meta_buf[sg_idx * sg_record_size];
+
+        // store pre-stripe ids
+        for (uint8_t pre_stripe_id = 0; pre_stripe_id < code.lambda_i; pre_stripe_id++)
+        {
+            uint32_t pre_stripe_id_global = stripe_group.pre_stripes[pre_stripe_id]->id;
+            memcpy(record, &pre_stripe_id_global, sizeof(uint32_t));
+            record += sizeof(uint32_t);
+        }
+
+        // store parity computation nodes
+        for (uint8_t parity_id = 0; parity_id < code.m_f; parity_id++)
+        {
+            uint16_t parity_compute_node = stripe_group.parity_comp_nodes[parity_id];
+            memcpy(record, &parity_compute_node, sizeof(uint16_t));
+            record += sizeof(uint16_t);
+        }
+
+        // store parity computation method
+        *record = (uint8_t)stripe_group.parity_comp_method;
+
+        sg_idx++;
+    }
+    section_bufs.push_back(pair<PlanSectionType, string>(PlanSectionType::SG_META, sg_meta_buf));
+
+    // block mappings
+    if (pre_block_mapping != NULL)
+    {
+        string records, paths;
+        serializeBlockMapping(*pre_block_mapping, records, paths);
+        section_bufs.push_back(pair<PlanSectionType, string>(PlanSectionType::PRE_BLOCK_MAPPING, records));
+        section_bufs.push_back(pair<PlanSectionType, string>(PlanSectionType::PRE_BLOCK_PATHS, paths));
+    }
+
+    if (post_block_mapping != NULL)
+    {
+        string records, paths;
+        serializeBlockMapping(*post_block_mapping, records, paths);
+        section_bufs.push_back(pair<PlanSectionType, string>(PlanSectionType::POST_BLOCK_MAPPING, records));
+        section_bufs.push_back(pair<PlanSectionType, string>(PlanSectionType::POST_BLOCK_PATHS, paths));
+    }
+
+    // header
+    PlanHeader header;
+    memset(&header, 0, sizeof(PlanHeader));
+    memcpy(header.magic, PLAN_FILE_MAGIC, sizeof(header.magic));
+    header.version = PLAN_FILE_VERSION;
+    header.k_i = code.k_i;
+    header.m_i = code.m_i;
+    header.k_f = code.k_f;
+    header.m_f = code.m_f;
+    header.num_nodes = settings.num_nodes;
+    header.num_sections = section_bufs.size();
+    header.num_stripes = settings.num_stripes;
+    header.num_sgs = stripe_batch.selected_sgs.size();
+    struct timeval gen_time;
+    gettimeofday(&gen_time, nullptr);
+    header.gen_time_us = (uint64_t)gen_time.tv_sec * 1000000 + gen_time.tv_usec;
+    header.meta_stamp = meta_stamp;
+
+    // section table (each section is aligned)
+    vector<PlanSection> sections(section_bufs.size());
+    uint64_t offset = sizeof(PlanHeader) + sections.size() * sizeof(PlanSection);
+    for (size_t idx = 0; idx < section_bufs.size(); idx++)
+    {
+        offset = (offset + PLAN_SECTION_ALIGNMENT - 1) / PLAN_SECTION_ALIGNMENT * PLAN_SECTION_ALIGNMENT;
+
+        sections[idx].type = section_bufs[idx].first;
+        sections[idx].reserved = 0;
+        sections[idx].offset = offset;
+        sections[idx].size = section_bufs[idx].second.size();
+
+        offset += sections[idx].size;
+    }
+
+    ofstream of(plan_filename, ios::out | ios::binary | ios::trunc);
+    if (of.fail())
+    {
+        LOG_ERROR("invalid plan file: %s", plan_filename.c_str());
+        return false;
+    }
+
+    of.write((char *)&header, sizeof(PlanHeader));
+    of.write((char *)&sections[0], sections.size() * sizeof(PlanSection));
+    uint64_t cur_offset = sizeof(PlanHeader) + sections.size() * sizeof(PlanSection);
+    for (size_t idx = 0; idx < section_bufs.size(); idx++)
+    {
+        // padding
+        string padding(sections[idx].offset - cur_offset, 0);
+        of.write(padding.c_str(), padding.size());
+
+        of.write(section_bufs[idx].second.c_str(), section_bufs[idx].second.size());
+        cur_offset = sections[idx].offset + sections[idx].size;
+    }
+
+    of.close();
+
+    LOG_INFO("finished storing plan (%u stripes, %u stripe groups) in %s", header.num_stripes, header.num_sgs, plan_filename.c_str());
+
+    return true;
+}
+
+bool PlanFile::open(string plan_filename, ConvertibleCode &code, ClusterSettings &settings)
+{
+    close();
+
+    fd = ::open(plan_filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        LOG_ERROR("invalid plan file: %s", plan_filename.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(PlanHeader))
+    {
+        LOG_ERROR("invalid plan file: %s", plan_filename.c_str());
+        close();
+        return false;
+    }
+
+    data_len = st.st_size;
+    data = (uint8_t *)mmap(NULL, data_len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        LOG_ERROR("error: failed to map plan file %s", plan_filename.c_str());
+        data = NULL;
+        close();
+        return false;
+    }
+
+    // validate header
+    memcpy(&header, data, sizeof(PlanHeader));
+    if (memcmp(header.magic, PLAN_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != PLAN_FILE_VERSION)
+    {
+        LOG_ERROR("error: invalid plan file format or version: %s", plan_filename.c_str());
+        close();
+        return false;
+    }
+
+    if (header.k_i != code.k_i || header.m_i != code.m_i || header.k_f != code.k_f || header.m_f != code.m_f || header.num_nodes != settings.num_nodes || header.num_stripes != settings.num_stripes)
+    {
+        LOG_ERROR("error: plan file %s doesn't match the code and cluster settings", plan_filename.c_str());
+        close();
+        return false;
+    }
+
+    // read section table
+    if (sizeof(PlanHeader) + header.num_sections * sizeof(PlanSection) > data_len)
+    {
+        LOG_ERROR("error: invalid section table in plan file: %s", plan_filename.c_str());
+        close();
+        return false;
+    }
+
+    sections_map.clear();
+    for (uint16_t idx = 0; idx < header.num_sections; idx++)
+    {
+        PlanSection section;
+        memcpy(&section, data + sizeof(PlanHeader) + idx * sizeof(PlanSection), sizeof(PlanSection));
+        if (section.offset + section.size > data_len)
+        {
+            LOG_ERROR("error: invalid section %u in plan file: %s", section.type, plan_filename.c_str());
+            close();
+            return false;
+        }
+        sections_map[section.type] = section;
+    }
+
+    LOG_INFO("finished mapping plan (%u stripes, %u stripe groups, generated at %lu us) from %s", header.num_stripes, header.num_sgs, header.gen_time_us, plan_filename.c_str());
+
+    return true;
+}
+
+void PlanFile::close()
+{
+    if (data != NULL)
+    {
+        munmap(data, data_len);
+        data = NULL;
+    }
+    data_len = 0;
+
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+
+    sections_map.clear();
+}
+
+const PlanSection *PlanFile::getSection(PlanSectionType type)
+{
+    auto it = sections_map.find(type);
+    return it == sections_map.end() ? NULL : &it->second;
+}
+
+bool PlanFile::hasSection(PlanSectionType type)
+{
+    return getSection(type) != NULL;
+}
+
+bool PlanFile::stampFiles(vector<string> filenames, uint64_t &meta_stamp)
+{
+    meta_stamp = 14695981039346656037ULL; // FNV-1a offset basis
+    for (auto &filename : filenames)
+    {
+        struct stat st;
+        if (stat(filename.c_str(), &st) != 0)
+        {
+            return false;
+        }
+
+        uint64_t attrs[3] = {(uint64_t)st.st_size, (uint64_t)st.st_mtim.tv_sec, (uint64_t)st.st_mtim.tv_nsec};
+        const uint8_t *bytes = (const uint8_t *)attrs;
+        for (size_t pos = 0; pos < sizeof(attrs); pos++)
+        {
+            meta_stamp ^= bytes[pos];
+            meta_stamp *= 1099511628211ULL; // FNV-1a prime
+        }
+    }
+
+    return true;
+}
+
+bool PlanFile::isMetaMatched(uint64_t meta_stamp)
+{
+    return header.meta_stamp == meta_stamp;
+}
+const uint16_t *PlanFile::getPlacement(PlanSectionType type, uint64_t &num_indices)
+{
+    const PlanSection *section = getSection(type);
+    if (section == NULL)
+    {
+        num_indices = 0;
+        return NULL;
+    }
+
+    num_indices = section->size / sizeof(uint16_t);
+    return (const uint16_t *)(data + section->offset);
+}
+
+bool PlanFile::bindStripes(PlanSectionType type, uint8_t ecn, vector<Stripe> &stripes)
+{
+    uint64_t num_indices = 0;
+    uint16_t *indices = (uint16_t *)getPlacement(type, num_indices);
+    if (indices == NULL || num_indices != stripes.size() * ecn)
+    {
+        LOG_ERROR("invalid placement section %u in plan file", type);
+        return false;
+    }
+
+    for (uint32_t stripe_id = 0; stripe_id < stripes.size(); stripe_id++)
+    {
+        stripes[stripe_id].indices = StripeIndices(indices + (uint64_t)stripe_id * ecn, ecn);
+    }
+
+    LOG_INFO("finished binding %lu stripes to plan file", stripes.size());
+
+    return true;
+}
+
+bool PlanFile::loadSGMetadata(StripeBatch &stripe_batch)
+{
+    ConvertibleCode &code = stripe_batch.code;
+
+    stripe_batch.selected_sgs.clear();
+
+    const PlanSection *section = getSection(PlanSectionType::SG_META);
+    uint32_t sg_record_size = getSGRecordSize(code);
+    if (section == NULL || section->size != (uint64_t)header.num_sgs * sg_record_size || header.num_sgs > stripe_batch.post_stripes.size())
+    {
+        LOG_ERROR("invalid sg_meta section in plan file");
+        return false;
+    }
+
+    for (uint32_t sg_id = 0; sg_id < header.num_sgs; sg_id++)
+    {
+        const uint8_t *record = data + section->offset + sg_id * sg_record_size;
+
+        vector<Stripe *> selected_pre_stripes(code.lambda_i, NULL);
+
+        // load pre-stripe ids
+        for (uint8_t pre_stripe_id = 0; pre_stripe_id < code.lambda_i; pre_stripe_id++)
+        {
+            uint32_t pre_stripe_id_global = 0;
+            memcpy(&pre_stripe_id_global, record, sizeof(uint32_t));
+            record += sizeof(uint32_t);
+            if (pre_stripe_id_global >= stripe_batch.pre_stripes.size())
+            {
+                LOG_ERROR("invalid pre-stripe id %u in plan file", pre_stripe_id_global);
+                stripe_batch.selected_sgs.clear();
+                return false;
+            }
+            selected_pre_stripes[pre_stripe_id] = &stripe_batch.pre_stripes[pre_stripe_id_global];
+        }
+
+        stripe_batch.selected_sgs.insert(pair<uint32_t, StripeGroup>(sg_id, StripeGroup(sg_id, code, stripe_batch.settings, selected_pre_stripes, &stripe_batch.post_stripes[sg_id])));
+
+        StripeGroup &stripe_group = stripe_batch.selected_sgs.find(sg_id)->second;
+
+        // load parity computation nodes
+        stripe_group.parity_comp_nodes.assign(code.m_f, INVALID_NODE_ID);
+        for (uint8_t parity_id = 0; parity_id < code.m_f; parity_id++)
+        {
+            uint16_t parity_compute_node = INVALID_NODE_ID;
+            memcpy(&parity_compute_node, record, sizeof(uint16_t));
+            record += sizeof(uint16_t);
+            stripe_group.parity_comp_nodes[parity_id] = parity_compute_node;
+        }
+
+        // load parity computation method
+        stripe_group.parity_comp_method = (EncodeMethod)*record;
+    }
+
+    LOG_INFO("finished loading %lu stripes group metadata from plan file", stripe_batch.selected_sgs.size());
+
+    return true;
+}
+
+bool PlanFile::loadBlockMapping(PlanSectionType type, uint8_t ecn, uint32_t num_stripes, vector<vector<pair<uint16_t, string>>> &block_mapping)
+{
+    PlanSectionType paths_type = PlanSectionType::NUM_PLAN_SECTIONS;
+    if (type == PlanSectionType::PRE_BLOCK_MAPPING)
+    {
+        paths_type = PlanSectionType::PRE_BLOCK_PATHS;
+    }
+    else if (type == PlanSectionType::POST_BLOCK_MAPPING)
+    {
+        paths_type = PlanSectionType::POST_BLOCK_PATHS;
+    }
+
+    const PlanSection *section = getSection(type);
+    const PlanSection *paths_section = getSection(paths_type);
+    if (section == NULL || paths_section == NULL || section->size != (uint64_t)num_stripes * ecn * sizeof(PlanBlockRecord))
+    {
+        return false;
+    }
+
+    const char *paths = (const char *)(data + paths_section->offset);
+
+    // init block mapping
+    block_mapping.clear();
+    block_mapping.assign(num_stripes, vector<pair<uint16_t, string>>(ecn, pair<uint16_t, string>(0, "")));
+
+    for (uint32_t stripe_id = 0; stripe_id < num_stripes; stripe_id++)
+    {
+        for (uint8_t block_id = 0; block_id < ecn; block_id++)
+        {
+            PlanBlockRecord record;
+            memcpy(&record, data + section->offset + ((uint64_t)stripe_id * ecn + block_id) * sizeof(PlanBlockRecord), sizeof(PlanBlockRecord));
+            if (record.path_offset + record.path_len > paths_section->size)
+            {
+                LOG_ERROR("PlanFile::loadBlockMapping error: invalid block record (stripe_id: %u, block_id: %u) in plan file", stripe_id, block_id);
+                block_mapping.clear();
+                return false;
+            }
+
+            block_mapping[stripe_id][block_id].first = record.node_id;
+            block_mapping[stripe_id][block_id].second.assign(paths + record.path_offset, record.path_len);
+        }
+    }
+
+    LOG_INFO("finished loading %lu blocks metadata from plan file", (uint64_t)num_stripes * ecn);
+
+    return true;
+}
@@ -0,0 +1,241 @@
+#ifndef __PLAN_FILE_HH__
+#define __PLAN_FILE_HH__
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../include/include.hh"
+#include "../util/Logger.hh"
+#include "ConvertibleCode.hh"
+#include "ClusterSettings.hh"
+#include "Stripe.hh"
+#include "StripeBatch.hh"
+
+#define PLAN_FILE_MAGIC "BARTPLAN"
+#define PLAN_FILE_VERSION 3
+#define PLAN_SECTION_ALIGNMENT 8
+
+/**
+ * @brief sections in the plan file
+ */
+enum PlanSectionType
+{
+    PRE_PLACEMENT,      // pre-transition placement: num_stripes * n_i uint16_t node ids
+    POST_PLACEMENT,     // post-transition placement: num_post_stripes * n_f uint16_t node ids
+    SG_META,            // stripe group metadata: num_sgs fixed-width records
+    PRE_BLOCK_MAPPING,  // pre-transition block mapping: num_stripes * n_i PlanBlockRecord
+    PRE_BLOCK_PATHS,    // pre-transition block paths (referenced by PRE_BLOCK_MAPPING)
+    POST_BLOCK_MAPPING, // post-transition block mapping: num_post_stripes * n_f PlanBlockRecord
+    POST_BLOCK_PATHS,   // post-transition block paths (referenced by POST_BLOCK_MAPPING)
+    NUM_PLAN_SECTIONS
+};
+
+/**
+ * @brief plan file header (fixed width, native byte order), followed by
+ * num_sections PlanSection entries
+ */
+typedef struct PlanHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint8_t k_i;
+    uint8_t m_i;
+    uint8_t k_f;
+    uint8_t m_f;
+    uint16_t num_nodes;
+    uint16_t num_sections;
+    uint32_t num_stripes;
+    uint32_t num_sgs;
+    uint32_t reserved;
+    uint64_t gen_time_us;   // generation time (wall clock, in us since epoch)
+    uint64_t meta_stamp;    // stamp of the text metadata generated with the plan (see PlanFile::stampFiles())
+} PlanHeader;
+
+typedef struct PlanSection
+{
+    uint32_t type;   // PlanSectionType
+    uint32_t reserved;
+    uint64_t offset; // offset from the beginning of the file
+    uint64_t size;   // size in bytes
+} PlanSection;
+
+typedef struct PlanBlockRecord
+{
+    uint16_t node_id;     // placed node id
+    uint16_t reserved;
+    uint32_t path_len;    // length of placed path
+    uint64_t path_offset; // offset of placed path in the paths section
+} PlanBlockRecord;
+
+/**
+ * @brief versioned binary plan container with pre/post placements, block
+ * mappings and stripe group metadata in fixed-width sections; the plan is
+ * memory-mapped on loading, so placements can be accessed without parsing
+ *
+ * the header records a stamp (sizes and modification times) of the text
+ * metadata (pre-transition placement, post-transition placement and sg_meta)
+ * generated together with the plan, so a plan left over from another run is
+ * detected without reading the metadata
+ *
+ * sg_meta record (per stripe group): lambda_i uint32_t pre-stripe ids,
+ * m_f uint16_t parity computation nodes, uint8_t parity computation method,
+ * padded to 4 bytes
+ */
+class PlanFile
+{
+private:
+    int fd;
+    uint8_t *data;     // mapped file
+    uint64_t data_len; // mapped file length
+
+    PlanHeader header;
+    unordered_map<uint32_t, PlanSection> sections_map; // <type, section>
+
+    /**
+     * @brief get the section
+     *
+     * @param type
+     * @return const PlanSection* NULL if the section doesn't exist
+     */
+    const PlanSection *getSection(PlanSectionType type);
+
+    /**
+     * @brief serialize placement of stripes
+     *
+     * @param stripes
+     * @param ecn
+     * @return string
+     */
+    static string serializePlacement(vector<Stripe> &stripes, uint8_t ecn);
+
+    /**
+     * @brief serialize block mapping into block records and paths
+     *
+     * @param block_mapping
+     * @param records (out)
+     * @param paths (out)
+     */
+    static void serializeBlockMapping(vector<vector<pair<uint16_t, string>>> &block_mapping, string &records, string &paths);
+
+public:
+    PlanFile();
+    ~PlanFile();
+
+    /**
+     * @brief get the size of a sg_meta record
+     *
+     * @param code
+     * @return uint32_t
+     */
+    static uint32_t getSGRecordSize(ConvertibleCode &code);
+
+    /**
+     * @brief store the plan of the stripe batch (placements and stripe group
+     * metadata) into plan file
+     *
+     * @param plan_filename
+     * @param stripe_batch
+     * @param pre_block_mapping pre-transition block mapping (NULL: not stored)
+     * @param post_block_mapping post-transition block mapping (NULL: not stored)
+     * @param meta_stamp stamp of the text metadata generated together
+     * @return true
+     * @return false
+     */
+    static bool store(string plan_filename, StripeBatch &stripe_batch, vector<vector<pair<uint16_t, string>>> *pre_block_mapping, vector<vector<pair<uint16_t, string>>> *post_block_mapping, uint64_t meta_stamp);
+
+    /**
+     * @brief calculate the stamp (64-bit FNV-1a) of the sizes and
+     * modification times of files in order (the contents are not read)
+     *
+     * @param filenames
+     * @param meta_stamp (out)
+     * @return true
+     * @return false a file can't be accessed
+     */
+    static bool stampFiles(vector<string> filenames, uint64_t &meta_stamp);
+
+    /**
+     * @brief check if the plan is generated together with the text metadata
+     *
+     * @param meta_stamp stamp of the text metadata
+     * @return true
+     * @return false
+     */
+    bool isMetaMatched(uint64_t meta_stamp);
+
+    /**
+     * @brief map the plan file (privately: writes through the mapping are
+     * not written back to the file) and validate the header against the
+     * settings
+     *
+     * @param plan_filename
+     * @param code
+     * @param settings
+     * @return true
+     * @return false
+     */
+    bool open(string plan_filename, ConvertibleCode &code, ClusterSettings &settings);
+
+    /**
+     * @brief unmap the plan file
+     *
+     */
+    void close();
+
+    /**
+     * @brief check if the section exists
+     *
+     * @param type
+     * @return true
+     * @return false
+     */
+    bool hasSection(PlanSectionType type);
+
+    /**
+     * @brief get the placement (zero-copy)
+     *
+     * @param type PRE_PLACEMENT or POST_PLACEMENT
+     * @param num_indices (out) number of node ids
+     * @return const uint16_t* NULL if the section doesn't exist
+     */
+    const uint16_t *getPlacement(PlanSectionType type, uint64_t &num_indices);
+
+    /**
+     * @brief bind stripes to placement section (zero-copy): the indices of
+     * each stripe become a view into the mapped placement, so the plan file
+     * should stay open while the stripes are in use
+     *
+     * @param type PRE_PLACEMENT or POST_PLACEMENT
+     * @param ecn
+     * @param stripes
+     * @return true
+     * @return false
+     */
+    bool bindStripes(PlanSectionType type, uint8_t ecn, vector<Stripe> &stripes);
+
+    /**
+     * @brief load stripe group metadata into stripe batch (the pre- and
+     * post-stripes should be loaded first)
+     *
+     * @param stripe_batch
+     * @return true
+     * @return false
+     */
+    bool loadSGMetadata(StripeBatch &stripe_batch);
+
+    /**
+     * @brief load block mapping
+     *
+     * @param type PRE_BLOCK_MAPPING or POST_BLOCK_MAPPING
+     * @param ecn
+     * @param num_stripes
+     * @param block_mapping <stripe <block> <placed_node_id, placed_path>>
+     * @return true
+     * @return false the block mapping is not stored, or is corrupted
+     */
+    bool loadBlockMapping(PlanSectionType type, uint8_t ecn, uint32_t num_stripes, vector<vector<pair<uint16_t, string>>> &block_mapping);
+};
+
+#endif // __PLAN_FILE_HH__
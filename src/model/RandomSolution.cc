@@ -8,24 +8,24 @@ RandomSolution::~RandomSolution()
 {
 }
 
-void RandomSolution::genSolution(StripeBatch &stripe_batch, string approach)
+void RandomSolution::genSolution(StripeBatch &stripe_batch, TransApproach approach)
 {
 
     // Step 1: randomly construct stripe groups (sequentially)
-    printf("Step 1: construct stripe groups\n");
+    LOG_INFO("Step 1: construct stripe groups");
     stripe_batch.constructSGInSequence();
     // stripe_batch.constructSGByRandomPick();
     // stripe_batch.print();
 
     // Step 2: generate transition solutions from all stripe groups
-    printf("Step 2: generate transition solution\n");
+    LOG_INFO("Step 2: generate transition solution");
     for (auto &item : stripe_batch.selected_sgs)
     {
         genSolution(item.second, approach);
     }
 }
 
-void RandomSolution::genSolution(StripeGroup &stripe_group, string approach)
+void RandomSolution::genSolution(StripeGroup &stripe_group, TransApproach approach)
 {
     ConvertibleCode &code = stripe_group.code;
     uint16_t num_nodes = stripe_group.settings.num_nodes;
@@ -36,12 +36,12 @@ void RandomSolution::genSolution(StripeGroup &stripe_group, string approach)
      */
     u16string enc_nodes(code.m_f, INVALID_NODE_ID);
 
-    if (approach == "RDRE")
+    if (approach == TransApproach::RDRE)
     {
         size_t random_node = Utils::randomUInt(0, num_nodes - 1, random_generator);
         enc_nodes.assign(code.m_f, random_node);
     }
-    else if (approach == "RDPM")
+    else if (approach == TransApproach::RDPM)
     {
         // randomly pick code.m_f nodes to do parity merging computation
         for (uint8_t parity_id = 0; parity_id < code.m_f; parity_id++)
@@ -51,7 +51,7 @@ void RandomSolution::genSolution(StripeGroup &stripe_group, string approach)
     }
     else
     {
-        fprintf(stderr, "invalid approach: %s\n", approach.c_str());
+        LOG_ERROR("invalid approach: %s", TransApproachUtils::getName(approach));
         return;
     }
 
@@ -119,11 +119,11 @@ void RandomSolution::genSolution(StripeGroup &stripe_group, string approach)
     }
 
     // update stripe group metadata
-    if (approach == "RDRE")
+    if (approach == TransApproach::RDRE)
     {
         stripe_group.parity_comp_method = EncodeMethod::RE_ENCODE;
     }
-    else if (approach == "RDPM")
+    else if (approach == TransApproach::RDPM)
     {
         stripe_group.parity_comp_method = EncodeMethod::PARITY_MERGE;
     }
@@ -9,6 +9,5 @@ Stripe::~Stripe()
 }
 void Stripe::print()
 {
-    printf("Stripe %u, indices: ", id);
-    Utils::printVector(indices);
+    LOG_DEBUG("Stripe %u, indices: %s", id, Utils::vectorToString(indices).c_str());
 }
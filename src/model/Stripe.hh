@@ -5,12 +5,96 @@
 #include "ConvertibleCode.hh"
 #include "ClusterSettings.hh"
 #include "../util/Utils.hh"
+#include "../util/Logger.hh"
+
+/**
+ * @brief node indices of a stripe: a fixed-length view into the contiguous
+ * placement array owned by the stripe batch (copying a view does not copy
+ * the node ids; assigning from a u16string copies the node ids into the
+ * placement array)
+ */
+class StripeIndices
+{
+private:
+    uint16_t *data_ptr;
+    uint8_t len;
+
+public:
+    typedef uint16_t value_type;
+    typedef uint16_t *iterator;
+    typedef const uint16_t *const_iterator;
+
+    StripeIndices() : data_ptr(NULL), len(0) {}
+    StripeIndices(uint16_t *_data_ptr, uint8_t _len) : data_ptr(_data_ptr), len(_len) {}
+
+    inline uint16_t &operator[](size_t pos) { return data_ptr[pos]; }
+    inline const uint16_t &operator[](size_t pos) const { return data_ptr[pos]; }
+    inline size_t size() const { return len; }
+    inline uint16_t *data() { return data_ptr; }
+    inline const uint16_t *data() const { return data_ptr; }
+
+    inline iterator begin() { return data_ptr; }
+    inline iterator end() { return data_ptr + len; }
+    inline const_iterator begin() const { return data_ptr; }
+    inline const_iterator end() const { return data_ptr + len; }
+    inline const_iterator cbegin() const { return data_ptr; }
+    inline const_iterator cend() const { return data_ptr + len; }
+
+    /**
+     * @brief copy node ids into the placement array (the length of the view
+     * is fixed; extra node ids are ignored)
+     *
+     * @param indices
+     * @return StripeIndices&
+     */
+    StripeIndices &operator=(const u16string &indices)
+    {
+        size_t num_copied = min(indices.size(), (size_t)len);
+        for (size_t pos = 0; pos < num_copied; pos++)
+        {
+            data_ptr[pos] = indices[pos];
+        }
+        return *this;
+    }
+
+    /**
+     * @brief fill the view with val
+     *
+     * @param count (must equal to the length of the view)
+     * @param val
+     */
+    void assign(size_t count, uint16_t val)
+    {
+        std::fill(data_ptr, data_ptr + min(count, (size_t)len), val);
+    }
+
+    /**
+     * @brief copy count node ids from src into the placement array
+     *
+     * @param src
+     * @param count (must equal to the length of the view)
+     */
+    void assign(const uint16_t *src, size_t count)
+    {
+        std::copy(src, src + min(count, (size_t)len), data_ptr);
+    }
+
+    /**
+     * @brief copy the node ids out of the placement array
+     *
+     * @return u16string
+     */
+    u16string str() const
+    {
+        return u16string(data_ptr, data_ptr + len);
+    }
+};
 
 class Stripe
 {
 private:
 public:
-    u16string indices; // stripe length: n
+    StripeIndices indices; // stripe length: n (view into StripeBatch placement)
     uint32_t id;
 
     Stripe();
@@ -23,4 +107,4 @@ public:
     void print();
 };
 
-#endif // __STRIPE_HH__
\ No newline at end of file
+#endif // __STRIPE_HH__
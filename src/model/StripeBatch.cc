@@ -2,24 +2,28 @@
 
 StripeBatch::StripeBatch(uint8_t _id, ConvertibleCode &_code, ClusterSettings &_settings, mt19937 &_random_generator) : id(_id), code(_code), settings(_settings), random_generator(_random_generator)
 {
+    // use all available cores for bandwidth calculation
+    num_threads = max(thread::hardware_concurrency(), 1u);
 
-    // init pre-transition stripes
+    // init pre-transition stripes (views into pre_placement)
+    pre_placement.assign((uint64_t)settings.num_stripes * code.n_i, INVALID_NODE_ID);
     pre_stripes.clear();
     pre_stripes.assign(settings.num_stripes, Stripe());
     for (uint32_t stripe_id = 0; stripe_id < settings.num_stripes; stripe_id++)
     {
         pre_stripes[stripe_id].id = stripe_id;
-        pre_stripes[stripe_id].indices.assign(code.n_i, INVALID_NODE_ID);
+        pre_stripes[stripe_id].indices = StripeIndices(&pre_placement[(uint64_t)stripe_id * code.n_i], code.n_i);
     }
 
-    // init post-transition stripes
+    // init post-transition stripes (views into post_placement)
     uint32_t num_post_stripes = settings.num_stripes / code.lambda_i;
+    post_placement.assign((uint64_t)num_post_stripes * code.n_f, INVALID_NODE_ID);
     post_stripes.clear();
     post_stripes.assign(num_post_stripes, Stripe());
     for (uint32_t post_stripe_id = 0; post_stripe_id < num_post_stripes; post_stripe_id++)
     {
         post_stripes[post_stripe_id].id = post_stripe_id;
-        post_stripes[post_stripe_id].indices.assign(code.n_f, INVALID_NODE_ID);
+        post_stripes[post_stripe_id].indices = StripeIndices(&post_placement[(uint64_t)post_stripe_id * code.n_f], code.n_f);
     }
 }
 
@@ -29,7 +33,7 @@ StripeBatch::~StripeBatch()
 
 void StripeBatch::print()
 {
-    printf("StripeBatch %u:\n", id);
+    LOG_DEBUG("StripeBatch %u:", id);
     for (auto &item : selected_sgs)
     {
         item.second.print();
@@ -88,8 +92,15 @@ void StripeBatch::constructSGByRandomPick()
     }
 }
 
-void StripeBatch::constructSGByBWBF(string approach)
+void StripeBatch::constructSGByBWBF(TransApproach approach)
 {
+    if (approach != TransApproach::BWRE && approach != TransApproach::BTRE && TransApproachUtils::isPMBW(approach) == false)
+    {
+        LOG_ERROR("invalid approach: %s", TransApproachUtils::getName(approach));
+        exit(EXIT_FAILURE);
+    }
+    bool is_pm_bw = TransApproachUtils::isPMBW(approach);
+
     uint32_t num_sgs = settings.num_stripes / code.lambda_i;
 
     selected_sgs.clear();
@@ -98,7 +109,7 @@ void StripeBatch::constructSGByBWBF(string approach)
     uint64_t num_combs = Utils::calCombSize(settings.num_stripes, code.lambda_i);
 
     uint64_t num_cand_sgs = num_combs;
-    printf("candidates stripe groups: %ld\n", num_cand_sgs);
+    LOG_INFO("candidates stripe groups: %ld", num_cand_sgs);
 
     /**
      * @brief bandwidth table for all stripe groups
@@ -124,15 +135,9 @@ void StripeBatch::constructSGByBWBF(string approach)
         // // get stripe ids
         // u32string sg_stripe_ids = Utils::getCombFromPosition(settings.num_stripes, code.lambda_i, cand_sg_id);
 
-        vector<Stripe *> selected_pre_stripes(code.lambda_i, NULL);
-        for (uint8_t stripe_id = 0; stripe_id < code.lambda_i; stripe_id++)
-        {
-            selected_pre_stripes[stripe_id] = &pre_stripes[sg_stripe_ids[stripe_id]];
-        }
-
-        StripeGroup stripe_group(0, code, settings, selected_pre_stripes, NULL);
+        StripeGroupView stripe_group(code, pre_stripes, sg_stripe_ids);
         u16string sg_enc_nodes(code.m_f, INVALID_NODE_ID);
-        uint8_t min_bw = stripe_group.getTransBW(approach, sg_enc_nodes);
+        uint8_t min_bw = is_pm_bw ? stripe_group.getTransBW<PMPolicy>(sg_enc_nodes) : stripe_group.getTransBW<REPolicy>(sg_enc_nodes);
         bw_sgs_table[min_bw].push_back(sg_stripe_ids);
 
         // printf("candidate stripe group: %lu, minimum bandwidth: %u\n", cand_sg_id, min_bw);
@@ -144,7 +149,7 @@ void StripeBatch::constructSGByBWBF(string approach)
         // logging
         if (cand_sg_id % (uint64_t)pow(10, 7) == 0)
         {
-            printf("stripe groups (%lu / %lu) bandwidth calculated\n", cand_sg_id, num_cand_sgs);
+            LOG_INFO("stripe groups (%lu / %lu) bandwidth calculated", cand_sg_id, num_cand_sgs);
         }
     }
 
@@ -216,7 +221,7 @@ void StripeBatch::constructSGByBWBF(string approach)
     // }
 }
 
-void StripeBatch::constructSGByBWPartial(string approach)
+void StripeBatch::constructSGByBWPartial(TransApproach approach)
 {
     uint32_t num_sgs = settings.num_stripes / code.lambda_i;
     uint8_t max_bw = code.n_f + code.k_f; // allowed maximum bandwidth
@@ -228,6 +233,17 @@ void StripeBatch::constructSGByBWPartial(string approach)
     struct timeval start_time, end_time;
     gettimeofday(&start_time, nullptr);
 
+    // for parity merging, candidates sharing no parity node have a bandwidth
+    // lower bound; we only enumerate candidates that share parity nodes
+    // (with the inverted index) for the bandwidth below the bound, and fall
+    // back to enumerate all remaining candidates afterwards
+    bool is_pruning_enabled = TransApproachUtils::isPMBW(approach);
+    vector<vector<uint32_t>> parity_node_stripes_index;
+    if (is_pruning_enabled == true)
+    {
+        buildParityNodeIndex(parity_node_stripes_index);
+    }
+
     // current partial stripe group
     vector<u32string> cur_partial_sgs;                        // store currently selected partial stripe groups
     vector<uint64_t> cur_bw_num_partial_sgs_table(max_bw, 0); // record the bandwidth stats
@@ -235,22 +251,16 @@ void StripeBatch::constructSGByBWPartial(string approach)
     // we execute the pairing for code.lambda_i - 1 iterations; every time after pairing, we keep <num_sgs> non-overlapped partial stripe groups with ascending order of bandwidth, which will be paired with remaining stripes in the next iteration; finally, we obtain <num_sgs> stripe groups
     for (uint8_t iter = 0; iter < code.lambda_i - 1; iter++)
     {
+        // base partial stripe groups to add pre_stripes into
+        vector<u32string> base_partial_sgs;
 
-        vector<u32string> updated_partial_sgs; // updated partial stripe groups (by adding pre_stripe into current partial stripe group; max_size: num_stripes * (num_stripes - 1) / 2)
-
-        // construct candidate partial stripe groups
         if (iter == 0)
         {
-            // initialize partial stripe group as all stripe groups in size = 2
-            u32string partial_sg(2, INVALID_STRIPE_ID_GLOBAL);
-            for (uint32_t pre_stripe_x = 0; pre_stripe_x < settings.num_stripes - 1; pre_stripe_x++)
+            // initialize partial stripe group as all stripe groups in size = 2, by pairing each pre_stripe with the pre_stripes after it
+            base_partial_sgs.assign(settings.num_stripes, u32string(1, INVALID_STRIPE_ID_GLOBAL));
+            for (uint32_t pre_stripe_id = 0; pre_stripe_id < settings.num_stripes; pre_stripe_id++)
             {
-                for (uint32_t pre_stripe_y = pre_stripe_x + 1; pre_stripe_y < settings.num_stripes; pre_stripe_y++)
-                {
-                    partial_sg[0] = pre_stripe_x;
-                    partial_sg[1] = pre_stripe_y;
-                    updated_partial_sgs.push_back(partial_sg);
-                }
+                base_partial_sgs[pre_stripe_id][0] = pre_stripe_id;
             }
         }
         else
@@ -269,124 +279,57 @@ void StripeBatch::constructSGByBWPartial(string approach)
             uint32_t num_selected_stripes = accumulate(is_pre_stripe_selected.begin(), is_pre_stripe_selected.end(), 0);
             if (num_selected_stripes != num_sgs * (iter + 1))
             {
-                printf("error: invalid partial stripe group selection!\n");
+                LOG_ERROR("error: invalid partial stripe group selection!");
                 exit(EXIT_FAILURE);
             }
 
-            for (auto &partial_sg : cur_partial_sgs)
-            {
-                for (uint32_t pre_stripe_id = 0; pre_stripe_id < settings.num_stripes; pre_stripe_id++)
-                {
-                    if (is_pre_stripe_selected[pre_stripe_id] == true)
-                    {
-                        continue;
-                    }
-
-                    // construct updated_partial_sg
-                    u32string updated_partial_sg = partial_sg;
-                    updated_partial_sg.push_back(pre_stripe_id);
-                    sort(updated_partial_sg.begin(), updated_partial_sg.end());
-
-                    // add the updated_partial_sg
-                    updated_partial_sgs.push_back(updated_partial_sg);
-                }
-            }
+            base_partial_sgs.swap(cur_partial_sgs);
         }
 
-        // printf("updated_partial_sgs: %lu\n", updated_partial_sgs.size());
-        // for (auto &partial_sg : updated_partial_sgs)
-        // {
-        //     Utils::printVector(partial_sg);
-        // }
-
-        /**
-         * @brief bandwidth table for all stripe groups
-         *  bandwidth 0: sg_0; sg_1; ...
-         *  bandwidth 1: sg_2; sg_3; ...
-         *  ...
-         *  bandwidth n_f: ...
-         */
-        vector<vector<uint64_t>> bw_partial_sgs_table(max_bw); // record partial_sg_id for each candidate stripe group
-        u16string sg_enc_nodes(code.m_f, INVALID_NODE_ID);
-
-        for (uint64_t partial_sg_id = 0; partial_sg_id < updated_partial_sgs.size(); partial_sg_id++)
-        {
-            u32string &partial_sg = updated_partial_sgs[partial_sg_id];
-            vector<Stripe *> updated_partial_pre_stripes;
-            for (auto pre_stripe_id : partial_sg)
-            {
-                updated_partial_pre_stripes.push_back(&pre_stripes[pre_stripe_id]);
-            }
-
-            // calculate bandwidth
-            StripeGroup partial_stripe_group(partial_sg_id, code, settings, updated_partial_pre_stripes, NULL);
-
-            uint8_t min_bw = partial_stripe_group.getTransBW(approach, sg_enc_nodes);
-
-            // update bw table
-            bw_partial_sgs_table[min_bw].push_back(partial_sg_id);
-        }
-
-        // printf("bw_partial_sgs_table:\n");
-        // for (uint8_t bw = 0; bw < max_bw; bw++)
-        // {
-        //     if (bw_partial_sgs_table[bw].size() > 0)
-        //     {
-        //         printf("bandwidth = %u: %lu stripe groups\n", bw, bw_partial_sgs_table[bw].size());
-        //         for (auto &partial_sg_id : bw_partial_sgs_table[bw])
-        //         {
-        //             Utils::printVector(updated_partial_sgs[partial_sg_id]);
-        //         }
-        //     }
-        // }
-
         // reset the current selection
         cur_partial_sgs.clear();
         cur_bw_num_partial_sgs_table.assign(max_bw, 0);
         vector<bool> is_pre_stripe_selected(settings.num_stripes, false); // mark if pre_stripe is selected
+        uint64_t num_cand_partial_sgs = 0;
+        uint8_t bw_start = 0;
 
-        // choose partial_sgs with lowest bandwidth
-        for (uint8_t bw = 0; bw < max_bw; bw++)
+        if (is_pruning_enabled == true)
         {
-            for (auto partial_sg_id : bw_partial_sgs_table[bw])
-            {
-                u32string &partial_sg = updated_partial_sgs[partial_sg_id];
+            // candidates with bandwidth lower than bw_lower_bound must share parity nodes
+            uint8_t bw_lower_bound = min(getNonSharingBWLowerBound(base_partial_sgs), max_bw);
 
-                // check whether the stripe group is valid
-                bool is_partial_sg_valid = true;
-                for (auto pre_stripe_id : partial_sg)
-                {
-                    // is_partial_sg_valid = is_partial_sg_valid && !stripe_selected[sg_stripe_ids[stripe_id]];
-                    if (is_pre_stripe_selected[pre_stripe_id] == true)
-                    {
-                        is_partial_sg_valid = false;
-                        break;
-                    }
-                }
+            vector<u32string> cand_partial_sgs;
+            genCandPartialSGs(base_partial_sgs, iter == 0, is_pre_stripe_selected, &parity_node_stripes_index, cand_partial_sgs);
 
-                if (is_partial_sg_valid == false)
-                {
-                    continue;
-                }
+            vector<vector<uint64_t>> bw_partial_sgs_table(max_bw);
+            calPartialSGsBW(approach, cand_partial_sgs, bw_partial_sgs_table);
 
-                // add the partial stripe group
-                cur_partial_sgs.push_back(partial_sg);
-                cur_bw_num_partial_sgs_table[bw]++;
-                for (auto pre_stripe_id : partial_sg)
-                { // mark the stripes as selected
-                    is_pre_stripe_selected[pre_stripe_id] = true;
-                }
+            selectPartialSGs(cand_partial_sgs, bw_partial_sgs_table, 0, bw_lower_bound, is_pre_stripe_selected, cur_partial_sgs, cur_bw_num_partial_sgs_table);
 
-                if (cur_partial_sgs.size() >= num_sgs)
-                { // only select <num_sgs> partial stripe groups
-                    break;
-                }
-            }
+            num_cand_partial_sgs += cand_partial_sgs.size();
+            bw_start = bw_lower_bound;
+        }
 
-            if (cur_partial_sgs.size() >= num_sgs)
-            { // only select <num_sgs> partial stripe groups
-                break;
-            }
+        if (cur_partial_sgs.size() < num_sgs)
+        {
+            // enumerate all candidates with the remaining pre_stripes (max_size: num_stripes * (num_stripes - 1) / 2)
+            vector<u32string> cand_partial_sgs;
+            genCandPartialSGs(base_partial_sgs, iter == 0, is_pre_stripe_selected, NULL, cand_partial_sgs);
+
+            /**
+             * @brief bandwidth table for all stripe groups
+             *  bandwidth 0: sg_0; sg_1; ...
+             *  bandwidth 1: sg_2; sg_3; ...
+             *  ...
+             *  bandwidth n_f: ...
+             */
+            vector<vector<uint64_t>> bw_partial_sgs_table(max_bw); // record partial_sg_id for each candidate stripe group
+            calPartialSGsBW(approach, cand_partial_sgs, bw_partial_sgs_table);
+
+            // choose partial_sgs with lowest bandwidth
+            selectPartialSGs(cand_partial_sgs, bw_partial_sgs_table, bw_start, max_bw, is_pre_stripe_selected, cur_partial_sgs, cur_bw_num_partial_sgs_table);
+
+            num_cand_partial_sgs += cand_partial_sgs.size();
         }
 
         uint32_t total_bw_selected_partial_sgs = 0;
@@ -395,7 +338,7 @@ void StripeBatch::constructSGByBWPartial(string approach)
             total_bw_selected_partial_sgs += cur_bw_num_partial_sgs_table[bw] * bw;
         }
 
-        printf("iter %u: selected (%lu / %lu) partial stripe groups, bandwidth: %u\n", iter, cur_partial_sgs.size(), updated_partial_sgs.size(), total_bw_selected_partial_sgs);
+        LOG_INFO("iter %u: selected (%lu / %lu) partial stripe groups, bandwidth: %u", iter, cur_partial_sgs.size(), num_cand_partial_sgs, total_bw_selected_partial_sgs);
 
         // printf("cur_partial_sgs:\n");
         // for (auto &partial_sg : cur_partial_sgs)
@@ -403,12 +346,12 @@ void StripeBatch::constructSGByBWPartial(string approach)
         //     Utils::printVector(partial_sg);
         // }
 
-        printf("cur_bw_num_partial_sgs_table:\n");
+        LOG_INFO("cur_bw_num_partial_sgs_table:");
         for (uint8_t bw = 0; bw < max_bw; bw++)
         {
             if (cur_bw_num_partial_sgs_table[bw] > 0)
             {
-                printf("bandwidth = %u: %lu stripe groups\n", bw, cur_bw_num_partial_sgs_table[bw]);
+                LOG_INFO("bandwidth = %u: %lu stripe groups", bw, cur_bw_num_partial_sgs_table[bw]);
             }
         }
     }
@@ -431,21 +374,269 @@ void StripeBatch::constructSGByBWPartial(string approach)
     uint32_t num_selected_stripes = accumulate(stripe_selected.begin(), stripe_selected.end(), 0);
     if (num_selected_stripes != settings.num_stripes)
     {
-        printf("error: invalid stripe group selection!\n");
+        LOG_ERROR("error: invalid stripe group selection!");
         exit(EXIT_FAILURE);
     }
 
     gettimeofday(&end_time, nullptr);
     finish_time = (end_time.tv_sec - start_time.tv_sec) * 1000 +
                   (end_time.tv_usec - start_time.tv_usec) / 1000;
-    printf("finished constructing %lu stripe groups, time: %f ms\n", selected_sgs.size(), finish_time);
+    LOG_INFO("finished constructing %lu stripe groups, time: %f ms", selected_sgs.size(), finish_time);
+}
+
+void StripeBatch::buildParityNodeIndex(vector<vector<uint32_t>> &parity_node_stripes_index)
+{
+    parity_node_stripes_index.assign(code.m_f * settings.num_nodes, vector<uint32_t>());
+
+    // pre_stripes are visited in ascending order of id, so each list is sorted
+    for (uint32_t pre_stripe_id = 0; pre_stripe_id < settings.num_stripes; pre_stripe_id++)
+    {
+        for (uint8_t parity_id = 0; parity_id < code.m_f; parity_id++)
+        {
+            uint16_t parity_node_id = pre_stripes[pre_stripe_id].indices[code.k_i + parity_id];
+            parity_node_stripes_index[parity_id * settings.num_nodes + parity_node_id].push_back(pre_stripe_id);
+        }
+    }
+}
+
+uint8_t StripeBatch::getNonSharingBWLowerBound(vector<u32string> &base_partial_sgs)
+{
+    uint32_t min_bw_lower_bound = UINT32_MAX;
+
+    for (auto &base_partial_sg : base_partial_sgs)
+    {
+        StripeGroupView base_stripe_group(code, pre_stripes, base_partial_sg);
+
+        // data relocation bandwidth never decreases after adding a pre_stripe
+        uint32_t bw_lower_bound = base_stripe_group.getDataRelocBW();
+
+        // with a pre_stripe sharing no parity node, each parity block needs
+        // at least (num_pre_stripes - max number of parity blocks at a node)
+        // blocks to be merged
+        uint8_t num_pre_stripes = base_partial_sg.size() + 1;
+        for (uint8_t parity_id = 0; parity_id < code.m_f; parity_id++)
+        {
+            bw_lower_bound += num_pre_stripes - base_stripe_group.getMaxNumParityBlocks(parity_id);
+        }
+
+        min_bw_lower_bound = min(min_bw_lower_bound, bw_lower_bound);
+    }
+
+    return (uint8_t)min(min_bw_lower_bound, (uint32_t)UINT8_MAX);
+}
+
+void StripeBatch::genCandPartialSGs(vector<u32string> &base_partial_sgs, bool is_pairing, vector<bool> &is_pre_stripe_selected, vector<vector<uint32_t>> *parity_node_stripes_index, vector<u32string> &cand_partial_sgs)
+{
+    cand_partial_sgs.clear();
+
+    // mark pre_stripes in base partial stripe groups
+    vector<bool> is_base_stripe(settings.num_stripes, false);
+    for (auto &base_partial_sg : base_partial_sgs)
+    {
+        for (auto pre_stripe_id : base_partial_sg)
+        {
+            is_base_stripe[pre_stripe_id] = true;
+        }
+    }
+
+    vector<uint32_t> visited_base_id(settings.num_stripes, 0); // mark the (base_id + 1) that pre_stripe is last visited by
+    vector<uint32_t> cand_pre_stripe_ids;
+
+    for (uint32_t base_id = 0; base_id < base_partial_sgs.size(); base_id++)
+    {
+        u32string &base_partial_sg = base_partial_sgs[base_id];
+
+        // skip selected base partial stripe groups
+        if (is_pre_stripe_selected[base_partial_sg[0]] == true)
+        {
+            continue;
+        }
+
+        // collect pre_stripes to add
+        cand_pre_stripe_ids.clear();
+        if (parity_node_stripes_index == NULL)
+        {
+            for (uint32_t pre_stripe_id = 0; pre_stripe_id < settings.num_stripes; pre_stripe_id++)
+            {
+                cand_pre_stripe_ids.push_back(pre_stripe_id);
+            }
+        }
+        else
+        {
+            // pre_stripes sharing parity nodes with the base partial stripe group
+            for (auto base_pre_stripe_id : base_partial_sg)
+            {
+                for (uint8_t parity_id = 0; parity_id < code.m_f; parity_id++)
+                {
+                    uint16_t parity_node_id = pre_stripes[base_pre_stripe_id].indices[code.k_i + parity_id];
+                    for (auto pre_stripe_id : (*parity_node_stripes_index)[parity_id * settings.num_nodes + parity_node_id])
+                    {
+                        if (visited_base_id[pre_stripe_id] != base_id + 1)
+                        {
+                            visited_base_id[pre_stripe_id] = base_id + 1;
+                            cand_pre_stripe_ids.push_back(pre_stripe_id);
+                        }
+                    }
+                }
+            }
+            sort(cand_pre_stripe_ids.begin(), cand_pre_stripe_ids.end());
+        }
+
+        for (auto pre_stripe_id : cand_pre_stripe_ids)
+        {
+            // for pairing, each pre_stripe is paired with pre_stripes after it; otherwise, pre_stripes in base partial stripe groups are excluded
+            if (is_pre_stripe_selected[pre_stripe_id] == true || (is_base_stripe[pre_stripe_id] == true && (is_pairing == false || pre_stripe_id <= base_partial_sg[0])))
+            {
+                continue;
+            }
+
+            // construct updated_partial_sg
+            u32string updated_partial_sg = base_partial_sg;
+            updated_partial_sg.push_back(pre_stripe_id);
+            sort(updated_partial_sg.begin(), updated_partial_sg.end());
+
+            // add the updated_partial_sg
+            cand_partial_sgs.push_back(updated_partial_sg);
+        }
+    }
+}
+
+void StripeBatch::selectPartialSGs(vector<u32string> &cand_partial_sgs, vector<vector<uint64_t>> &bw_partial_sgs_table, uint8_t bw_start, uint8_t bw_end, vector<bool> &is_pre_stripe_selected, vector<u32string> &selected_partial_sgs, vector<uint64_t> &bw_num_selected_partial_sgs)
+{
+    uint32_t num_sgs = settings.num_stripes / code.lambda_i;
+
+    for (uint8_t bw = bw_start; bw < bw_end && selected_partial_sgs.size() < num_sgs; bw++)
+    {
+        for (auto partial_sg_id : bw_partial_sgs_table[bw])
+        {
+            u32string &partial_sg = cand_partial_sgs[partial_sg_id];
+
+            // check whether the stripe group is valid
+            bool is_partial_sg_valid = true;
+            for (auto pre_stripe_id : partial_sg)
+            {
+                if (is_pre_stripe_selected[pre_stripe_id] == true)
+                {
+                    is_partial_sg_valid = false;
+                    break;
+                }
+            }
+
+            if (is_partial_sg_valid == false)
+            {
+                continue;
+            }
+
+            // add the partial stripe group
+            selected_partial_sgs.push_back(partial_sg);
+            bw_num_selected_partial_sgs[bw]++;
+            for (auto pre_stripe_id : partial_sg)
+            { // mark the stripes as selected
+                is_pre_stripe_selected[pre_stripe_id] = true;
+            }
+
+            if (selected_partial_sgs.size() >= num_sgs)
+            { // only select <num_sgs> partial stripe groups
+                break;
+            }
+        }
+    }
+}
+
+void StripeBatch::calPartialSGsBW(TransApproach approach, vector<u32string> &partial_sgs, vector<vector<uint64_t>> &bw_partial_sgs_table)
+{
+    // resolve the parity update policy once for all candidates
+    switch (approach)
+    {
+    case TransApproach::BWRE:
+    case TransApproach::BTRE:
+        calPartialSGsBW<REPolicy>(partial_sgs, bw_partial_sgs_table);
+        break;
+    case TransApproach::BWPM:
+    case TransApproach::BTPM:
+    case TransApproach::BT:
+    case TransApproach::BT_WEIGHTED:
+        calPartialSGsBW<PMPolicy>(partial_sgs, bw_partial_sgs_table);
+        break;
+    default:
+        LOG_ERROR("invalid approach: %s", TransApproachUtils::getName(approach));
+        exit(EXIT_FAILURE);
+    }
+}
+
+template <typename ParityUpdatePolicy>
+void StripeBatch::calPartialSGsBW(vector<u32string> &partial_sgs, vector<vector<uint64_t>> &bw_partial_sgs_table)
+{
+    uint8_t max_bw = code.n_f + code.k_f; // allowed maximum bandwidth
+    uint64_t num_partial_sgs = partial_sgs.size();
+
+    // number of threads (avoid spawning threads for a small number of candidates)
+    uint64_t num_workers = min((uint64_t)num_threads, num_partial_sgs / MIN_NUM_PARTIAL_SGS_PER_THREAD);
+
+    bw_partial_sgs_table.assign(max_bw, vector<uint64_t>());
+
+    if (num_workers <= 1)
+    {
+        calPartialSGsBWInRange<ParityUpdatePolicy>(partial_sgs, 0, num_partial_sgs, bw_partial_sgs_table);
+        return;
+    }
+
+    // each worker records bandwidth in its own table
+    vector<vector<vector<uint64_t>>> worker_bw_tables(num_workers, vector<vector<uint64_t>>(max_bw));
+    thread *workers = new thread[num_workers];
+    for (uint64_t worker_id = 0; worker_id < num_workers; worker_id++)
+    {
+        uint64_t start_id = num_partial_sgs * worker_id / num_workers;
+        uint64_t end_id = num_partial_sgs * (worker_id + 1) / num_workers;
+        workers[worker_id] = thread(&StripeBatch::calPartialSGsBWInRange<ParityUpdatePolicy>, this, ref(partial_sgs), start_id, end_id, ref(worker_bw_tables[worker_id]));
+    }
+
+    for (uint64_t worker_id = 0; worker_id < num_workers; worker_id++)
+    {
+        workers[worker_id].join();
+    }
+    delete[] workers;
+
+    // merge the tables in the order of ranges
+    for (uint8_t bw = 0; bw < max_bw; bw++)
+    {
+        uint64_t num_bw_partial_sgs = 0;
+        for (uint64_t worker_id = 0; worker_id < num_workers; worker_id++)
+        {
+            num_bw_partial_sgs += worker_bw_tables[worker_id][bw].size();
+        }
+        bw_partial_sgs_table[bw].reserve(num_bw_partial_sgs);
+
+        for (uint64_t worker_id = 0; worker_id < num_workers; worker_id++)
+        {
+            vector<uint64_t> &worker_bw_partial_sgs = worker_bw_tables[worker_id][bw];
+            bw_partial_sgs_table[bw].insert(bw_partial_sgs_table[bw].end(), worker_bw_partial_sgs.begin(), worker_bw_partial_sgs.end());
+        }
+    }
+}
+
+template <typename ParityUpdatePolicy>
+void StripeBatch::calPartialSGsBWInRange(vector<u32string> &partial_sgs, uint64_t start_id, uint64_t end_id, vector<vector<uint64_t>> &bw_partial_sgs_table)
+{
+    u16string sg_enc_nodes(code.m_f, INVALID_NODE_ID);
+
+    for (uint64_t partial_sg_id = start_id; partial_sg_id < end_id; partial_sg_id++)
+    {
+        // calculate bandwidth
+        StripeGroupView partial_stripe_group(code, pre_stripes, partial_sgs[partial_sg_id]);
+
+        uint8_t min_bw = partial_stripe_group.getTransBW<ParityUpdatePolicy>(sg_enc_nodes);
+
+        // update bw table
+        bw_partial_sgs_table[min_bw].push_back(partial_sg_id);
+    }
 }
 
 void StripeBatch::storeSGMetadata(string sg_meta_filename)
 {
     if (selected_sgs.size() == 0)
     {
-        printf("invalid number of stripe groups\n");
+        LOG_ERROR("invalid number of stripe groups");
         return;
     }
 
@@ -476,7 +667,7 @@ void StripeBatch::storeSGMetadata(string sg_meta_filename)
 
     of.close();
 
-    printf("finished storing %lu stripe groups in %s\n", selected_sgs.size(), sg_meta_filename.c_str());
+    LOG_INFO("finished storing %lu stripe groups in %s", selected_sgs.size(), sg_meta_filename.c_str());
 }
 
 bool StripeBatch::loadSGMetadata(string sg_meta_filename)
@@ -487,7 +678,7 @@ bool StripeBatch::loadSGMetadata(string sg_meta_filename)
 
     if (ifs.fail())
     {
-        printf("invalid sg_meta file: %s\n", sg_meta_filename.c_str());
+        LOG_ERROR("invalid sg_meta file: %s", sg_meta_filename.c_str());
         return false;
     }
 
@@ -532,7 +723,7 @@ bool StripeBatch::loadSGMetadata(string sg_meta_filename)
 
     ifs.close();
 
-    printf("finished loading %lu stripes group metadata from %s\n", selected_sgs.size(), sg_meta_filename.c_str());
+    LOG_INFO("finished loading %lu stripes group metadata from %s", selected_sgs.size(), sg_meta_filename.c_str());
 
     return true;
 }
\ No newline at end of file
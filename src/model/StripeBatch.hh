@@ -1,9 +1,14 @@
 #ifndef __STRIPE_BATCH_HH__
 #define __STRIPE_BATCH_HH__
 
+#include <thread>
 #include "../include/include.hh"
 #include "../util/Utils.hh"
+#include "../util/Logger.hh"
 #include "StripeGroup.hh"
+#include "StripeGroupView.hh"
+
+#define MIN_NUM_PARTIAL_SGS_PER_THREAD 4096 // minimum number of candidate partial stripe groups handled by a thread
 
 class StripeBatch
 {
@@ -13,8 +18,15 @@ public:
     ConvertibleCode &code;
     ClusterSettings &settings;
     mt19937 &random_generator;
-    vector<Stripe> pre_stripes;  // placement of pre-transition stripes
-    vector<Stripe> post_stripes; // placement of post-transition stripes
+    unsigned int num_threads; // number of threads for bandwidth calculation
+
+    // placements are stored contiguously (structure of arrays); each
+    // stripe's indices is a view into its slice, so the arrays are allocated
+    // once in the constructor and never resized
+    vector<uint16_t> pre_placement;  // num_stripes * n_i node ids
+    vector<uint16_t> post_placement; // num_post_stripes * n_f node ids
+    vector<Stripe> pre_stripes;      // placement of pre-transition stripes
+    vector<Stripe> post_stripes;     // placement of post-transition stripes
 
     // step 1: stripe group selection
     map<uint32_t, StripeGroup> selected_sgs; // selected stripe groups in order <sg_id, StripeGroup>
@@ -22,6 +34,10 @@ public:
     StripeBatch(uint8_t _id, ConvertibleCode &_code, ClusterSettings &_settings, mt19937 &_random_generator);
     ~StripeBatch();
 
+    // stripes are views into the placement arrays: not copyable
+    StripeBatch(const StripeBatch &) = delete;
+    StripeBatch &operator=(const StripeBatch &) = delete;
+
     /**
      * @brief construct stripe group in sequence of stripes
      *
@@ -40,7 +56,7 @@ public:
      *
      * @param approach
      */
-    void constructSGByBWBF(string approach);
+    void constructSGByBWBF(TransApproach approach);
 
     /**
      * @brief construct stripe group by bandwidth (with partial stripe groups)
@@ -49,7 +65,91 @@ public:
      *
      * @param approach
      */
-    void constructSGByBWPartial(string approach);
+    void constructSGByBWPartial(TransApproach approach);
+
+    /**
+     * @brief build inverted index from (parity_id, node_id) to the
+     * pre_stripes storing the parity block at the node (in ascending order)
+     *
+     * @param parity_node_stripes_index (out) index at parity_id * num_nodes + node_id
+     */
+    void buildParityNodeIndex(vector<vector<uint32_t>> &parity_node_stripes_index);
+
+    /**
+     * @brief get the parity merging bandwidth lower bound of adding a
+     * pre_stripe into any of the base partial stripe groups, where the
+     * pre_stripe shares no parity node with the base partial stripe group
+     *
+     * @param base_partial_sgs
+     * @return uint8_t
+     */
+    uint8_t getNonSharingBWLowerBound(vector<u32string> &base_partial_sgs);
+
+    /**
+     * @brief generate candidate partial stripe groups by adding an unselected
+     * pre_stripe into each unselected base partial stripe group; candidates
+     * are generated in ascending order of (base partial stripe group,
+     * pre_stripe id)
+     *
+     * @param base_partial_sgs base partial stripe groups
+     * @param is_pairing whether each base is a single pre_stripe (paired with pre_stripes after it)
+     * @param is_pre_stripe_selected mark if pre_stripe is selected
+     * @param parity_node_stripes_index only add pre_stripes sharing parity nodes via the index (NULL: add all pre_stripes)
+     * @param cand_partial_sgs (out) candidate partial stripe groups
+     */
+    void genCandPartialSGs(vector<u32string> &base_partial_sgs, bool is_pairing, vector<bool> &is_pre_stripe_selected, vector<vector<uint32_t>> *parity_node_stripes_index, vector<u32string> &cand_partial_sgs);
+
+    /**
+     * @brief select non-overlapped candidate partial stripe groups with
+     * bandwidth in [bw_start, bw_end), in ascending order of bandwidth, until
+     * <num_sgs> partial stripe groups are selected
+     *
+     * @param cand_partial_sgs candidate partial stripe groups
+     * @param bw_partial_sgs_table bandwidth table <bw, partial_sg_ids>
+     * @param bw_start
+     * @param bw_end
+     * @param is_pre_stripe_selected (in/out) mark if pre_stripe is selected
+     * @param selected_partial_sgs (in/out) selected partial stripe groups
+     * @param bw_num_selected_partial_sgs (in/out) number of selected partial stripe groups for each bandwidth
+     */
+    void selectPartialSGs(vector<u32string> &cand_partial_sgs, vector<vector<uint64_t>> &bw_partial_sgs_table, uint8_t bw_start, uint8_t bw_end, vector<bool> &is_pre_stripe_selected, vector<u32string> &selected_partial_sgs, vector<uint64_t> &bw_num_selected_partial_sgs);
+
+    /**
+     * @brief calculate bandwidth for candidate partial stripe groups
+     * candidates are split into contiguous ranges handled by different
+     * threads; the per-thread bandwidth tables are merged in the order of
+     * ranges, so each bandwidth entry keeps ascending order of partial_sg_id
+     * (the same as calculated by a single thread)
+     *
+     * @param approach
+     * @param partial_sgs candidate partial stripe groups
+     * @param bw_partial_sgs_table (out) bandwidth table <bw, partial_sg_ids>
+     */
+    void calPartialSGsBW(TransApproach approach, vector<u32string> &partial_sgs, vector<vector<uint64_t>> &bw_partial_sgs_table);
+
+    /**
+     * @brief calculate bandwidth for candidate partial stripe groups with
+     * the parity update policy resolved from the approach
+     *
+     * @tparam ParityUpdatePolicy parity update policy (REPolicy, PMPolicy)
+     * @param partial_sgs candidate partial stripe groups
+     * @param bw_partial_sgs_table (out) bandwidth table <bw, partial_sg_ids>
+     */
+    template <typename ParityUpdatePolicy>
+    void calPartialSGsBW(vector<u32string> &partial_sgs, vector<vector<uint64_t>> &bw_partial_sgs_table);
+
+    /**
+     * @brief calculate bandwidth for candidate partial stripe groups in
+     * range [start_id, end_id)
+     *
+     * @tparam ParityUpdatePolicy parity update policy (REPolicy, PMPolicy)
+     * @param partial_sgs candidate partial stripe groups
+     * @param start_id
+     * @param end_id
+     * @param bw_partial_sgs_table (out) bandwidth table <bw, partial_sg_ids>
+     */
+    template <typename ParityUpdatePolicy>
+    void calPartialSGsBWInRange(vector<u32string> &partial_sgs, uint64_t start_id, uint64_t end_id, vector<vector<uint64_t>> &bw_partial_sgs_table);
 
     /**
      * @brief store selected stripe group metadata into sg_meta_filename
@@ -12,18 +12,16 @@ StripeGroup::~StripeGroup()
 
 void StripeGroup::print()
 {
-    printf("Stripe group %u: ", id);
+    LOG_DEBUG("Stripe group %u:", id);
     // for (auto stripe : pre_stripes)
     // {
     //     printf("%u, ", stripe->id);
     // }
 
-    printf("\n");
     for (auto stripe : pre_stripes)
     {
         stripe->print();
     }
-    printf("\n");
 }
 
 void StripeGroup::initDataDist()
@@ -55,33 +53,21 @@ void StripeGroup::initParityDists()
     }
 }
 
-uint8_t StripeGroup::getTransBW(string approach, u16string &enc_nodes)
+uint8_t StripeGroup::getTransBW(TransApproach approach, u16string &enc_nodes)
 {
-    uint8_t parity_update_bw = 0;
-
-    if (approach == "BWRE" || approach == "BTRE")
+    if (approach == TransApproach::BWRE || approach == TransApproach::BTRE)
     { // re-encoding only
-        parity_update_bw = getREBW(enc_nodes);
-    }
-    else if (approach == "BWPM" || approach == "BTPM")
-    { // parity-merging only
-        parity_update_bw = getPMBW(enc_nodes);
+        return getTransBW<REPolicy>(enc_nodes);
     }
-    else if (approach == "BT" || approach == "BTWeighted")
-    { // mixed with re-encoding and parity merging
-        // NOTE: here we assume that bandwidth(pm) <= bandwidth(re), thus we calculate pm bandwidth only
-        parity_update_bw = getPMBW(enc_nodes);
+    else if (approach == TransApproach::BWPM || approach == TransApproach::BTPM || approach == TransApproach::BT || approach == TransApproach::BT_WEIGHTED)
+    { // parity-merging only, or mixed with re-encoding and parity merging
+        return getTransBW<PMPolicy>(enc_nodes);
     }
     else
     {
-        fprintf(stderr, "invalid approach: %s\n", approach.c_str());
+        LOG_ERROR("invalid approach: %s", TransApproachUtils::getName(approach));
         exit(EXIT_FAILURE);
     }
-
-    // data relocation bw
-    uint8_t data_reloc_bw = getDataRelocBW();
-
-    return parity_update_bw + data_reloc_bw;
 }
 
 uint8_t StripeGroup::getDataRelocBW()
@@ -233,51 +219,6 @@ void StripeGroup::genLTForPerfectPM()
     applied_lt.bw = 0;
 }
 
-void StripeGroup::genAllPartialLTs4ParityCompute(string approach)
-{
-    uint16_t num_nodes = settings.num_nodes;
-
-    // for re-encoding, there are <num_nodes> possible candidate load tables, as we can collect num_final_data_blocks data blocks and distribute code.m_f parity blocks at <num_nodes> possible nodes
-    uint32_t num_re_lts = num_nodes;
-    // for parity merging, there are <num_nodes ^ code.m_f> possible candidate load tables, as we can collect each of m_f parity blocks at num_nodes nodes
-    uint32_t num_pm_lts = pow(num_nodes, code.m_f);
-
-    // enumerate partial load tables for re-encoding
-    vector<LoadTable> cand_re_lts(num_re_lts);
-    for (uint16_t node_id = 0; node_id < num_nodes; node_id++)
-    {
-        u16string enc_nodes(code.m_f, node_id);
-        cand_re_lts[node_id] = genPartialLTForParityCompute(EncodeMethod::RE_ENCODE, enc_nodes);
-    }
-
-    // enumerate partial load tables for parity merging
-    vector<LoadTable> cand_pm_lts(num_pm_lts);
-    u16string pm_nodes(code.m_f, 0); // computation for parity i is at pm_nodes[i]
-    for (uint32_t perm_id = 0; perm_id < num_pm_lts; perm_id++)
-    {
-        cand_pm_lts[perm_id] = genPartialLTForParityCompute(EncodeMethod::PARITY_MERGE, pm_nodes);
-
-        // get next permutation
-        Utils::getNextPerm(num_nodes, code.m_f, pm_nodes);
-    }
-
-    // create load tables
-    cand_partial_lts.clear();
-    if (approach == "BTRE")
-    { // use re-encoding only
-        cand_partial_lts.insert(cand_partial_lts.end(), make_move_iterator(cand_re_lts.begin()), make_move_iterator(cand_re_lts.end()));
-    }
-    else if (approach == "BTPM")
-    { // use parity merging only
-        cand_partial_lts.insert(cand_partial_lts.end(), make_move_iterator(cand_pm_lts.begin()), make_move_iterator(cand_pm_lts.end()));
-    }
-    else if (approach == "BT")
-    { // use both
-        cand_partial_lts.insert(cand_partial_lts.end(), make_move_iterator(cand_re_lts.begin()), make_move_iterator(cand_re_lts.end()));
-        cand_partial_lts.insert(cand_partial_lts.end(), make_move_iterator(cand_pm_lts.begin()), make_move_iterator(cand_pm_lts.end()));
-    }
-}
-
 LoadTable StripeGroup::genPartialLTForParityCompute(EncodeMethod enc_method, u16string &enc_nodes)
 {
     uint16_t num_nodes = settings.num_nodes;
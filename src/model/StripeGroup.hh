@@ -3,9 +3,11 @@
 
 #include "../include/include.hh"
 #include "../util/Utils.hh"
+#include "../util/Logger.hh"
 #include "ConvertibleCode.hh"
 #include "ClusterSettings.hh"
 #include "Stripe.hh"
+#include "TransApproach.hh"
 
 enum EncodeMethod
 {
@@ -53,7 +55,6 @@ public:
 
     // (for BART only) load tables
     LoadTable applied_lt;
-    vector<LoadTable> cand_partial_lts;
 
     StripeGroup(uint32_t _id, ConvertibleCode &_code, ClusterSettings &_settings, vector<Stripe *> &_pre_stripes, Stripe *_post_stripe);
     ~StripeGroup();
@@ -76,6 +77,24 @@ public:
      */
     void initParityDists();
 
+    /**
+     * @brief Get transitioning bandwidth for the stripe group
+     *
+     * @tparam ParityUpdatePolicy parity update policy (REPolicy, PMPolicy)
+     * @param enc_nodes encoding node for assignment
+     * @return uint8_t bandwidth
+     */
+    template <typename ParityUpdatePolicy>
+    uint8_t getTransBW(u16string &enc_nodes)
+    {
+        uint8_t parity_update_bw = ParityUpdatePolicy::getParityUpdateBW(*this, enc_nodes);
+
+        // data relocation bw
+        uint8_t data_reloc_bw = getDataRelocBW();
+
+        return parity_update_bw + data_reloc_bw;
+    }
+
     /**
      * @brief Get transitioning bandwidth for the stripe group
      *
@@ -83,7 +102,7 @@ public:
      * @param enc_nodes encoding node for assignment
      * @return uint8_t bandwidth
      */
-    uint8_t getTransBW(string approach, u16string &enc_nodes);
+    uint8_t getTransBW(TransApproach approach, u16string &enc_nodes);
 
     /**
      * @brief Get data relocation bandwidth
@@ -152,15 +171,6 @@ public:
      * @return LoadTable
      */
     LoadTable genPartialLTForParityCompute(EncodeMethod enc_method, u16string &enc_nodes);
-
-    /**
-     * @brief generate all possible partial load tables with traffic for
-     * parity generation only
-     *
-     * @param approach transitioning approach
-     * @return LoadTable
-     */
-    void genAllPartialLTs4ParityCompute(string approach);
 };
 
 #endif // __STRIPE_GROUP_HH__
\ No newline at end of file
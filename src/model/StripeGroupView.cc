@@ -0,0 +1,158 @@
+#include "StripeGroupView.hh"
+
+StripeGroupView::StripeGroupView(ConvertibleCode &_code, vector<Stripe> &_stripes, const u32string &_pre_stripe_ids) : code(_code)
+{
+    num_pre_stripes = _pre_stripe_ids.size();
+    num_data_blocks = 0;
+
+    for (uint8_t pre_stripe_id = 0; pre_stripe_id < num_pre_stripes; pre_stripe_id++)
+    {
+        const Stripe &stripe = _stripes[_pre_stripe_ids[pre_stripe_id]];
+        pre_stripes[pre_stripe_id] = &stripe;
+
+        for (uint8_t block_id = 0; block_id < code.k_i; block_id++)
+        {
+            data_nodes[num_data_blocks++] = stripe.indices[block_id];
+        }
+    }
+
+    sort(data_nodes, data_nodes + num_data_blocks);
+}
+
+StripeGroupView::~StripeGroupView()
+{
+}
+
+void StripeGroupView::getSortedParityNodes(uint8_t parity_id, uint16_t *parity_nodes)
+{
+    for (uint8_t pre_stripe_id = 0; pre_stripe_id < num_pre_stripes; pre_stripe_id++)
+    {
+        parity_nodes[pre_stripe_id] = pre_stripes[pre_stripe_id]->indices[code.k_i + parity_id];
+    }
+
+    sort(parity_nodes, parity_nodes + num_pre_stripes);
+}
+
+uint8_t StripeGroupView::getNumDataBlocks(uint16_t node_id)
+{
+    pair<uint16_t *, uint16_t *> range = equal_range(data_nodes, data_nodes + num_data_blocks, node_id);
+    return range.second - range.first;
+}
+
+uint8_t StripeGroupView::getDataRelocBW()
+{
+    // each data block placed at the same node with a previous one needs to be relocated
+    uint8_t data_reloc_bw = 0;
+    for (uint8_t idx = 1; idx < num_data_blocks; idx++)
+    {
+        if (data_nodes[idx] == data_nodes[idx - 1])
+        {
+            data_reloc_bw++;
+        }
+    }
+
+    return data_reloc_bw;
+}
+
+uint8_t StripeGroupView::getREBW(u16string &enc_nodes)
+{
+    // for re-encoding, find the node stored with most number of data blocks
+    // (the smallest node id for ties, same as StripeGroup::getREBW())
+    uint16_t re_node = data_nodes[0];
+    uint8_t max_num_data_blocks = 0;
+
+    uint8_t idx = 0;
+    while (idx < num_data_blocks)
+    {
+        uint8_t run_end = idx;
+        while (run_end < num_data_blocks && data_nodes[run_end] == data_nodes[idx])
+        {
+            run_end++;
+        }
+
+        if (run_end - idx > max_num_data_blocks)
+        {
+            max_num_data_blocks = run_end - idx;
+            re_node = data_nodes[idx];
+        }
+        idx = run_end;
+    }
+
+    uint8_t re_bw = code.k_f - max_num_data_blocks;
+    enc_nodes.assign(code.m_f, re_node);
+
+    return re_bw;
+}
+
+uint8_t StripeGroupView::getPMBW(u16string &enc_nodes)
+{
+    uint8_t sum_pm_bw = 0;
+    uint16_t parity_nodes[MAX_NUM_SG_BLOCKS];
+
+    for (uint8_t parity_id = 0; parity_id < code.m_f; parity_id++)
+    {
+        uint16_t min_bw_node = UINT16_MAX;
+        uint8_t min_bw = UINT8_MAX;
+
+        // visit the nodes storing the parity blocks in ascending order of node id
+        getSortedParityNodes(parity_id, parity_nodes);
+
+        uint8_t idx = 0;
+        while (idx < num_pre_stripes)
+        {
+            uint16_t cand_pm_node = parity_nodes[idx];
+            uint8_t run_end = idx;
+            while (run_end < num_pre_stripes && parity_nodes[run_end] == cand_pm_node)
+            {
+                run_end++;
+            }
+            uint8_t num_src_parity_blocks = run_end - idx;
+            idx = run_end;
+
+            // check if the node is placed with a data block or a new parity block
+            bool is_placed = getNumDataBlocks(cand_pm_node) > 0;
+            for (uint8_t prev_parity_id = 0; prev_parity_id < parity_id && is_placed == false; prev_parity_id++)
+            {
+                is_placed = (enc_nodes[prev_parity_id] == cand_pm_node);
+            }
+
+            // bandwidth = the number of source parity blocks required +
+            // new parity block relocation bandwidth
+            uint8_t pm_bw = (num_pre_stripes - num_src_parity_blocks) + (is_placed == true ? 1 : 0);
+
+            if (pm_bw < min_bw)
+            {
+                min_bw = pm_bw;
+                min_bw_node = cand_pm_node;
+
+                // no need to search if min_bw = 0
+                if (min_bw == 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        // assign encode node
+        enc_nodes[parity_id] = min_bw_node;
+        sum_pm_bw += min_bw; // update bw
+    }
+
+    return sum_pm_bw;
+}
+
+uint8_t StripeGroupView::getMaxNumParityBlocks(uint8_t parity_id)
+{
+    uint16_t parity_nodes[MAX_NUM_SG_BLOCKS];
+    getSortedParityNodes(parity_id, parity_nodes);
+
+    uint8_t max_num_parity_blocks = 0;
+    uint8_t num_parity_blocks = 0;
+    for (uint8_t idx = 0; idx < num_pre_stripes; idx++)
+    {
+        num_parity_blocks = (idx > 0 && parity_nodes[idx] == parity_nodes[idx - 1]) ? num_parity_blocks + 1 : 1;
+        max_num_parity_blocks = max(max_num_parity_blocks, num_parity_blocks);
+    }
+
+    return max_num_parity_blocks;
+}
@@ -0,0 +1,101 @@
+#ifndef __STRIPE_GROUP_VIEW_HH__
+#define __STRIPE_GROUP_VIEW_HH__
+
+#include "../include/include.hh"
+#include "ConvertibleCode.hh"
+#include "Stripe.hh"
+#include "TransApproach.hh"
+
+#define MAX_NUM_SG_BLOCKS UINT8_MAX // maximum number of data blocks in a (partial) stripe group (at most k_f)
+
+/**
+ * @brief lightweight view of a (partial) stripe group for bandwidth
+ * calculation; it keeps block placements in sorted stack-resident arrays
+ * (instead of node-sized distributions in StripeGroup), so that evaluating
+ * candidate stripe groups requires no heap allocation
+ *
+ */
+class StripeGroupView
+{
+private:
+    ConvertibleCode &code;
+
+    uint8_t num_pre_stripes;
+    const Stripe *pre_stripes[MAX_NUM_SG_BLOCKS]; // pre-transition stripes
+
+    uint8_t num_data_blocks;
+    uint16_t data_nodes[MAX_NUM_SG_BLOCKS]; // sorted nodes of data blocks
+
+    /**
+     * @brief get sorted nodes of parity blocks with parity_id
+     *
+     * @param parity_id
+     * @param parity_nodes (out) array with size num_pre_stripes
+     */
+    void getSortedParityNodes(uint8_t parity_id, uint16_t *parity_nodes);
+
+    /**
+     * @brief get the number of data blocks stored in a node
+     *
+     * @param node_id
+     * @return uint8_t
+     */
+    uint8_t getNumDataBlocks(uint16_t node_id);
+
+public:
+    StripeGroupView(ConvertibleCode &_code, vector<Stripe> &_stripes, const u32string &_pre_stripe_ids);
+    ~StripeGroupView();
+
+    /**
+     * @brief Get transitioning bandwidth for the stripe group (same as
+     * StripeGroup::getTransBW())
+     *
+     * @tparam ParityUpdatePolicy parity update policy (REPolicy, PMPolicy)
+     * @param enc_nodes encoding node for assignment
+     * @return uint8_t bandwidth
+     */
+    template <typename ParityUpdatePolicy>
+    uint8_t getTransBW(u16string &enc_nodes)
+    {
+        uint8_t parity_update_bw = ParityUpdatePolicy::getParityUpdateBW(*this, enc_nodes);
+
+        // data relocation bw
+        uint8_t data_reloc_bw = getDataRelocBW();
+
+        return parity_update_bw + data_reloc_bw;
+    }
+
+    /**
+     * @brief Get data relocation bandwidth
+     *
+     * @return uint8_t bandwidth
+     */
+    uint8_t getDataRelocBW();
+
+    /**
+     * @brief get re-encoding bandwidth
+     *
+     * @param enc_nodes
+     * @return uint8_t
+     */
+    uint8_t getREBW(u16string &enc_nodes);
+
+    /**
+     * @brief get parity merging bandwidth
+     *
+     * @param enc_nodes
+     * @return uint8_t
+     */
+    uint8_t getPMBW(u16string &enc_nodes);
+
+    /**
+     * @brief get the maximum number of parity blocks (with parity_id) stored
+     * in a node
+     *
+     * @param parity_id
+     * @return uint8_t
+     */
+    uint8_t getMaxNumParityBlocks(uint8_t parity_id);
+};
+
+#endif // __STRIPE_GROUP_VIEW_HH__
@@ -0,0 +1,26 @@
+#include "TransApproach.hh"
+
+static const char *trans_approach_names[] = {"RDRE", "RDPM", "BWRE", "BWPM", "BTRE", "BTPM", "BT", "BTWeighted", "UNKNOWN"};
+
+TransApproach TransApproachUtils::parse(const string &name)
+{
+    for (int approach = RDRE; approach < UNKNOWN_APPROACH; approach++)
+    {
+        if (name == trans_approach_names[approach])
+        {
+            return (TransApproach)approach;
+        }
+    }
+
+    return UNKNOWN_APPROACH;
+}
+
+const char *TransApproachUtils::getName(TransApproach approach)
+{
+    return trans_approach_names[approach];
+}
+
+bool TransApproachUtils::isPMBW(TransApproach approach)
+{
+    return approach == TransApproach::BWPM || approach == TransApproach::BTPM || approach == TransApproach::BT || approach == TransApproach::BT_WEIGHTED;
+}
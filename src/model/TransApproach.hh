@@ -0,0 +1,85 @@
+#ifndef __TRANS_APPROACH_HH__
+#define __TRANS_APPROACH_HH__
+
+#include "../include/include.hh"
+
+/**
+ * @brief transitioning approaches
+ * RD: random; BW: bandwidth optimized; BT: BART
+ * RE: re-encoding; PM: parity merging
+ */
+enum TransApproach
+{
+    RDRE,
+    RDPM,
+    BWRE,
+    BWPM,
+    BTRE,
+    BTPM,
+    BT,
+    BT_WEIGHTED,
+    UNKNOWN_APPROACH
+};
+
+/**
+ * @brief parity update policy with re-encoding, used as the template
+ * parameter of bandwidth calculation
+ */
+struct REPolicy
+{
+    template <typename StripeGroupType>
+    static inline uint8_t getParityUpdateBW(StripeGroupType &stripe_group, u16string &enc_nodes)
+    {
+        return stripe_group.getREBW(enc_nodes);
+    }
+};
+
+/**
+ * @brief parity update policy with parity merging, used as the template
+ * parameter of bandwidth calculation
+ */
+struct PMPolicy
+{
+    template <typename StripeGroupType>
+    static inline uint8_t getParityUpdateBW(StripeGroupType &stripe_group, u16string &enc_nodes)
+    {
+        return stripe_group.getPMBW(enc_nodes);
+    }
+};
+
+class TransApproachUtils
+{
+public:
+    /**
+     * @brief parse transitioning approach from name
+     *
+     * @param name RDRE/RDPM/BWRE/BWPM/BTRE/BTPM/BT/BTWeighted
+     * @return TransApproach (UNKNOWN_APPROACH for invalid name)
+     */
+    static TransApproach parse(const string &name);
+
+    /**
+     * @brief get name of transitioning approach
+     *
+     * @param approach
+     * @return const char*
+     */
+    static const char *getName(TransApproach approach);
+
+    /**
+     * @brief check if the bandwidth of the approach is calculated with
+     * parity merging (PMPolicy); otherwise it is calculated with re-encoding
+     * (REPolicy)
+     *
+     * NOTE: for BT and BTWeighted (mixed with re-encoding and parity
+     * merging), we assume that bandwidth(pm) <= bandwidth(re), thus we
+     * calculate pm bandwidth only
+     *
+     * @param approach
+     * @return true
+     * @return false
+     */
+    static bool isPMBW(TransApproach approach);
+};
+
+#endif // __TRANS_APPROACH_HH__
@@ -49,7 +49,7 @@ void TransSolution::print()
 
     for (auto &item : *task_list)
     {
-        printf("stripe group %u, number of tasks: %lu\n", item.first, item.second.size());
+        LOG_DEBUG("stripe group %u, number of tasks: %lu", item.first, item.second.size());
         for (auto &task : item.second)
         {
             task->print();
@@ -82,7 +82,7 @@ bool TransSolution::isFinalBlockPlacementValid(StripeBatch &stripe_batch)
     for (auto &item : stripe_batch.selected_sgs)
     {
         StripeGroup &stripe_group = item.second;
-        u16string &final_block_placement = stripe_group.post_stripe->indices;
+        StripeIndices &final_block_placement = stripe_group.post_stripe->indices;
 
         vector<bool> is_node_placed(settings.num_nodes, false);
 
@@ -95,9 +95,7 @@ bool TransSolution::isFinalBlockPlacementValid(StripeBatch &stripe_batch)
             }
             else
             { // more than one block placed at the node
-                printf("invalid final block placement, stripe_group id: %u, placement: ", stripe_group.id);
-                Utils::printVector(final_block_placement);
-                printf("\n");
+                LOG_ERROR("invalid final block placement, stripe_group id: %u, placement: %s", stripe_group.id, Utils::vectorToString(final_block_placement).c_str());
                 return false;
             }
         }
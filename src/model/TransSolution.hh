@@ -2,6 +2,7 @@
 #define __TRANS_SOLUTION_HH__
 
 #include "../include/include.hh"
+#include "../util/Logger.hh"
 #include "ConvertibleCode.hh"
 #include "ClusterSettings.hh"
 #include "TransTask.hh"
@@ -10,5 +10,5 @@ TransTask::~TransTask()
 
 void TransTask::print()
 {
-    printf("Transition Task: type: %u, post_stripe: (%u, %u), pre_stripe: (%u, %u, %u), src_node: %u, dst_node: %u\n", type, post_stripe_id, post_block_id, pre_stripe_id_global, pre_stripe_id_relative, pre_block_id, src_node_id, dst_node_id);
+    LOG_DEBUG("Transition Task: type: %u, post_stripe: (%u, %u), pre_stripe: (%u, %u, %u), src_node: %u, dst_node: %u", type, post_stripe_id, post_block_id, pre_stripe_id_global, pre_stripe_id_relative, pre_block_id, src_node_id, dst_node_id);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define __TRANS_TASK_HH__
 
 #include "../include/include.hh"
+#include "../util/Logger.hh"
 
 enum TransTaskType
 {
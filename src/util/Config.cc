@@ -18,6 +18,25 @@ Config::Config(string filename)
     inipp::get_value(ini.sections["Common"], "num_nodes", num_nodes);
     inipp::get_value(ini.sections["Common"], "num_stripes", num_stripes);
     inipp::get_value(ini.sections["Common"], "approach", approach);
+    inipp::get_value(ini.sections["Common"], "trace_dir", trace_dir);
+    trace_buffer_size = DEFAULT_TRACE_BUFFER_SIZE;
+    inipp::get_value(ini.sections["Common"], "trace_buffer_size", trace_buffer_size);
+    if (trace_buffer_size == 0)
+    {
+        trace_buffer_size = 1;
+    }
+    string log_level_str = "info";
+    inipp::get_value(ini.sections["Common"], "log_level", log_level_str);
+    log_level = Logger::parseLevel(log_level_str);
+    if (log_level < 0)
+    {
+        LOG_ERROR("Config::Config invalid log_level: %s (debug / info / warn / error)", log_level_str.c_str());
+        exit(EXIT_FAILURE);
+    }
+    log_buffer_size = DEFAULT_LOG_BUFFER_SIZE;
+    inipp::get_value(ini.sections["Common"], "log_buffer_size", log_buffer_size);
+    log_rate_limit = DEFAULT_LOG_RATE_LIMIT;
+    inipp::get_value(ini.sections["Common"], "log_rate_limit", log_rate_limit);
 
     code = ConvertibleCode(k_i, m_i, k_f, m_f);
     settings = ClusterSettings(num_nodes, num_stripes);
@@ -31,6 +50,29 @@ Config::Config(string filename)
     inipp::get_value(ini.sections["Controller"], "post_placement_filename", post_placement_filename);
     inipp::get_value(ini.sections["Controller"], "post_block_mapping_filename", post_block_mapping_filename);
     inipp::get_value(ini.sections["Controller"], "sg_meta_filename", sg_meta_filename);
+    inipp::get_value(ini.sections["Controller"], "plan_filename", plan_filename);
+    string dispatch_mode_str = "push";
+    inipp::get_value(ini.sections["Controller"], "dispatch_mode", dispatch_mode_str);
+    if (dispatch_mode_str == "push")
+    {
+        dispatch_mode = DispatchMode::DISPATCH_PUSH;
+    }
+    else if (dispatch_mode_str == "pull")
+    {
+        dispatch_mode = DispatchMode::DISPATCH_PULL;
+    }
+    else
+    {
+        LOG_ERROR("Config::Config invalid dispatch_mode: %s (push / pull)", dispatch_mode_str.c_str());
+        exit(EXIT_FAILURE);
+    }
+    dispatch_tasks_per_worker = DEFAULT_DISPATCH_TASKS_PER_WORKER;
+    inipp::get_value(ini.sections["Controller"], "dispatch_tasks_per_worker", dispatch_tasks_per_worker);
+    if (dispatch_tasks_per_worker == 0)
+    {
+        dispatch_tasks_per_worker = 1;
+    }
+    inipp::get_value(ini.sections["Controller"], "bw_limit_filename", bw_limit_filename);
 
     // controller ip, port
     auto delim_pos = controller_addr_raw.find(":");
@@ -65,8 +107,83 @@ Config::Config(string filename)
 
     // Agent
     inipp::get_value(ini.sections["Agent"], "block_size", block_size);
+    chunk_size = DEFAULT_CHUNK_SIZE;
+    inipp::get_value(ini.sections["Agent"], "chunk_size", chunk_size);
+    if (chunk_size == 0 || chunk_size > block_size)
+    { // handle the whole block at once
+        chunk_size = block_size;
+    }
+    num_chunk_slots = DEFAULT_NUM_CHUNK_SLOTS;
+    inipp::get_value(ini.sections["Agent"], "num_chunk_slots", num_chunk_slots);
+    uint64_t num_chunks = (block_size + chunk_size - 1) / chunk_size;
+    if (num_chunk_slots == 0 || num_chunk_slots > num_chunks)
+    { // buffer the whole block
+        num_chunk_slots = num_chunks;
+    }
+    memory_budget = 0;
+    inipp::get_value(ini.sections["Agent"], "memory_budget", memory_budget);
+    unsigned int use_hugepage_raw = 0;
+    inipp::get_value(ini.sections["Agent"], "use_hugepage", use_hugepage_raw);
+    use_hugepage = (use_hugepage_raw != 0);
+    unsigned int incremental_encoding_raw = 0;
+    inipp::get_value(ini.sections["Agent"], "incremental_encoding", incremental_encoding_raw);
+    incremental_encoding = (incremental_encoding_raw != 0);
+    unsigned int zero_copy_raw = 1;
+    inipp::get_value(ini.sections["Agent"], "zero_copy", zero_copy_raw);
+    zero_copy = (zero_copy_raw != 0);
+    unsigned int use_io_uring_raw = 1;
+    inipp::get_value(ini.sections["Agent"], "use_io_uring", use_io_uring_raw);
+    use_io_uring = (use_io_uring_raw != 0);
+    io_queue_depth = DEFAULT_IO_QUEUE_DEPTH;
+    inipp::get_value(ini.sections["Agent"], "io_queue_depth", io_queue_depth);
+    if (io_queue_depth == 0)
+    {
+        io_queue_depth = DEFAULT_IO_QUEUE_DEPTH;
+    }
+    unsigned int use_direct_io_raw = 0;
+    inipp::get_value(ini.sections["Agent"], "use_direct_io", use_direct_io_raw);
+    use_direct_io = (use_direct_io_raw != 0);
+    unsigned int preallocate_raw = 1;
+    inipp::get_value(ini.sections["Agent"], "preallocate", preallocate_raw);
+    preallocate = (preallocate_raw != 0);
+    string sync_policy_str = "none";
+    inipp::get_value(ini.sections["Agent"], "sync_policy", sync_policy_str);
+    if (sync_policy_str == "none")
+    {
+        sync_policy = SyncPolicy::SYNC_NONE;
+    }
+    else if (sync_policy_str == "block")
+    {
+        sync_policy = SyncPolicy::SYNC_PER_BLOCK;
+    }
+    else if (sync_policy_str == "batch")
+    {
+        sync_policy = SyncPolicy::SYNC_BATCHED;
+    }
+    else
+    {
+        LOG_ERROR("Config::Config invalid sync_policy: %s (none / block / batch)", sync_policy_str.c_str());
+        exit(EXIT_FAILURE);
+    }
+    sync_batch_size = DEFAULT_SYNC_BATCH_SIZE;
+    inipp::get_value(ini.sections["Agent"], "sync_batch_size", sync_batch_size);
+    if (sync_batch_size == 0)
+    {
+        sync_batch_size = 1;
+    }
     inipp::get_value(ini.sections["Agent"], "num_compute_workers", num_compute_workers);
     inipp::get_value(ini.sections["Agent"], "num_reloc_workers", num_reloc_workers);
+    max_conns_per_peer = DEFAULT_MAX_CONNS_PER_PEER;
+    inipp::get_value(ini.sections["Agent"], "max_conns_per_peer", max_conns_per_peer);
+    if (max_conns_per_peer < code.lambda_i)
+    { // the source blocks of a computation stored at a node are streamed concurrently
+        LOG_WARN("Config::Config max_conns_per_peer (%u) is raised to lambda_i (%u)", max_conns_per_peer, code.lambda_i);
+        max_conns_per_peer = code.lambda_i;
+    }
+    send_bw_limit = 0;
+    inipp::get_value(ini.sections["Agent"], "send_bw_limit", send_bw_limit);
+    recv_bw_limit = 0;
+    inipp::get_value(ini.sections["Agent"], "recv_bw_limit", recv_bw_limit);
 }
 
 Config::~Config()
@@ -75,32 +192,56 @@ Config::~Config()
 
 void Config::print()
 {
-    printf("========= Configurations ==========\n");
+    LOG_INFO("========= Configurations ==========");
 
-    printf("========= Common ==========\n");
+    LOG_INFO("========= Common ==========");
     code.print();
     settings.print();
-    printf("transitioning approach: %s\n", approach.c_str());
-    printf("===========================\n");
+    LOG_INFO("transitioning approach: %s", approach.c_str());
+    LOG_INFO("trace_dir: %s", trace_dir.c_str());
+    LOG_INFO("trace_buffer_size: %u", trace_buffer_size);
+    LOG_INFO("log_level: %d", log_level);
+    LOG_INFO("log_buffer_size: %u", log_buffer_size);
+    LOG_INFO("log_rate_limit: %u", log_rate_limit);
+    LOG_INFO("===========================");
 
-    printf("========= Controller ==========\n");
-    printf("address: %s:%u\n", controller_addr.first.c_str(), controller_addr.second);
-    printf("pre_placement_filename: %s\n", pre_placement_filename.c_str());
-    printf("pre_block_mapping_filename: %s\n", pre_block_mapping_filename.c_str());
-    printf("post_placement_filename: %s\n", post_placement_filename.c_str());
-    printf("post_block_mapping_filename: %s\n", post_block_mapping_filename.c_str());
-    printf("sg_meta_filename: %s\n", sg_meta_filename.c_str());
-    printf("===========================\n");
+    LOG_INFO("========= Controller ==========");
+    LOG_INFO("address: %s:%u", controller_addr.first.c_str(), controller_addr.second);
+    LOG_INFO("pre_placement_filename: %s", pre_placement_filename.c_str());
+    LOG_INFO("pre_block_mapping_filename: %s", pre_block_mapping_filename.c_str());
+    LOG_INFO("post_placement_filename: %s", post_placement_filename.c_str());
+    LOG_INFO("post_block_mapping_filename: %s", post_block_mapping_filename.c_str());
+    LOG_INFO("sg_meta_filename: %s", sg_meta_filename.c_str());
+    LOG_INFO("plan_filename: %s", plan_filename.c_str());
+    LOG_INFO("dispatch_mode: %u", dispatch_mode);
+    LOG_INFO("dispatch_tasks_per_worker: %u", dispatch_tasks_per_worker);
+    LOG_INFO("bw_limit_filename: %s", bw_limit_filename.c_str());
+    LOG_INFO("===========================");
 
-    printf("========= Agents ==========\n");
-    printf("block_size: %lu\n", block_size);
-    printf("num_compute_workers: %u\n", num_compute_workers);
-    printf("num_reloc_workers: %u\n", num_reloc_workers);
-    printf("addresses: (%lu)\n", agent_addr_map.size());
+    LOG_INFO("========= Agents ==========");
+    LOG_INFO("block_size: %lu", block_size);
+    LOG_INFO("chunk_size: %lu", chunk_size);
+    LOG_INFO("num_chunk_slots: %lu", num_chunk_slots);
+    LOG_INFO("memory_budget: %lu", memory_budget);
+    LOG_INFO("use_hugepage: %u", use_hugepage);
+    LOG_INFO("incremental_encoding: %u", incremental_encoding);
+    LOG_INFO("zero_copy: %u", zero_copy);
+    LOG_INFO("use_io_uring: %u", use_io_uring);
+    LOG_INFO("io_queue_depth: %u", io_queue_depth);
+    LOG_INFO("use_direct_io: %u", use_direct_io);
+    LOG_INFO("preallocate: %u", preallocate);
+    LOG_INFO("sync_policy: %u", sync_policy);
+    LOG_INFO("sync_batch_size: %u", sync_batch_size);
+    LOG_INFO("num_compute_workers: %u", num_compute_workers);
+    LOG_INFO("num_reloc_workers: %u", num_reloc_workers);
+    LOG_INFO("max_conns_per_peer: %u", max_conns_per_peer);
+    LOG_INFO("send_bw_limit: %lu", send_bw_limit);
+    LOG_INFO("recv_bw_limit: %lu", recv_bw_limit);
+    LOG_INFO("addresses: (%lu)", agent_addr_map.size());
     for (auto &item : agent_addr_map)
     {
         auto &agent_addr = item.second;
-        printf("Agent %u, ip: %s:%d\n", item.first, agent_addr.first.c_str(), agent_addr.second);
+        LOG_INFO("Agent %u, ip: %s:%d", item.first, agent_addr.first.c_str(), agent_addr.second);
     }
-    printf("===========================\n");
+    LOG_INFO("===========================");
 }
\ No newline at end of file
@@ -5,6 +5,34 @@
 #include "../model/ConvertibleCode.hh"
 #include "../model/ClusterSettings.hh"
 #include "../util/inipp.h"
+#include "../util/Logger.hh"
+
+#define DEFAULT_MAX_CONNS_PER_PEER 4        // default maximum number of persistent connections from an Agent to each peer
+#define DEFAULT_CHUNK_SIZE 1048576          // default chunk size (in Bytes) of pipelined block transfer and computation
+#define DEFAULT_NUM_CHUNK_SLOTS 4           // default number of chunks of a block buffered in memory at a time
+#define DEFAULT_IO_QUEUE_DEPTH 32           // default maximum number of in-flight chunk I/Os of an asynchronous I/O engine
+#define DEFAULT_SYNC_BATCH_SIZE 16          // default number of written blocks synced together (batched sync policy)
+#define DEFAULT_DISPATCH_TASKS_PER_WORKER 2 // default number of dispatched but unfinished tasks per Agent worker (pull dispatch)
+#define DEFAULT_TRACE_BUFFER_SIZE 65536     // default number of trace events kept per thread
+
+/**
+ * @brief dispatch of transition tasks from Controller to Agents
+ */
+enum DispatchMode
+{
+    DISPATCH_PUSH, // push all tasks at once; Agents assign tasks to workers round-robin
+    DISPATCH_PULL  // hand out stripe groups (critical path first) as Agents report finished tasks
+};
+
+/**
+ * @brief durability of written blocks
+ */
+enum SyncPolicy
+{
+    SYNC_NONE,      // none (left to the page cache)
+    SYNC_PER_BLOCK, // fdatasync each written block
+    SYNC_BATCHED    // syncfs once per batch of written blocks
+};
 
 class Config
 {
@@ -13,21 +41,45 @@ public:
     // Common
     ConvertibleCode code;
     ClusterSettings settings;
-    string approach; // transitioning approach
+    string approach;                // transitioning approach
+    string trace_dir;               // (optional) directory of the timeline traces of nodes (empty: no tracing)
+    unsigned int trace_buffer_size; // number of trace events kept per thread (the oldest are overwritten)
+    int log_level;                  // minimum level of logged messages (LOG_LEVEL_*)
+    unsigned int log_buffer_size;   // Bytes of log messages buffered per thread (the newest are dropped if full)
+    unsigned int log_rate_limit;    // maximum number of log messages per second of each call site (0: unlimited)
 
     // Controller
     pair<string, unsigned int> controller_addr;
     map<uint16_t, pair<string, unsigned int>> agent_addr_map;
-    string pre_placement_filename;      // pre-transition placement
-    string pre_block_mapping_filename;  // pre-transition block mapping
-    string post_placement_filename;     // post-transition placement
-    string post_block_mapping_filename; // post-transition block mapping
-    string sg_meta_filename;            // stripe group metadata
+    string pre_placement_filename;          // pre-transition placement
+    string pre_block_mapping_filename;      // pre-transition block mapping
+    string post_placement_filename;         // post-transition placement
+    string post_block_mapping_filename;     // post-transition block mapping
+    string sg_meta_filename;                // stripe group metadata
+    string plan_filename;                   // (optional) binary plan file (placements, block mappings and stripe group metadata)
+    DispatchMode dispatch_mode;             // dispatch of transition tasks
+    unsigned int dispatch_tasks_per_worker; // number of dispatched but unfinished tasks per Agent worker (DISPATCH_PULL)
+    string bw_limit_filename;               // (optional) bandwidth limits of Agents (<agent_id> <send_bw_limit> <recv_bw_limit> per line), reloaded on change
 
     // Agent
     uint64_t block_size;              // block size in Bytes
+    uint64_t chunk_size;              // chunk size in Bytes: blocks are read, transferred, computed and written chunk by chunk
+    uint64_t num_chunk_slots;         // number of chunks of a block buffered in memory at a time (by a transfer or computation)
+    uint64_t memory_budget;           // memory budget in Bytes: size of the memory pool of chunk buffers shared by all workers (0: sized for all workers)
+    bool use_hugepage;                // back the memory pool with hugepages
+    bool incremental_encoding;        // accumulate each retrieved chunk into the parity blocks (ec_encode_data_update), instead of buffering all source chunks
+    bool zero_copy;                   // relocate and serve blocks with sendfile / splice, instead of through chunk buffers
+    bool use_io_uring;                // drive disk I/Os asynchronously with io_uring (otherwise synchronous I/Os)
+    unsigned int io_queue_depth;      // maximum number of in-flight chunk I/Os per thread
+    bool use_direct_io;               // open block files with O_DIRECT (bypass the page cache)
+    bool preallocate;                 // preallocate written blocks (fallocate)
+    SyncPolicy sync_policy;           // durability of written blocks
+    unsigned int sync_batch_size;     // number of written blocks synced together (SYNC_BATCHED)
     unsigned int num_compute_workers; // number of compute workers
     unsigned int num_reloc_workers;   // number of relocation workers
+    unsigned int max_conns_per_peer;  // maximum number of persistent connections to each peer's block request handler
+    uint64_t send_bw_limit;           // bandwidth limit of sending blocks in Bytes per second (0: unlimited)
+    uint64_t recv_bw_limit;           // bandwidth limit of receiving blocks in Bytes per second (0: unlimited)
 
     Config(string filename);
     ~Config();
@@ -0,0 +1,329 @@
+#include "Logger.hh"
+
+int Logger::level = LOG_LEVEL_INFO;
+size_t Logger::buffer_size = DEFAULT_LOG_BUFFER_SIZE;
+uint32_t Logger::rate_limit = 0;
+atomic<bool> Logger::is_async(false);
+
+mutex Logger::buffers_mtx;
+vector<LogBuffer *> Logger::buffers;
+vector<LogBuffer *> Logger::free_buffers;
+
+mutex Logger::flush_mtx;
+thread *Logger::flusher = NULL;
+mutex Logger::flusher_mtx;
+condition_variable Logger::flusher_cv;
+bool Logger::is_stopped = false;
+
+/**
+ * @brief the log buffer of a thread, released when the thread exits
+ */
+typedef struct LogBufferHolder
+{
+    LogBuffer *buffer;
+
+    LogBufferHolder() : buffer(NULL) {}
+    ~LogBufferHolder()
+    {
+        if (buffer != NULL)
+        {
+            Logger::releaseBuffer(buffer);
+        }
+    }
+} LogBufferHolder;
+
+static thread_local LogBufferHolder thread_buffer_holder;
+
+void Logger::init(int _level, size_t _buffer_size, uint32_t _rate_limit)
+{
+    level = _level;
+    buffer_size = max(_buffer_size, (size_t)(2 * getRecordSize(LOG_MAX_MSG_SIZE - 1)));
+    buffer_size = (buffer_size + LOG_RECORD_ALIGNMENT - 1) / LOG_RECORD_ALIGNMENT * LOG_RECORD_ALIGNMENT;
+    rate_limit = _rate_limit;
+
+    if (flusher != NULL)
+    {
+        return;
+    }
+
+    static bool is_exit_handler_registered = false;
+    if (is_exit_handler_registered == false)
+    {
+        atexit(Logger::flushAtExit);
+        is_exit_handler_registered = true;
+    }
+
+    is_stopped = false;
+    is_async = true;
+    flusher = new thread(Logger::runFlusher);
+}
+
+void Logger::shutdown()
+{
+    if (flusher == NULL)
+    {
+        return;
+    }
+
+    unique_lock<mutex> lck(flusher_mtx);
+    is_stopped = true;
+    lck.unlock();
+    flusher_cv.notify_one();
+
+    flusher->join();
+    delete flusher;
+    flusher = NULL;
+
+    // messages are written synchronously afterwards
+    is_async = false;
+    unique_lock<mutex> flush_lck(flush_mtx);
+    flushBuffers();
+}
+
+int Logger::parseLevel(string level_str)
+{
+    if (level_str == "debug")
+    {
+        return LOG_LEVEL_DEBUG;
+    }
+    else if (level_str == "info")
+    {
+        return LOG_LEVEL_INFO;
+    }
+    else if (level_str == "warn")
+    {
+        return LOG_LEVEL_WARN;
+    }
+    else if (level_str == "error")
+    {
+        return LOG_LEVEL_ERROR;
+    }
+    return -1;
+}
+
+LogBuffer *Logger::getThreadBuffer()
+{
+    LogBuffer *buffer = thread_buffer_holder.buffer;
+    if (buffer != NULL)
+    {
+        return buffer;
+    }
+
+    // reuse the buffer of an exited thread, or create a new one
+    unique_lock<mutex> lck(buffers_mtx);
+    if (free_buffers.empty() == false)
+    {
+        buffer = free_buffers.back();
+        free_buffers.pop_back();
+    }
+    else
+    { // not initialized (the pages are touched as messages are written)
+        buffer = new LogBuffer();
+        buffer->data = new char[buffer_size];
+        buffer->size = buffer_size;
+        buffer->head = 0;
+        buffer->tail = 0;
+        buffer->num_dropped = 0;
+        buffers.push_back(buffer);
+    }
+    lck.unlock();
+
+    thread_buffer_holder.buffer = buffer;
+    return buffer;
+}
+
+uint64_t Logger::getRecordSize(uint16_t msg_len)
+{
+    uint64_t record_size = sizeof(LogRecord) + msg_len + 1;
+    return (record_size + LOG_RECORD_ALIGNMENT - 1) / LOG_RECORD_ALIGNMENT * LOG_RECORD_ALIGNMENT;
+}
+
+void Logger::releaseBuffer(LogBuffer *buffer)
+{
+    unique_lock<mutex> lck(buffers_mtx);
+    free_buffers.push_back(buffer);
+}
+
+void Logger::log(int msg_level, LogSite &site, const char *fmt, ...)
+{
+    uint64_t cur_time_us = Utils::getTimeUs();
+
+    // rate limiting of the call site (errors are never suppressed)
+    uint32_t num_suppressed = 0;
+    if (rate_limit > 0 && msg_level < LOG_LEVEL_ERROR)
+    {
+        uint64_t window_start_us = site.window_start_us.load(memory_order_relaxed);
+        if (cur_time_us - window_start_us >= LOG_RATE_LIMIT_WINDOW_US && site.window_start_us.compare_exchange_strong(window_start_us, cur_time_us) == true)
+        {
+            site.num_logged = 0;
+        }
+        if (site.num_logged.fetch_add(1) >= rate_limit)
+        {
+            site.num_suppressed++;
+            return;
+        }
+        num_suppressed = site.num_suppressed.exchange(0);
+    }
+
+    va_list args;
+    va_start(args, fmt);
+
+    if (msg_level == LOG_LEVEL_ERROR || is_async == false)
+    {
+        // synchronous: format the whole message
+        va_list args_copy;
+        va_copy(args_copy, args);
+        int len = vsnprintf(NULL, 0, fmt, args_copy);
+        va_end(args_copy);
+        string msg(len > 0 ? len : 0, '\0');
+        vsnprintf(&msg[0], msg.size() + 1, fmt, args);
+        va_end(args);
+
+        if (msg_level == LOG_LEVEL_ERROR)
+        { // errors are written after the buffered messages
+            unique_lock<mutex> lck(flush_mtx);
+            flushBuffers();
+            fflush(stdout);
+            writeMessage(msg_level, msg.c_str(), num_suppressed);
+        }
+        else
+        {
+            writeMessage(msg_level, msg.c_str(), num_suppressed);
+        }
+        return;
+    }
+
+    // format on the stack, and buffer only the Bytes of the message
+    char msg[LOG_MAX_MSG_SIZE];
+    int len = vsnprintf(msg, LOG_MAX_MSG_SIZE, fmt, args);
+    va_end(args);
+    uint16_t msg_len = (len < 0) ? 0 : min(len, LOG_MAX_MSG_SIZE - 1);
+    uint64_t record_size = getRecordSize(msg_len);
+
+    LogBuffer *buffer = getThreadBuffer();
+    uint64_t head = buffer->head.load(memory_order_relaxed);
+    uint64_t num_buffered = head - buffer->tail.load(memory_order_acquire);
+
+    // the record doesn't wrap around: skip the end of the ring if it doesn't fit
+    uint64_t offset = head % buffer->size;
+    uint64_t num_skipped = (buffer->size - offset < record_size) ? buffer->size - offset : 0;
+    if (num_buffered + num_skipped + record_size > buffer->size)
+    { // the buffer is full: drop the message
+        buffer->num_dropped++;
+        flusher_cv.notify_one();
+        return;
+    }
+    if (num_skipped >= sizeof(LogRecord))
+    {
+        LogRecord *padding = (LogRecord *)(buffer->data + offset);
+        padding->msg_len = LOG_PADDING_LEN;
+    }
+
+    LogRecord *record = (LogRecord *)(buffer->data + (head + num_skipped) % buffer->size);
+    record->time_us = cur_time_us;
+    record->num_suppressed = num_suppressed;
+    record->msg_len = msg_len;
+    record->level = msg_level;
+    memcpy((char *)(record + 1), msg, msg_len);
+    ((char *)(record + 1))[msg_len] = '\0';
+
+    buffer->head.store(head + num_skipped + record_size, memory_order_release);
+
+    // wake up the flusher early once the buffer is half full
+    uint64_t half_size = buffer->size / 2;
+    if (num_buffered < half_size && num_buffered + num_skipped + record_size >= half_size)
+    {
+        flusher_cv.notify_one();
+    }
+}
+
+void Logger::writeMessage(int msg_level, const char *msg, uint32_t num_suppressed)
+{
+    FILE *out = msg_level == LOG_LEVEL_ERROR ? stderr : stdout;
+    if (num_suppressed > 0)
+    {
+        fprintf(out, "%s (%u similar messages suppressed)\n", msg, num_suppressed);
+    }
+    else
+    {
+        fprintf(out, "%s\n", msg);
+    }
+}
+
+void Logger::flushBuffers()
+{
+    unique_lock<mutex> lck(buffers_mtx);
+    vector<LogBuffer *> cur_buffers = buffers;
+    lck.unlock();
+
+    // collect the buffered messages of all threads
+    vector<LogRecord *> records;
+    vector<uint64_t> heads(cur_buffers.size());
+    uint64_t num_dropped = 0;
+    for (size_t idx = 0; idx < cur_buffers.size(); idx++)
+    {
+        LogBuffer *buffer = cur_buffers[idx];
+        heads[idx] = buffer->head.load(memory_order_acquire);
+        uint64_t pos = buffer->tail.load(memory_order_relaxed);
+        while (pos < heads[idx])
+        {
+            uint64_t offset = pos % buffer->size;
+            LogRecord *record = (LogRecord *)(buffer->data + offset);
+            if (buffer->size - offset < sizeof(LogRecord) || record->msg_len == LOG_PADDING_LEN)
+            { // skipped end of the ring
+                pos += buffer->size - offset;
+                continue;
+            }
+            records.push_back(record);
+            pos += getRecordSize(record->msg_len);
+        }
+        num_dropped += buffer->num_dropped.exchange(0);
+    }
+
+    if (records.empty() == false)
+    {
+        std::stable_sort(records.begin(), records.end(), [](LogRecord *r1, LogRecord *r2)
+                         { return r1->time_us < r2->time_us; });
+        for (auto record : records)
+        {
+            writeMessage(record->level, (const char *)(record + 1), record->num_suppressed);
+        }
+        fflush(stdout);
+    }
+
+    if (num_dropped > 0)
+    {
+        fprintf(stderr, "Logger::flushBuffers dropped %lu messages (log buffers are full)\n", num_dropped);
+    }
+
+    // return the flushed records to the producers
+    for (size_t idx = 0; idx < cur_buffers.size(); idx++)
+    {
+        cur_buffers[idx]->tail.store(heads[idx], memory_order_release);
+    }
+}
+
+void Logger::runFlusher()
+{
+    unique_lock<mutex> lck(flusher_mtx);
+    while (is_stopped == false)
+    {
+        flusher_cv.wait_for(lck, chrono::microseconds(LOG_FLUSH_INTERVAL_US));
+        lck.unlock();
+
+        unique_lock<mutex> flush_lck(flush_mtx);
+        flushBuffers();
+        flush_lck.unlock();
+
+        lck.lock();
+    }
+}
+
+void Logger::flushAtExit()
+{
+    if (is_async == true)
+    {
+        unique_lock<mutex> lck(flush_mtx);
+        flushBuffers();
+    }
+}
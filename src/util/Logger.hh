@@ -0,0 +1,214 @@
+#ifndef __LOGGER_HH__
+#define __LOGGER_HH__
+
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+
+#include "../include/include.hh"
+#include "Utils.hh"
+
+// log levels (macros, so that they can be compared by the preprocessor)
+#define LOG_LEVEL_DEBUG 0 // per command / task / block diagnostics
+#define LOG_LEVEL_INFO 1  // progress and results
+#define LOG_LEVEL_WARN 2  // recoverable failures (e.g., fallbacks)
+#define LOG_LEVEL_ERROR 3 // errors (written synchronously to stderr)
+
+// messages below the compile-time level are compiled out (together with the
+// evaluation of their arguments); build with -DLOG_COMPILE_LEVEL=0 to keep
+// the debug messages
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_MAX_MSG_SIZE 1024            // maximum size of a message (longer messages are truncated)
+#define LOG_FLUSH_INTERVAL_US 10000      // interval of flushing the buffers (10 ms)
+#define LOG_RATE_LIMIT_WINDOW_US 1000000 // window of rate limiting (1 second)
+#define LOG_RECORD_ALIGNMENT 8           // alignment of the records in a buffer
+#define LOG_PADDING_LEN UINT16_MAX       // msg_len of a padding record (to the end of a buffer)
+
+#define DEFAULT_LOG_BUFFER_SIZE 16384 // default Bytes of messages buffered per thread
+#define DEFAULT_LOG_RATE_LIMIT 100    // default maximum number of messages per second of each call site
+
+/**
+ * @brief check if messages of the level are logged
+ */
+#define LOG_IS_ENABLED(level) ((level) >= LOG_COMPILE_LEVEL && Logger::isEnabled(level) == true)
+
+#define LOG_AT(level, fmt, ...)                               \
+    do                                                        \
+    {                                                         \
+        if (LOG_IS_ENABLED(level))                            \
+        {                                                     \
+            static LogSite log_site;                          \
+            Logger::log(level, log_site, fmt, ##__VA_ARGS__); \
+        }                                                     \
+    } while (0)
+
+#define LOG_DEBUG(fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...) LOG_AT(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...) LOG_AT(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_ERROR(fmt, ...) LOG_AT(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief state of a call site for rate limiting (a static of each LOG_*
+ * expansion)
+ */
+typedef struct LogSite
+{
+    atomic<uint64_t> window_start_us; // start of the current window
+    atomic<uint32_t> num_logged;      // messages logged in the current window
+    atomic<uint32_t> num_suppressed;  // messages suppressed since the last logged one
+} LogSite;
+
+/**
+ * @brief header of a buffered message, followed by the formatted message
+ * (without the line break) and '\0'; a record never wraps around the end
+ * of a buffer (the end is skipped, with a padding record if it fits)
+ */
+typedef struct LogRecord
+{
+    uint64_t time_us;        // (Utils::getTimeUs())
+    uint32_t num_suppressed; // messages of the call site suppressed before it
+    uint16_t msg_len;        // length of the message (LOG_PADDING_LEN: padding record)
+    uint8_t level;           // level of the message
+} LogRecord;
+
+/**
+ * @brief ring buffer of the messages of a thread, in variable-length
+ * records: single producer (the thread) and single consumer (the flusher),
+ * without locks. The memory is not initialized, so only the Bytes written
+ * so far are resident. A buffer is reused by the threads created later once
+ * its thread exits
+ */
+typedef struct LogBuffer
+{
+    char *data;                   // ring of records
+    uint64_t size;                // Bytes of the ring
+    atomic<uint64_t> head;        // Bytes written (by the producer)
+    atomic<uint64_t> tail;        // Bytes flushed (by the consumer)
+    atomic<uint64_t> num_dropped; // messages dropped as the buffer is full
+} LogBuffer;
+
+/**
+ * @brief leveled, asynchronous logging: messages are formatted into
+ * per-thread ring buffers, and written to stdout (errors to stderr) by a
+ * background flusher, so the worker threads don't contend on the stdio lock
+ * nor block on the output. Messages of each call site beyond the rate limit
+ * are suppressed (and counted in the next logged message of the site).
+ *
+ * Before init() (e.g., in the simulation tools), messages are written
+ * synchronously without rate limiting. Errors are always written
+ * synchronously, after the buffered messages.
+ */
+class Logger
+{
+private:
+    static int level;             // minimum level of logged messages
+    static size_t buffer_size;    // Bytes of messages buffered per thread
+    static uint32_t rate_limit;   // maximum number of messages per second of each call site (0: unlimited)
+    static atomic<bool> is_async; // messages are buffered and written by the flusher
+
+    static mutex buffers_mtx;
+    static vector<LogBuffer *> buffers;      // all buffers
+    static vector<LogBuffer *> free_buffers; // buffers of exited threads
+
+    static mutex flush_mtx; // consumer side of all buffers and the output
+    static thread *flusher;
+    static mutex flusher_mtx;
+    static condition_variable flusher_cv;
+    static bool is_stopped;
+
+    /**
+     * @brief get the buffer of the calling thread (acquired on first use,
+     * and released when the thread exits)
+     *
+     * @return LogBuffer*
+     */
+    static LogBuffer *getThreadBuffer();
+
+    /**
+     * @brief get the Bytes of a record
+     *
+     * @param msg_len
+     * @return uint64_t
+     */
+    static uint64_t getRecordSize(uint16_t msg_len);
+
+    /**
+     * @brief flush the buffered messages of all threads (in time order);
+     * the caller holds flush_mtx
+     *
+     */
+    static void flushBuffers();
+
+    /**
+     * @brief background flusher
+     *
+     */
+    static void runFlusher();
+
+    /**
+     * @brief write a message (and the number of suppressed messages before
+     * it) to the output of its level
+     */
+    static void writeMessage(int msg_level, const char *msg, uint32_t num_suppressed);
+
+    /**
+     * @brief flush the buffered messages at exit (e.g., exit() on errors)
+     *
+     */
+    static void flushAtExit();
+
+public:
+    /**
+     * @brief start asynchronous logging
+     *
+     * @param _level minimum level of logged messages
+     * @param _buffer_size Bytes of messages buffered per thread (at least
+     * two maximum-size records; messages are dropped if the buffer is full)
+     * @param _rate_limit maximum number of messages per second of each call
+     * site (0: unlimited)
+     */
+    static void init(int _level, size_t _buffer_size, uint32_t _rate_limit);
+
+    /**
+     * @brief flush the buffered messages, and stop the flusher (messages are
+     * written synchronously afterwards)
+     *
+     */
+    static void shutdown();
+
+    static bool isEnabled(int msg_level)
+    {
+        return msg_level >= level;
+    }
+
+    /**
+     * @brief parse a level name (debug / info / warn / error)
+     *
+     * @param level_str
+     * @return int level (-1 if invalid)
+     */
+    static int parseLevel(string level_str);
+
+    /**
+     * @brief log a message (use the LOG_* macros instead)
+     *
+     * @param msg_level
+     * @param site call site
+     * @param fmt printf format (without the trailing line break)
+     */
+    static void log(int msg_level, LogSite &site, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+    /**
+     * @brief release the buffer of an exited thread
+     *
+     * @param buffer
+     */
+    static void releaseBuffer(LogBuffer *buffer);
+};
+
+#endif // __LOGGER_HH__
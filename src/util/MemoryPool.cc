@@ -1,73 +1,172 @@
 #include "MemoryPool.hh"
 
-MemoryPool::MemoryPool(unsigned int _num_blocks, uint64_t _block_size) : num_blocks(_num_blocks), block_size(_block_size)
+MemoryPool::MemoryPool(unsigned int _num_blocks, uint64_t _block_size, bool use_hugepage) : num_blocks(_num_blocks), block_size(_block_size)
 {
-    // free block list
-    // free_block_queue = new moodycamel::ConcurrentQueue<unsigned int>(num_blocks);
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+    block_stride = (block_size + page_size - 1) / page_size * page_size;
+    pool_size = num_blocks * block_stride;
 
-    free_block_queue = new queue<unsigned int>();
-
-    block_ptrs = (unsigned char **)malloc(num_blocks * sizeof(unsigned char *));
-    for (unsigned int block_id = 0; block_id < num_blocks; block_id++)
+    // map (and pre-fault) the pool, so borrowers never touch fresh pages
+    pool_buffer = (unsigned char *)MAP_FAILED;
+    is_hugepage = false;
+    if (use_hugepage == true)
     {
-        // allocate block in memory
-        block_ptrs[block_id] = (unsigned char *)malloc(block_size * sizeof(unsigned char));
-
-        // create block ptr map
-        block_ptrs_map[block_ptrs[block_id]] = block_id;
+        uint64_t huge_pool_size = (pool_size + MEMORY_POOL_HUGEPAGE_SIZE - 1) / MEMORY_POOL_HUGEPAGE_SIZE * MEMORY_POOL_HUGEPAGE_SIZE;
+        pool_buffer = (unsigned char *)mmap(NULL, huge_pool_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE | MAP_HUGETLB, -1, 0);
+        if (pool_buffer != MAP_FAILED)
+        {
+            pool_size = huge_pool_size;
+            is_hugepage = true;
+        }
+        else
+        {
+            LOG_WARN("MemoryPool::MemoryPool failed to map %lu Bytes of hugepages (error: %d), fall back to transparent hugepages", huge_pool_size, errno);
+        }
+    }
 
-        // add to free block
-        // free_block_queue->enqueue(block_id);
+    if (pool_buffer == MAP_FAILED)
+    {
+        pool_buffer = (unsigned char *)mmap(NULL, pool_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (pool_buffer == MAP_FAILED)
+        {
+            LOG_ERROR("MemoryPool::MemoryPool error: failed to map %lu Bytes, error: %d", pool_size, errno);
+            exit(EXIT_FAILURE);
+        }
+        if (use_hugepage == true)
+        {
+            madvise(pool_buffer, pool_size, MADV_HUGEPAGE);
+        }
+    }
 
-        free_block_queue->push(block_id);
+    // all blocks are free
+    free_next = new atomic<uint32_t>[num_blocks];
+    free_head = 0;
+    for (unsigned int block_id = num_blocks; block_id > 0; block_id--)
+    {
+        pushFreeBlock(block_id - 1);
     }
+    num_free_blocks = num_blocks;
+    num_waiters = 0;
 }
 
 MemoryPool::~MemoryPool()
 {
-    for (unsigned int block_id = 0; block_id < num_blocks; block_id++)
+    delete[] free_next;
+    munmap(pool_buffer, pool_size);
+}
+
+void MemoryPool::pushFreeBlock(uint32_t block_id)
+{
+    uint64_t head = free_head.load();
+    uint64_t new_head;
+    do
     {
-        free(block_ptrs[block_id]);
-    }
-    free(block_ptrs);
+        free_next[block_id].store((uint32_t)head);
+        new_head = (((head >> 32) + 1) << 32) | (block_id + 1);
+    } while (free_head.compare_exchange_weak(head, new_head) == false);
+}
 
-    delete free_block_queue;
+uint32_t MemoryPool::popFreeBlock()
+{
+    // the block is reserved before popping, so the stack is not empty
+    uint64_t head = free_head.load();
+    uint64_t new_head;
+    do
+    {
+        while ((uint32_t)head == 0)
+        { // the returned block is not pushed yet
+            this_thread::yield();
+            head = free_head.load();
+        }
+        uint32_t top = (uint32_t)head - 1;
+        new_head = (((head >> 32) + 1) << 32) | free_next[top].load();
+    } while (free_head.compare_exchange_weak(head, new_head) == false);
+
+    return (uint32_t)head - 1;
 }
 
 unsigned char *MemoryPool::getBlock()
 {
-    unsigned int free_block_id;
-    unique_lock<mutex> lck(free_queue_mutex);
-    while (free_block_queue->empty())
+    vector<unsigned char *> block_ptrs;
+    getBlocks(1, block_ptrs);
+
+    return block_ptrs[0];
+}
+
+void MemoryPool::getBlocks(unsigned int num_req_blocks, vector<unsigned char *> &block_ptrs)
+{
+    if (num_req_blocks > num_blocks)
     {
-        queue_cv.wait(lck, [&]
-                      { return !free_block_queue->empty(); });
+        LOG_ERROR("MemoryPool::getBlocks error: %u blocks requested from a pool of %u blocks", num_req_blocks, num_blocks);
+        exit(EXIT_FAILURE);
+    }
+
+    // reserve the blocks (wait until enough blocks are returned)
+    int64_t num_avail_blocks = num_free_blocks.load();
+    while (true)
+    {
+        if (num_avail_blocks >= num_req_blocks)
+        {
+            if (num_free_blocks.compare_exchange_weak(num_avail_blocks, num_avail_blocks - num_req_blocks) == true)
+            {
+                break;
+            }
+            continue;
+        }
+
+        num_waiters++;
+        unique_lock<mutex> lck(wait_mutex);
+        wait_cv.wait(lck, [&]
+                     { return num_free_blocks.load() >= num_req_blocks; });
+        lck.unlock();
+        num_waiters--;
+
+        num_avail_blocks = num_free_blocks.load();
+    }
+
+    block_ptrs.resize(num_req_blocks);
+    for (unsigned int idx = 0; idx < num_req_blocks; idx++)
+    {
+        block_ptrs[idx] = pool_buffer + popFreeBlock() * block_stride;
     }
-    // // dequeue and return free block
-    // if (free_block_queue->try_dequeue(free_block_id) == true)
-    // {
-    //     return block_ptrs[free_block_id];
-    // }
-
-    free_block_id = free_block_queue->front();
-    free_block_queue->pop();
-    return block_ptrs[free_block_id];
 }
 
 void MemoryPool::freeBlock(unsigned char *block_ptr)
 {
-    auto it = block_ptrs_map.find(block_ptr);
-    if (it == block_ptrs_map.end())
+    vector<unsigned char *> block_ptrs(1, block_ptr);
+    freeBlocks(block_ptrs);
+}
+
+void MemoryPool::freeBlocks(vector<unsigned char *> &block_ptrs)
+{
+    for (auto block_ptr : block_ptrs)
     {
-        fprintf(stderr, "error: invalid block pointer to free: %p\n", block_ptr);
-        exit(EXIT_FAILURE);
+        if (block_ptr < pool_buffer || block_ptr >= pool_buffer + num_blocks * block_stride || (block_ptr - pool_buffer) % block_stride != 0)
+        {
+            LOG_ERROR("MemoryPool::freeBlocks error: invalid block pointer to free: %p", block_ptr);
+            exit(EXIT_FAILURE);
+        }
+        pushFreeBlock((block_ptr - pool_buffer) / block_stride);
     }
 
-    // enqueue the free block
-    // free_block_queue->enqueue(it->second);
+    // the blocks are pushed before being released to borrowers
+    num_free_blocks += block_ptrs.size();
+
+    if (num_waiters.load() > 0)
+    {
+        unique_lock<mutex> lck(wait_mutex);
+        lck.unlock();
+        wait_cv.notify_all();
+    }
+}
 
-    unique_lock<mutex> lck(free_queue_mutex);
-    free_block_queue->push(it->second);
-    lck.unlock();
-    queue_cv.notify_one();
+unsigned char *MemoryPool::getRegion(uint64_t &stride)
+{
+    stride = block_stride;
+    return pool_buffer;
+}
+
+unsigned int MemoryPool::getNumFreeBlocks()
+{
+    return num_free_blocks.load();
 }
\ No newline at end of file
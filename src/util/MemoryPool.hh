@@ -3,33 +3,99 @@
 
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "../include/include.hh"
-// #include "../util/concurrentqueue.h"
+#include "Logger.hh"
 
-#include <queue>
+#define MEMORY_POOL_HUGEPAGE_SIZE 2097152 // 2 MiB
 
+/**
+ * @brief agent-wide pool of page-aligned buffers of block_size, borrowed by
+ * all workers. The buffers are carved from one pre-faulted mapping
+ * (optionally backed by hugepages); free buffers are kept in a lock-free
+ * stack, and a borrower of n buffers reserves them from an atomic counter
+ * first, so a borrower either gets all n buffers or waits (back-pressure)
+ * without holding any of them
+ */
 class MemoryPool
 {
 private:
-    /* data */
+    unsigned char *pool_buffer; // mapped region
+    uint64_t pool_size;         // mapped region size
+    uint64_t block_stride;      // block_size aligned to the page size
+
+    // lock-free free block stack (indices); the head packs a tag (upper 32
+    // bits, against ABA) and the top index + 1 (lower 32 bits, 0: empty)
+    atomic<uint64_t> free_head;
+    atomic<uint32_t> *free_next;
+
+    // number of free blocks not reserved by borrowers
+    atomic<int64_t> num_free_blocks;
+
+    // borrowers waiting for blocks
+    atomic<uint32_t> num_waiters;
+    mutex wait_mutex;
+    std::condition_variable wait_cv;
+
+    void pushFreeBlock(uint32_t block_id);
+    uint32_t popFreeBlock();
+
 public:
     unsigned int num_blocks;
     uint64_t block_size;
-    unsigned char **block_ptrs;
-
-    queue<unsigned int> *free_block_queue;
-    mutex free_queue_mutex;
-    std::condition_variable queue_cv;
+    bool is_hugepage; // backed by hugepages
 
-    // moodycamel::ConcurrentQueue<unsigned int> *free_block_queue;
-    unordered_map<unsigned char *, unsigned int> block_ptrs_map;
-
-    MemoryPool(unsigned int _num_blocks, uint64_t _block_size);
+    MemoryPool(unsigned int _num_blocks, uint64_t _block_size, bool use_hugepage = false);
     ~MemoryPool();
 
+    /**
+     * @brief borrow a block (wait until a block is returned if the pool is
+     * exhausted)
+     *
+     * @return unsigned char*
+     */
     unsigned char *getBlock();
+
+    /**
+     * @brief borrow num_req_blocks blocks all at once
+     *
+     * @param num_req_blocks
+     * @param block_ptrs (out)
+     */
+    void getBlocks(unsigned int num_req_blocks, vector<unsigned char *> &block_ptrs);
+
+    /**
+     * @brief return a block
+     *
+     * @param block_ptr
+     */
     void freeBlock(unsigned char *block_ptr);
+
+    /**
+     * @brief return blocks
+     *
+     * @param block_ptrs
+     */
+    void freeBlocks(vector<unsigned char *> &block_ptrs);
+
+    /**
+     * @brief get the mapped region (for registering it with the kernel)
+     *
+     * @param stride (out) distance between adjacent blocks
+     * @return unsigned char* the first block
+     */
+    unsigned char *getRegion(uint64_t &stride);
+
+    /**
+     * @brief get the number of free blocks (not borrowed)
+     *
+     * @return unsigned int
+     */
+    unsigned int getNumFreeBlocks();
 };
 
-#endif // __MEMORY_POOL_HH__
\ No newline at end of file
+#endif // __MEMORY_POOL_HH__
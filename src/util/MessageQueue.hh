@@ -15,9 +15,14 @@ private:
     /* data */
 public:
     // use the open-source lock-free queue from here: https://github.com/cameron314/readerwriterqueue
-    moodycamel::ReaderWriterQueue<T> *queue;
+    // moodycamel::ReaderWriterQueue<T> *queue;
     // moodycamel::ConcurrentQueue<T> *queue;
     // moodycamel::BlockingConcurrentQueue<T> *queue;
+    moodycamel::BlockingReaderWriterQueue<T> *queue;
+
+    // free slots of the queue (bounded by maxSize): a full queue blocks the
+    // producer; both waits spin briefly, then sleep on the semaphore
+    moodycamel::spsc_sema::LightweightSemaphore *free_slots;
 
     /**
      * @brief Construct a new Message Queue object
@@ -26,9 +31,11 @@ public:
      */
     MessageQueue(uint32_t maxSize)
     {
-        queue = new moodycamel::ReaderWriterQueue<T>(maxSize);
+        // queue = new moodycamel::ReaderWriterQueue<T>(maxSize);
         // queue = new moodycamel::ConcurrentQueue<T>(maxSize);
         // queue = new moodycamel::BlockingConcurrentQueue<T>(maxSize);
+        queue = new moodycamel::BlockingReaderWriterQueue<T>(maxSize);
+        free_slots = new moodycamel::spsc_sema::LightweightSemaphore(maxSize);
     }
 
     /**
@@ -40,6 +47,7 @@ public:
         bool flag = IsEmpty();
         if (flag)
         {
+            delete free_slots;
             delete queue;
         }
         else
@@ -50,7 +58,8 @@ public:
     }
 
     /**
-     * @brief Push data to the queue
+     * @brief Push data to the queue (wait for a free slot if the queue is
+     * full)
      *
      * @param data
      * @return true
@@ -58,13 +67,12 @@ public:
      */
     bool Push(T &data)
     {
-        while (!queue->try_enqueue(data))
-            ;
-        return true;
+        free_slots->wait();
+        return queue->enqueue(data);
     }
 
     /**
-     * @brief Pop data from the queue
+     * @brief Pop data from the queue (non-blocking)
      *
      * @param data
      * @return true
@@ -72,7 +80,56 @@ public:
      */
     bool Pop(T &data)
     {
-        return queue->try_dequeue(data);
+        if (queue->try_dequeue(data) == false)
+        {
+            return false;
+        }
+        free_slots->signal();
+        return true;
+    }
+
+    /**
+     * @brief Pop data from the queue (wait until data is available)
+     *
+     * @param data
+     * @param timeout_usecs (-1: wait forever)
+     * @return true
+     * @return false timed out
+     */
+    bool WaitPop(T &data, int64_t timeout_usecs = -1)
+    {
+        if (timeout_usecs < 0)
+        {
+            queue->wait_dequeue(data);
+        }
+        else if (queue->wait_dequeue_timed(data, timeout_usecs) == false)
+        {
+            return false;
+        }
+        free_slots->signal();
+        return true;
+    }
+
+    /**
+     * @brief Pop all available data (at most max_items) from the queue
+     * (wait until data is available)
+     *
+     * @param items
+     * @param max_items
+     * @return size_t number of items
+     */
+    size_t WaitPopBulk(vector<T> &items, size_t max_items)
+    {
+        items.resize(max_items);
+        queue->wait_dequeue(items[0]);
+        size_t num_items = 1;
+        while (num_items < max_items && queue->try_dequeue(items[num_items]) == true)
+        {
+            num_items++;
+        }
+        items.resize(num_items);
+        free_slots->signal(num_items);
+        return num_items;
     }
 
     /**
@@ -86,6 +143,16 @@ public:
         size_t count = queue->size_approx();
         return (count == 0);
     }
+
+    /**
+     * @brief Get the (approximate) number of items in the queue
+     *
+     * @return size_t
+     */
+    size_t Size()
+    {
+        return queue->size_approx();
+    }
 };
 
 #endif // __MESSAGE_QUEUE_HH__
\ No newline at end of file
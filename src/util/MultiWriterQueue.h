@@ -2,6 +2,7 @@
 #define __MULTIWRITER_QUEUE_HH__
 
 #include "../include/include.hh"
+#include "Logger.hh"
 // #include "concurrentqueue.h"
 #include "blockingconcurrentqueue.h"
 #include <mutex>
@@ -17,6 +18,10 @@ public:
     // moodycamel::MultiWriterQueue<T> *queue;
     moodycamel::BlockingConcurrentQueue<T> *queue;
 
+    // free slots of the queue (bounded by maxSize): a full queue blocks the
+    // producers; both waits spin briefly, then sleep on the semaphore
+    moodycamel::LightweightSemaphore *free_slots;
+
     /**
      * @brief Construct a new MultiWriter Queue object
      *
@@ -27,6 +32,7 @@ public:
         // queue = new moodycamel::ReaderWriterQueue<T>(maxSize);
         // queue = new moodycamel::MultiWriterQueue<T>(maxSize);
         queue = new moodycamel::BlockingConcurrentQueue<T>(maxSize);
+        free_slots = new moodycamel::LightweightSemaphore(maxSize);
     }
 
     /**
@@ -38,17 +44,19 @@ public:
         bool flag = IsEmpty();
         if (flag)
         {
+            delete free_slots;
             delete queue;
         }
         else
         {
-            fprintf(stderr, "MultiWriterQueue: Queue is not empty.\n");
+            LOG_ERROR("MultiWriterQueue::~MultiWriterQueue error: queue is not empty");
             exit(EXIT_FAILURE);
         }
     }
 
     /**
-     * @brief Push data to the queue
+     * @brief Push data to the queue (wait for a free slot if the queue is
+     * full)
      *
      * @param data
      * @return true
@@ -56,13 +64,12 @@ public:
      */
     bool Push(T &data)
     {
-        while (!queue->try_enqueue(data))
-            ;
-        return true;
+        free_slots->wait();
+        return queue->enqueue(data);
     }
 
     /**
-     * @brief Pop data from the queue
+     * @brief Pop data from the queue (non-blocking)
      *
      * @param data
      * @return true
@@ -70,7 +77,51 @@ public:
      */
     bool Pop(T &data)
     {
-        return queue->try_dequeue(data);
+        if (queue->try_dequeue(data) == false)
+        {
+            return false;
+        }
+        free_slots->signal();
+        return true;
+    }
+
+    /**
+     * @brief Pop data from the queue (wait until data is available)
+     *
+     * @param data
+     * @param timeout_usecs (-1: wait forever)
+     * @return true
+     * @return false timed out
+     */
+    bool WaitPop(T &data, int64_t timeout_usecs = -1)
+    {
+        if (timeout_usecs < 0)
+        {
+            queue->wait_dequeue(data);
+        }
+        else if (queue->wait_dequeue_timed(data, timeout_usecs) == false)
+        {
+            return false;
+        }
+        free_slots->signal();
+        return true;
+    }
+
+    /**
+     * @brief Pop all available data (at most max_items) from the queue
+     * (wait until data is available)
+     *
+     * @param items
+     * @param max_items
+     * @return size_t number of items
+     */
+    size_t WaitPopBulk(vector<T> &items, size_t max_items)
+    {
+        items.resize(max_items);
+        size_t num_items = queue->wait_dequeue_bulk(items.begin(), max_items);
+        items.resize(num_items);
+        free_slots->signal(num_items);
+        return num_items;
     }
 
     /**
@@ -84,6 +135,16 @@ public:
         size_t count = queue->size_approx();
         return (count == 0);
     }
+
+    /**
+     * @brief Get the (approximate) number of items in the queue
+     *
+     * @return size_t
+     */
+    size_t Size()
+    {
+        return queue->size_approx();
+    }
 };
 
 #endif // __MULTIWRITER_QUEUE_HH__
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "TokenBucket.hh"
+
+TokenBucket::TokenBucket() : rate(0), burst_size(TOKEN_BUCKET_MIN_BURST), num_tokens(0), last_refill_us(0)
+{
+}
+
+TokenBucket::~TokenBucket()
+{
+}
+
+void TokenBucket::refill(uint64_t cur_time_us)
+{
+    uint64_t cur_rate = rate.load(memory_order_relaxed);
+    if (cur_time_us > last_refill_us)
+    {
+        num_tokens += (double)(cur_time_us - last_refill_us) * cur_rate / 1000000;
+        if (num_tokens > burst_size)
+        {
+            num_tokens = burst_size;
+        }
+    }
+    last_refill_us = cur_time_us;
+}
+
+void TokenBucket::setRate(uint64_t _rate)
+{
+    unique_lock<mutex> lck(bucket_mtx);
+
+    // the tokens so far are refilled at the previous rate
+    uint64_t cur_time_us = Utils::getTimeUs();
+    refill(cur_time_us);
+
+    rate = _rate;
+    burst_size = max(_rate * TOKEN_BUCKET_BURST_US / 1000000, (uint64_t)TOKEN_BUCKET_MIN_BURST);
+    if (_rate == 0 || num_tokens > burst_size)
+    { // start full (the debt is cleared once unlimited)
+        num_tokens = burst_size;
+    }
+}
+
+void TokenBucket::acquire(uint64_t num_bytes)
+{
+    if (isLimited() == false)
+    {
+        return;
+    }
+
+    unique_lock<mutex> lck(bucket_mtx);
+    uint64_t cur_rate = rate.load(memory_order_relaxed);
+    if (cur_rate == 0)
+    {
+        return;
+    }
+
+    refill(Utils::getTimeUs());
+    num_tokens -= num_bytes;
+    if (num_tokens >= 0)
+    {
+        return;
+    }
+
+    // wait until the debt (including the tokens taken by the earlier
+    // waiters) is repaid
+    uint64_t wait_us = (uint64_t)(-num_tokens * 1000000 / cur_rate);
+    lck.unlock();
+
+    this_thread::sleep_for(chrono::microseconds(wait_us));
+}
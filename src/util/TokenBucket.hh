@@ -0,0 +1,71 @@
+#ifndef __TOKEN_BUCKET_HH__
+#define __TOKEN_BUCKET_HH__
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "../include/include.hh"
+#include "Utils.hh"
+
+#define TOKEN_BUCKET_BURST_US 100000 // burst size of a token bucket: tokens accumulated in 100 ms
+#define TOKEN_BUCKET_MIN_BURST 65536 // minimum burst size (in Bytes)
+
+/**
+ * @brief token bucket rate limiter shared by threads: tokens (Bytes) are
+ * refilled at the rate up to the burst size, and a caller takes the tokens
+ * of its Bytes before moving them. A caller taking more tokens than
+ * available runs the bucket into debt, and sleeps until the debt is repaid,
+ * so later callers queue up behind it and the long-term rate is kept. The
+ * rate can be changed at any time (0: unlimited, where acquire() returns
+ * right away without locking)
+ */
+class TokenBucket
+{
+private:
+    mutex bucket_mtx;
+    atomic<uint64_t> rate;   // Bytes per second (0: unlimited)
+    uint64_t burst_size;     // maximum number of tokens
+    double num_tokens;       // available tokens (negative: debt)
+    uint64_t last_refill_us; // time of the last refill (Utils::getTimeUs())
+
+    /**
+     * @brief refill the tokens accumulated since the last refill (with the
+     * lock held)
+     *
+     * @param cur_time_us
+     */
+    void refill(uint64_t cur_time_us);
+
+public:
+    TokenBucket();
+    ~TokenBucket();
+
+    /**
+     * @brief set the rate
+     *
+     * @param _rate Bytes per second (0: unlimited)
+     */
+    void setRate(uint64_t _rate);
+
+    uint64_t getRate()
+    {
+        return rate.load(memory_order_relaxed);
+    }
+
+    bool isLimited()
+    {
+        return getRate() > 0;
+    }
+
+    /**
+     * @brief take the tokens of num_bytes, and wait until they are
+     * available
+     *
+     * @param num_bytes
+     */
+    void acquire(uint64_t num_bytes);
+};
+
+#endif // __TOKEN_BUCKET_HH__
@@ -0,0 +1,178 @@
+#include "Tracer.hh"
+
+bool Tracer::is_enabled = false;
+string Tracer::trace_path;
+uint32_t Tracer::pid = 0;
+string Tracer::process_name;
+size_t Tracer::buffer_size = 0;
+int64_t Tracer::clock_offset_us = 0;
+
+mutex Tracer::buffers_mtx;
+vector<TraceBuffer *> Tracer::buffers;
+vector<TraceBuffer *> Tracer::free_buffers;
+
+/**
+ * @brief the trace buffer of a thread, released when the thread exits
+ */
+typedef struct TraceBufferHolder
+{
+    TraceBuffer *buffer;
+
+    TraceBufferHolder() : buffer(NULL) {}
+    ~TraceBufferHolder()
+    {
+        if (buffer != NULL)
+        {
+            Tracer::releaseBuffer(buffer);
+        }
+    }
+} TraceBufferHolder;
+
+static thread_local TraceBufferHolder thread_buffer_holder;
+
+void Tracer::init(string _trace_path, uint32_t _pid, string _process_name, size_t _buffer_size)
+{
+    trace_path = _trace_path;
+    pid = _pid;
+    process_name = _process_name;
+    buffer_size = max(_buffer_size, (size_t)1);
+
+    // timestamps are recorded with the monotonic clock, and dumped in
+    // wall-clock time (to align the traces of nodes)
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t wall_clock_us = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    clock_offset_us = (int64_t)wall_clock_us - (int64_t)Utils::getTimeUs();
+
+    is_enabled = true;
+
+    LOG_INFO("Tracer::init tracing enabled, trace file: %s, buffer size: %lu events per thread", trace_path.c_str(), buffer_size);
+}
+
+TraceBuffer *Tracer::getThreadBuffer()
+{
+    TraceBuffer *buffer = thread_buffer_holder.buffer;
+    if (buffer != NULL)
+    {
+        return buffer;
+    }
+
+    // reuse the buffer of an exited thread, or create a new lane
+    unique_lock<mutex> lck(buffers_mtx);
+    if (free_buffers.empty() == false)
+    {
+        buffer = free_buffers.back();
+        free_buffers.pop_back();
+    }
+    else
+    {
+        buffer = new TraceBuffer();
+        buffer->tid = buffers.size();
+        buffer->num_events = 0;
+        buffers.push_back(buffer);
+    }
+    lck.unlock();
+
+    thread_buffer_holder.buffer = buffer;
+    return buffer;
+}
+
+void Tracer::setThreadName(string name)
+{
+    if (is_enabled == false)
+    {
+        return;
+    }
+
+    getThreadBuffer()->thread_name = name;
+}
+
+void Tracer::record(const char *name, uint64_t start_us, uint64_t end_us, uint32_t post_stripe_id, uint8_t post_block_id)
+{
+    if (is_enabled == false)
+    {
+        return;
+    }
+
+    TraceBuffer *buffer = getThreadBuffer();
+
+    TraceEvent event;
+    event.name = name;
+    event.start_us = start_us;
+    event.dur_us = end_us > start_us ? end_us - start_us : 0;
+    event.post_stripe_id = post_stripe_id;
+    event.post_block_id = post_block_id;
+
+    // the ring grows up to the buffer size, then overwrites the oldest events
+    if (buffer->events.size() < buffer_size)
+    {
+        buffer->events.push_back(event);
+    }
+    else
+    {
+        buffer->events[buffer->num_events % buffer_size] = event;
+    }
+    buffer->num_events++;
+}
+
+void Tracer::releaseBuffer(TraceBuffer *buffer)
+{
+    unique_lock<mutex> lck(buffers_mtx);
+    free_buffers.push_back(buffer);
+}
+
+bool Tracer::dump()
+{
+    if (is_enabled == false)
+    {
+        return true;
+    }
+    is_enabled = false;
+
+    FILE *trace_file = fopen(trace_path.c_str(), "w");
+    if (trace_file == NULL)
+    {
+        LOG_ERROR("Tracer::dump error opening trace file: %s, error: %d", trace_path.c_str(), errno);
+        return false;
+    }
+
+    unique_lock<mutex> lck(buffers_mtx);
+
+    // process and thread names
+    fprintf(trace_file, "{\"traceEvents\":[\n");
+    fprintf(trace_file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":0,\"args\":{\"name\":\"%s\"}}", pid, process_name.c_str());
+    for (auto buffer : buffers)
+    {
+        string thread_name = buffer->thread_name.empty() ? "Thread " + to_string(buffer->tid) : buffer->thread_name;
+        fprintf(trace_file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", pid, buffer->tid, thread_name.c_str());
+    }
+
+    // stages
+    uint64_t num_dumped_events = 0;
+    uint64_t num_dropped_events = 0;
+    for (auto buffer : buffers)
+    {
+        for (auto &event : buffer->events)
+        {
+            fprintf(trace_file, ",\n{\"name\":\"%s\",\"cat\":\"bart\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%lu,\"dur\":%u", event.name, pid, buffer->tid, (uint64_t)((int64_t)event.start_us + clock_offset_us), event.dur_us);
+            if (event.post_stripe_id != INVALID_SG_ID)
+            {
+                fprintf(trace_file, ",\"args\":{\"post_stripe_id\":%u,\"post_block_id\":%u}", event.post_stripe_id, event.post_block_id);
+            }
+            fprintf(trace_file, "}");
+        }
+        num_dumped_events += buffer->events.size();
+        num_dropped_events += buffer->num_events - buffer->events.size();
+    }
+    fprintf(trace_file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    if (fclose(trace_file) != 0)
+    {
+        LOG_ERROR("Tracer::dump error writing trace file: %s, error: %d", trace_path.c_str(), errno);
+        return false;
+    }
+
+    LOG_INFO("Tracer::dump written %lu events of %lu threads to %s (%lu oldest events overwritten)", num_dumped_events, buffers.size(), trace_path.c_str(), num_dropped_events);
+
+    return true;
+}
@@ -0,0 +1,147 @@
+#ifndef __TRACER_HH__
+#define __TRACER_HH__
+
+#include <mutex>
+
+#include "../include/include.hh"
+#include "Utils.hh"
+#include "Logger.hh"
+
+/**
+ * @brief a traced stage: begin and end of a stage of a task (a complete
+ * event of the Chrome trace format)
+ */
+typedef struct TraceEvent
+{
+    const char *name;        // stage name (a string literal)
+    uint64_t start_us;       // start time (Utils::getTimeUs())
+    uint32_t dur_us;         // duration
+    uint32_t post_stripe_id; // (optional) post-transition stripe id of the task
+    uint8_t post_block_id;   // (optional) post-transition block id of the task
+} TraceEvent;
+
+/**
+ * @brief ring buffer of the trace events of a thread: written by the thread
+ * only (without locks), and read at the dump. A buffer is reused by the
+ * threads created later once its thread exits, so short-lived threads (e.g.,
+ * data requests of tasks) share the timeline lanes
+ */
+typedef struct TraceBuffer
+{
+    uint32_t tid;              // timeline lane
+    string thread_name;        // name of the (last) thread
+    vector<TraceEvent> events; // ring of events (grows up to the buffer size)
+    uint64_t num_events;       // number of recorded events (the latest events.size() events are kept)
+} TraceBuffer;
+
+/**
+ * @brief low-overhead timeline tracing of a node: the stages of tasks are
+ * recorded into thread-local ring buffers, and dumped at shutdown as a
+ * Chrome / Perfetto trace (JSON), with the node as the process and threads
+ * as lanes. Timestamps are in wall-clock time, so the traces of all nodes
+ * can be merged into one timeline (scripts/merge_traces.py)
+ */
+class Tracer
+{
+private:
+    static bool is_enabled;
+    static string trace_path;       // output trace file
+    static uint32_t pid;            // process id in the trace (node id)
+    static string process_name;     // process name in the trace
+    static size_t buffer_size;      // maximum number of events kept per thread
+    static int64_t clock_offset_us; // wall-clock time - Utils::getTimeUs()
+
+    static mutex buffers_mtx;
+    static vector<TraceBuffer *> buffers;      // all buffers (by tid)
+    static vector<TraceBuffer *> free_buffers; // buffers of exited threads
+
+    /**
+     * @brief get the buffer of the calling thread (acquired on first use,
+     * and released when the thread exits)
+     *
+     * @return TraceBuffer*
+     */
+    static TraceBuffer *getThreadBuffer();
+
+public:
+    /**
+     * @brief enable tracing of the node
+     *
+     * @param _trace_path output trace file
+     * @param _pid process id in the trace
+     * @param _process_name process name in the trace
+     * @param _buffer_size maximum number of events kept per thread (the
+     * oldest events are overwritten)
+     */
+    static void init(string _trace_path, uint32_t _pid, string _process_name, size_t _buffer_size);
+
+    static bool isEnabled()
+    {
+        return is_enabled;
+    }
+
+    /**
+     * @brief name the lane of the calling thread
+     *
+     * @param name
+     */
+    static void setThreadName(string name);
+
+    /**
+     * @brief record a stage of the calling thread
+     *
+     * @param name stage name (a string literal)
+     * @param start_us (Utils::getTimeUs())
+     * @param end_us (Utils::getTimeUs())
+     * @param post_stripe_id
+     * @param post_block_id
+     */
+    static void record(const char *name, uint64_t start_us, uint64_t end_us, uint32_t post_stripe_id = INVALID_SG_ID, uint8_t post_block_id = INVALID_BLK_ID);
+
+    /**
+     * @brief release the buffer of an exited thread
+     *
+     * @param buffer
+     */
+    static void releaseBuffer(TraceBuffer *buffer);
+
+    /**
+     * @brief write the trace (after all traced threads are finished), and
+     * disable tracing
+     *
+     * @return true
+     * @return false
+     */
+    static bool dump();
+};
+
+/**
+ * @brief record the enclosing scope as a stage (if tracing is enabled)
+ */
+class TraceScope
+{
+private:
+    const char *name;
+    uint64_t start_us;
+    uint32_t post_stripe_id;
+    uint8_t post_block_id;
+
+public:
+    TraceScope(const char *_name, uint32_t _post_stripe_id = INVALID_SG_ID, uint8_t _post_block_id = INVALID_BLK_ID) : name(_name), start_us(0), post_stripe_id(_post_stripe_id), post_block_id(_post_block_id)
+    {
+        if (Tracer::isEnabled() == true)
+        {
+            start_us = Utils::getTimeUs();
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (start_us != 0)
+        {
+            Tracer::record(name, start_us, Utils::getTimeUs(), post_stripe_id, post_block_id);
+        }
+    }
+};
+
+#endif // __TRACER_HH__
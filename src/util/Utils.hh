@@ -22,6 +22,22 @@ public:
         printf("\n");
     }
 
+    /**
+     * @brief format a vector in the same way as printVector (without the
+     * line break), e.g., for logging
+     *
+     * @tparam T
+     * @param vec
+     * @return string
+     */
+    template <typename T>
+    static string vectorToString(T &vec)
+    {
+        std::ostringstream oss;
+        std::copy(vec.cbegin(), vec.cend(), std::ostream_iterator<typename T::value_type>(oss, " "));
+        return oss.str();
+    }
+
     static void printUCharBuffer(unsigned char *buffer, unsigned int buffer_size);
 
     template <typename T>
@@ -139,6 +155,13 @@ public:
      * @return vector<size_t>
      */
     static vector<size_t> dotAddUIntVectors(vector<size_t> &v1, vector<size_t> &v2);
+
+    /**
+     * @brief get the time of a monotonic clock (for measuring durations)
+     *
+     * @return uint64_t time in microseconds
+     */
+    static uint64_t getTimeUs();
 };
 
 #endif // __UTILS_HH__
\ No newline at end of file